@@ -169,7 +169,7 @@ solution "SOIL2"
 			links {"opengl32"}
 
 		configuration "linux"
-			links {"GL"}
+			links {"GL","pthread"}
 
 		configuration "macosx"
 			links { "OpenGL.framework", "CoreFoundation.framework" }
@@ -181,7 +181,7 @@ solution "SOIL2"
 			links {"GL"}
 
 		configuration "freebsd"
-			links {"GL"}
+			links {"GL","pthread"}
 
 		configuration "debug"
 			defines { "DEBUG" }
@@ -215,7 +215,7 @@ solution "SOIL2"
 			links {"opengl32","SDL2main","SDL2"}
 
 		configuration "linux"
-			links {"GL","SDL2"}
+			links {"GL","SDL2","pthread"}
 
 		configuration "macosx"
 			links { "OpenGL.framework", "CoreFoundation.framework", get_backend_link_name("SDL2") }
@@ -231,7 +231,7 @@ solution "SOIL2"
 			links {"GL","SDL2"}
 
 		configuration "freebsd"
-			links {"GL","SDL2"}
+			links {"GL","SDL2","pthread"}
 
 		configuration "debug"
 			defines { "DEBUG" }
@@ -265,7 +265,7 @@ solution "SOIL2"
             links {"opengl32","SDL2main","SDL2"}
 
         configuration "linux"
-            links {"GL","SDL2"}
+            links {"GL","SDL2","pthread"}
 
         configuration "macosx"
             links { "OpenGL.framework", "CoreFoundation.framework", get_backend_link_name("SDL2") }
@@ -281,7 +281,7 @@ solution "SOIL2"
             links {"GL","SDL2"}
 
         configuration "freebsd"
-            links {"GL","SDL2"}
+            links {"GL","SDL2","pthread"}
 
         configuration "debug"
             defines { "DEBUG" }
@@ -316,7 +316,7 @@ solution "SOIL2"
 			links {"opengl32","SDL2main","SDL2"}
 
 		configuration "linux"
-			links {"GL","SDL2"}
+			links {"GL","SDL2","pthread"}
 
 		configuration "macosx"
 			links { "OpenGL.framework", "CoreFoundation.framework", get_backend_link_name("SDL2") }
@@ -332,7 +332,7 @@ solution "SOIL2"
 			links {"GL","SDL2"}
 
 		configuration "freebsd"
-			links {"GL","SDL2"}
+			links {"GL","SDL2","pthread"}
 
 		configuration "debug"
 			defines { "DEBUG" }
@@ -140,7 +140,7 @@ workspace "SOIL2"
 			links {"opengl32"}
 
 		filter "system:linux"
-			links {"GL"}
+			links {"GL","pthread"}
 
 		filter "system:macosx"
 			links { "OpenGL.framework", "CoreFoundation.framework" }
@@ -152,7 +152,7 @@ workspace "SOIL2"
 			links {"GL"}
 
 		filter "system:bsd"
-			links {"GL"}
+			links {"GL","pthread"}
 
 		filter "action:not vs*"
 			buildoptions { "-Wall" }
@@ -180,7 +180,7 @@ workspace "SOIL2"
 			links {"opengl32","SDL2main","SDL2"}
 
 		filter "system:linux"
-			links {"GL","SDL2"}
+			links {"GL","SDL2","pthread"}
 
 		filter "system:macosx"
 			links { "OpenGL.framework", "CoreFoundation.framework", get_backend_link_name("SDL2") }
@@ -196,7 +196,7 @@ workspace "SOIL2"
 			links {"GL","SDL2"}
 
 		filter "system:bsd"
-			links {"GL","SDL2"}
+			links {"GL","SDL2","pthread"}
 
 		filter "action:not vs*"
 			buildoptions { "-Wall" }
@@ -235,7 +235,7 @@ workspace "SOIL2"
 			links {"opengl32","SDL2main","SDL2"}
 
 		filter "system:linux"
-			links {"GL","SDL2"}
+			links {"GL","SDL2","pthread"}
 
 		filter "system:macosx"
 			links { "OpenGL.framework", "CoreFoundation.framework", get_backend_link_name("SDL2") }
@@ -251,7 +251,7 @@ workspace "SOIL2"
 			links {"GL","SDL2"}
 
 		filter "system:bsd"
-			links {"GL","SDL2"}
+			links {"GL","SDL2","pthread"}
 
 		filter "action:not vs*"
 			buildoptions { "-Wall" }
@@ -288,7 +288,7 @@ workspace "SOIL2"
 			defines { "_CRT_SECURE_NO_WARNINGS" }
 
 		filter "system:linux"
-			links {"GL","SDL2"}
+			links {"GL","SDL2","pthread"}
 
 		filter "system:macosx"
 			links { "OpenGL.framework", "CoreFoundation.framework", get_backend_link_name("SDL2") }
@@ -304,7 +304,7 @@ workspace "SOIL2"
 			links {"GL","SDL2"}
 
 		filter "system:bsd"
-			links {"GL","SDL2"}
+			links {"GL","SDL2","pthread"}
 
 		filter "action:not vs*"
 			buildoptions { "-Wall" }
@@ -359,7 +359,7 @@ workspace "SOIL2"
 			links { "opengl32", "SDL2main", "SDL2" }
 
 		filter "system:linux"
-			links { "GL", "SDL2" }
+			links { "GL", "SDL2", "pthread" }
 
 		filter "system:macosx"
 			links { "OpenGL.framework", "CoreFoundation.framework", get_backend_link_name("SDL2") }
@@ -375,7 +375,7 @@ workspace "SOIL2"
 			links { "GL", "SDL2" }
 
 		filter "system:bsd"
-			links { "GL", "SDL2" }
+			links { "GL", "SDL2", "pthread" }
 
 		filter "action:not vs*"
 			buildoptions { "-Wall" }
@@ -412,7 +412,7 @@ workspace "SOIL2"
 			links { "opengl32", "SDL2main", "SDL2" }
 
 		filter "system:linux"
-			links { "GL", "SDL2" }
+			links { "GL", "SDL2", "pthread" }
 
 		filter "system:macosx"
 			links { "OpenGL.framework", "CoreFoundation.framework", get_backend_link_name("SDL2") }
@@ -428,7 +428,7 @@ workspace "SOIL2"
 			links { "GL", "SDL2" }
 
 		filter "system:bsd"
-			links { "GL", "SDL2" }
+			links { "GL", "SDL2", "pthread" }
 
 		filter "action:not vs*"
 			buildoptions { "-Wall" }
@@ -465,7 +465,7 @@ workspace "SOIL2"
 			links { "opengl32", "SDL2main", "SDL2" }
 
 		filter "system:linux"
-			links { "GL", "SDL2" }
+			links { "GL", "SDL2", "pthread" }
 
 		filter "system:macosx"
 			links { "OpenGL.framework", "CoreFoundation.framework", get_backend_link_name("SDL2") }
@@ -481,7 +481,7 @@ workspace "SOIL2"
 			links { "GL", "SDL2" }
 
 		filter "system:bsd"
-			links { "GL", "SDL2" }
+			links { "GL", "SDL2", "pthread" }
 
 		filter "action:not vs*"
 			buildoptions { "-Wall" }
@@ -506,6 +506,338 @@ workspace "SOIL2"
 			incdirs { "./" .. remote_sdl2_version .. "/include" }
 
 
+	project "soil2-batch-test"
+		kind "ConsoleApp"
+		language "C++"
+		links { "soil2-static-lib" }
+		files { "src/test/test_Batch.cpp" }
+
+		filter { "system:windows", "action:not vs*" }
+			links { "mingw32" }
+
+		filter "system:windows"
+			links { "opengl32" }
+
+		filter "system:linux"
+			links { "GL", "pthread" }
+
+		filter "system:macosx"
+			links { "OpenGL.framework", "CoreFoundation.framework" }
+			buildoptions { "-F /Library/Frameworks" }
+			linkoptions { "-F /Library/Frameworks" }
+			defines { "GL_SILENCE_DEPRECATION" }
+
+		filter "system:haiku"
+			links { "GL" }
+
+		filter "system:bsd"
+			links { "GL", "pthread" }
+
+		filter "action:not vs*"
+			buildoptions { "-Wall" }
+
+		filter "configurations:debug"
+			defines { "DEBUG" }
+			symbols "On"
+			targetname "soil2-batch-test-debug"
+
+		filter "configurations:release"
+			defines { "NDEBUG" }
+			optimize "On"
+			targetname "soil2-batch-test-release"
+
+	project "soil2-simd-test"
+		kind "ConsoleApp"
+		language "C++"
+		links { "soil2-static-lib" }
+		files { "src/test/test_SIMD.cpp" }
+
+		filter { "system:windows", "action:not vs*" }
+			links { "mingw32" }
+
+		filter "system:windows"
+			links { "opengl32" }
+
+		filter "system:linux"
+			links { "GL", "pthread" }
+
+		filter "system:macosx"
+			links { "OpenGL.framework", "CoreFoundation.framework" }
+			buildoptions { "-F /Library/Frameworks" }
+			linkoptions { "-F /Library/Frameworks" }
+			defines { "GL_SILENCE_DEPRECATION" }
+
+		filter "system:haiku"
+			links { "GL" }
+
+		filter "system:bsd"
+			links { "GL", "pthread" }
+
+		filter "action:not vs*"
+			buildoptions { "-Wall" }
+
+		filter "configurations:debug"
+			defines { "DEBUG" }
+			symbols "On"
+			targetname "soil2-simd-test-debug"
+
+		filter "configurations:release"
+			defines { "NDEBUG" }
+			optimize "On"
+			targetname "soil2-simd-test-release"
+
+	project "soil2-async-test"
+		kind "ConsoleApp"
+		language "C++"
+		links { "soil2-static-lib" }
+		files { "src/test/test_Async.cpp" }
+
+		filter { "system:windows", "action:not vs*" }
+			links { "mingw32" }
+
+		filter "system:windows"
+			links { "opengl32", "SDL2main", "SDL2" }
+
+		filter "system:linux"
+			links { "GL", "SDL2", "pthread" }
+
+		filter "system:macosx"
+			links { "OpenGL.framework", "CoreFoundation.framework", get_backend_link_name("SDL2") }
+			buildoptions { "-F /Library/Frameworks" }
+			linkoptions { "-F /Library/Frameworks" }
+			includedirs { "/Library/Frameworks/SDL2.framework/Headers" }
+			defines { "GL_SILENCE_DEPRECATION" }
+			if not _OPTIONS["use-frameworks"] then
+				defines { "SOIL2_NO_FRAMEWORKS" }
+			end
+
+		filter "system:haiku"
+			links { "GL", "SDL2" }
+
+		filter "system:bsd"
+			links { "GL", "SDL2", "pthread" }
+
+		filter "action:not vs*"
+			buildoptions { "-Wall" }
+
+		filter "configurations:debug"
+			defines { "DEBUG" }
+			symbols "On"
+			targetname "soil2-async-test-debug"
+
+		filter "configurations:release"
+			defines { "NDEBUG" }
+			optimize "On"
+			targetname "soil2-async-test-release"
+
+		filter { "options:windows-vc-build", "system:windows", "platforms:x86" }
+			syslibdirs { "./" .. remote_sdl2_version .. "/lib/x86" }
+
+		filter { "options:windows-vc-build", "system:windows", "platforms:x86_64" }
+			syslibdirs { "./" .. remote_sdl2_version .. "/lib/x64" }
+
+		filter { "options:windows-vc-build", "system:windows" }
+			incdirs { "./" .. remote_sdl2_version .. "/include" }
+
+	project "soil2-pbo-test"
+		kind "ConsoleApp"
+		language "C++"
+		links { "soil2-static-lib" }
+		files { "src/test/test_PBO.cpp" }
+
+		filter { "system:windows", "action:not vs*" }
+			links { "mingw32" }
+
+		filter "system:windows"
+			links { "opengl32", "SDL2main", "SDL2" }
+
+		filter "system:linux"
+			links { "GL", "SDL2", "pthread" }
+
+		filter "system:macosx"
+			links { "OpenGL.framework", "CoreFoundation.framework", get_backend_link_name("SDL2") }
+			buildoptions { "-F /Library/Frameworks" }
+			linkoptions { "-F /Library/Frameworks" }
+			includedirs { "/Library/Frameworks/SDL2.framework/Headers" }
+			defines { "GL_SILENCE_DEPRECATION" }
+			if not _OPTIONS["use-frameworks"] then
+				defines { "SOIL2_NO_FRAMEWORKS" }
+			end
+
+		filter "system:haiku"
+			links { "GL", "SDL2" }
+
+		filter "system:bsd"
+			links { "GL", "SDL2", "pthread" }
+
+		filter "action:not vs*"
+			buildoptions { "-Wall" }
+
+		filter "configurations:debug"
+			defines { "DEBUG" }
+			symbols "On"
+			targetname "soil2-pbo-test-debug"
+
+		filter "configurations:release"
+			defines { "NDEBUG" }
+			optimize "On"
+			targetname "soil2-pbo-test-release"
+
+		filter { "options:windows-vc-build", "system:windows", "platforms:x86" }
+			syslibdirs { "./" .. remote_sdl2_version .. "/lib/x86" }
+
+		filter { "options:windows-vc-build", "system:windows", "platforms:x86_64" }
+			syslibdirs { "./" .. remote_sdl2_version .. "/lib/x64" }
+
+		filter { "options:windows-vc-build", "system:windows" }
+			incdirs { "./" .. remote_sdl2_version .. "/include" }
+
+	project "soil2-reload-test"
+		kind "ConsoleApp"
+		language "C++"
+		links { "soil2-static-lib" }
+		files { "src/test/test_Reload.cpp" }
+
+		filter { "system:windows", "action:not vs*" }
+			links { "mingw32" }
+
+		filter "system:windows"
+			links { "opengl32", "SDL2main", "SDL2" }
+
+		filter "system:linux"
+			links { "GL", "SDL2", "pthread" }
+
+		filter "system:macosx"
+			links { "OpenGL.framework", "CoreFoundation.framework", get_backend_link_name("SDL2") }
+			buildoptions { "-F /Library/Frameworks" }
+			linkoptions { "-F /Library/Frameworks" }
+			includedirs { "/Library/Frameworks/SDL2.framework/Headers" }
+			defines { "GL_SILENCE_DEPRECATION" }
+			if not _OPTIONS["use-frameworks"] then
+				defines { "SOIL2_NO_FRAMEWORKS" }
+			end
+
+		filter "system:haiku"
+			links { "GL", "SDL2" }
+
+		filter "system:bsd"
+			links { "GL", "SDL2", "pthread" }
+
+		filter "action:not vs*"
+			buildoptions { "-Wall" }
+
+		filter "configurations:debug"
+			defines { "DEBUG" }
+			symbols "On"
+			targetname "soil2-reload-test-debug"
+
+		filter "configurations:release"
+			defines { "NDEBUG" }
+			optimize "On"
+			targetname "soil2-reload-test-release"
+
+		filter { "options:windows-vc-build", "system:windows", "platforms:x86" }
+			syslibdirs { "./" .. remote_sdl2_version .. "/lib/x86" }
+
+		filter { "options:windows-vc-build", "system:windows", "platforms:x86_64" }
+			syslibdirs { "./" .. remote_sdl2_version .. "/lib/x64" }
+
+		filter { "options:windows-vc-build", "system:windows" }
+			incdirs { "./" .. remote_sdl2_version .. "/include" }
+
+	project "soil2-context-test"
+		kind "ConsoleApp"
+		language "C++"
+		links { "soil2-static-lib" }
+		files { "src/test/test_Context.cpp" }
+
+		filter { "system:windows", "action:not vs*" }
+			links { "mingw32" }
+
+		filter "system:windows"
+			links { "opengl32", "SDL2main", "SDL2" }
+
+		filter "system:linux"
+			links { "GL", "SDL2", "pthread" }
+
+		filter "system:macosx"
+			links { "OpenGL.framework", "CoreFoundation.framework", get_backend_link_name("SDL2") }
+			buildoptions { "-F /Library/Frameworks" }
+			linkoptions { "-F /Library/Frameworks" }
+			includedirs { "/Library/Frameworks/SDL2.framework/Headers" }
+			defines { "GL_SILENCE_DEPRECATION" }
+			if not _OPTIONS["use-frameworks"] then
+				defines { "SOIL2_NO_FRAMEWORKS" }
+			end
+
+		filter "system:haiku"
+			links { "GL", "SDL2" }
+
+		filter "system:bsd"
+			links { "GL", "SDL2", "pthread" }
+
+		filter "action:not vs*"
+			buildoptions { "-Wall" }
+
+		filter "configurations:debug"
+			defines { "DEBUG" }
+			symbols "On"
+			targetname "soil2-context-test-debug"
+
+		filter "configurations:release"
+			defines { "NDEBUG" }
+			optimize "On"
+			targetname "soil2-context-test-release"
+
+		filter { "options:windows-vc-build", "system:windows", "platforms:x86" }
+			syslibdirs { "./" .. remote_sdl2_version .. "/lib/x86" }
+
+		filter { "options:windows-vc-build", "system:windows", "platforms:x86_64" }
+			syslibdirs { "./" .. remote_sdl2_version .. "/lib/x64" }
+
+		filter { "options:windows-vc-build", "system:windows" }
+			incdirs { "./" .. remote_sdl2_version .. "/include" }
+
+	project "soil2-dxt-benchmark"
+		kind "ConsoleApp"
+		language "C++"
+		links { "soil2-static-lib" }
+		files { "src/test/benchmark_DXT.cpp" }
+
+		filter { "system:windows", "action:not vs*" }
+			links { "mingw32" }
+
+		filter "system:windows"
+			links { "opengl32" }
+
+		filter "system:linux"
+			links { "GL", "pthread" }
+
+		filter "system:macosx"
+			links { "OpenGL.framework", "CoreFoundation.framework" }
+			buildoptions { "-F /Library/Frameworks" }
+			linkoptions { "-F /Library/Frameworks" }
+			defines { "GL_SILENCE_DEPRECATION" }
+
+		filter "system:haiku"
+			links { "GL" }
+
+		filter "system:bsd"
+			links { "GL", "pthread" }
+
+		filter "action:not vs*"
+			buildoptions { "-Wall" }
+
+		filter "configurations:debug"
+			defines { "DEBUG" }
+			symbols "On"
+			targetname "soil2-dxt-benchmark-debug"
+
+		filter "configurations:release"
+			defines { "NDEBUG" }
+			optimize "On"
+			targetname "soil2-dxt-benchmark-release"
+
     project "soil2-grid-atlas-test"
         kind "ConsoleApp"
         language "C++"
@@ -519,7 +851,7 @@ workspace "SOIL2"
             links {"opengl32","SDL2main","SDL2"}
 
         filter "system:linux"
-            links {"GL","SDL2"}
+            links {"GL","SDL2","pthread"}
 
         filter "system:macosx"
             links { "OpenGL.framework", "CoreFoundation.framework", get_backend_link_name("SDL2") }
@@ -535,7 +867,7 @@ workspace "SOIL2"
             links {"GL","SDL2"}
 
         filter "system:bsd"
-            links {"GL","SDL2"}
+            links {"GL","SDL2","pthread"}
 
         filter "action:not vs*"
             buildoptions { "-Wall" }
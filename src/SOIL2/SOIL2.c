@@ -101,6 +101,12 @@
 #ifndef GL_BGRA
 #define GL_BGRA 0x80E1
 #endif
+#ifndef GL_BGR
+#define GL_BGR 0x80E0
+#endif
+#ifndef GL_UNPACK_ROW_LENGTH
+#define GL_UNPACK_ROW_LENGTH 0x0CF2
+#endif
 
 #ifndef GL_RED
 #define GL_RED 0x1903
@@ -141,9 +147,24 @@
 #ifndef GL_RGBA8
 #define GL_RGBA8 0x8058
 #endif
+#ifndef GL_RGB8
+#define GL_RGB8 0x8051
+#endif
+#ifndef GL_SRGB8
+#define GL_SRGB8 0x8C41
+#endif
 #ifndef GL_SRGB8_ALPHA8
 #define GL_SRGB8_ALPHA8 0x8C43
 #endif
+#ifndef GL_LUMINANCE8
+#define GL_LUMINANCE8 0x8040
+#endif
+#ifndef GL_LUMINANCE8_ALPHA8
+#define GL_LUMINANCE8_ALPHA8 0x8045
+#endif
+#ifndef GL_TEXTURE_INTERNAL_FORMAT
+#define GL_TEXTURE_INTERNAL_FORMAT 0x1003
+#endif
 #ifndef GL_RGB10_A2
 #define GL_RGB10_A2 0x8059
 #endif
@@ -166,6 +187,12 @@
 #ifndef GL_UNSIGNED_SHORT_5_6_5
 #define GL_UNSIGNED_SHORT_5_6_5 0x8363
 #endif
+#ifndef GL_UNSIGNED_SHORT_4_4_4_4_REV
+#define GL_UNSIGNED_SHORT_4_4_4_4_REV 0x8365
+#endif
+#ifndef GL_UNSIGNED_SHORT_1_5_5_5_REV
+#define GL_UNSIGNED_SHORT_1_5_5_5_REV 0x8366
+#endif
 
 #ifndef GL_UNSIGNED_BYTE_3_3_2
 #define GL_UNSIGNED_BYTE_3_3_2 0x8032
@@ -178,17 +205,73 @@
 #include "stb_image_write.h"
 #include "image_helper.h"
 #include "image_DXT.h"
+#include "image_BPTC.h"
+#include "image_ETC.h"
+#include "image_transcode.h"
 #include "pvr_helper.h"
 #include "pkm_helper.h"
 #include "image_array.h"
+#include "thread_pool.h"
+#include "file_map.h"
 
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 
 unsigned long SOIL_version() { return SOIL_COMPILED_VERSION; }
 
-/*	error reporting	*/
-const char *result_string_pointer = "SOIL initialized";
+/*	error reporting, kept per thread so concurrent loads
+	never report each other's results	*/
+#ifndef SOIL_NO_THREAD_LOCALS
+	#if defined( _MSC_VER )
+		#define SOIL_THREAD_LOCAL __declspec( thread )
+	#elif defined( __STDC_VERSION__ ) && __STDC_VERSION__ >= 201112L
+		#define SOIL_THREAD_LOCAL _Thread_local
+	#elif defined( __GNUC__ )
+		#define SOIL_THREAD_LOCAL __thread
+	#endif
+#endif
+#ifndef SOIL_THREAD_LOCAL
+	#define SOIL_THREAD_LOCAL
+#endif
+
+static SOIL_THREAD_LOCAL const char *result_string_pointer = "SOIL initialized";
+static SOIL_THREAD_LOCAL int result_code = SOIL_RESULT_OK;
+
+static void SOIL_set_result( int code, const char *message )
+{
+	result_code = code;
+	result_string_pointer = message;
+}
+
+/*	maps or reads a file for the _from_memory loaders, release it with
+	file_map_close.  Reports the failures, not_found_error when the
+	file can't be opened.  A lazy mapping is only read where it's used.	*/
+static int SOIL_internal_map_file( const char *filename, file_map *map, int lazy, const char *not_found_error )
+{
+	if( NULL == filename )
+	{
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "NULL filename" );
+		return 0;
+	}
+	switch( lazy ? file_map_open_lazy( filename, map ) : file_map_open( filename, map ) )
+	{
+	case FILE_MAP_OK:
+		return 1;
+	case FILE_MAP_NOT_FOUND:
+		SOIL_set_result( SOIL_RESULT_FILE_NOT_FOUND, not_found_error );
+		return 0;
+	case FILE_MAP_TOO_LARGE:
+		SOIL_set_result( SOIL_RESULT_IO_ERROR, "File is larger than 2GB" );
+		return 0;
+	case FILE_MAP_OUT_OF_MEMORY:
+		SOIL_set_result( SOIL_RESULT_OUT_OF_MEMORY, "malloc failed" );
+		return 0;
+	default:
+		SOIL_set_result( SOIL_RESULT_IO_ERROR, "Could not read the complete file" );
+		return 0;
+	}
+}
 
 /*	for loading cube maps	*/
 enum{
@@ -196,7 +279,6 @@ enum{
 	SOIL_CAPABILITY_NONE = 0,
 	SOIL_CAPABILITY_PRESENT = 1
 };
-static int has_cubemap_capability = SOIL_CAPABILITY_UNKNOWN;
 int query_cubemap_capability( void );
 #define SOIL_TEXTURE_WRAP_R					0x8072
 #define SOIL_CLAMP_TO_EDGE					0x812F
@@ -215,21 +297,16 @@ int query_cubemap_capability( void );
 #define SOIL_TEXTURE_MAX_LEVEL				0x813D
 /*	for non-power-of-two texture	*/
 #define SOIL_IS_POW2( v ) ( ( v & ( v - 1 ) ) == 0 )
-static int has_NPOT_capability = SOIL_CAPABILITY_UNKNOWN;
+#define SOIL_MIP_SIZE( v ) ( ( v ) > 1 ? ( v ) / 2 : 1 )
 int query_NPOT_capability( void );
 /*	for texture rectangles	*/
-static int has_tex_rectangle_capability = SOIL_CAPABILITY_UNKNOWN;
 int query_tex_rectangle_capability( void );
 #define SOIL_TEXTURE_RECTANGLE_ARB				0x84F5
 #define SOIL_MAX_RECTANGLE_TEXTURE_SIZE_ARB		0x84F8
 /*	for using DXT compression	*/
-static int has_DXT_capability = SOIL_CAPABILITY_UNKNOWN;
 int query_DXT_capability( void );
-static int has_3Dc_capability = SOIL_CAPABILITY_UNKNOWN;
 int query_3Dc_capability( void );
-static int has_BPTC_capability = SOIL_CAPABILITY_UNKNOWN;
 int query_BPTC_capability( void );
-static int has_texture_float_capability = SOIL_CAPABILITY_UNKNOWN;
 int query_texture_float_capability( void );
 #define SOIL_GL_SRGB			0x8C40
 #define SOIL_GL_SRGB_ALPHA		0x8C42
@@ -255,27 +332,18 @@ int query_texture_float_capability( void );
 #define SOIL_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT 0x8C4D
 #define SOIL_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT 0x8C4E
 #define SOIL_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
-static int has_sRGB_capability = SOIL_CAPABILITY_UNKNOWN;
 int query_sRGB_capability( void );
 typedef void (APIENTRY * P_SOIL_GLCOMPRESSEDTEXIMAGE2DPROC) (GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const GLvoid * data);
-static P_SOIL_GLCOMPRESSEDTEXIMAGE2DPROC soilGlCompressedTexImage2D = NULL;
 static P_SOIL_GLCOMPRESSEDTEXIMAGE2DPROC get_glCompressedTexImage2D_addr( void );
 
 typedef void (APIENTRY *P_SOIL_GLGENERATEMIPMAPPROC)(GLenum target);
-static P_SOIL_GLGENERATEMIPMAPPROC soilGlGenerateMipmap = NULL;
 
-static int has_gen_mipmap_capability = SOIL_CAPABILITY_UNKNOWN;
 static int query_gen_mipmap_capability( void );
 
-static int has_PVR_capability = SOIL_CAPABILITY_UNKNOWN;
 int query_PVR_capability( void );
-static int has_BGRA8888_capability = SOIL_CAPABILITY_UNKNOWN;
 int query_BGRA8888_capability( void );
-static int has_ETC1_capability = SOIL_CAPABILITY_UNKNOWN;
 int query_ETC1_capability( void );
-static int has_ETC2_EAC_capability = SOIL_CAPABILITY_UNKNOWN;
 static int query_ETC2_EAC_capability( void );
-static int has_ASTC_LDR_capability = SOIL_CAPABILITY_UNKNOWN;
 static int query_ASTC_LDR_capability( void );
 
 /* GL_IMG_texture_compression_pvrtc */
@@ -289,8 +357,10 @@ static int query_ASTC_LDR_capability( void );
 #define SOIL_GL_COMPRESSED_RG11_EAC                               0x9272
 #define SOIL_GL_COMPRESSED_SIGNED_RG11_EAC                        0x9273
 #define SOIL_GL_COMPRESSED_RGB8_ETC2                              0x9274
+#define SOIL_GL_COMPRESSED_SRGB8_ETC2                             0x9275
 #define SOIL_GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2          0x9276
 #define SOIL_GL_COMPRESSED_RGBA8_ETC2_EAC                         0x9278
+#define SOIL_GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC                  0x9279
 #define SOIL_GL_COMPRESSED_RGBA_ASTC_4x4_KHR                      0x93B0
 #define SOIL_GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR              0x93D0
 
@@ -302,7 +372,6 @@ int query_teximage3d_capability( void );
 
 #if defined( SOIL_IMAGE_ARRAY_SUPPORT )
 typedef const GLubyte *(APIENTRY * P_SOIL_glGetStringiFunc) (GLenum, GLuint);
-static P_SOIL_glGetStringiFunc soilGlGetStringiFunc = NULL;
 
 #ifndef GL_TEXTURE_2D_ARRAY
 #define GL_TEXTURE_2D_ARRAY 0x8C1A
@@ -320,7 +389,6 @@ typedef void (APIENTRY *P_SOIL_GLTEXIMAGE3DPROC)(
 	GLenum type,
 	const void *pixels
 );
-static P_SOIL_GLTEXIMAGE3DPROC soilGlTexImage3D = NULL;
 
 typedef void (APIENTRY *P_SOIL_GLTEXSUBIMAGE3DPROC)(
 	GLenum target,
@@ -335,22 +403,640 @@ typedef void (APIENTRY *P_SOIL_GLTEXSUBIMAGE3DPROC)(
 	GLenum type,
 	const void *pixels
 );
-static P_SOIL_GLTEXSUBIMAGE3DPROC soilGlTexSubImage3D = NULL;
 
-static int has_teximage3d_capability = SOIL_CAPABILITY_UNKNOWN;
+typedef void (APIENTRY *P_SOIL_GLCOMPRESSEDTEXIMAGE3DPROC)(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLsizei imageSize, const void *data);
+typedef void (APIENTRY *P_SOIL_GLCOMPRESSEDTEXSUBIMAGE3DPROC)(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLsizei imageSize, const void *data);
 
-static int isAtLeastGL3()
+#endif
+
+#ifndef GL_TEXTURE_3D
+#define GL_TEXTURE_3D 0x806F
+#endif
+
+/*	for DDS cubemap arrays	*/
+static int query_cubemap_array_capability( void );
+#define SOIL_TEXTURE_CUBE_MAP_ARRAY		0x9009
+
+/*	for pixel buffer object uploads	*/
+static int query_PBO_capability( void );
+#define SOIL_GL_PIXEL_UNPACK_BUFFER				0x88EC
+#define SOIL_GL_STREAM_DRAW						0x88E0
+#define SOIL_GL_WRITE_ONLY						0x88B9
+#define SOIL_GL_MAP_WRITE_BIT					0x0002
+#define SOIL_GL_MAP_INVALIDATE_RANGE_BIT		0x0004
+#define SOIL_GL_MAP_INVALIDATE_BUFFER_BIT		0x0008
+#define SOIL_GL_MAP_UNSYNCHRONIZED_BIT			0x0020
+#define SOIL_GL_SYNC_GPU_COMMANDS_COMPLETE		0x9117
+#define SOIL_GL_SYNC_FLUSH_COMMANDS_BIT			0x0001
+#define SOIL_GL_ALREADY_SIGNALED				0x911A
+#define SOIL_GL_CONDITION_SATISFIED				0x911C
+#define SOIL_PBO_MAX_RING_SIZE					8
+typedef void (APIENTRY *P_SOIL_GLGENBUFFERSPROC)(GLsizei n, GLuint *buffers);
+typedef void (APIENTRY *P_SOIL_GLDELETEBUFFERSPROC)(GLsizei n, const GLuint *buffers);
+typedef void (APIENTRY *P_SOIL_GLBINDBUFFERPROC)(GLenum target, GLuint buffer);
+typedef void (APIENTRY *P_SOIL_GLBUFFERDATAPROC)(GLenum target, ptrdiff_t size, const void *data, GLenum usage);
+typedef void *(APIENTRY *P_SOIL_GLMAPBUFFERPROC)(GLenum target, GLenum access);
+typedef void *(APIENTRY *P_SOIL_GLMAPBUFFERRANGEPROC)(GLenum target, ptrdiff_t offset, ptrdiff_t length, GLbitfield access);
+typedef GLboolean (APIENTRY *P_SOIL_GLUNMAPBUFFERPROC)(GLenum target);
+typedef void *(APIENTRY *P_SOIL_GLFENCESYNCPROC)(GLenum condition, GLbitfield flags);
+typedef GLenum (APIENTRY *P_SOIL_GLCLIENTWAITSYNCPROC)(void *sync, GLbitfield flags, unsigned long long timeout);
+typedef void (APIENTRY *P_SOIL_GLDELETESYNCPROC)(void *sync);
+
+/*	for immutable texture storage and in place updates	*/
+static int query_tex_storage_capability( void );
+
+/*	for sampling RGTC compressed luminance like GL_LUMINANCE(_ALPHA)	*/
+static int query_texture_swizzle_capability( void );
+static int query_BGR_unpack_capability( void );
+static int query_unpack_row_length_capability( void );
+#define SOIL_TEXTURE_SWIZZLE_R		0x8E42
+#define SOIL_TEXTURE_SWIZZLE_G		0x8E43
+#define SOIL_TEXTURE_SWIZZLE_B		0x8E44
+#define SOIL_TEXTURE_SWIZZLE_A		0x8E45
+#define SOIL_GL_RED					0x1903
+#define SOIL_GL_GREEN				0x1904
+#define SOIL_GL_BLUE				0x1905
+#define SOIL_GL_TEXTURE_IMMUTABLE_FORMAT		0x912F
+#define SOIL_GL_TEXTURE_DEPTH				0x8071
+typedef void (APIENTRY *P_SOIL_GLTEXSTORAGE2DPROC)(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height);
+typedef void (APIENTRY *P_SOIL_GLCOMPRESSEDTEXSUBIMAGE2DPROC)(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void *data);
+
+/*	one buffer of the upload ring, the fence marks the last upload
+	sourced from it	*/
+typedef struct
+{
+	GLuint buffer;
+	size_t size;
+	void *fence;
+} SOIL_PBO_slot;
+
+/*	Everything learnt about an OpenGL context: the capabilities,
+	the entry points and (for a SOIL_Context) the extension set.
+	The process wide default is used when no context is bound.	*/
+typedef struct
+{
+	const char **slots;
+	char *names;
+	unsigned int slot_mask;
+} SOIL_extension_set;
+
+typedef struct
+{
+	int has_cubemap_capability;
+	int has_NPOT_capability;
+	int has_tex_rectangle_capability;
+	int has_DXT_capability;
+	int has_3Dc_capability;
+	int has_BPTC_capability;
+	int has_texture_float_capability;
+	int has_sRGB_capability;
+	int has_gen_mipmap_capability;
+	int has_PVR_capability;
+	int has_BGRA8888_capability;
+	int has_ETC1_capability;
+	int has_ETC2_EAC_capability;
+	int has_ASTC_LDR_capability;
+	int has_teximage3d_capability;
+	int has_PBO_capability;
+	int has_tex_storage_capability;
+	int has_texture_swizzle_capability;
+	int has_BGR_unpack_capability;
+	int has_unpack_row_length_capability;
+	int has_cubemap_array_capability;
+	int is_gl3;
+	P_SOIL_GLCOMPRESSEDTEXIMAGE2DPROC soilGlCompressedTexImage2D;
+	P_SOIL_GLGENERATEMIPMAPPROC soilGlGenerateMipmap;
+#if defined( SOIL_IMAGE_ARRAY_SUPPORT )
+	P_SOIL_glGetStringiFunc soilGlGetStringiFunc;
+	P_SOIL_GLTEXIMAGE3DPROC soilGlTexImage3D;
+	P_SOIL_GLTEXSUBIMAGE3DPROC soilGlTexSubImage3D;
+	P_SOIL_GLCOMPRESSEDTEXIMAGE3DPROC soilGlCompressedTexImage3D;
+	P_SOIL_GLCOMPRESSEDTEXSUBIMAGE3DPROC soilGlCompressedTexSubImage3D;
+#endif
+	P_SOIL_GLGENBUFFERSPROC soilGlGenBuffers;
+	P_SOIL_GLDELETEBUFFERSPROC soilGlDeleteBuffers;
+	P_SOIL_GLBINDBUFFERPROC soilGlBindBuffer;
+	P_SOIL_GLBUFFERDATAPROC soilGlBufferData;
+	P_SOIL_GLMAPBUFFERPROC soilGlMapBuffer;
+	P_SOIL_GLMAPBUFFERRANGEPROC soilGlMapBufferRange;
+	P_SOIL_GLUNMAPBUFFERPROC soilGlUnmapBuffer;
+	P_SOIL_GLFENCESYNCPROC soilGlFenceSync;
+	P_SOIL_GLCLIENTWAITSYNCPROC soilGlClientWaitSync;
+	P_SOIL_GLDELETESYNCPROC soilGlDeleteSync;
+	P_SOIL_GLTEXSTORAGE2DPROC soilGlTexStorage2D;
+	P_SOIL_GLCOMPRESSEDTEXSUBIMAGE2DPROC soilGlCompressedTexSubImage2D;
+	/*	the upload ring, empty unless SOIL_enable_PBO_uploads was called	*/
+	SOIL_PBO_slot PBO_slots[SOIL_PBO_MAX_RING_SIZE];
+	int PBO_count;
+	int PBO_next;
+	SOIL_extension_set extensions;
+} SOIL_GL_state;
+
+struct SOIL_Context
+{
+	SOIL_Allocator allocator;
+	SOIL_GL_state gl;
+	/*	reusable scratch memory, see SOIL_scratch_alloc	*/
+	void *scratch;
+	size_t scratch_size;
+	int scratch_in_use;
+};
+
+/*	named, so adding a field can not shift the others	*/
+#define SOIL_GL_STATE_UNKNOWN \
+{ \
+	.has_cubemap_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_NPOT_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_tex_rectangle_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_DXT_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_3Dc_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_BPTC_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_texture_float_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_sRGB_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_gen_mipmap_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_PVR_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_BGRA8888_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_ETC1_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_ETC2_EAC_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_ASTC_LDR_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_teximage3d_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_PBO_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_tex_storage_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_texture_swizzle_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_BGR_unpack_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_unpack_row_length_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.has_cubemap_array_capability = SOIL_CAPABILITY_UNKNOWN, \
+	.is_gl3 = SOIL_CAPABILITY_UNKNOWN \
+}
+
+static SOIL_GL_state default_GL_state = SOIL_GL_STATE_UNKNOWN;
+
+static SOIL_THREAD_LOCAL SOIL_Context *current_context = NULL;
+
+static SOIL_GL_state *soil_gl( void )
+{
+	return NULL != current_context ? &current_context->gl : &default_GL_state;
+}
+
+static void *SOIL_context_alloc( SOIL_Context *context, size_t size )
+{
+	return context->allocator.allocate( size, context->allocator.user_data );
+}
+
+static void SOIL_context_release( SOIL_Context *context, void *memory )
+{
+	if( NULL != memory )
+	{
+		context->allocator.release( memory, context->allocator.user_data );
+	}
+}
+
+/*	Temporary buffers that never leave the library.  With a context bound
+	the context keeps its buffer between calls and only grows it, nested
+	requests (and the unbound case) fall back to malloc.	*/
+static void *SOIL_scratch_alloc( size_t size )
+{
+	SOIL_Context *context = current_context;
+
+	if( NULL == context || context->scratch_in_use )
+	{
+		return malloc( size );
+	}
+
+	if( context->scratch_size < size )
+	{
+		SOIL_context_release( context, context->scratch );
+		context->scratch = SOIL_context_alloc( context, size );
+		context->scratch_size = NULL != context->scratch ? size : 0;
+		if( NULL == context->scratch )
+		{
+			return NULL;
+		}
+	}
+
+	context->scratch_in_use = 1;
+	return context->scratch;
+}
+
+static void SOIL_scratch_free( void *memory )
+{
+	SOIL_Context *context = current_context;
+
+	if( NULL == memory )
+	{
+		return;
+	}
+
+	if( NULL != context && memory == context->scratch )
+	{
+		context->scratch_in_use = 0;
+	}
+	else
+	{
+		free( memory );
+	}
+}
+
+/*	Copies the pixels of an upload into the next buffer of the PBO ring
+	and leaves that buffer bound to GL_PIXEL_UNPACK_BUFFER, the upload
+	then reads from offset 0 and the driver can return before the
+	transfer is done.  Returns 0, with nothing bound, when the ring is
+	off or the buffer could not be mapped: upload from client memory.	*/
+static int SOIL_PBO_stage( const void *data, size_t size )
+{
+	SOIL_GL_state *gl = soil_gl();
+	SOIL_PBO_slot *slot;
+	void *mapped = NULL;
+
+	if( 0 == gl->PBO_count || NULL == data || 0 == size )
+	{
+		return 0;
+	}
+
+	slot = &gl->PBO_slots[gl->PBO_next];
+	gl->soilGlBindBuffer( SOIL_GL_PIXEL_UNPACK_BUFFER, slot->buffer );
+
+	if( NULL != slot->fence )
+	{
+		/*	once the last upload from this buffer completed it can be
+			rewritten in place, without a new allocation.  On a timeout
+			or a failed wait it may still be read, so it's orphaned	*/
+		GLenum status = gl->soilGlClientWaitSync( slot->fence, SOIL_GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull );
+		gl->soilGlDeleteSync( slot->fence );
+		slot->fence = NULL;
+
+		if( slot->size >= size &&
+			( status == SOIL_GL_ALREADY_SIGNALED || status == SOIL_GL_CONDITION_SATISFIED ) )
+		{
+			mapped = gl->soilGlMapBufferRange( SOIL_GL_PIXEL_UNPACK_BUFFER, 0, (ptrdiff_t)size,
+				SOIL_GL_MAP_WRITE_BIT | SOIL_GL_MAP_INVALIDATE_RANGE_BIT | SOIL_GL_MAP_UNSYNCHRONIZED_BIT );
+		}
+	}
+
+	if( NULL == mapped )
+	{
+		/*	grow the buffer, or orphan its storage so the driver
+			never waits for a pending upload	*/
+		if( slot->size < size )
+		{
+			slot->size = size;
+		}
+		gl->soilGlBufferData( SOIL_GL_PIXEL_UNPACK_BUFFER, (ptrdiff_t)slot->size, NULL, SOIL_GL_STREAM_DRAW );
+
+		if( NULL != gl->soilGlMapBufferRange )
+		{
+			mapped = gl->soilGlMapBufferRange( SOIL_GL_PIXEL_UNPACK_BUFFER, 0, (ptrdiff_t)size,
+				SOIL_GL_MAP_WRITE_BIT | SOIL_GL_MAP_INVALIDATE_BUFFER_BIT );
+		}
+		else
+		{
+			mapped = gl->soilGlMapBuffer( SOIL_GL_PIXEL_UNPACK_BUFFER, SOIL_GL_WRITE_ONLY );
+		}
+	}
+
+	if( NULL == mapped )
+	{
+		gl->soilGlBindBuffer( SOIL_GL_PIXEL_UNPACK_BUFFER, 0 );
+		return 0;
+	}
+
+	memcpy( mapped, data, size );
+
+	if( GL_FALSE == gl->soilGlUnmapBuffer( SOIL_GL_PIXEL_UNPACK_BUFFER ) )
+	{
+		/*	the contents were lost, e.g. on a mode switch	*/
+		gl->soilGlBindBuffer( SOIL_GL_PIXEL_UNPACK_BUFFER, 0 );
+		return 0;
+	}
+
+	return 1;
+}
+
+/*	fences the staged upload and moves the ring to the next buffer	*/
+static void SOIL_PBO_release( int staged )
+{
+	SOIL_GL_state *gl = soil_gl();
+
+	if( !staged )
+	{
+		return;
+	}
+
+	if( NULL != gl->soilGlFenceSync && NULL != gl->soilGlMapBufferRange )
+	{
+		gl->PBO_slots[gl->PBO_next].fence = gl->soilGlFenceSync( SOIL_GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+	}
+
+	gl->soilGlBindBuffer( SOIL_GL_PIXEL_UNPACK_BUFFER, 0 );
+	gl->PBO_next = ( gl->PBO_next + 1 ) % gl->PBO_count;
+}
+
+/*	Every pixel upload goes through these, size is the number of bytes
+	read from pixels with GL_UNPACK_ALIGNMENT set to 1.  With sub_image
+	set the level already has storage of that size and format (see
+	SOIL_internal_prepare_storage) and is updated in place.	*/
+static void SOIL_upload_tex_image_2D(
+	int sub_image,
+	GLenum target, GLint level, GLint internal_format,
+	GLsizei width, GLsizei height,
+	GLenum format, GLenum type,
+	const void *pixels, size_t size )
+{
+	int staged = SOIL_PBO_stage( pixels, size );
+
+	if( sub_image )
+	{
+		glTexSubImage2D( target, level, 0, 0, width, height,
+			format, type, staged ? NULL : pixels );
+	}
+	else
+	{
+		glTexImage2D( target, level, internal_format, width, height, 0,
+			format, type, staged ? NULL : pixels );
+	}
+
+	SOIL_PBO_release( staged );
+}
+
+static void SOIL_upload_compressed_tex_image_2D(
+	int sub_image,
+	GLenum target, GLint level, GLenum internal_format,
+	GLsizei width, GLsizei height,
+	GLsizei size, const void *data )
+{
+	int staged = SOIL_PBO_stage( data, (size_t)size );
+
+	if( sub_image )
+	{
+		soil_gl()->soilGlCompressedTexSubImage2D( target, level, 0, 0, width, height,
+			internal_format, size, staged ? NULL : data );
+	}
+	else
+	{
+		soil_gl()->soilGlCompressedTexImage2D( target, level, internal_format,
+			width, height, 0, size, staged ? NULL : data );
+	}
+
+	SOIL_PBO_release( staged );
+}
+
+#if defined( SOIL_IMAGE_ARRAY_SUPPORT )
+static void SOIL_upload_tex_sub_image_3D(
+	GLenum target, GLint level,
+	GLint xoffset, GLint yoffset, GLint zoffset,
+	GLsizei width, GLsizei height, GLsizei depth,
+	GLenum format, GLenum type,
+	const void *pixels, size_t size )
+{
+	int staged = SOIL_PBO_stage( pixels, size );
+
+	soil_gl()->soilGlTexSubImage3D( target, level, xoffset, yoffset, zoffset,
+		width, height, depth, format, type, staged ? NULL : pixels );
+
+	SOIL_PBO_release( staged );
+}
+
+static void SOIL_upload_compressed_tex_sub_image_3D(
+	GLenum target, GLint level,
+	GLint zoffset,
+	GLsizei width, GLsizei height, GLsizei depth,
+	GLenum internal_format,
+	GLsizei size, const void *data )
+{
+	int staged = SOIL_PBO_stage( data, (size_t)size );
+
+	soil_gl()->soilGlCompressedTexSubImage3D( target, level, 0, 0, zoffset,
+		width, height, depth, internal_format, size, staged ? NULL : data );
+
+	SOIL_PBO_release( staged );
+}
+#endif
+
+/*	the sized format glTexStorage2D wants for an unsized internal format	*/
+static GLenum SOIL_sized_internal_format( GLenum internal_format )
+{
+	switch( internal_format )
+	{
+		case GL_LUMINANCE:			return GL_LUMINANCE8;
+		case GL_LUMINANCE_ALPHA:	return GL_LUMINANCE8_ALPHA8;
+		case GL_RGB:				return GL_RGB8;
+		case GL_RGBA:				return GL_RGBA8;
+		case SOIL_GL_SRGB:			return GL_SRGB8;
+		case SOIL_GL_SRGB_ALPHA:	return GL_SRGB8_ALPHA8;
+		default:					return internal_format;
+	}
+}
+
+/*	The unpack state that has GL skip the padding of rows source_pitch
+	bytes apart.  Padding up to 2, 4 or 8 bytes is what GL_UNPACK_ALIGNMENT
+	describes, any other pitch needs GL_UNPACK_ROW_LENGTH.  Returns 0 when
+	the rows have to be repacked instead.	*/
+static int SOIL_DDS_unpack_rows(
+	unsigned int tight_pitch, unsigned int source_pitch,
+	unsigned int pixel_size, int has_row_length,
+	GLint *alignment, GLint *row_length )
+{
+	GLint a;
+
+	*alignment = 1;
+	*row_length = 0;
+	if( source_pitch == tight_pitch )
+	{
+		return 1;
+	}
+
+	for( a = 2; a <= 8; a *= 2 )
+	{
+		if( source_pitch == ( ( tight_pitch + a - 1 ) & ~( (unsigned int)a - 1 ) ) )
+		{
+			*alignment = a;
+			return 1;
+		}
+	}
+
+	if( has_row_length && ( source_pitch % pixel_size ) == 0 )
+	{
+		*row_length = source_pitch / pixel_size;
+		return 1;
+	}
+
+	return 0;
+}
+
+/*	the number of levels of a complete chain	*/
+static int SOIL_mip_level_count( int width, int height )
+{
+	int levels = 1;
+
+	while( width > 1 || height > 1 )
+	{
+		width = SOIL_MIP_SIZE( width );
+		height = SOIL_MIP_SIZE( height );
+		++levels;
+	}
+
+	return levels;
+}
+
+/*	the first of the levels stored in a file that gets uploaded: skip_mips
+	levels down, or further until no side is larger than max_dimension
+	( 0 for no limit ).  The last stored level is always kept.	*/
+static unsigned int SOIL_first_kept_level(
+		unsigned int width, unsigned int height, unsigned int depth,
+		unsigned int levels, int skip_mips, int max_dimension )
+{
+	unsigned int first = 0;
+
+	while( first + 1 < levels &&
+		( (int)first < skip_mips ||
+		  ( max_dimension > 0 &&
+		    ( width > (unsigned int)max_dimension || height > (unsigned int)max_dimension ||
+		      depth > (unsigned int)max_dimension ) ) ) )
+	{
+		width = SOIL_MIP_SIZE( width );
+		height = SOIL_MIP_SIZE( height );
+		depth = SOIL_MIP_SIZE( depth );
+		++first;
+	}
+
+	return first;
+}
+
+/*	Does level 0 of the bound texture have this size and format, with
+	the rest of the chain in place?  depth is the layer or slice count of
+	a 3D texture, 0 for a 2D one.  Without glGetTexLevelParameteriv
+	(OpenGL ES) only immutable storage is trusted to match.	*/
+static int SOIL_internal_storage_matches(
+	unsigned int opengl_texture_type,
+	unsigned int opengl_texture_target,
+	unsigned int internal_texture_format,
+	int width, int height, int depth, int levels,
+	int immutable )
+{
+#if !defined( SOIL_GLES1 ) && !defined( SOIL_GLES2 )
+	GLint level_width = 0, level_height = 0, level_depth = 0, level_format = 0;
+	(void)opengl_texture_type;
+	(void)immutable;
+
+	glGetTexLevelParameteriv( opengl_texture_target, 0, GL_TEXTURE_WIDTH, &level_width );
+	glGetTexLevelParameteriv( opengl_texture_target, 0, GL_TEXTURE_HEIGHT, &level_height );
+	glGetTexLevelParameteriv( opengl_texture_target, 0, GL_TEXTURE_INTERNAL_FORMAT, &level_format );
+	if( depth > 0 )
+	{
+		glGetTexLevelParameteriv( opengl_texture_target, 0, SOIL_GL_TEXTURE_DEPTH, &level_depth );
+	}
+	if( level_width != width || level_height != height || level_depth != depth ||
+		( (GLenum)level_format != internal_texture_format &&
+		  (GLenum)level_format != SOIL_sized_internal_format( internal_texture_format ) ) )
+	{
+		return 0;
+	}
+
+	if( levels > 1 )
+	{
+		int last_width = width >> ( levels - 1 );
+		level_width = 0;
+		glGetTexLevelParameteriv( opengl_texture_target, levels - 1, GL_TEXTURE_WIDTH, &level_width );
+		if( level_width != ( last_width > 0 ? last_width : 1 ) )
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+#else
+	(void)opengl_texture_type;
+	(void)opengl_texture_target;
+	(void)internal_texture_format;
+	(void)width;
+	(void)height;
+	(void)depth;
+	(void)levels;
+	return immutable;
+#endif
+}
+
+/*	Picks how the levels of the bound texture are uploaded.  A reused
+	texture that already has the right size and format is updated in
+	place, with SOIL_FLAG_IMMUTABLE_STORAGE any other one first gets
+	glTexStorage2D storage for the whole chain.
+	Returns 1 for sub-image uploads, 0 for glTexImage2D and -1 when an
+	immutable texture can't hold the image.	*/
+static int SOIL_internal_prepare_storage(
+	unsigned int opengl_texture_type,
+	unsigned int opengl_texture_target,
+	int reused,
+	unsigned int internal_texture_format,
+	int width, int height, int levels,
+	unsigned int flags )
+{
+	SOIL_GL_state *gl = soil_gl();
+	GLint immutable = 0;
+
+	if( query_tex_storage_capability() == SOIL_CAPABILITY_PRESENT )
+	{
+		glGetTexParameteriv( opengl_texture_type, SOIL_GL_TEXTURE_IMMUTABLE_FORMAT, &immutable );
+	}
+
+	if( NULL != gl->soilGlCompressedTexSubImage2D &&
+		( reused || immutable ) &&
+		SOIL_internal_storage_matches( opengl_texture_type, opengl_texture_target,
+			internal_texture_format, width, height, 0, levels, immutable ) )
+	{
+		return 1;
+	}
+
+	if( immutable )
+	{
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "The image doesn't fit the immutable texture storage" );
+		return -1;
+	}
+
+	if( ( flags & SOIL_FLAG_IMMUTABLE_STORAGE ) &&
+		NULL != gl->soilGlCompressedTexSubImage2D &&
+		query_tex_storage_capability() == SOIL_CAPABILITY_PRESENT )
+	{
+		while( glGetError() != GL_NO_ERROR ) {}
+		gl->soilGlTexStorage2D( opengl_texture_type, levels,
+			SOIL_sized_internal_format( internal_texture_format ), width, height );
+		if( glGetError() == GL_NO_ERROR )
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static void SOIL_PBO_delete_ring( SOIL_GL_state *gl )
 {
-	static int is_gl3 = SOIL_CAPABILITY_UNKNOWN;
+	int i;
+
+	for( i = 0; i < gl->PBO_count; ++i )
+	{
+		if( NULL != gl->PBO_slots[i].fence )
+		{
+			gl->soilGlDeleteSync( gl->PBO_slots[i].fence );
+		}
+		gl->soilGlDeleteBuffers( 1, &gl->PBO_slots[i].buffer );
+	}
+
+	memset( gl->PBO_slots, 0, sizeof(gl->PBO_slots) );
+	gl->PBO_count = 0;
+	gl->PBO_next = 0;
+}
 
-	if ( SOIL_CAPABILITY_UNKNOWN == is_gl3 )
+#if defined( SOIL_IMAGE_ARRAY_SUPPORT )
+static int isAtLeastGL3()
+{
+	if ( SOIL_CAPABILITY_UNKNOWN == soil_gl()->is_gl3 )
 	{
 		const char * verstr	= (const char *) glGetString( GL_VERSION );
-		is_gl3				= ( verstr && ( atoi(verstr) >= 3 ) &&
+		soil_gl()->is_gl3	= ( verstr && ( atoi(verstr) >= 3 ) &&
 								strstr( verstr, " ES " ) == NULL );
 	}
 
-	return is_gl3;
+	return soil_gl()->is_gl3;
 }
 #else
 static int isAtLeastGL3()
@@ -453,6 +1139,162 @@ void * SOIL_GL_GetProcAddress(const char *proc)
 
 
 
+#ifndef GL_NUM_EXTENSIONS
+#define GL_NUM_EXTENSIONS 0x821D
+#endif
+
+/*	FNV-1a	*/
+static unsigned int SOIL_extension_hash( const char *name )
+{
+	unsigned int hash = 2166136261u;
+
+	while( *name )
+	{
+		hash ^= (unsigned char)*name++;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+static int SOIL_extension_set_find( const SOIL_extension_set *set, const char *name )
+{
+	unsigned int slot = SOIL_extension_hash( name ) & set->slot_mask;
+
+	while( NULL != set->slots[slot] )
+	{
+		if( 0 == strcmp( set->slots[slot], name ) )
+		{
+			return 1;
+		}
+		slot = ( slot + 1 ) & set->slot_mask;
+	}
+
+	return 0;
+}
+
+/*	copies the extension names of the current OpenGL context into the
+	context's allocator and indexes them in an open addressed hash set	*/
+static void SOIL_extension_set_build( SOIL_Context *context )
+{
+	SOIL_extension_set *set = &context->gl.extensions;
+	size_t names_length = 0;
+	size_t count = 0;
+	size_t capacity = 16;
+	size_t i;
+	char *names = NULL;
+
+	#if defined( SOIL_IMAGE_ARRAY_SUPPORT )
+	if ( isAtLeastGL3() )
+	{
+		GLint num_exts = 0;
+		GLint e;
+		char *cursor;
+
+		if ( NULL == soil_gl()->soilGlGetStringiFunc )
+		{
+			soil_gl()->soilGlGetStringiFunc = (P_SOIL_glGetStringiFunc)SOIL_GL_GetProcAddress("glGetStringi");
+
+			if ( NULL == soil_gl()->soilGlGetStringiFunc )
+			{
+				return;
+			}
+		}
+
+		glGetIntegerv(GL_NUM_EXTENSIONS, &num_exts);
+		for (e = 0; e < num_exts; e++)
+		{
+			const char *thisext = (const char *) soil_gl()->soilGlGetStringiFunc(GL_EXTENSIONS, e);
+			names_length += ( NULL != thisext ? strlen( thisext ) : 0 ) + 1;
+		}
+
+		if ( 0 == names_length )
+		{
+			return;
+		}
+
+		names = (char *)SOIL_context_alloc( context, names_length );
+		if ( NULL == names )
+		{
+			return;
+		}
+
+		cursor = names;
+		for (e = 0; e < num_exts; e++)
+		{
+			const char *thisext = (const char *) soil_gl()->soilGlGetStringiFunc(GL_EXTENSIONS, e);
+			size_t length = NULL != thisext ? strlen( thisext ) : 0;
+			memcpy( cursor, thisext, length );
+			cursor[length] = '\0';
+			cursor += length + 1;
+		}
+	}
+	else
+	#endif
+	{
+		const char *extensions = (const char *) glGetString(GL_EXTENSIONS);
+
+		if ( NULL == extensions )
+		{
+			return;
+		}
+
+		names_length = strlen( extensions ) + 1;
+		names = (char *)SOIL_context_alloc( context, names_length );
+		if ( NULL == names )
+		{
+			return;
+		}
+
+		/*	split in place, the names are separated by spaces	*/
+		for ( i = 0; i < names_length; ++i )
+		{
+			names[i] = ( ' ' == extensions[i] ) ? '\0' : extensions[i];
+		}
+	}
+
+	for ( i = 0; i < names_length; i += strlen( &names[i] ) + 1 )
+	{
+		if ( '\0' != names[i] )
+		{
+			++count;
+		}
+	}
+
+	/*	keep the load factor at or below one half	*/
+	while ( capacity < count * 2 )
+	{
+		capacity *= 2;
+	}
+
+	set->slots = (const char **)SOIL_context_alloc( context, capacity * sizeof(const char *) );
+	if ( NULL == set->slots )
+	{
+		SOIL_context_release( context, names );
+		return;
+	}
+	memset( (void *)set->slots, 0, capacity * sizeof(const char *) );
+	set->names = names;
+	set->slot_mask = (unsigned int)( capacity - 1 );
+
+	for ( i = 0; i < names_length; i += strlen( &names[i] ) + 1 )
+	{
+		unsigned int slot;
+
+		if ( '\0' == names[i] || SOIL_extension_set_find( set, &names[i] ) )
+		{
+			continue;
+		}
+
+		slot = SOIL_extension_hash( &names[i] ) & set->slot_mask;
+		while ( NULL != set->slots[slot] )
+		{
+			slot = ( slot + 1 ) & set->slot_mask;
+		}
+		set->slots[slot] = &names[i];
+	}
+}
+
 /* Based on the SDL2 implementation */
 int SOIL_GL_ExtensionSupported(const char *extension)
 {
@@ -468,6 +1310,12 @@ int SOIL_GL_ExtensionSupported(const char *extension)
 		return 0;
 	}
 
+	/* A bound context answers from its snapshot */
+	if ( NULL != current_context && NULL != current_context->gl.extensions.slots )
+	{
+		return SOIL_extension_set_find( &current_context->gl.extensions, extension );
+	}
+
 	#if defined( SOIL_X11_PLATFORM ) || defined( SOIL_PLATFORM_WIN32 ) || defined( SOIL_PLATFORM_OSX ) || defined(__HAIKU__)
 	/* Lookup the available extensions */
 	if ( isAtLeastGL3() )
@@ -475,11 +1323,11 @@ int SOIL_GL_ExtensionSupported(const char *extension)
 		GLint num_exts = 0;
 		GLint i;
 
-		if ( NULL == soilGlGetStringiFunc )
+		if ( NULL == soil_gl()->soilGlGetStringiFunc )
 		{
-			soilGlGetStringiFunc = (P_SOIL_glGetStringiFunc)SOIL_GL_GetProcAddress("glGetStringi");
+			soil_gl()->soilGlGetStringiFunc = (P_SOIL_glGetStringiFunc)SOIL_GL_GetProcAddress("glGetStringi");
 
-			if ( NULL == soilGlGetStringiFunc )
+			if ( NULL == soil_gl()->soilGlGetStringiFunc )
 			{
 				return 0;
 			}
@@ -491,7 +1339,7 @@ int SOIL_GL_ExtensionSupported(const char *extension)
 		glGetIntegerv(GL_NUM_EXTENSIONS, &num_exts);
 		for (i = 0; i < num_exts; i++)
 		{
-			const char *thisext = (const char *) soilGlGetStringiFunc(GL_EXTENSIONS, i);
+			const char *thisext = (const char *) soil_gl()->soilGlGetStringiFunc(GL_EXTENSIONS, i);
 
 			if (strcmp(thisext, extension) == 0)
 			{
@@ -535,6 +1383,166 @@ int SOIL_GL_ExtensionSupported(const char *extension)
 	return 0;
 }
 
+static void *SOIL_default_allocate( size_t size, void *user_data )
+{
+	(void)user_data;
+	return malloc( size );
+}
+
+static void SOIL_default_release( void *memory, void *user_data )
+{
+	(void)user_data;
+	free( memory );
+}
+
+SOIL_Context *
+	SOIL_create_context
+	(
+		const SOIL_Allocator *allocator
+	)
+{
+	static const SOIL_GL_state unknown_GL_state = SOIL_GL_STATE_UNKNOWN;
+	SOIL_Allocator hooks;
+	SOIL_Context *context;
+	SOIL_Context *previous;
+
+	if( NULL != allocator && NULL != allocator->allocate && NULL != allocator->release )
+	{
+		hooks = *allocator;
+	}
+	else
+	{
+		hooks.allocate = SOIL_default_allocate;
+		hooks.release = SOIL_default_release;
+		hooks.user_data = NULL;
+	}
+
+	context = (SOIL_Context *)hooks.allocate( sizeof(SOIL_Context), hooks.user_data );
+	if( NULL == context )
+	{
+		SOIL_set_result( SOIL_RESULT_OUT_OF_MEMORY, "Failed to allocate the SOIL context" );
+		return NULL;
+	}
+
+	memset( context, 0, sizeof(SOIL_Context) );
+	context->allocator = hooks;
+	context->gl = unknown_GL_state;
+
+	/*	snapshot everything now, so later calls never query OpenGL	*/
+	previous = SOIL_bind_context( context );
+	SOIL_extension_set_build( context );
+	query_cubemap_capability();
+	query_NPOT_capability();
+	query_tex_rectangle_capability();
+	query_DXT_capability();
+	query_3Dc_capability();
+	query_BPTC_capability();
+	query_texture_float_capability();
+	query_sRGB_capability();
+	query_gen_mipmap_capability();
+	query_PVR_capability();
+	query_BGRA8888_capability();
+	query_ETC1_capability();
+	query_ETC2_EAC_capability();
+	query_ASTC_LDR_capability();
+	query_teximage3d_capability();
+	query_PBO_capability();
+	query_tex_storage_capability();
+	query_texture_swizzle_capability();
+	query_BGR_unpack_capability();
+	query_unpack_row_length_capability();
+	query_cubemap_array_capability();
+	SOIL_bind_context( previous );
+
+	SOIL_set_result( SOIL_RESULT_OK, "SOIL context created" );
+	return context;
+}
+
+void
+	SOIL_free_context
+	(
+		SOIL_Context *context
+	)
+{
+	SOIL_Allocator hooks;
+
+	if( NULL == context )
+	{
+		return;
+	}
+
+	if( current_context == context )
+	{
+		current_context = NULL;
+	}
+
+	hooks = context->allocator;
+	SOIL_PBO_delete_ring( &context->gl );
+	SOIL_context_release( context, context->scratch );
+	SOIL_context_release( context, (void *)context->gl.extensions.slots );
+	SOIL_context_release( context, context->gl.extensions.names );
+	hooks.release( context, hooks.user_data );
+}
+
+SOIL_Context *
+	SOIL_bind_context
+	(
+		SOIL_Context *context
+	)
+{
+	SOIL_Context *previous = current_context;
+	current_context = context;
+	return previous;
+}
+
+int
+	SOIL_enable_PBO_uploads
+	(
+		int ring_size
+	)
+{
+	SOIL_GL_state *gl = soil_gl();
+	GLuint buffers[SOIL_PBO_MAX_RING_SIZE];
+	int i;
+
+	SOIL_PBO_delete_ring( gl );
+
+	if( ring_size <= 0 )
+	{
+		SOIL_set_result( SOIL_RESULT_OK, "PBO uploads disabled" );
+		return 0;
+	}
+
+	if( query_PBO_capability() != SOIL_CAPABILITY_PRESENT )
+	{
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "Pixel buffer objects are not supported" );
+		return 0;
+	}
+
+	if( ring_size > SOIL_PBO_MAX_RING_SIZE )
+	{
+		ring_size = SOIL_PBO_MAX_RING_SIZE;
+	}
+
+	memset( buffers, 0, sizeof(buffers) );
+	gl->soilGlGenBuffers( ring_size, buffers );
+
+	for( i = 0; i < ring_size; ++i )
+	{
+		if( 0 == buffers[i] )
+		{
+			gl->soilGlDeleteBuffers( ring_size, buffers );
+			SOIL_set_result( SOIL_RESULT_GL_ERROR, "Could not create the pixel buffer objects" );
+			return 0;
+		}
+		gl->PBO_slots[i].buffer = buffers[i];
+	}
+
+	gl->PBO_count = ring_size;
+	SOIL_set_result( SOIL_RESULT_OK, "PBO uploads enabled" );
+	return 1;
+}
+
 /*	other functions	*/
 unsigned int
 	SOIL_internal_create_OGL_texture
@@ -606,8 +1614,7 @@ unsigned int
 	}
 	if( NULL == img )
 	{
-		/*	image loading failed	*/
-		result_string_pointer = stbi_failure_reason();
+		/*	SOIL_load_image reported why, e.g. a missing file	*/
 		return 0;
 	}
 	/*	OK, make it a texture!	*/
@@ -636,28 +1643,35 @@ unsigned int
 	unsigned char* img = NULL;
 	int width, height, channels;
 	unsigned int tex_id;
+	file_map map;
 	/*	no direct uploading of the image as a DDS file	*/
 	/* error check */
 	if( (fake_HDR_format != SOIL_HDR_RGBE) &&
 		(fake_HDR_format != SOIL_HDR_RGBdivA) &&
 		(fake_HDR_format != SOIL_HDR_RGBdivA2) )
 	{
-		result_string_pointer = "Invalid fake HDR format specified";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid fake HDR format specified" );
+		return 0;
+	}
+
+	if( !SOIL_internal_map_file( filename, &map, 0, "Unable to open the HDR image file" ) )
+	{
 		return 0;
 	}
 
 	/* check if the image is HDR */
-	if ( stbi_is_hdr( filename ) )
+	if ( stbi_is_hdr_from_memory( map.data, map.size ) )
 	{
 		/*	try to load the image (only the HDR type) */
-		img = stbi_load( filename, &width, &height, &channels, 4 );
+		img = stbi_load_from_memory( map.data, map.size, &width, &height, &channels, 4 );
 	}
+	file_map_close( &map );
 
 	/*	channels holds the original number of channels, which may have been forced	*/
 	if( NULL == img )
 	{
 		/*	image loading failed	*/
-		result_string_pointer = stbi_failure_reason();
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, stbi_failure_reason() );
 		return 0;
 	}
 	/* the load worked, do I need to convert it? */
@@ -707,28 +1721,40 @@ static int SOIL_HDR_validate_options(
 	{
 		*internal_format = SOIL_GL_RGB32F;
 	}
+	else if( hdr_texture_format == SOIL_HDR_TEXTURE_BC6H )
+	{
+		/*	without BPTC support fall back to half floats	*/
+		*internal_format = ( query_BPTC_capability() == SOIL_CAPABILITY_PRESENT ) ?
+			SOIL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT : SOIL_GL_RGB16F;
+	}
 	else
 	{
-		result_string_pointer = "Invalid native HDR texture format specified";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid native HDR texture format specified" );
 		return 0;
 	}
 
 	if( flags & ~supported_flags )
 	{
-		result_string_pointer = "Unsupported flags for native HDR texture";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Unsupported flags for native HDR texture" );
 		return 0;
 	}
 
+	if( *internal_format == SOIL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT )
+	{
+		/*	the BC6H levels are compressed on the CPU	*/
+		return 1;
+	}
+
 	if( query_texture_float_capability() != SOIL_CAPABILITY_PRESENT )
 	{
-		result_string_pointer = "Floating-point textures not supported by the OpenGL driver";
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "Floating-point textures not supported by the OpenGL driver" );
 		return 0;
 	}
 
 	if( ( flags & SOIL_FLAG_GL_MIPMAPS ) &&
 		query_gen_mipmap_capability() != SOIL_CAPABILITY_PRESENT )
 	{
-		result_string_pointer = "OpenGL mipmap generation not supported by the OpenGL driver";
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "OpenGL mipmap generation not supported by the OpenGL driver" );
 		return 0;
 	}
 
@@ -744,20 +1770,41 @@ static int SOIL_HDR_upload_levels(
 	unsigned int flags )
 {
 	const float *level_data = data;
-	float *allocated_level = NULL;
+	float *scratch = NULL;
+	size_t scratch_size_A = 0;
 	int level_width = width;
 	int level_height = height;
 	int level = 0;
 
 	for( ;; )
 	{
-		glTexImage2D(
-			target, level, internal_format, level_width, level_height, 0,
-			GL_RGB, GL_FLOAT, level_data );
+		if( internal_format == SOIL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT )
+		{
+			int compressed_size = 0;
+			unsigned char *compressed = convert_image_to_BC6H(
+				level_data, level_width, level_height, 3, &compressed_size, 0 );
+			if( compressed == NULL )
+			{
+				SOIL_scratch_free( scratch );
+				SOIL_set_result( SOIL_RESULT_PROCESSING_FAILED, "Failed to compress native HDR texture to BC6H" );
+				return 0;
+			}
+			SOIL_upload_compressed_tex_image_2D(
+				0, target, level, internal_format, level_width, level_height,
+				compressed_size, compressed );
+			SOIL_free_image_data( compressed );
+		}
+		else
+		{
+			SOIL_upload_tex_image_2D(
+				0, target, level, internal_format, level_width, level_height,
+				GL_RGB, GL_FLOAT, level_data,
+				(size_t)level_width * level_height * 3 * sizeof(float) );
+		}
 		if( glGetError() != GL_NO_ERROR )
 		{
-			free( allocated_level );
-			result_string_pointer = "Failed to upload native HDR texture";
+			SOIL_scratch_free( scratch );
+			SOIL_set_result( SOIL_RESULT_GL_ERROR, "Failed to upload native HDR texture" );
 			return 0;
 		}
 
@@ -768,27 +1815,42 @@ static int SOIL_HDR_upload_levels(
 			break;
 		}
 
+		if( scratch == NULL )
+		{
+			/*	one allocation for the whole chain, the levels
+				ping-pong between its two halves	*/
+			const size_t w1 = (size_t)SOIL_MIP_SIZE( width );
+			const size_t h1 = (size_t)SOIL_MIP_SIZE( height );
+			scratch_size_A = w1 * h1 * 3;
+			scratch = (float *)SOIL_scratch_alloc(
+				( scratch_size_A + SOIL_MIP_SIZE( w1 ) * SOIL_MIP_SIZE( h1 ) * 3 ) *
+				sizeof(float) );
+			if( scratch == NULL )
+			{
+				SOIL_set_result( SOIL_RESULT_PROCESSING_FAILED, "Failed to create native HDR texture mipmap" );
+				return 0;
+			}
+		}
+
 		{
 			int next_width, next_height;
-			float *next_level = image_array_make_next_mipmap_f32(
+			float *next_level = ( level & 1 ) ? scratch + scratch_size_A : scratch;
+			if( !image_array_make_next_mipmap_into_f32(
 				level_data, 3, level_width, level_height,
-				&next_width, &next_height );
-			if( next_level == NULL )
+				next_level, &next_width, &next_height ) )
 			{
-				free( allocated_level );
-				result_string_pointer = "Failed to create native HDR texture mipmap";
+				SOIL_scratch_free( scratch );
+				SOIL_set_result( SOIL_RESULT_PROCESSING_FAILED, "Failed to create native HDR texture mipmap" );
 				return 0;
 			}
-			free( allocated_level );
-			allocated_level = next_level;
-			level_data = allocated_level;
+			level_data = next_level;
 			level_width = next_width;
 			level_height = next_height;
 			++level;
 		}
 	}
 
-	free( allocated_level );
+	SOIL_scratch_free( scratch );
 	return 1;
 }
 
@@ -815,9 +1877,15 @@ static unsigned int SOIL_internal_create_OGL_HDR_texture(
 	{
 		return 0;
 	}
+	if( internal_format == SOIL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT &&
+		( flags & SOIL_FLAG_GL_MIPMAPS ) )
+	{
+		/*	drivers can't generate the mipmaps of compressed textures	*/
+		flags = ( flags & ~SOIL_FLAG_GL_MIPMAPS ) | SOIL_FLAG_MIPMAPS;
+	}
 	if( cubemap && query_cubemap_capability() != SOIL_CAPABILITY_PRESENT )
 	{
-		result_string_pointer = "No cube map capability present";
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "No cube map capability present" );
 		return 0;
 	}
 
@@ -826,13 +1894,13 @@ static unsigned int SOIL_internal_create_OGL_HDR_texture(
 		if( images[image_index].width != images[0].width ||
 			images[image_index].height != images[0].height )
 		{
-			result_string_pointer = "Native HDR cubemap faces must have identical dimensions";
+			SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Native HDR cubemap faces must have identical dimensions" );
 			return 0;
 		}
 	}
 	if( cubemap && images[0].width != images[0].height )
 	{
-		result_string_pointer = "Native HDR cubemap faces must be square";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Native HDR cubemap faces must be square" );
 		return 0;
 	}
 
@@ -841,7 +1909,7 @@ static unsigned int SOIL_internal_create_OGL_HDR_texture(
 		&max_supported_size );
 	if( max_supported_size < 1 )
 	{
-		result_string_pointer = "Invalid maximum OpenGL texture size";
+		SOIL_set_result( SOIL_RESULT_GL_ERROR, "Invalid maximum OpenGL texture size" );
 		return 0;
 	}
 
@@ -855,7 +1923,7 @@ static unsigned int SOIL_internal_create_OGL_HDR_texture(
 		query_NPOT_capability() != SOIL_CAPABILITY_PRESENT )
 	{
 		const int resized = image_array_resize_POT_f32(
-			image_data, image_count, 3, &target_width, &target_height );
+			image_data, image_count, 3, &target_width, &target_height, max_supported_size );
 		for( image_index = 0; image_index < image_count; ++image_index )
 		{
 			images[image_index].data = image_data[image_index];
@@ -864,7 +1932,7 @@ static unsigned int SOIL_internal_create_OGL_HDR_texture(
 		}
 		if( !resized )
 		{
-			result_string_pointer = "Failed to resize native HDR image array to POT";
+			SOIL_set_result( SOIL_RESULT_PROCESSING_FAILED, "Failed to resize native HDR image array to POT" );
 			return 0;
 		}
 	}
@@ -892,7 +1960,7 @@ static unsigned int SOIL_internal_create_OGL_HDR_texture(
 		}
 		if( !resized )
 		{
-			result_string_pointer = "Failed to resize native HDR image array";
+			SOIL_set_result( SOIL_RESULT_PROCESSING_FAILED, "Failed to resize native HDR image array" );
 			return 0;
 		}
 	}
@@ -918,7 +1986,7 @@ static unsigned int SOIL_internal_create_OGL_HDR_texture(
 		{
 			glDeleteTextures( 1, &tex_id );
 		}
-		result_string_pointer = "Failed to generate an OpenGL texture name; missing OpenGL context?";
+		SOIL_set_result( SOIL_RESULT_GL_ERROR, "Failed to generate an OpenGL texture name; missing OpenGL context?" );
 		return 0;
 	}
 
@@ -929,7 +1997,7 @@ static unsigned int SOIL_internal_create_OGL_HDR_texture(
 		{
 			glDeleteTextures( 1, &tex_id );
 		}
-		result_string_pointer = "Failed to bind native HDR texture";
+		SOIL_set_result( SOIL_RESULT_GL_ERROR, "Failed to bind native HDR texture" );
 		return 0;
 	}
 
@@ -962,7 +2030,7 @@ static unsigned int SOIL_internal_create_OGL_HDR_texture(
 
 	if( flags & SOIL_FLAG_GL_MIPMAPS )
 	{
-		soilGlGenerateMipmap( texture_type );
+		soil_gl()->soilGlGenerateMipmap( texture_type );
 		if( glGetError() != GL_NO_ERROR )
 		{
 			if( unpack_alignment != 1 )
@@ -973,7 +2041,7 @@ static unsigned int SOIL_internal_create_OGL_HDR_texture(
 			{
 				glDeleteTextures( 1, &tex_id );
 			}
-			result_string_pointer = "Failed to generate native HDR texture mipmaps";
+			SOIL_set_result( SOIL_RESULT_GL_ERROR, "Failed to generate native HDR texture mipmaps" );
 			return 0;
 		}
 	}
@@ -1010,32 +2078,53 @@ static unsigned int SOIL_internal_create_OGL_HDR_texture(
 		{
 			glDeleteTextures( 1, &tex_id );
 		}
-		result_string_pointer = "Failed to configure native HDR texture";
+		SOIL_set_result( SOIL_RESULT_GL_ERROR, "Failed to configure native HDR texture" );
 		return 0;
 	}
 
-	result_string_pointer = "HDR image loaded as a native floating-point OpenGL texture";
+	SOIL_set_result( SOIL_RESULT_OK, "HDR image loaded as a native floating-point OpenGL texture" );
 	return tex_id;
 }
 
+static int SOIL_HDR_load_memory(
+	const unsigned char *buffer,
+	int buffer_length,
+	SOIL_HDR_image *image );
+
 static int SOIL_HDR_load_file( const char *filename, SOIL_HDR_image *image )
 {
 	int channels;
+	file_map map;
 	if( filename == NULL )
 	{
-		result_string_pointer = "Invalid HDR image filename";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid HDR image filename" );
+		return 0;
+	}
+	switch( file_map_open( filename, &map ) )
+	{
+	case FILE_MAP_OK:
+		{
+			const int loaded = SOIL_HDR_load_memory( map.data, map.size, image );
+			file_map_close( &map );
+			return loaded;
+		}
+	case FILE_MAP_NOT_FOUND:
+		SOIL_set_result( SOIL_RESULT_FILE_NOT_FOUND, "Unable to open the HDR image file" );
 		return 0;
+	default:
+		break;
 	}
+	/*	let stb_image report why the file can't be read	*/
 	if( !stbi_is_hdr( filename ) )
 	{
-		result_string_pointer = "Image is not a Radiance HDR file";
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "Image is not a Radiance HDR file" );
 		return 0;
 	}
 	image->data = stbi_loadf(
 		filename, &image->width, &image->height, &channels, 3 );
 	if( image->data == NULL )
 	{
-		result_string_pointer = stbi_failure_reason();
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, stbi_failure_reason() );
 		return 0;
 	}
 	return 1;
@@ -1049,12 +2138,12 @@ static int SOIL_HDR_load_memory(
 	int channels;
 	if( buffer == NULL || buffer_length < 1 )
 	{
-		result_string_pointer = "Invalid HDR image buffer";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid HDR image buffer" );
 		return 0;
 	}
 	if( !stbi_is_hdr_from_memory( buffer, buffer_length ) )
 	{
-		result_string_pointer = "Image is not a Radiance HDR file";
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "Image is not a Radiance HDR file" );
 		return 0;
 	}
 	image->data = stbi_loadf_from_memory(
@@ -1062,7 +2151,7 @@ static int SOIL_HDR_load_memory(
 		&image->width, &image->height, &channels, 3 );
 	if( image->data == NULL )
 	{
-		result_string_pointer = stbi_failure_reason();
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, stbi_failure_reason() );
 		return 0;
 	}
 	return 1;
@@ -1281,7 +2370,7 @@ unsigned int
 	if( NULL == img )
 	{
 		/*	image loading failed	*/
-		result_string_pointer = stbi_failure_reason();
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, stbi_failure_reason() );
 		return 0;
 	}
 	/*	OK, make it a texture!	*/
@@ -1318,7 +2407,20 @@ void SOIL_choose_gl_formats(
 
 	*out_internal = *out_external;
 
-	if (flags & SOIL_FLAG_COMPRESS_TO_DXT) {
+	if ((flags & SOIL_FLAG_COMPRESS_TO_BC7) && query_BPTC_capability() == SOIL_CAPABILITY_PRESENT) {
+		*out_internal = sRGB
+			? SOIL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM
+			: SOIL_COMPRESSED_RGBA_BPTC_UNORM;
+	} else if ((flags & SOIL_FLAG_COMPRESS_TO_ETC2) && query_ETC2_EAC_capability() == SOIL_CAPABILITY_PRESENT) {
+		if ((channels & 1) == 1)
+			*out_internal = sRGB
+				? SOIL_GL_COMPRESSED_SRGB8_ETC2
+				: SOIL_GL_COMPRESSED_RGB8_ETC2;
+		else
+			*out_internal = sRGB
+				? SOIL_GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC
+				: SOIL_GL_COMPRESSED_RGBA8_ETC2_EAC;
+	} else if (flags & (SOIL_FLAG_COMPRESS_TO_DXT | SOIL_FLAG_COMPRESS_TO_BC7 | SOIL_FLAG_COMPRESS_TO_ETC2)) {
 		if (query_DXT_capability() == SOIL_CAPABILITY_PRESENT) {
 			if ((channels & 1) == 1)
 				*out_internal = sRGB
@@ -1342,7 +2444,7 @@ void SOIL_upload_image_array_layers(
 {
 #if defined( SOIL_IMAGE_ARRAY_SUPPORT )
 	for (int layer = 0; layer < imgArray->layers; ++layer) {
-		soilGlTexSubImage3D(
+		SOIL_upload_tex_sub_image_3D(
 			GL_TEXTURE_2D_ARRAY,
 			0,
 			0, 0, layer,
@@ -1351,12 +2453,47 @@ void SOIL_upload_image_array_layers(
 			1,
 			external_fmt,
 			GL_UNSIGNED_BYTE,
-			imgArray->data[layer]
+			imgArray->data[layer],
+			(size_t)imgArray->width * imgArray->height * imgArray->channels
 		);
 	}
 #endif
 }
 
+#if defined( SOIL_IMAGE_ARRAY_SUPPORT )
+/*	Storage for levels 0 to levels - 1 of the bound array or 3D texture.
+	The layers of an array stay the same on every level, the depth of a
+	3D texture halves.  block_size is the size of a 4x4 block of a
+	compressed internal format, 0 for an uncompressed one.	*/
+static void SOIL_internal_allocate_levels_3D(
+	GLenum target,
+	GLint internal_fmt, GLenum external_fmt, GLenum type,
+	unsigned int block_size,
+	int w, int h, int depth, int levels )
+{
+	for( int level = 0; level < levels; ++level )
+	{
+		if( block_size )
+		{
+			const GLsizei size = ( ( w + 3 ) / 4 ) * ( ( h + 3 ) / 4 ) * block_size * depth;
+			soil_gl()->soilGlCompressedTexImage3D( target, level, internal_fmt,
+				w, h, depth, 0, size, NULL );
+		}
+		else
+		{
+			soil_gl()->soilGlTexImage3D( target, level, internal_fmt,
+				w, h, depth, 0, external_fmt, type, NULL );
+		}
+		w = SOIL_MIP_SIZE( w );
+		h = SOIL_MIP_SIZE( h );
+		if( target == GL_TEXTURE_3D )
+		{
+			depth = SOIL_MIP_SIZE( depth );
+		}
+	}
+}
+#endif
+
 unsigned int SOIL_create_texture_array_storage(
 	unsigned int reuse_id,
 	int internal_fmt,
@@ -1370,7 +2507,7 @@ unsigned int SOIL_create_texture_array_storage(
 
 	if (query_teximage3d_capability() != SOIL_CAPABILITY_PRESENT)
 	{
-		result_string_pointer = "OpenGL 3D textures not supported";
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "OpenGL 3D textures not supported" );
 		return 0;
 	}
 
@@ -1383,15 +2520,14 @@ unsigned int SOIL_create_texture_array_storage(
 
 	glBindTexture(GL_TEXTURE_2D_ARRAY, tex);
 
-	soilGlTexImage3D(
+	SOIL_internal_allocate_levels_3D(
 		GL_TEXTURE_2D_ARRAY,
-		0,
 		internal_fmt,
-		w, h, layers,
-		0,
 		external_fmt,
 		GL_UNSIGNED_BYTE,
-		NULL
+		0,
+		w, h, layers,
+		1
 	);
 #endif
 
@@ -1402,8 +2538,8 @@ void SOIL_setup_texture_params(int flags)
 {
 #if defined( SOIL_IMAGE_ARRAY_SUPPORT )
 	if (flags & (SOIL_FLAG_MIPMAPS | SOIL_FLAG_GL_MIPMAPS)) {
-		if (soilGlGenerateMipmap)
-			soilGlGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+		if (soil_gl()->soilGlGenerateMipmap)
+			soil_gl()->soilGlGenerateMipmap(GL_TEXTURE_2D_ARRAY);
 
 		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
@@ -1432,7 +2568,7 @@ unsigned int SOIL_load_OGL_texture_array_from_atlas_grid(
 ){
 	if (query_teximage3d_capability() != SOIL_CAPABILITY_PRESENT)
 	{
-		result_string_pointer = "Texture arrays not supported by OpenGL driver";
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "Texture arrays not supported by OpenGL driver" );
 		return 0;
 	}
 
@@ -1444,7 +2580,7 @@ unsigned int SOIL_load_OGL_texture_array_from_atlas_grid(
 
 	if (!atlasData)
 	{
-		result_string_pointer = stbi_failure_reason();
+		/*	SOIL_load_image reported why, e.g. a missing file	*/
 		return 0;
 	}
 
@@ -1452,6 +2588,12 @@ unsigned int SOIL_load_OGL_texture_array_from_atlas_grid(
 		channels = force_channels;
 	}
 
+	if (cols <= 0 || rows <= 0 || atlasW % cols != 0 || atlasH % rows != 0) {
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Atlas cannot be evenly divided by grid" );
+		SOIL_free_image_data(atlasData);
+		return 0;
+	}
+
 	SOIL_ImageArray imgArray = extract_image_array_from_atlas_grid(
 		atlasData,
 		atlasW,
@@ -1462,7 +2604,7 @@ unsigned int SOIL_load_OGL_texture_array_from_atlas_grid(
 	);
 
 	if (!imgArray.data || imgArray.layers == 0) {
-		result_string_pointer = "Failed to extract image array from atlas";
+		SOIL_set_result( SOIL_RESULT_OUT_OF_MEMORY, "Failed to extract image array from atlas" );
 		SOIL_free_image_data(atlasData);
 		return 0;
 	}
@@ -1491,37 +2633,32 @@ int SOIL_prepare_image_array(
 )
 {
 	if (!imgArray || !imgArray->data) {
-		result_string_pointer = "Invalid image array";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid image array" );
 		return 0;
 	}
 
-	if (flags & SOIL_FLAG_INVERT_Y) {
-		image_array_invert_y(imgArray);
-	}
+	unsigned int operations = 0;
 
-	if (flags & SOIL_FLAG_NTSC_SAFE_RGB) {
-		image_array_to_NTSC_safe(imgArray);
-	}
+	if (flags & SOIL_FLAG_INVERT_Y)
+		operations |= IMAGE_TRANSFORM_INVERT_Y;
 
-	if (flags & SOIL_FLAG_MULTIPLY_ALPHA) {
-		image_array_premultiply_alpha(imgArray);
-	}
+	if (flags & SOIL_FLAG_NTSC_SAFE_RGB)
+		operations |= IMAGE_TRANSFORM_NTSC_SAFE;
 
-	if (flags & SOIL_FLAG_CoCg_Y) {
-		image_array_to_YCoCg(imgArray);
-	}
+	if (flags & SOIL_FLAG_MULTIPLY_ALPHA)
+		operations |= IMAGE_TRANSFORM_MULTIPLY_ALPHA;
 
-	/* POT handling */
-	if ((flags & SOIL_FLAG_POWER_OF_TWO) ||
-		query_NPOT_capability() != SOIL_CAPABILITY_PRESENT)
-	{
-		if (!image_array_resize_POT(imgArray)) {
-			result_string_pointer = "Failed to resize image array to POT";
-			return 0;
-		}
+	if (flags & SOIL_FLAG_CoCg_Y)
+		operations |= IMAGE_TRANSFORM_YCOCG;
+
+	/* one pass over each layer, the same transform as single textures */
+	if (operations && !image_array_transform(imgArray, operations)) {
+		SOIL_set_result( SOIL_RESULT_OUT_OF_MEMORY, "Failed to transform image array" );
+		return 0;
 	}
 
-	/* GPU max texture size */
+	/* GPU max texture size, shrink first so POT never upsamples
+	   something that is about to be thrown away */
 	int max_texture_size = 0;
 	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
 
@@ -1529,7 +2666,17 @@ int SOIL_prepare_image_array(
 		imgArray->height > max_texture_size)
 	{
 		if (!image_array_reduce_to_max(imgArray, max_texture_size)) {
-			result_string_pointer = "Failed to reduce image array to GPU limits";
+			SOIL_set_result( SOIL_RESULT_PROCESSING_FAILED, "Failed to reduce image array to GPU limits" );
+			return 0;
+		}
+	}
+
+	/* POT handling, halved back down when the maximum isn't a power of 2 */
+	if ((flags & SOIL_FLAG_POWER_OF_TWO) ||
+		query_NPOT_capability() != SOIL_CAPABILITY_PRESENT)
+	{
+		if (!image_array_resize_POT(imgArray, max_texture_size)) {
+			SOIL_set_result( SOIL_RESULT_PROCESSING_FAILED, "Failed to resize image array to POT" );
 			return 0;
 		}
 	}
@@ -1605,13 +2752,13 @@ unsigned int
 		(z_pos_file == NULL) ||
 		(z_neg_file == NULL) )
 	{
-		result_string_pointer = "Invalid cube map files list";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid cube map files list" );
 		return 0;
 	}
 	/*	capability checking	*/
 	if( query_cubemap_capability() != SOIL_CAPABILITY_PRESENT )
 	{
-		result_string_pointer = "No cube map capability present";
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "No cube map capability present" );
 		return 0;
 	}
 	/*	1st face: try to load the image	*/
@@ -1623,8 +2770,7 @@ unsigned int
 	}
 	if( NULL == img )
 	{
-		/*	image loading failed	*/
-		result_string_pointer = stbi_failure_reason();
+		/*	SOIL_load_image reported why, e.g. a missing file	*/
 		return 0;
 	}
 	/*	upload the texture, and create a texture ID if necessary	*/
@@ -1647,8 +2793,7 @@ unsigned int
 		}
 		if( NULL == img )
 		{
-			/*	image loading failed	*/
-			result_string_pointer = stbi_failure_reason();
+			/*	SOIL_load_image reported why, e.g. a missing file	*/
 			return 0;
 		}
 		/*	upload the texture, but reuse the assigned texture ID	*/
@@ -1672,8 +2817,7 @@ unsigned int
 		}
 		if( NULL == img )
 		{
-			/*	image loading failed	*/
-			result_string_pointer = stbi_failure_reason();
+			/*	SOIL_load_image reported why, e.g. a missing file	*/
 			return 0;
 		}
 		/*	upload the texture, but reuse the assigned texture ID	*/
@@ -1697,8 +2841,7 @@ unsigned int
 		}
 		if( NULL == img )
 		{
-			/*	image loading failed	*/
-			result_string_pointer = stbi_failure_reason();
+			/*	SOIL_load_image reported why, e.g. a missing file	*/
 			return 0;
 		}
 		/*	upload the texture, but reuse the assigned texture ID	*/
@@ -1722,8 +2865,7 @@ unsigned int
 		}
 		if( NULL == img )
 		{
-			/*	image loading failed	*/
-			result_string_pointer = stbi_failure_reason();
+			/*	SOIL_load_image reported why, e.g. a missing file	*/
 			return 0;
 		}
 		/*	upload the texture, but reuse the assigned texture ID	*/
@@ -1747,8 +2889,7 @@ unsigned int
 		}
 		if( NULL == img )
 		{
-			/*	image loading failed	*/
-			result_string_pointer = stbi_failure_reason();
+			/*	SOIL_load_image reported why, e.g. a missing file	*/
 			return 0;
 		}
 		/*	upload the texture, but reuse the assigned texture ID	*/
@@ -1796,13 +2937,13 @@ unsigned int
 		(z_pos_buffer == NULL) ||
 		(z_neg_buffer == NULL) )
 	{
-		result_string_pointer = "Invalid cube map buffers list";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid cube map buffers list" );
 		return 0;
 	}
 	/*	capability checking	*/
 	if( query_cubemap_capability() != SOIL_CAPABILITY_PRESENT )
 	{
-		result_string_pointer = "No cube map capability present";
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "No cube map capability present" );
 		return 0;
 	}
 	/*	1st face: try to load the image	*/
@@ -1817,7 +2958,7 @@ unsigned int
 	if( NULL == img )
 	{
 		/*	image loading failed	*/
-		result_string_pointer = stbi_failure_reason();
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, stbi_failure_reason() );
 		return 0;
 	}
 	/*	upload the texture, and create a texture ID if necessary	*/
@@ -1843,7 +2984,7 @@ unsigned int
 		if( NULL == img )
 		{
 			/*	image loading failed	*/
-			result_string_pointer = stbi_failure_reason();
+			SOIL_set_result( SOIL_RESULT_DECODE_FAILED, stbi_failure_reason() );
 			return 0;
 		}
 		/*	upload the texture, but reuse the assigned texture ID	*/
@@ -1870,7 +3011,7 @@ unsigned int
 		if( NULL == img )
 		{
 			/*	image loading failed	*/
-			result_string_pointer = stbi_failure_reason();
+			SOIL_set_result( SOIL_RESULT_DECODE_FAILED, stbi_failure_reason() );
 			return 0;
 		}
 		/*	upload the texture, but reuse the assigned texture ID	*/
@@ -1897,7 +3038,7 @@ unsigned int
 		if( NULL == img )
 		{
 			/*	image loading failed	*/
-			result_string_pointer = stbi_failure_reason();
+			SOIL_set_result( SOIL_RESULT_DECODE_FAILED, stbi_failure_reason() );
 			return 0;
 		}
 		/*	upload the texture, but reuse the assigned texture ID	*/
@@ -1924,7 +3065,7 @@ unsigned int
 		if( NULL == img )
 		{
 			/*	image loading failed	*/
-			result_string_pointer = stbi_failure_reason();
+			SOIL_set_result( SOIL_RESULT_DECODE_FAILED, stbi_failure_reason() );
 			return 0;
 		}
 		/*	upload the texture, but reuse the assigned texture ID	*/
@@ -1951,7 +3092,7 @@ unsigned int
 		if( NULL == img )
 		{
 			/*	image loading failed	*/
-			result_string_pointer = stbi_failure_reason();
+			SOIL_set_result( SOIL_RESULT_DECODE_FAILED, stbi_failure_reason() );
 			return 0;
 		}
 		/*	upload the texture, but reuse the assigned texture ID	*/
@@ -1984,7 +3125,7 @@ unsigned int
 	/*	error checking	*/
 	if( filename == NULL )
 	{
-		result_string_pointer = "Invalid single cube map file name";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid single cube map file name" );
 		return 0;
 	}
 	/*	does the user want direct uploading of the image as a DDS file?	*/
@@ -2027,14 +3168,14 @@ unsigned int
 			(face_order[i] != 'U') &&
 			(face_order[i] != 'D') )
 		{
-			result_string_pointer = "Invalid single cube map face order";
+			SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid single cube map face order" );
 			return 0;
 		};
 	}
 	/*	capability checking	*/
 	if( query_cubemap_capability() != SOIL_CAPABILITY_PRESENT )
 	{
-		result_string_pointer = "No cube map capability present";
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "No cube map capability present" );
 		return 0;
 	}
 	/*	1st off, try to load the full image	*/
@@ -2046,8 +3187,7 @@ unsigned int
 	}
 	if( NULL == img )
 	{
-		/*	image loading failed	*/
-		result_string_pointer = stbi_failure_reason();
+		/*	SOIL_load_image reported why, e.g. a missing file	*/
 		return 0;
 	}
 	/*	now, does this image have the right dimensions?	*/
@@ -2055,7 +3195,7 @@ unsigned int
 		(6*width != height) )
 	{
 		SOIL_free_image_data( img );
-		result_string_pointer = "Single cubemap image must have a 6:1 ratio";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Single cubemap image must have a 6:1 ratio" );
 		return 0;
 	}
 	/*	try the image split and create	*/
@@ -2086,7 +3226,7 @@ unsigned int
 	/*	error checking	*/
 	if( buffer == NULL )
 	{
-		result_string_pointer = "Invalid single cube map buffer";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid single cube map buffer" );
 		return 0;
 	}
 	/*	does the user want direct uploading of the image as a DDS file?	*/
@@ -2133,14 +3273,14 @@ unsigned int
 			(face_order[i] != 'U') &&
 			(face_order[i] != 'D') )
 		{
-			result_string_pointer = "Invalid single cube map face order";
+			SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid single cube map face order" );
 			return 0;
 		};
 	}
 	/*	capability checking	*/
 	if( query_cubemap_capability() != SOIL_CAPABILITY_PRESENT )
 	{
-		result_string_pointer = "No cube map capability present";
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "No cube map capability present" );
 		return 0;
 	}
 	/*	1st off, try to load the full image	*/
@@ -2156,7 +3296,7 @@ unsigned int
 	if( NULL == img )
 	{
 		/*	image loading failed	*/
-		result_string_pointer = stbi_failure_reason();
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, stbi_failure_reason() );
 		return 0;
 	}
 	/*	now, does this image have the right dimensions?	*/
@@ -2164,7 +3304,7 @@ unsigned int
 		(6*width != height) )
 	{
 		SOIL_free_image_data( img );
-		result_string_pointer = "Single cubemap image must have a 6:1 ratio";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Single cubemap image must have a 6:1 ratio" );
 		return 0;
 	}
 	/*	try the image split and create	*/
@@ -2194,7 +3334,7 @@ unsigned int
 	/*	error checking	*/
 	if( data == NULL )
 	{
-		result_string_pointer = "Invalid single cube map image data";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid single cube map image data" );
 		return 0;
 	}
 	/*	face order checking	*/
@@ -2207,21 +3347,21 @@ unsigned int
 			(face_order[i] != 'U') &&
 			(face_order[i] != 'D') )
 		{
-			result_string_pointer = "Invalid single cube map face order";
+			SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid single cube map face order" );
 			return 0;
 		};
 	}
 	/*	capability checking	*/
 	if( query_cubemap_capability() != SOIL_CAPABILITY_PRESENT )
 	{
-		result_string_pointer = "No cube map capability present";
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "No cube map capability present" );
 		return 0;
 	}
 	/*	now, does this image have the right dimensions?	*/
 	if( (width != 6*height) &&
 		(6*width != height) )
 	{
-		result_string_pointer = "Single cubemap image must have a 6:1 ratio";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Single cubemap image must have a 6:1 ratio" );
 		return 0;
 	}
 	/*	which way am I stepping?	*/
@@ -2323,119 +3463,268 @@ void check_for_GL_errors( const char *calling_location )
 }
 #endif
 
+/*	the internal compressor, to the format SOIL_internal_texture_formats
+	picked: DXT1 for RGB, DXT5 for RGBA, BC4 / BC5 for L / LA, BC7 or ETC2	*/
+static unsigned char* SOIL_internal_compress_DXT(
+		const unsigned char *const data,
+		int width, int height, int channels,
+		unsigned int flags, unsigned int internal_texture_format,
+		int *DDS_size )
+{
+	const unsigned int options =
+		( ( flags & SOIL_FLAG_DXT_DETERMINISTIC ) ? DXT_COMPRESS_DETERMINISTIC : 0 ) |
+		( ( flags & SOIL_FLAG_DXT_HIGH_QUALITY ) ? DXT_COMPRESS_CLUSTER_FIT : 0 );
+	if( internal_texture_format == SOIL_COMPRESSED_RGBA_BPTC_UNORM ||
+		internal_texture_format == SOIL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM )
+	{
+		return convert_image_to_BC7( data, width, height, channels, DDS_size,
+			( flags & SOIL_FLAG_DXT_HIGH_QUALITY ) ? BPTC_COMPRESS_MULTI_MODE : 0 );
+	}
+	if( internal_texture_format == SOIL_GL_COMPRESSED_RGB8_ETC2 ||
+		internal_texture_format == SOIL_GL_COMPRESSED_SRGB8_ETC2 ||
+		internal_texture_format == SOIL_GL_COMPRESSED_RGBA8_ETC2_EAC ||
+		internal_texture_format == SOIL_GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC )
+	{
+		return convert_image_to_ETC2( data, width, height, channels, DDS_size );
+	}
+	if( internal_texture_format == SOIL_COMPRESSED_RED_RGTC1 )
+	{
+		return convert_image_to_BC4( data, width, height, channels, DDS_size, options );
+	}
+	if( internal_texture_format == SOIL_COMPRESSED_RG_RGTC2 )
+	{
+		return convert_image_to_BC5( data, width, height, channels, DDS_size, options );
+	}
+	if( (channels & 1) == 1 )
+	{
+		/*	RGB, use DXT1	*/
+		return convert_image_to_DXT1_ex( data, width, height, channels, DDS_size, options );
+	}
+	/*	RGBA, use DXT5	*/
+	return convert_image_to_DXT5_ex( data, width, height, channels, DDS_size, options );
+}
+
 static void createMipmaps(const unsigned char *const img,
 		int width, int height, int channels,
 		unsigned int flags,
 		unsigned int opengl_texture_target,
 		unsigned int internal_texture_format,
 		unsigned int original_texture_format,
-		int DXT_mode)
+		int DXT_mode,
+		int sub_image)
 {
 	if ( ( flags & SOIL_FLAG_GL_MIPMAPS ) && query_gen_mipmap_capability() == SOIL_CAPABILITY_PRESENT )
 	{
-		soilGlGenerateMipmap(opengl_texture_target);
+		soil_gl()->soilGlGenerateMipmap(opengl_texture_target);
 	}
 	else
 	{
+		/*	each level is built from the previous one, ping-ponging
+			between two halves of a single scratch allocation.
+			The chain follows OpenGL's floor(n/2) rule, so NPOT
+			textures get a complete chain too.	*/
 		int MIPlevel = 1;
-		int MIPwidth = (width+1) / 2;
-		int MIPheight = (height+1) / 2;
-		unsigned char *resampled = (unsigned char*)malloc( channels*MIPwidth*MIPheight );
+		int MIPwidth = SOIL_MIP_SIZE( width );
+		int MIPheight = SOIL_MIP_SIZE( height );
+		int prev_width = width;
+		int prev_height = height;
+		const int scratch_size_A = channels*MIPwidth*MIPheight;
+		const int scratch_size_B = channels*SOIL_MIP_SIZE( MIPwidth )*SOIL_MIP_SIZE( MIPheight );
+		unsigned char *scratch = (unsigned char*)SOIL_scratch_alloc( scratch_size_A + scratch_size_B );
+		const unsigned char *prev = img;
+		unsigned char *resampled;
 
-		while( ((1<<MIPlevel) <= width) || ((1<<MIPlevel) <= height) )
+		if( NULL == scratch )
 		{
-			/*	do this MIPmap level	*/
-			mipmap_image(
-					img, width, height, channels,
-					resampled,
-					(1 << MIPlevel), (1 << MIPlevel) );
-
+			return;
+		}
+
+		while( (prev_width > 1) || (prev_height > 1) )
+		{
+			resampled = (MIPlevel & 1) ? scratch : scratch + scratch_size_A;
+
+			/*	do this MIPmap level	*/
+			mipmap_image_next_level(
+					prev, prev_width, prev_height, channels,
+					resampled );
+
 			/*  upload the MIPmaps	*/
 			if( DXT_mode == SOIL_CAPABILITY_PRESENT )
 			{
 				/*	user wants me to do the DXT conversion!	*/
 				int DDS_size;
-				unsigned char *DDS_data = NULL;
-				if( (channels & 1) == 1 )
-				{
-					/*	RGB, use DXT1	*/
-					DDS_data = convert_image_to_DXT1(
-							resampled, MIPwidth, MIPheight, channels, &DDS_size );
-				} else
-				{
-					/*	RGBA, use DXT5	*/
-					DDS_data = convert_image_to_DXT5(
-							resampled, MIPwidth, MIPheight, channels, &DDS_size );
-				}
+				unsigned char *DDS_data = SOIL_internal_compress_DXT(
+						resampled, MIPwidth, MIPheight, channels, flags,
+						internal_texture_format, &DDS_size );
 				if( DDS_data )
 				{
-					soilGlCompressedTexImage2D(
-						opengl_texture_target, MIPlevel,
-						internal_texture_format, MIPwidth, MIPheight, 0,
+					SOIL_upload_compressed_tex_image_2D(
+						sub_image, opengl_texture_target, MIPlevel,
+						internal_texture_format, MIPwidth, MIPheight,
 						DDS_size, DDS_data );
 					check_for_GL_errors( "glCompressedTexImage2D" );
 					SOIL_free_image_data( DDS_data );
 				} else
 				{
 					/*	my compression failed, try the OpenGL driver's version	*/
-					glTexImage2D(
-						opengl_texture_target, MIPlevel,
-						internal_texture_format, MIPwidth, MIPheight, 0,
-						original_texture_format, GL_UNSIGNED_BYTE, resampled );
+					SOIL_upload_tex_image_2D(
+						sub_image, opengl_texture_target, MIPlevel,
+						internal_texture_format, MIPwidth, MIPheight,
+						original_texture_format, GL_UNSIGNED_BYTE, resampled,
+						(size_t)MIPwidth * MIPheight * channels );
 					check_for_GL_errors( "glTexImage2D" );
 				}
 			} else
 			{
 				/*	user want OpenGL to do all the work!	*/
-				glTexImage2D(
-					opengl_texture_target, MIPlevel,
-					internal_texture_format, MIPwidth, MIPheight, 0,
-					original_texture_format, GL_UNSIGNED_BYTE, resampled );
+				SOIL_upload_tex_image_2D(
+					sub_image, opengl_texture_target, MIPlevel,
+					internal_texture_format, MIPwidth, MIPheight,
+					original_texture_format, GL_UNSIGNED_BYTE, resampled,
+					(size_t)MIPwidth * MIPheight * channels );
 				check_for_GL_errors( "glTexImage2D" );
 			}
 			/*	prep for the next level	*/
+			prev = resampled;
+			prev_width = MIPwidth;
+			prev_height = MIPheight;
 			++MIPlevel;
-			MIPwidth = (MIPwidth + 1) / 2;
-			MIPheight = (MIPheight + 1) / 2;
+			MIPwidth = SOIL_MIP_SIZE( MIPwidth );
+			MIPheight = SOIL_MIP_SIZE( MIPheight );
 		}
 
-		SOIL_free_image_data( resampled );
+		SOIL_scratch_free( scratch );
 	}
 }
 
-unsigned int
-	SOIL_internal_create_OGL_texture
-	(
-		const unsigned char *const data,
-		int *width, int *height, int channels,
-		unsigned int reuse_texture_ID,
-		unsigned int flags,
-		unsigned int opengl_texture_type,
-		unsigned int opengl_texture_target,
-		unsigned int texture_check_size_enum
-	)
+typedef struct
 {
-	/*	variables	*/
-	unsigned char* img = NULL;
-	unsigned int tex_id;
-	unsigned int internal_texture_format = 0, original_texture_format = 0;
-	int DXT_mode = SOIL_CAPABILITY_UNKNOWN;
-	int sRGB_texture = query_sRGB_capability() == SOIL_CAPABILITY_PRESENT && ( flags & SOIL_FLAG_SRGB_COLOR_SPACE );;
 	int max_supported_size;
-	int iwidth = *width;
-	int iheight = *height;
-	int needCopy;
-	GLint unpack_aligment;
+	int tex_rectangle;
+	int NPOT;
+	int sRGB;
+	int DXT;
+	/*	RGTC with the swizzle that keeps it sampling like luminance	*/
+	int RGTC;
+	int BPTC;
+	int ETC2;
+	int gen_mipmap;
+} SOIL_texture_caps;
+
+/*	everything the CPU side of texture creation needs to know about
+	OpenGL, queried up front so that side can run on any thread	*/
+static void SOIL_internal_query_texture_caps(
+		unsigned int texture_check_size_enum,
+		unsigned int flags,
+		SOIL_texture_caps *caps )
+{
+	GLint max_supported_size = 0;
 
 	/*	how large of a texture can this OpenGL implementation handle?	*/
 	/*	texture_check_size_enum will be GL_MAX_TEXTURE_SIZE or SOIL_MAX_CUBE_MAP_TEXTURE_SIZE	*/
 	glGetIntegerv( texture_check_size_enum, &max_supported_size );
+	caps->max_supported_size = max_supported_size;
+	caps->tex_rectangle = ( flags & SOIL_FLAG_TEXTURE_RECTANGLE ) ? query_tex_rectangle_capability() : SOIL_CAPABILITY_UNKNOWN;
+	caps->NPOT = query_NPOT_capability();
+	caps->sRGB = query_sRGB_capability();
+	/*	SOIL_FLAG_COMPRESS_TO_BC7 and SOIL_FLAG_COMPRESS_TO_ETC2 fall back to DXT	*/
+	if( flags & ( SOIL_FLAG_COMPRESS_TO_BC7 | SOIL_FLAG_COMPRESS_TO_ETC2 ) )
+	{
+		flags |= SOIL_FLAG_COMPRESS_TO_DXT;
+	}
+	caps->BPTC = ( flags & SOIL_FLAG_COMPRESS_TO_BC7 ) ? query_BPTC_capability() : SOIL_CAPABILITY_UNKNOWN;
+	caps->ETC2 = ( flags & SOIL_FLAG_COMPRESS_TO_ETC2 ) ? query_ETC2_EAC_capability() : SOIL_CAPABILITY_UNKNOWN;
+	if( caps->ETC2 == SOIL_CAPABILITY_PRESENT && NULL == soil_gl()->soilGlCompressedTexImage2D )
+	{
+		/*	ETC2 comes with the OpenGL version, so nothing loaded the upload function yet	*/
+		soil_gl()->soilGlCompressedTexImage2D = get_glCompressedTexImage2D_addr();
+		if( NULL == soil_gl()->soilGlCompressedTexImage2D )
+		{
+			caps->ETC2 = SOIL_CAPABILITY_NONE;
+		}
+	}
+	caps->DXT = ( flags & SOIL_FLAG_COMPRESS_TO_DXT ) ? query_DXT_capability() : SOIL_CAPABILITY_UNKNOWN;
+	caps->RGTC = SOIL_CAPABILITY_UNKNOWN;
+	if( flags & SOIL_FLAG_COMPRESS_TO_DXT )
+	{
+		caps->RGTC = ( query_3Dc_capability() == SOIL_CAPABILITY_PRESENT &&
+			query_texture_swizzle_capability() == SOIL_CAPABILITY_PRESENT ) ?
+			SOIL_CAPABILITY_PRESENT : SOIL_CAPABILITY_NONE;
+	}
+	caps->gen_mipmap = ( flags & ( SOIL_FLAG_MIPMAPS | SOIL_FLAG_GL_MIPMAPS ) ) ? query_gen_mipmap_capability() : SOIL_CAPABILITY_UNKNOWN;
+}
+
+/*	the power of two size an image is resampled to	*/
+static void SOIL_internal_POT_size(
+		int width, int height, int max_supported_size,
+		int *new_width, int *new_height )
+{
+	*new_width = 1;
+	*new_height = 1;
+	while( *new_width < width )
+	{
+		*new_width *= 2;
+	}
+	while( *new_height < height )
+	{
+		*new_height *= 2;
+	}
+	/*	the maximum size is not always a power of 2	*/
+	while( *new_width > max_supported_size && *new_width > 1 )
+	{
+		*new_width /= 2;
+	}
+	while( *new_height > max_supported_size && *new_height > 1 )
+	{
+		*new_height /= 2;
+	}
+}
+
+/*	will SOIL_internal_prepare_image resample the image?	*/
+static int SOIL_internal_image_resized(
+		int width, int height, unsigned int flags, int max_supported_size )
+{
+	int new_width, new_height;
+
+	if( (width > max_supported_size) || (height > max_supported_size) )
+	{
+		return 1;
+	}
+	if( !( flags & SOIL_FLAG_POWER_OF_TWO ) || ( SOIL_IS_POW2(width) && SOIL_IS_POW2(height) ) )
+	{
+		return 0;
+	}
+	SOIL_internal_POT_size( width, height, max_supported_size, &new_width, &new_height );
+	return (new_width != width) || (new_height != height);
+}
+
+/*	The CPU side of texture creation: settles the flags and the target
+	against the capabilities, then applies the pixel transforms and the
+	resizing.  *prepared receives a new image, or NULL when data can be
+	uploaded as is.  Doesn't touch OpenGL.	*/
+static int SOIL_internal_prepare_image(
+		const unsigned char *const data,
+		int *width, int *height, int channels,
+		unsigned int *texture_flags,
+		const SOIL_texture_caps *caps,
+		unsigned int *texture_type,
+		unsigned int *texture_target,
+		unsigned char **prepared )
+{
+	unsigned char* img = NULL;
+	unsigned int flags = *texture_flags;
+	unsigned int opengl_texture_type = *texture_type;
+	unsigned int opengl_texture_target = *texture_target;
+	int max_supported_size = caps->max_supported_size;
+	int iwidth = *width;
+	int iheight = *height;
+	unsigned int operations = 0;
 
 	/*	If the user wants to use the texture rectangle I kill a few flags	*/
 	if( flags & SOIL_FLAG_TEXTURE_RECTANGLE )
 	{
 		/*	well, the user asked for it, can we do that?	*/
-		if( query_tex_rectangle_capability() == SOIL_CAPABILITY_PRESENT )
+		if( caps->tex_rectangle == SOIL_CAPABILITY_PRESENT )
 		{
 			/*	only allow this if the user in _NOT_ trying to do a cubemap!	*/
 			if( opengl_texture_type == GL_TEXTURE_2D )
@@ -2457,109 +3746,94 @@ unsigned int
 		} else
 		{
 			/*	can't do it, and that is a breakable offense (uv coords use pixels instead of [0,1]!)	*/
-			result_string_pointer = "Texture Rectangle extension unsupported";
+			SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "Texture Rectangle extension unsupported" );
 			return 0;
 		}
 	}
 
 	/*	if the user can't support NPOT textures, make sure we force the POT option	*/
-	if( (query_NPOT_capability() == SOIL_CAPABILITY_NONE) &&
+	if( (caps->NPOT == SOIL_CAPABILITY_NONE) &&
 		!(flags & SOIL_FLAG_TEXTURE_RECTANGLE) )
 	{
 		/*	add in the POT flag */
 		flags |= SOIL_FLAG_POWER_OF_TWO;
 	}
 
-	needCopy = ( ( flags & SOIL_FLAG_INVERT_Y ) ||
-				 ( flags & SOIL_FLAG_NTSC_SAFE_RGB ) ||
-				 ( flags & SOIL_FLAG_MULTIPLY_ALPHA ) ||
-				 ( flags & SOIL_FLAG_CoCg_Y )
-				);
-
-	/*	create a copy the image data only if needed */
-	if ( needCopy ) {
-		img = (unsigned char*)malloc( iwidth*iheight*channels );
-		memcpy( img, data, iwidth*iheight*channels );
-	}
-
-	/*	does the user want me to invert the image?	*/
 	if( flags & SOIL_FLAG_INVERT_Y )
 	{
-		int i, j;
-		for( j = 0; j*2 < iheight; ++j )
-		{
-			int index1 = j * iwidth * channels;
-			int index2 = (iheight - 1 - j) * iwidth * channels;
-			for( i = iwidth * channels; i > 0; --i )
-			{
-				unsigned char temp = img[index1];
-				img[index1] = img[index2];
-				img[index2] = temp;
-				++index1;
-				++index2;
-			}
-		}
+		operations |= IMAGE_TRANSFORM_INVERT_Y;
 	}
-	/*	does the user want me to scale the colors into the NTSC safe RGB range?	*/
 	if( flags & SOIL_FLAG_NTSC_SAFE_RGB )
 	{
-		scale_image_RGB_to_NTSC_safe( img, iwidth, iheight, channels );
+		operations |= IMAGE_TRANSFORM_NTSC_SAFE;
 	}
-	/*	does the user want me to convert from straight to pre-multiplied alpha?
-		(and do we even _have_ alpha?)	*/
 	if( flags & SOIL_FLAG_MULTIPLY_ALPHA )
 	{
-		int i;
-		switch( channels )
-		{
-		case 2:
-			for( i = 0; i < 2*iwidth*iheight; i += 2 )
-			{
-				img[i] = (img[i] * img[i+1] + 128) >> 8;
-			}
-			break;
-		case 4:
-			for( i = 0; i < 4*iwidth*iheight; i += 4 )
-			{
-				img[i+0] = (img[i+0] * img[i+3] + 128) >> 8;
-				img[i+1] = (img[i+1] * img[i+3] + 128) >> 8;
-				img[i+2] = (img[i+2] * img[i+3] + 128) >> 8;
-			}
-			break;
-		default:
-			/*	no other number of channels contains alpha data	*/
-			break;
-		}
+		operations |= IMAGE_TRANSFORM_MULTIPLY_ALPHA;
 	}
 
-	/*	do I need to make it a power of 2?	*/
-	if(
-		( ( flags & SOIL_FLAG_POWER_OF_TWO) && ( !SOIL_IS_POW2(iwidth) || !SOIL_IS_POW2(iheight) ) ) ||	/*	user asked for it and the texture is not power of 2	*/
-		( (flags & SOIL_FLAG_MIPMAPS)&& !( ( flags & SOIL_FLAG_GL_MIPMAPS ) &&
-										   query_gen_mipmap_capability() == SOIL_CAPABILITY_PRESENT &&
-										   query_NPOT_capability() == SOIL_CAPABILITY_PRESENT ) ) ||	/*	need it for the MIP-maps when mipmaps required
-																											and not GL mipmaps required and supported	*/
-		(iwidth > max_supported_size) ||		/*	it's too big, (make sure it's	*/
-		(iheight > max_supported_size) )		/*	2^n for later down-sampling)	*/
+	/*	YCoCg comes after any resizing, so it only joins the single
+		pass when the image keeps its size	*/
+	if( ( flags & SOIL_FLAG_CoCg_Y ) &&
+		!SOIL_internal_image_resized( iwidth, iheight, flags, max_supported_size ) )
 	{
-		int new_width = 1;
-		int new_height = 1;
-		while( new_width < iwidth )
-		{
-			new_width *= 2;
-		}
-		while( new_height < iheight )
+		operations |= IMAGE_TRANSFORM_YCOCG;
+	}
+
+	/*	create a transformed copy of the image data only if needed	*/
+	if( operations )
+	{
+		img = (unsigned char*)malloc( iwidth*iheight*channels );
+		if( NULL == img )
 		{
-			new_height *= 2;
+			SOIL_set_result( SOIL_RESULT_OUT_OF_MEMORY, "Failed to allocate the transformed image" );
+			return 0;
 		}
+		transform_image( data, iwidth, iheight, channels, img, operations );
+	}
+
+	/*	if it is too large, area average it straight down to the
+		allowable maximum (no need to go through a power of 2 first)	*/
+	if( (iwidth > max_supported_size) || (iheight > max_supported_size) )
+	{
+		unsigned char *resampled;
+		int new_width = iwidth > max_supported_size ? max_supported_size : iwidth;
+		int new_height = iheight > max_supported_size ? max_supported_size : iheight;
+		resampled = (unsigned char*)malloc( channels*new_width*new_height );
+		/*	perform the actual reduction	*/
+		down_scale_image( NULL != img ? img : data, iwidth, iheight, channels,
+						resampled, new_width, new_height );
+		/*	nuke the old guy, then point it at the new guy	*/
+		SOIL_free_image_data( img );
+		img = resampled;
+		*width = new_width;
+		*height = new_height;
+		iwidth = new_width;
+		iheight = new_height;
+	}
+	/*	do I need to make it a power of 2?
+		(MIPmaps don't need it, the CPU chain handles any size and
+		the POT flag is already forced when NPOT is unsupported)	*/
+	if( ( flags & SOIL_FLAG_POWER_OF_TWO) && ( !SOIL_IS_POW2(iwidth) || !SOIL_IS_POW2(iheight) ) )
+	{
+		int new_width, new_height;
+		SOIL_internal_POT_size( iwidth, iheight, max_supported_size, &new_width, &new_height );
 		/*	still?	*/
 		if( (new_width != iwidth) || (new_height != iheight) )
 		{
 			/*	yep, resize	*/
 			unsigned char *resampled = (unsigned char*)malloc( channels*new_width*new_height );
-			up_scale_image(
-					NULL != img ? img : data, iwidth, iheight, channels,
-					resampled, new_width, new_height );
+			if( (new_width <= iwidth) && (new_height <= iheight) )
+			{
+				down_scale_image(
+						NULL != img ? img : data, iwidth, iheight, channels,
+						resampled, new_width, new_height );
+			} else
+			{
+				up_scale_image(
+						NULL != img ? img : data, iwidth, iheight, channels,
+						resampled, new_width, new_height );
+			}
 
 			/*	nuke the old guy ( if a copy exists ), then point it at the new guy	*/
 			SOIL_free_image_data( img );
@@ -2570,108 +3844,238 @@ unsigned int
 			iheight = new_height;
 		}
 	}
-	/*	now, if it is too large...	*/
-	if( (iwidth > max_supported_size) || (iheight > max_supported_size) )
+	/*	does the user want us to use YCoCg color space?	*/
+	if( ( flags & SOIL_FLAG_CoCg_Y ) && !( operations & IMAGE_TRANSFORM_YCOCG ) )
 	{
-		/*	I've already made it a power of two, so simply use the MIPmapping
-			code to reduce its size to the allowable maximum.	*/
-		unsigned char *resampled;
-		int reduce_block_x = 1, reduce_block_y = 1;
-		int new_width, new_height;
-		if( iwidth > max_supported_size )
+		/*	this will only work with RGB and RGBA images */
+		convert_RGB_to_YCoCg( img, iwidth, iheight, channels );
+	}
+
+	*texture_flags = flags;
+	*texture_type = opengl_texture_type;
+	*texture_target = opengl_texture_target;
+	*prepared = img;
+	return 1;
+}
+
+/*	the OpenGL formats for an image, and whether SOIL compresses it to DXT	*/
+static void SOIL_internal_texture_formats(
+		int channels,
+		unsigned int flags,
+		const SOIL_texture_caps *caps,
+		unsigned int *original_texture_format,
+		unsigned int *internal_texture_format,
+		int *DXT_mode )
+{
+	int sRGB_texture = caps->sRGB == SOIL_CAPABILITY_PRESENT && ( flags & SOIL_FLAG_SRGB_COLOR_SPACE );
+
+	*DXT_mode = SOIL_CAPABILITY_UNKNOWN;
+	*original_texture_format = 0;
+	/*	and what type am I using as the internal texture format?	*/
+	switch( channels )
+	{
+	case 1:
+		*original_texture_format = GL_LUMINANCE;
+		break;
+	case 2:
+		*original_texture_format = GL_LUMINANCE_ALPHA;
+		break;
+	case 3:
+		*original_texture_format = GL_RGB;
+		break;
+	case 4:
+		*original_texture_format = GL_RGBA;
+		break;
+	}
+	*internal_texture_format = *original_texture_format;
+	/*	does the user want me to, and can I, save as DXT?	*/
+	if( ( flags & SOIL_FLAG_COMPRESS_TO_BC7 ) && caps->BPTC == SOIL_CAPABILITY_PRESENT )
+	{
+		/*	any number of channels, L is stored as RGB	*/
+		*DXT_mode = SOIL_CAPABILITY_PRESENT;
+		*internal_texture_format = sRGB_texture ? SOIL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : SOIL_COMPRESSED_RGBA_BPTC_UNORM;
+	}
+	else if( ( flags & SOIL_FLAG_COMPRESS_TO_ETC2 ) && caps->ETC2 == SOIL_CAPABILITY_PRESENT )
+	{
+		/*	1 or 3 channels = RGB8, 2 or 4 channels = RGBA8 with EAC alpha	*/
+		*DXT_mode = SOIL_CAPABILITY_PRESENT;
+		if( (channels & 1) == 1 )
 		{
-			reduce_block_x = iwidth / max_supported_size;
-		}
-		if( iheight > max_supported_size )
+			*internal_texture_format = sRGB_texture ? SOIL_GL_COMPRESSED_SRGB8_ETC2 : SOIL_GL_COMPRESSED_RGB8_ETC2;
+		} else
 		{
-			reduce_block_y = iheight / max_supported_size;
+			*internal_texture_format = sRGB_texture ? SOIL_GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC : SOIL_GL_COMPRESSED_RGBA8_ETC2_EAC;
 		}
-		new_width = iwidth / reduce_block_x;
-		new_height = iheight / reduce_block_y;
-		resampled = (unsigned char*)malloc( channels*new_width*new_height );
-		/*	perform the actual reduction	*/
-		mipmap_image( NULL != img ? img : data, iwidth, iheight, channels,
-						resampled, reduce_block_x, reduce_block_y );
-		/*	nuke the old guy, then point it at the new guy	*/
-		SOIL_free_image_data( img );
-		img = resampled;
-		*width = new_width;
-		*height = new_height;
-		iwidth = new_width;
-		iheight = new_height;
 	}
-	/*	does the user want us to use YCoCg color space?	*/
-	if( flags & SOIL_FLAG_CoCg_Y )
+	else if( ( flags & (SOIL_FLAG_COMPRESS_TO_DXT | SOIL_FLAG_COMPRESS_TO_BC7 | SOIL_FLAG_COMPRESS_TO_ETC2) ) && channels < 3 && !sRGB_texture &&
+		caps->RGTC == SOIL_CAPABILITY_PRESENT )
 	{
-		/*	this will only work with RGB and RGBA images */
-		convert_RGB_to_YCoCg( img, iwidth, iheight, channels );
+		/*	1 channel = BC4, 2 channels = BC5, swizzled back to luminance	*/
+		*DXT_mode = SOIL_CAPABILITY_PRESENT;
+		*internal_texture_format = ( channels == 1 ) ? SOIL_COMPRESSED_RED_RGTC1 : SOIL_COMPRESSED_RG_RGTC2;
 	}
-	/*	create the OpenGL texture ID handle
-		(note: allowing a forced texture ID lets me reload a texture)	*/
-	tex_id = reuse_texture_ID;
-	if( tex_id == 0 )
+	else if( flags & (SOIL_FLAG_COMPRESS_TO_DXT | SOIL_FLAG_COMPRESS_TO_BC7 | SOIL_FLAG_COMPRESS_TO_ETC2) )
 	{
-		glGenTextures( 1, &tex_id );
+		*DXT_mode = caps->DXT;
+		if( *DXT_mode == SOIL_CAPABILITY_PRESENT )
+		{
+			/*	I can use DXT, whether I compress it or OpenGL does	*/
+			if( (channels & 1) == 1 )
+			{
+				/*	1 or 3 channels = DXT1	*/
+				*internal_texture_format = sRGB_texture ? SOIL_GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : SOIL_RGB_S3TC_DXT1;
+			} else
+			{
+				/*	2 or 4 channels = DXT5	*/
+				*internal_texture_format = sRGB_texture ? SOIL_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : SOIL_RGBA_S3TC_DXT5;
+			}
+		}
 	}
-	check_for_GL_errors( "glGenTextures" );
-	/* Note: sometimes glGenTextures fails (usually no OpenGL context)	*/
-	if( tex_id )
+	else if ( sRGB_texture )
 	{
-		/*	and what type am I using as the internal texture format?	*/
 		switch( channels )
 		{
-		case 1:
-			original_texture_format = GL_LUMINANCE;
-			break;
-		case 2:
-			original_texture_format = GL_LUMINANCE_ALPHA;
-			break;
 		case 3:
-			original_texture_format = GL_RGB;
+			*internal_texture_format = SOIL_GL_SRGB;
 			break;
 		case 4:
-			original_texture_format = GL_RGBA;
+			*internal_texture_format = SOIL_GL_SRGB_ALPHA;
 			break;
 		}
-		internal_texture_format = original_texture_format;
-		/*	does the user want me to, and can I, save as DXT?	*/
-		if( flags & SOIL_FLAG_COMPRESS_TO_DXT )
+	}
+}
+
+/*	filtering and wrapping of a freshly uploaded texture	*/
+static void SOIL_internal_set_texture_parameters(
+		unsigned int opengl_texture_type,
+		unsigned int flags,
+		unsigned int internal_texture_format )
+{
+	/*	RGTC holds luminance in red and alpha in green	*/
+	if( internal_texture_format == SOIL_COMPRESSED_RED_RGTC1 ||
+		internal_texture_format == SOIL_COMPRESSED_RG_RGTC2 )
+	{
+		glTexParameteri( opengl_texture_type, SOIL_TEXTURE_SWIZZLE_R, SOIL_GL_RED );
+		glTexParameteri( opengl_texture_type, SOIL_TEXTURE_SWIZZLE_G, SOIL_GL_RED );
+		glTexParameteri( opengl_texture_type, SOIL_TEXTURE_SWIZZLE_B, SOIL_GL_RED );
+		glTexParameteri( opengl_texture_type, SOIL_TEXTURE_SWIZZLE_A,
+			internal_texture_format == SOIL_COMPRESSED_RG_RGTC2 ? SOIL_GL_GREEN : GL_ONE );
+		check_for_GL_errors( "GL_TEXTURE_SWIZZLE_*" );
+	} else if( soil_gl()->has_texture_swizzle_capability == SOIL_CAPABILITY_PRESENT )
+	{
+		/*	a reused texture may still have the swizzle	*/
+		glTexParameteri( opengl_texture_type, SOIL_TEXTURE_SWIZZLE_R, SOIL_GL_RED );
+		glTexParameteri( opengl_texture_type, SOIL_TEXTURE_SWIZZLE_G, SOIL_GL_GREEN );
+		glTexParameteri( opengl_texture_type, SOIL_TEXTURE_SWIZZLE_B, SOIL_GL_BLUE );
+		glTexParameteri( opengl_texture_type, SOIL_TEXTURE_SWIZZLE_A, GL_ALPHA );
+	}
+
+	/*	are any MIPmaps desired?	*/
+	if( flags & SOIL_FLAG_MIPMAPS || flags & SOIL_FLAG_GL_MIPMAPS )
+	{
+		/*	instruct OpenGL to use the MIPmaps	*/
+		glTexParameteri( opengl_texture_type, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+		glTexParameteri( opengl_texture_type, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
+		check_for_GL_errors( "GL_TEXTURE_MIN/MAG_FILTER" );
+	} else
+	{
+		/*	instruct OpenGL _NOT_ to use the MIPmaps	*/
+		glTexParameteri( opengl_texture_type, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+		glTexParameteri( opengl_texture_type, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+		check_for_GL_errors( "GL_TEXTURE_MIN/MAG_FILTER" );
+	}
+
+	/*	does the user want clamping, or wrapping?	*/
+	if( flags & SOIL_FLAG_TEXTURE_REPEATS )
+	{
+		glTexParameteri( opengl_texture_type, GL_TEXTURE_WRAP_S, GL_REPEAT );
+		glTexParameteri( opengl_texture_type, GL_TEXTURE_WRAP_T, GL_REPEAT );
+		if( opengl_texture_type == SOIL_TEXTURE_CUBE_MAP )
 		{
-			DXT_mode = query_DXT_capability();
-			if( DXT_mode == SOIL_CAPABILITY_PRESENT )
-			{
-				/*	I can use DXT, whether I compress it or OpenGL does	*/
-				if( (channels & 1) == 1 )
-				{
-					/*	1 or 3 channels = DXT1	*/
-					internal_texture_format = sRGB_texture ? SOIL_GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : SOIL_RGB_S3TC_DXT1;
-				} else
-				{
-					/*	2 or 4 channels = DXT5	*/
-					internal_texture_format = sRGB_texture ? SOIL_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : SOIL_RGBA_S3TC_DXT5;
-				}
-			}
+			/*	SOIL_TEXTURE_WRAP_R is invalid if cubemaps aren't supported	*/
+			glTexParameteri( opengl_texture_type, SOIL_TEXTURE_WRAP_R, GL_REPEAT );
 		}
-		else if ( sRGB_texture )
+		check_for_GL_errors( "GL_TEXTURE_WRAP_*" );
+	} else
+	{
+		unsigned int clamp_mode = SOIL_CLAMP_TO_EDGE;
+		/* unsigned int clamp_mode = GL_CLAMP; */
+		glTexParameteri( opengl_texture_type, GL_TEXTURE_WRAP_S, clamp_mode );
+		glTexParameteri( opengl_texture_type, GL_TEXTURE_WRAP_T, clamp_mode );
+		if( opengl_texture_type == SOIL_TEXTURE_CUBE_MAP )
 		{
-			switch( channels )
-			{
-			case 3:
-				internal_texture_format = SOIL_GL_SRGB;
-				break;
-			case 4:
-				internal_texture_format = SOIL_GL_SRGB_ALPHA;
-				break;
-			}
+			/*	SOIL_TEXTURE_WRAP_R is invalid if cubemaps aren't supported	*/
+			glTexParameteri( opengl_texture_type, SOIL_TEXTURE_WRAP_R, clamp_mode );
 		}
+		check_for_GL_errors( "GL_TEXTURE_WRAP_*" );
+	}
+}
+
+unsigned int
+	SOIL_internal_create_OGL_texture
+	(
+		const unsigned char *const data,
+		int *width, int *height, int channels,
+		unsigned int reuse_texture_ID,
+		unsigned int flags,
+		unsigned int opengl_texture_type,
+		unsigned int opengl_texture_target,
+		unsigned int texture_check_size_enum
+	)
+{
+	/*	variables	*/
+	unsigned char* img = NULL;
+	unsigned int tex_id;
+	unsigned int internal_texture_format = 0, original_texture_format = 0;
+	int DXT_mode = SOIL_CAPABILITY_UNKNOWN;
+	SOIL_texture_caps caps;
+	int iwidth, iheight;
+	int sub_image;
+	GLint unpack_aligment;
+
+	SOIL_internal_query_texture_caps( texture_check_size_enum, flags, &caps );
+	if( !SOIL_internal_prepare_image(
+			data, width, height, channels, &flags, &caps,
+			&opengl_texture_type, &opengl_texture_target, &img ) )
+	{
+		return 0;
+	}
+	iwidth = *width;
+	iheight = *height;
+
+	/*	create the OpenGL texture ID handle
+		(note: allowing a forced texture ID lets me reload a texture)	*/
+	tex_id = reuse_texture_ID;
+	if( tex_id == 0 )
+	{
+		glGenTextures( 1, &tex_id );
+	}
+	check_for_GL_errors( "glGenTextures" );
+	/* Note: sometimes glGenTextures fails (usually no OpenGL context)	*/
+	if( tex_id )
+	{
+		SOIL_internal_texture_formats( channels, flags, &caps,
+				&original_texture_format, &internal_texture_format, &DXT_mode );
 
 		/*  bind an OpenGL texture ID	*/
 		glBindTexture( opengl_texture_type, tex_id );
 		check_for_GL_errors( "glBindTexture" );
 
-		/* set the unpack aligment */
-		glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpack_aligment);
-		if ( 1 != unpack_aligment )
+		/*	a reused texture of the same size is updated in place	*/
+		sub_image = SOIL_internal_prepare_storage(
+				opengl_texture_type, opengl_texture_target, 0 != reuse_texture_ID,
+				internal_texture_format, iwidth, iheight,
+				( flags & ( SOIL_FLAG_MIPMAPS | SOIL_FLAG_GL_MIPMAPS ) ) ? SOIL_mip_level_count( iwidth, iheight ) : 1,
+				flags );
+		if( sub_image < 0 )
+		{
+			SOIL_free_image_data( img );
+			return 0;
+		}
+
+		/* set the unpack aligment */
+		glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpack_aligment);
+		if ( 1 != unpack_aligment )
 		{
 			glPixelStorei(GL_UNPACK_ALIGNMENT,1);
 		}
@@ -2681,21 +4085,14 @@ unsigned int
 		{
 			/*	user wants me to do the DXT conversion!	*/
 			int DDS_size;
-			unsigned char *DDS_data = NULL;
-			if( (channels & 1) == 1 )
-			{
-				/*	RGB, use DXT1	*/
-				DDS_data = convert_image_to_DXT1( NULL != img ? img : data, iwidth, iheight, channels, &DDS_size );
-			} else
-			{
-				/*	RGBA, use DXT5	*/
-				DDS_data = convert_image_to_DXT5( NULL != img ? img : data, iwidth, iheight, channels, &DDS_size );
-			}
+			unsigned char *DDS_data = SOIL_internal_compress_DXT(
+					NULL != img ? img : data, iwidth, iheight, channels, flags,
+					internal_texture_format, &DDS_size );
 			if( DDS_data )
 			{
-				soilGlCompressedTexImage2D(
-					opengl_texture_target, 0,
-					internal_texture_format, iwidth, iheight, 0,
+				SOIL_upload_compressed_tex_image_2D(
+					sub_image, opengl_texture_target, 0,
+					internal_texture_format, iwidth, iheight,
 					DDS_size, DDS_data );
 				check_for_GL_errors( "glCompressedTexImage2D" );
 				SOIL_free_image_data( DDS_data );
@@ -2703,20 +4100,22 @@ unsigned int
 			} else
 			{
 				/*	my compression failed, try the OpenGL driver's version	*/
-				glTexImage2D(
-					opengl_texture_target, 0,
-					internal_texture_format, iwidth, iheight, 0,
-					original_texture_format, GL_UNSIGNED_BYTE, NULL != img ? img : data );
+				SOIL_upload_tex_image_2D(
+					sub_image, opengl_texture_target, 0,
+					internal_texture_format, iwidth, iheight,
+					original_texture_format, GL_UNSIGNED_BYTE, NULL != img ? img : data,
+					(size_t)iwidth * iheight * channels );
 				check_for_GL_errors( "glTexImage2D" );
 				/*	printf( "OpenGL DXT compressor\n" );	*/
 			}
 		} else
 		{
 			/*	user want OpenGL to do all the work!	*/
-			glTexImage2D(
-				opengl_texture_target, 0,
-				internal_texture_format, iwidth, iheight, 0,
-				original_texture_format, GL_UNSIGNED_BYTE, NULL != img ? img : data );
+			SOIL_upload_tex_image_2D(
+				sub_image, opengl_texture_target, 0,
+				internal_texture_format, iwidth, iheight,
+				original_texture_format, GL_UNSIGNED_BYTE, NULL != img ? img : data,
+				(size_t)iwidth * iheight * channels );
 
 			check_for_GL_errors( "glTexImage2D" );
 			/*printf( "OpenGL DXT compressor\n" );	*/
@@ -2725,18 +4124,7 @@ unsigned int
 		/*	are any MIPmaps desired?	*/
 		if( flags & SOIL_FLAG_MIPMAPS || flags & SOIL_FLAG_GL_MIPMAPS )
 		{
-			createMipmaps( NULL != img ? img : data, iwidth, iheight, channels, flags, opengl_texture_target, internal_texture_format, original_texture_format, DXT_mode );
-
-			/*	instruct OpenGL to use the MIPmaps	*/
-			glTexParameteri( opengl_texture_type, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
-			glTexParameteri( opengl_texture_type, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
-			check_for_GL_errors( "GL_TEXTURE_MIN/MAG_FILTER" );
-		} else
-		{
-			/*	instruct OpenGL _NOT_ to use the MIPmaps	*/
-			glTexParameteri( opengl_texture_type, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
-			glTexParameteri( opengl_texture_type, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
-			check_for_GL_errors( "GL_TEXTURE_MIN/MAG_FILTER" );
+			createMipmaps( NULL != img ? img : data, iwidth, iheight, channels, flags, opengl_texture_target, internal_texture_format, original_texture_format, DXT_mode, sub_image );
 		}
 
 		/* recover the unpack aligment */
@@ -2745,41 +4133,698 @@ unsigned int
 			glPixelStorei(GL_UNPACK_ALIGNMENT, unpack_aligment);
 		}
 
-		/*	does the user want clamping, or wrapping?	*/
-		if( flags & SOIL_FLAG_TEXTURE_REPEATS )
+		SOIL_internal_set_texture_parameters( opengl_texture_type, flags, internal_texture_format );
+		/*	done	*/
+		SOIL_set_result( SOIL_RESULT_OK, "Image loaded as an OpenGL texture" );
+	} else
+	{
+		/*	failed	*/
+		SOIL_set_result( SOIL_RESULT_GL_ERROR, "Failed to generate an OpenGL texture name; missing OpenGL context?" );
+	}
+
+	SOIL_free_image_data( img );
+
+	return tex_id;
+}
+
+/*	asynchronous texture loading: the CPU work runs on the thread pool,
+	the OpenGL thread only uploads the prepared levels.
+	A request freed while the pool still runs its task is released by
+	the pool, once the task is done with it.	*/
+#define SOIL_ASYNC_MAX_LEVELS 32
+
+typedef struct
+{
+	unsigned char *data;
+	int width, height;
+	int size;
+	int compressed;
+} SOIL_async_level;
+
+struct SOIL_AsyncTexture
+{
+	/*	the request, read only once submitted	*/
+	char *filename;
+	const unsigned char *buffer;
+	int buffer_length;
+	int force_channels;
+	unsigned int reuse_texture_ID;
+	SOIL_texture_caps caps;
+	thread_pool_group group;
+	/*	written by the worker before the request is queued for upload	*/
+	unsigned int flags;
+	unsigned int opengl_texture_type;
+	unsigned int opengl_texture_target;
+	unsigned int internal_texture_format;
+	unsigned int original_texture_format;
+	int generate_mipmaps;
+	SOIL_async_level levels[SOIL_ASYNC_MAX_LEVELS];
+	int level_count;
+	/*	upload progress, only touched on the OpenGL thread	*/
+	unsigned int tex_id;
+	int sub_image;
+	int next_level;
+	/*	protected by the queue lock	*/
+	int state;
+	int cancelled;
+	int result_code;
+	const char *result_string;
+	/*	the pool let go of the request, and SOIL_async_free was called	*/
+	int task_done;
+	int released;
+	SOIL_AsyncTexture *next;
+};
+
+static struct
+{
+	SOIL_ThreadPool *pool;
+	struct thread_pool_mutex *lock;
+	/*	prepared requests, in submission order	*/
+	SOIL_AsyncTexture *ready_head;
+	SOIL_AsyncTexture *ready_tail;
+} SOIL_async_queue = { NULL, NULL, NULL, NULL };
+
+static void SOIL_async_free_levels( SOIL_AsyncTexture *request )
+{
+	int i;
+	for( i = 0; i < request->level_count; ++i )
+	{
+		SOIL_free_image_data( request->levels[i].data );
+		request->levels[i].data = NULL;
+	}
+	request->level_count = 0;
+}
+
+static void SOIL_async_destroy( SOIL_AsyncTexture *request )
+{
+	SOIL_async_free_levels( request );
+	free( request->filename );
+	free( request );
+}
+
+/*	takes ownership of image.  Builds the MIPmap chain and compresses
+	the levels, everything the upload needs	*/
+static int SOIL_async_build_levels(
+		SOIL_AsyncTexture *request,
+		unsigned char *image,
+		int width, int height, int channels,
+		int DXT_mode )
+{
+	int i;
+
+	request->levels[0].data = image;
+	request->levels[0].width = width;
+	request->levels[0].height = height;
+	request->levels[0].size = width * height * channels;
+	request->levels[0].compressed = 0;
+	request->level_count = 1;
+
+	if( ( request->flags & ( SOIL_FLAG_MIPMAPS | SOIL_FLAG_GL_MIPMAPS ) ) && !request->generate_mipmaps )
+	{
+		while( ( width > 1 || height > 1 ) && request->level_count < SOIL_ASYNC_MAX_LEVELS )
 		{
-			glTexParameteri( opengl_texture_type, GL_TEXTURE_WRAP_S, GL_REPEAT );
-			glTexParameteri( opengl_texture_type, GL_TEXTURE_WRAP_T, GL_REPEAT );
-			if( opengl_texture_type == SOIL_TEXTURE_CUBE_MAP )
+			SOIL_async_level *prev = &request->levels[request->level_count - 1];
+			SOIL_async_level *level = &request->levels[request->level_count];
+			width = SOIL_MIP_SIZE( width );
+			height = SOIL_MIP_SIZE( height );
+			level->data = (unsigned char*)malloc( width * height * channels );
+			if( NULL == level->data )
 			{
-				/*	SOIL_TEXTURE_WRAP_R is invalid if cubemaps aren't supported	*/
-				glTexParameteri( opengl_texture_type, SOIL_TEXTURE_WRAP_R, GL_REPEAT );
+				return 0;
 			}
-			check_for_GL_errors( "GL_TEXTURE_WRAP_*" );
-		} else
+			mipmap_image_next_level( prev->data, prev->width, prev->height, channels, level->data );
+			level->width = width;
+			level->height = height;
+			level->size = width * height * channels;
+			level->compressed = 0;
+			++request->level_count;
+		}
+	}
+
+	if( DXT_mode == SOIL_CAPABILITY_PRESENT )
+	{
+		/*	levels that fail to compress are left for the driver to compress	*/
+		for( i = 0; i < request->level_count; ++i )
 		{
-			unsigned int clamp_mode = SOIL_CLAMP_TO_EDGE;
-			/* unsigned int clamp_mode = GL_CLAMP; */
-			glTexParameteri( opengl_texture_type, GL_TEXTURE_WRAP_S, clamp_mode );
-			glTexParameteri( opengl_texture_type, GL_TEXTURE_WRAP_T, clamp_mode );
-			if( opengl_texture_type == SOIL_TEXTURE_CUBE_MAP )
+			SOIL_async_level *level = &request->levels[i];
+			int DDS_size;
+			unsigned char *DDS_data = SOIL_internal_compress_DXT(
+				level->data, level->width, level->height, channels, request->flags,
+				request->internal_texture_format, &DDS_size );
+			if( DDS_data )
 			{
-				/*	SOIL_TEXTURE_WRAP_R is invalid if cubemaps aren't supported	*/
-				glTexParameteri( opengl_texture_type, SOIL_TEXTURE_WRAP_R, clamp_mode );
+				SOIL_free_image_data( level->data );
+				level->data = DDS_data;
+				level->size = DDS_size;
+				level->compressed = 1;
 			}
-			check_for_GL_errors( "GL_TEXTURE_WRAP_*" );
 		}
-		/*	done	*/
-		result_string_pointer = "Image loaded as an OpenGL texture";
+	}
+
+	return 1;
+}
+
+/*	runs on the thread pool	*/
+static void SOIL_async_prepare( void *argument )
+{
+	SOIL_AsyncTexture *request = (SOIL_AsyncTexture *)argument;
+	unsigned char *img = NULL;
+	unsigned char *prepared = NULL;
+	int width = 0, height = 0, channels = 0;
+	int DXT_mode;
+	int cancelled;
+
+	thread_pool_mutex_lock( SOIL_async_queue.lock );
+	cancelled = request->cancelled;
+	thread_pool_mutex_unlock( SOIL_async_queue.lock );
+
+	if( !cancelled )
+	{
+		if( NULL != request->filename )
+		{
+			img = SOIL_load_image( request->filename, &width, &height, &channels, request->force_channels );
+		}
+		else
+		{
+			img = SOIL_load_image_from_memory( request->buffer, request->buffer_length,
+					&width, &height, &channels, request->force_channels );
+		}
+	}
+
+	if( NULL != img )
+	{
+		/*	channels holds the original number of channels, which may have been forced	*/
+		if( (request->force_channels >= 1) && (request->force_channels <= 4) )
+		{
+			channels = request->force_channels;
+		}
+
+		if( SOIL_internal_prepare_image(
+				img, &width, &height, channels, &request->flags, &request->caps,
+				&request->opengl_texture_type, &request->opengl_texture_target, &prepared ) )
+		{
+			if( NULL != prepared )
+			{
+				SOIL_free_image_data( img );
+				img = prepared;
+			}
+
+			SOIL_internal_texture_formats( channels, request->flags, &request->caps,
+					&request->original_texture_format, &request->internal_texture_format, &DXT_mode );
+			request->generate_mipmaps =
+				( request->flags & SOIL_FLAG_GL_MIPMAPS ) &&
+				request->caps.gen_mipmap == SOIL_CAPABILITY_PRESENT;
+
+			if( SOIL_async_build_levels( request, img, width, height, channels, DXT_mode ) )
+			{
+				SOIL_set_result( SOIL_RESULT_OK, "Image prepared for upload" );
+			}
+			else
+			{
+				SOIL_async_free_levels( request );
+				SOIL_set_result( SOIL_RESULT_OUT_OF_MEMORY, "malloc failed" );
+			}
+		}
+		else
+		{
+			SOIL_free_image_data( img );
+		}
+	}
+
+	thread_pool_mutex_lock( SOIL_async_queue.lock );
+	cancelled = request->cancelled;
+	if( !cancelled )
+	{
+		request->result_code = result_code;
+		request->result_string = result_string_pointer;
+		if( request->level_count > 0 )
+		{
+			request->state = SOIL_ASYNC_UPLOADING;
+			request->next = NULL;
+			if( NULL != SOIL_async_queue.ready_tail )
+			{
+				SOIL_async_queue.ready_tail->next = request;
+			}
+			else
+			{
+				SOIL_async_queue.ready_head = request;
+			}
+			SOIL_async_queue.ready_tail = request;
+		}
+		else
+		{
+			request->state = SOIL_ASYNC_FAILED;
+		}
+	}
+	thread_pool_mutex_unlock( SOIL_async_queue.lock );
+
+	if( cancelled )
+	{
+		SOIL_async_free_levels( request );
+	}
+}
+
+/*	runs on the thread pool after SOIL_async_prepare, once the pool
+	doesn't touch the request anymore	*/
+static void SOIL_async_task_done( void *argument )
+{
+	SOIL_AsyncTexture *request = (SOIL_AsyncTexture *)argument;
+	int released;
+
+	thread_pool_mutex_lock( SOIL_async_queue.lock );
+	request->task_done = 1;
+	released = request->released;
+	thread_pool_mutex_unlock( SOIL_async_queue.lock );
+
+	if( released )
+	{
+		SOIL_async_destroy( request );
+	}
+}
+
+/*	call with the queue lock held	*/
+static void SOIL_async_unqueue( SOIL_AsyncTexture *request )
+{
+	SOIL_AsyncTexture *prev = NULL;
+	SOIL_AsyncTexture *it = SOIL_async_queue.ready_head;
+
+	while( NULL != it && it != request )
+	{
+		prev = it;
+		it = it->next;
+	}
+	if( NULL == it )
+	{
+		return;
+	}
+
+	if( NULL != prev )
+	{
+		prev->next = request->next;
+	}
+	else
+	{
+		SOIL_async_queue.ready_head = request->next;
+	}
+	if( SOIL_async_queue.ready_tail == request )
+	{
+		SOIL_async_queue.ready_tail = prev;
+	}
+	request->next = NULL;
+}
+
+static void SOIL_async_finish( SOIL_AsyncTexture *request, int state )
+{
+	thread_pool_mutex_lock( SOIL_async_queue.lock );
+	SOIL_async_unqueue( request );
+	request->state = state;
+	thread_pool_mutex_unlock( SOIL_async_queue.lock );
+	SOIL_async_free_levels( request );
+}
+
+/*	uploads the next level of a prepared request.
+	Returns 1 once the request is done, then its state tells how it went.	*/
+static int SOIL_async_upload_level( SOIL_AsyncTexture *request )
+{
+	SOIL_async_level *level;
+	GLint unpack_aligment;
+
+	if( 0 == request->next_level )
+	{
+		/*	create the OpenGL texture ID handle	*/
+		request->tex_id = request->reuse_texture_ID;
+		if( request->tex_id == 0 )
+		{
+			glGenTextures( 1, &request->tex_id );
+		}
+		check_for_GL_errors( "glGenTextures" );
+		if( 0 == request->tex_id )
+		{
+			request->result_code = SOIL_RESULT_GL_ERROR;
+			request->result_string = "Failed to generate an OpenGL texture name; missing OpenGL context?";
+			SOIL_async_finish( request, SOIL_ASYNC_FAILED );
+			return 1;
+		}
+
+		/*	a reused texture of the same size is updated in place	*/
+		glBindTexture( request->opengl_texture_type, request->tex_id );
+		request->sub_image = SOIL_internal_prepare_storage(
+			request->opengl_texture_type, request->opengl_texture_target,
+			0 != request->reuse_texture_ID, request->internal_texture_format,
+			request->levels[0].width, request->levels[0].height,
+			request->generate_mipmaps ?
+				SOIL_mip_level_count( request->levels[0].width, request->levels[0].height ) :
+				request->level_count,
+			request->flags );
+		if( request->sub_image < 0 )
+		{
+			request->result_code = SOIL_last_result_code();
+			request->result_string = SOIL_last_result();
+			SOIL_async_finish( request, SOIL_ASYNC_FAILED );
+			return 1;
+		}
+	}
+
+	glBindTexture( request->opengl_texture_type, request->tex_id );
+	check_for_GL_errors( "glBindTexture" );
+
+	glGetIntegerv( GL_UNPACK_ALIGNMENT, &unpack_aligment );
+	if ( 1 != unpack_aligment )
+	{
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+	}
+
+	level = &request->levels[request->next_level];
+	if( level->compressed )
+	{
+		SOIL_upload_compressed_tex_image_2D(
+			request->sub_image, request->opengl_texture_target, request->next_level,
+			request->internal_texture_format, level->width, level->height,
+			level->size, level->data );
+		check_for_GL_errors( "glCompressedTexImage2D" );
 	} else
 	{
-		/*	failed	*/
-		result_string_pointer = "Failed to generate an OpenGL texture name; missing OpenGL context?";
+		SOIL_upload_tex_image_2D(
+			request->sub_image, request->opengl_texture_target, request->next_level,
+			request->internal_texture_format, level->width, level->height,
+			request->original_texture_format, GL_UNSIGNED_BYTE, level->data,
+			(size_t)level->size );
+		check_for_GL_errors( "glTexImage2D" );
 	}
 
-	SOIL_free_image_data( img );
+	if ( 1 != unpack_aligment )
+	{
+		glPixelStorei( GL_UNPACK_ALIGNMENT, unpack_aligment );
+	}
 
-	return tex_id;
+	/*	the level is on the GPU, release it right away	*/
+	SOIL_free_image_data( level->data );
+	level->data = NULL;
+
+	if( ++request->next_level < request->level_count )
+	{
+		return 0;
+	}
+
+	if( request->generate_mipmaps )
+	{
+		soil_gl()->soilGlGenerateMipmap( request->opengl_texture_target );
+	}
+	SOIL_internal_set_texture_parameters( request->opengl_texture_type, request->flags, request->internal_texture_format );
+	request->result_code = SOIL_RESULT_OK;
+	request->result_string = "Image loaded as an OpenGL texture";
+	SOIL_async_finish( request, SOIL_ASYNC_COMPLETE );
+	return 1;
+}
+
+static SOIL_AsyncTexture *
+	SOIL_async_submit
+	(
+		const char *filename,
+		const unsigned char *const buffer,
+		int buffer_length,
+		int force_channels,
+		unsigned int reuse_texture_ID,
+		unsigned int flags
+	)
+{
+	SOIL_AsyncTexture *request;
+
+	if( NULL == SOIL_async_queue.lock )
+	{
+		SOIL_async_queue.lock = thread_pool_mutex_create();
+		if( NULL == SOIL_async_queue.lock )
+		{
+			SOIL_set_result( SOIL_RESULT_OUT_OF_MEMORY, "malloc failed" );
+			return NULL;
+		}
+		SOIL_async_queue.pool = thread_pool_shared();
+	}
+
+	request = (SOIL_AsyncTexture *)malloc( sizeof(SOIL_AsyncTexture) );
+	if( NULL == request )
+	{
+		SOIL_set_result( SOIL_RESULT_OUT_OF_MEMORY, "malloc failed" );
+		return NULL;
+	}
+	memset( request, 0, sizeof(SOIL_AsyncTexture) );
+
+	if( NULL != filename )
+	{
+		request->filename = (char *)malloc( strlen( filename ) + 1 );
+		if( NULL == request->filename )
+		{
+			free( request );
+			SOIL_set_result( SOIL_RESULT_OUT_OF_MEMORY, "malloc failed" );
+			return NULL;
+		}
+		strcpy( request->filename, filename );
+	}
+	request->buffer = buffer;
+	request->buffer_length = buffer_length;
+	request->force_channels = force_channels;
+	request->reuse_texture_ID = reuse_texture_ID;
+	request->flags = flags;
+	request->opengl_texture_type = GL_TEXTURE_2D;
+	request->opengl_texture_target = GL_TEXTURE_2D;
+	request->state = SOIL_ASYNC_DECODING;
+	thread_pool_group_init( &request->group );
+
+	/*	the capabilities need OpenGL, so they are taken here	*/
+	SOIL_internal_query_texture_caps( GL_MAX_TEXTURE_SIZE, flags, &request->caps );
+	if( ( ( ( flags & (SOIL_FLAG_COMPRESS_TO_DXT | SOIL_FLAG_COMPRESS_TO_BC7 | SOIL_FLAG_COMPRESS_TO_ETC2) ) && request->caps.DXT == SOIL_CAPABILITY_PRESENT ) ||
+		request->caps.BPTC == SOIL_CAPABILITY_PRESENT || request->caps.ETC2 == SOIL_CAPABILITY_PRESENT ) &&
+		NULL == soil_gl()->soilGlCompressedTexImage2D )
+	{
+		soil_gl()->soilGlCompressedTexImage2D = get_glCompressedTexImage2D_addr();
+	}
+
+	if( NULL == SOIL_async_queue.pool ||
+		!thread_pool_submit_with_done( SOIL_async_queue.pool, &request->group,
+			SOIL_async_prepare, SOIL_async_task_done, request ) )
+	{
+		SOIL_async_prepare( request );
+		SOIL_async_task_done( request );
+	}
+
+	SOIL_set_result( SOIL_RESULT_OK, "Texture request queued" );
+	return request;
+}
+
+SOIL_AsyncTexture *
+	SOIL_load_OGL_texture_async
+	(
+		const char *filename,
+		int force_channels,
+		unsigned int reuse_texture_ID,
+		unsigned int flags
+	)
+{
+	if( NULL == filename )
+	{
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid texture filename" );
+		return NULL;
+	}
+	return SOIL_async_submit( filename, NULL, 0, force_channels, reuse_texture_ID, flags );
+}
+
+SOIL_AsyncTexture *
+	SOIL_load_OGL_texture_from_memory_async
+	(
+		const unsigned char *const buffer,
+		int buffer_length,
+		int force_channels,
+		unsigned int reuse_texture_ID,
+		unsigned int flags
+	)
+{
+	if( NULL == buffer || buffer_length <= 0 )
+	{
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid texture buffer" );
+		return NULL;
+	}
+	return SOIL_async_submit( NULL, buffer, buffer_length, force_channels, reuse_texture_ID, flags );
+}
+
+int
+	SOIL_async_pump
+	(
+		unsigned int budget_us
+	)
+{
+	double start = thread_pool_time_us();
+	int completed = 0;
+	int uploaded = 0;
+
+	if( NULL == SOIL_async_queue.lock )
+	{
+		return 0;
+	}
+
+	for( ;; )
+	{
+		SOIL_AsyncTexture *request;
+
+		if( uploaded > 0 && thread_pool_time_us() - start >= (double)budget_us )
+		{
+			break;
+		}
+
+		thread_pool_mutex_lock( SOIL_async_queue.lock );
+		request = SOIL_async_queue.ready_head;
+		thread_pool_mutex_unlock( SOIL_async_queue.lock );
+		if( NULL == request )
+		{
+			break;
+		}
+
+		++uploaded;
+		if( SOIL_async_upload_level( request ) && request->state == SOIL_ASYNC_COMPLETE )
+		{
+			++completed;
+		}
+	}
+
+	return completed;
+}
+
+int
+	SOIL_async_poll
+	(
+		SOIL_AsyncTexture *request
+	)
+{
+	int state;
+	thread_pool_mutex_lock( SOIL_async_queue.lock );
+	state = request->state;
+	thread_pool_mutex_unlock( SOIL_async_queue.lock );
+	return state;
+}
+
+unsigned int
+	SOIL_async_wait
+	(
+		SOIL_AsyncTexture *request
+	)
+{
+	if( NULL != SOIL_async_queue.pool )
+	{
+		thread_pool_wait( SOIL_async_queue.pool, &request->group );
+	}
+
+	if( SOIL_async_poll( request ) == SOIL_ASYNC_UPLOADING )
+	{
+		while( !SOIL_async_upload_level( request ) )
+		{
+		}
+	}
+
+	SOIL_set_result( request->result_code, request->result_string );
+	return SOIL_async_poll( request ) == SOIL_ASYNC_COMPLETE ? request->tex_id : 0;
+}
+
+int
+	SOIL_async_cancel
+	(
+		SOIL_AsyncTexture *request
+	)
+{
+	int state;
+
+	thread_pool_mutex_lock( SOIL_async_queue.lock );
+	state = request->state;
+	if( state == SOIL_ASYNC_DECODING || state == SOIL_ASYNC_UPLOADING )
+	{
+		SOIL_async_unqueue( request );
+		request->cancelled = 1;
+		request->state = SOIL_ASYNC_CANCELLED;
+		request->result_code = SOIL_RESULT_PROCESSING_FAILED;
+		request->result_string = "Texture request cancelled";
+	}
+	thread_pool_mutex_unlock( SOIL_async_queue.lock );
+
+	if( state == SOIL_ASYNC_UPLOADING )
+	{
+		/*	the worker is done with it, drop the prepared levels
+			and the texture name generated for a partial upload	*/
+		SOIL_async_free_levels( request );
+		if( request->next_level > 0 && 0 == request->reuse_texture_ID )
+		{
+			glDeleteTextures( 1, &request->tex_id );
+		}
+		request->tex_id = 0;
+	}
+
+	return state == SOIL_ASYNC_DECODING || state == SOIL_ASYNC_UPLOADING;
+}
+
+unsigned int
+	SOIL_async_texture_id
+	(
+		SOIL_AsyncTexture *request
+	)
+{
+	return SOIL_async_poll( request ) == SOIL_ASYNC_COMPLETE ? request->tex_id : 0;
+}
+
+int
+	SOIL_async_result_code
+	(
+		SOIL_AsyncTexture *request
+	)
+{
+	int code;
+	thread_pool_mutex_lock( SOIL_async_queue.lock );
+	code = request->result_code;
+	thread_pool_mutex_unlock( SOIL_async_queue.lock );
+	return code;
+}
+
+const char *
+	SOIL_async_result
+	(
+		SOIL_AsyncTexture *request
+	)
+{
+	const char *result;
+	thread_pool_mutex_lock( SOIL_async_queue.lock );
+	result = NULL != request->result_string ? request->result_string : "Texture request pending";
+	thread_pool_mutex_unlock( SOIL_async_queue.lock );
+	return result;
+}
+
+void
+	SOIL_async_free
+	(
+		SOIL_AsyncTexture *request
+	)
+{
+	int task_done;
+
+	if( NULL == request )
+	{
+		return;
+	}
+
+	SOIL_async_cancel( request );
+
+	/*	without workers the cancelled task only runs when waited for	*/
+	if( NULL != SOIL_async_queue.pool &&
+		0 == thread_pool_thread_count( SOIL_async_queue.pool ) )
+	{
+		thread_pool_wait( SOIL_async_queue.pool, &request->group );
+	}
+
+	/*	if the pool still holds the task, SOIL_async_task_done releases it	*/
+	thread_pool_mutex_lock( SOIL_async_queue.lock );
+	task_done = request->task_done;
+	request->released = 1;
+	thread_pool_mutex_unlock( SOIL_async_queue.lock );
+
+	if( task_done )
+	{
+		SOIL_async_destroy( request );
+	}
 }
 
 int
@@ -2799,17 +4844,17 @@ int
 	/*	error checks	*/
 	if( (width < 1) || (height < 1) )
 	{
-		result_string_pointer = "Invalid screenshot dimensions";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid screenshot dimensions" );
 		return 0;
 	}
 	if( (x < 0) || (y < 0) )
 	{
-		result_string_pointer = "Invalid screenshot location";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid screenshot location" );
 		return 0;
 	}
 	if( filename == NULL )
 	{
-		result_string_pointer = "Invalid screenshot filename";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid screenshot filename" );
 		return 0;
 	}
 
@@ -2859,14 +4904,30 @@ unsigned char*
 		int force_channels
 	)
 {
-	unsigned char *result = stbi_load( filename,
-			width, height, channels, force_channels );
+	unsigned char *result;
+	file_map map;
+	const int status = file_map_open( filename, &map );
+	if( status == FILE_MAP_OK )
+	{
+		result = stbi_load_from_memory( map.data, map.size,
+				width, height, channels, force_channels );
+		file_map_close( &map );
+	} else if( status == FILE_MAP_NOT_FOUND )
+	{
+		SOIL_set_result( SOIL_RESULT_FILE_NOT_FOUND, "Unable to open the image file" );
+		return NULL;
+	} else
+	{
+		/*	let stb_image report why the file can't be read	*/
+		result = stbi_load( filename,
+				width, height, channels, force_channels );
+	}
 	if( result == NULL )
 	{
-		result_string_pointer = stbi_failure_reason();
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, stbi_failure_reason() );
 	} else
 	{
-		result_string_pointer = "Image loaded";
+		SOIL_set_result( SOIL_RESULT_OK, "Image loaded" );
 	}
 	return result;
 }
@@ -2886,14 +4947,152 @@ unsigned char*
 				force_channels );
 	if( result == NULL )
 	{
-		result_string_pointer = stbi_failure_reason();
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, stbi_failure_reason() );
 	} else
 	{
-		result_string_pointer = "Image loaded from memory";
+		SOIL_set_result( SOIL_RESULT_OK, "Image loaded from memory" );
 	}
 	return result;
 }
 
+typedef struct
+{
+	const SOIL_LoadDesc *desc;
+	SOIL_Image *image;
+} SOIL_batch_item;
+
+/*	runs on a pool thread, the result is thread local so it is
+	copied to the image before the thread moves on	*/
+static void SOIL_load_batch_item( void *argument )
+{
+	SOIL_batch_item *item = (SOIL_batch_item *)argument;
+	const SOIL_LoadDesc *desc = item->desc;
+	SOIL_Image *image = item->image;
+
+	if( NULL != desc->filename )
+	{
+		image->data = SOIL_load_image( desc->filename,
+				&image->width, &image->height, &image->channels,
+				desc->force_channels );
+	}
+	else if( NULL != desc->buffer && desc->buffer_length > 0 )
+	{
+		image->data = SOIL_load_image_from_memory( desc->buffer, desc->buffer_length,
+				&image->width, &image->height, &image->channels,
+				desc->force_channels );
+	}
+	else
+	{
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Batch item has neither a filename nor a buffer" );
+	}
+
+	image->result_code = result_code;
+	image->result_string = result_string_pointer;
+}
+
+SOIL_ThreadPool *
+	SOIL_create_thread_pool
+	(
+		int thread_count
+	)
+{
+	SOIL_ThreadPool *pool = thread_pool_create( thread_count );
+	if( NULL == pool )
+	{
+		SOIL_set_result( SOIL_RESULT_OUT_OF_MEMORY, "Failed to create the thread pool" );
+	}
+	return pool;
+}
+
+void
+	SOIL_free_thread_pool
+	(
+		SOIL_ThreadPool *pool
+	)
+{
+	thread_pool_destroy( pool );
+}
+
+int
+	SOIL_load_images_batch
+	(
+		const SOIL_LoadDesc *descs,
+		int count,
+		SOIL_Image *images
+	)
+{
+	return SOIL_load_images_batch_pool( thread_pool_shared(), descs, count, images );
+}
+
+int
+	SOIL_load_images_batch_pool
+	(
+		SOIL_ThreadPool *pool,
+		const SOIL_LoadDesc *descs,
+		int count,
+		SOIL_Image *images
+	)
+{
+	SOIL_batch_item *items;
+	thread_pool_group group;
+	int first_failure = -1;
+	int loaded = 0;
+	int i;
+
+	if( NULL == descs || NULL == images || count <= 0 )
+	{
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid batch" );
+		return 0;
+	}
+
+	memset( images, 0, count * sizeof(SOIL_Image) );
+	items = (SOIL_batch_item *)malloc( count * sizeof(SOIL_batch_item) );
+	if( NULL == items )
+	{
+		SOIL_set_result( SOIL_RESULT_OUT_OF_MEMORY, "malloc failed" );
+		return 0;
+	}
+
+	thread_pool_group_init( &group );
+	for( i = 0; i < count; ++i )
+	{
+		items[i].desc = &descs[i];
+		items[i].image = &images[i];
+		/*	without a pool, or when it can't take more work, decode here	*/
+		if( NULL == pool || !thread_pool_submit( pool, &group, SOIL_load_batch_item, &items[i] ) )
+		{
+			SOIL_load_batch_item( &items[i] );
+		}
+	}
+	if( NULL != pool )
+	{
+		thread_pool_wait( pool, &group );
+	}
+	free( items );
+
+	for( i = 0; i < count; ++i )
+	{
+		if( NULL != images[i].data )
+		{
+			++loaded;
+		}
+		else if( first_failure < 0 )
+		{
+			first_failure = i;
+		}
+	}
+
+	if( first_failure < 0 )
+	{
+		SOIL_set_result( SOIL_RESULT_OK, "Image batch loaded" );
+	}
+	else
+	{
+		SOIL_set_result( images[first_failure].result_code, images[first_failure].result_string );
+	}
+	return loaded;
+}
+
 
 int
 	SOIL_save_image
@@ -2954,6 +5153,11 @@ int
 	if ( image_type == SOIL_SAVE_TYPE_QOI )
 	{
 		save_result = stbi_write_qoi( filename, width, height, channels, (const void*)data );
+	} else
+	if( image_type == SOIL_SAVE_TYPE_PKM )
+	{
+		save_result = save_image_as_PKM( filename,
+				width, height, channels, (const unsigned char *const)data, 0 );
 	}
 	else
 	{
@@ -2962,14 +5166,67 @@ int
 
 	if( save_result == 0 )
 	{
-		result_string_pointer = "Saving the image failed";
+		SOIL_set_result( SOIL_RESULT_IO_ERROR, "Saving the image failed" );
 	} else
 	{
-		result_string_pointer = "Image saved";
+		SOIL_set_result( SOIL_RESULT_OK, "Image saved" );
 	}
 	return save_result;
 }
 
+int
+	SOIL_save_image_DDS
+	(
+		const char *filename,
+		int width, int height, int channels,
+		const unsigned char *const data,
+		unsigned int flags,
+		double *rmse, double *psnr
+	)
+{
+	DXT_error error;
+	/*	1 and 2 channel images are saved as BC4 and BC5	*/
+	unsigned int options = DXT_COMPRESS_RGTC;
+
+	/*	error check	*/
+	if( (width < 1) || (height < 1) ||
+		(channels < 1) || (channels > 4) ||
+		(data == NULL) ||
+		(filename == NULL) )
+	{
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "Invalid image to save" );
+		return 0;
+	}
+	if( flags & SOIL_FLAG_DXT_DETERMINISTIC )
+	{
+		options |= DXT_COMPRESS_DETERMINISTIC;
+	}
+	if( flags & SOIL_FLAG_DXT_HIGH_QUALITY )
+	{
+		options |= DXT_COMPRESS_CLUSTER_FIT;
+	}
+	if( flags & SOIL_FLAG_COMPRESS_TO_BC7 )
+	{
+		options |= DXT_COMPRESS_BC7;
+	}
+	if( !save_image_as_DDS_ex( filename, width, height, channels, data, options,
+		( rmse || psnr ) ? &error : NULL ) )
+	{
+		SOIL_set_result( SOIL_RESULT_IO_ERROR, "Saving the image failed" );
+		return 0;
+	}
+	if( rmse )
+	{
+		*rmse = error.RMSE;
+	}
+	if( psnr )
+	{
+		*psnr = error.PSNR;
+	}
+	SOIL_set_result( SOIL_RESULT_OK, "Image saved" );
+	return 1;
+}
+
 
 typedef struct
 {
@@ -3070,7 +5327,7 @@ SOIL_write_image_to_memory_quality
 	{
 		save_result = stbi_write_tga_to_func(write_to_memory, &context, width, height, channels, (const unsigned char*)data);
 	}
-	else if (image_type == SOIL_SAVE_TYPE_DDS)
+	else if (image_type == SOIL_SAVE_TYPE_DDS || image_type == SOIL_SAVE_TYPE_PKM)
 	{
 		save_result = 0; // not supported thru stbi
 	}
@@ -3104,11 +5361,11 @@ SOIL_write_image_to_memory_quality
 
 	if (save_result == 0)
 	{
-		result_string_pointer = "writing the image failed";
+		SOIL_set_result( SOIL_RESULT_IO_ERROR, "writing the image failed" );
 	}
 	else
 	{
-		result_string_pointer = "Image written";
+		SOIL_set_result( SOIL_RESULT_OK, "Image written" );
 	}
 
 	return imageMemory;
@@ -3146,6 +5403,106 @@ const char*
 	return result_string_pointer;
 }
 
+int
+	SOIL_last_result_code
+	(
+		void
+	)
+{
+	return result_code;
+}
+
+/*	Picks the block format a texture of the TRANSCODE_* source_format
+	is converted to when the context can't sample it, from the cached
+	capabilities: BC, then ETC, then BPTC for color, RGTC for EAC.
+	Returns 0 if the context has no block format to convert to.	*/
+static int SOIL_internal_transcode_target(
+	int source_format,
+	int has_alpha,
+	int sRGB,
+	int *target_format,
+	unsigned int *internal_format )
+{
+	if( source_format == TRANSCODE_EAC_R11 || source_format == TRANSCODE_EAC_RG11 )
+	{
+		if( query_3Dc_capability() != SOIL_CAPABILITY_PRESENT )
+			return 0;
+		*target_format = ( source_format == TRANSCODE_EAC_R11 ) ? TRANSCODE_BC4 : TRANSCODE_BC5;
+		*internal_format = ( source_format == TRANSCODE_EAC_R11 ) ?
+			SOIL_COMPRESSED_RED_RGTC1 : SOIL_COMPRESSED_RG_RGTC2;
+	}
+	else if( source_format == TRANSCODE_BC4 || source_format == TRANSCODE_BC5 )
+	{
+		/*	there's no EAC encoder	*/
+		return 0;
+	}
+	else if( query_DXT_capability() == SOIL_CAPABILITY_PRESENT )
+	{
+		*target_format = has_alpha ? TRANSCODE_BC3 : TRANSCODE_BC1;
+		if( sRGB )
+			*internal_format = has_alpha ? SOIL_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : SOIL_GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;
+		else
+			*internal_format = has_alpha ? SOIL_RGBA_S3TC_DXT5 : SOIL_RGB_S3TC_DXT1;
+	}
+	else if( query_ETC2_EAC_capability() == SOIL_CAPABILITY_PRESENT )
+	{
+		*target_format = has_alpha ? TRANSCODE_ETC2_RGBA8 : TRANSCODE_ETC2_RGB8;
+		if( sRGB )
+			*internal_format = has_alpha ? SOIL_GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC : SOIL_GL_COMPRESSED_SRGB8_ETC2;
+		else
+			*internal_format = has_alpha ? SOIL_GL_COMPRESSED_RGBA8_ETC2_EAC : SOIL_GL_COMPRESSED_RGB8_ETC2;
+	}
+	else if( !has_alpha && !sRGB &&
+	         query_ETC1_capability() == SOIL_CAPABILITY_PRESENT )
+	{
+		*target_format = TRANSCODE_ETC1;
+		*internal_format = SOIL_GL_ETC1_RGB8_OES;
+	}
+	else if( query_BPTC_capability() == SOIL_CAPABILITY_PRESENT )
+	{
+		*target_format = TRANSCODE_BC7;
+		*internal_format = sRGB ? SOIL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM : SOIL_COMPRESSED_RGBA_BPTC_UNORM;
+	}
+	else
+	{
+		return 0;
+	}
+	/*	the ETC2 query doesn't load it	*/
+	if( NULL == soil_gl()->soilGlCompressedTexImage2D )
+		soil_gl()->soilGlCompressedTexImage2D = get_glCompressedTexImage2D_addr();
+	return NULL != soil_gl()->soilGlCompressedTexImage2D;
+}
+
+/*	uploads a level of blocks, transcoded first when transcode_from is
+	a TRANSCODE_* format and not -1	*/
+static int SOIL_upload_compressed_level(
+	int sub_image,
+	GLenum target, GLint level, GLenum internal_format,
+	GLsizei width, GLsizei height,
+	GLsizei size, const unsigned char *data,
+	int transcode_from, int transcode_to )
+{
+	unsigned char *transcoded;
+	int transcoded_size;
+	if( transcode_from < 0 )
+	{
+		SOIL_upload_compressed_tex_image_2D(
+			sub_image, target, level, internal_format, width, height, size, data );
+		return 1;
+	}
+	transcoded = transcode_image(
+		data, width, height, transcode_from, transcode_to, &transcoded_size );
+	if( NULL == transcoded )
+	{
+		SOIL_set_result( SOIL_RESULT_OUT_OF_MEMORY, "Could not transcode the texture blocks" );
+		return 0;
+	}
+	SOIL_upload_compressed_tex_image_2D(
+		sub_image, target, level, internal_format, width, height, transcoded_size, transcoded );
+	free( transcoded );
+	return 1;
+}
+
 /* This circumvent a VS2022 compiler bug */
 #ifdef _MSC_VER
 #pragma optimize( "", off )
@@ -3299,33 +5656,488 @@ static int SOIL_DDS_map_uncompressed_dxgi(
 	}
 }
 
-unsigned int SOIL_direct_load_DDS_from_memory(
-		const unsigned char *const buffer,
-		const int buffer_length,
+/*	where the direct loaders take the levels of a file from: all of the
+	file in memory, or a stream whose levels are read one at a time into
+	a staging buffer.  A stream's length isn't known, its reads fail at
+	the end of the file instead.	*/
+typedef struct
+{
+	const unsigned char *memory;
+	unsigned long long length;
+	const SOIL_io_callbacks *callbacks;
+	void *user;
+	unsigned long long position;
+	unsigned char *staging;
+	unsigned long long staging_size;
+	unsigned long long staged_offset;
+	unsigned long long staged_size;
+} SOIL_level_source;
+
+#define SOIL_STREAM_LENGTH	0x7fffffffULL
+
+static void SOIL_level_source_memory( SOIL_level_source *source, const unsigned char *buffer, int buffer_length )
+{
+	memset( source, 0, sizeof( *source ) );
+	source->memory = buffer;
+	source->length = buffer_length > 0 ? (unsigned long long)buffer_length : 0;
+}
+
+static void SOIL_level_source_stream( SOIL_level_source *source, const SOIL_io_callbacks *callbacks, void *user )
+{
+	memset( source, 0, sizeof( *source ) );
+	source->length = SOIL_STREAM_LENGTH;
+	source->callbacks = callbacks;
+	source->user = user;
+}
+
+/*	moves a stream to offset, skip takes an int so a long way is taken in steps	*/
+static void SOIL_level_source_seek( SOIL_level_source *source, unsigned long long offset )
+{
+	while( source->position != offset )
+	{
+		const long long distance = (long long)offset - (long long)source->position;
+		const int step = distance > 0x40000000 ? 0x40000000 :
+			distance < -0x40000000 ? -0x40000000 : (int)distance;
+		source->callbacks->skip( source->user, step );
+		source->position += step;
+	}
+}
+
+/*	whether a stream has a byte at offset	*/
+static int SOIL_level_source_probe( SOIL_level_source *source, unsigned long long offset )
+{
+	char byte;
+	SOIL_level_source_seek( source, offset );
+	if( source->callbacks->read( source->user, &byte, 1 ) != 1 )
+	{
+		return 0;
+	}
+	source->position += 1;
+	return 1;
+}
+
+/*	size bytes from offset, valid until the next read, or NULL past the
+	end of the file.  Asking for the last bytes read again doesn't read
+	them again.	*/
+static const unsigned char *SOIL_level_source_read(
+		SOIL_level_source *source, unsigned long long offset, unsigned long long size )
+{
+	unsigned long long total = 0;
+
+	if( offset > source->length || size > source->length - offset )
+	{
+		return NULL;
+	}
+	if( NULL != source->memory )
+	{
+		return &source->memory[offset];
+	}
+	if( NULL != source->staging && offset == source->staged_offset && size <= source->staged_size )
+	{
+		return source->staging;
+	}
+
+	if( size > source->staging_size || NULL == source->staging )
+	{
+		unsigned char *staging;
+		/*	a bogus size from a header fails here, not with the allocation	*/
+		if( size > 1 && !SOIL_level_source_probe( source, offset + size - 1 ) )
+		{
+			return NULL;
+		}
+		staging = (unsigned char*)realloc( source->staging, size > 0 ? (size_t)size : 1 );
+		if( NULL == staging )
+		{
+			return NULL;
+		}
+		source->staging = staging;
+		source->staging_size = size;
+	}
+	source->staged_size = 0;
+
+	SOIL_level_source_seek( source, offset );
+	while( total < size )
+	{
+		const unsigned long long left = size - total;
+		const int bytes_read = source->callbacks->read( source->user,
+			(char*)&source->staging[total], left > 0x40000000 ? 0x40000000 : (int)left );
+		if( bytes_read <= 0 )
+		{
+			break;
+		}
+		total += bytes_read;
+	}
+	source->position += total;
+	if( total != size )
+	{
+		return NULL;
+	}
+
+	source->staged_offset = offset;
+	source->staged_size = size;
+	return source->staging;
+}
+
+/*	whether the file is at least end bytes long, a stream is checked by
+	reading its last byte, before any storage is made for a bogus size	*/
+static int SOIL_level_source_has( SOIL_level_source *source, unsigned long long end )
+{
+	if( end > source->length )
+	{
+		return 0;
+	}
+	return NULL != source->memory || 0 == end ||
+		SOIL_level_source_probe( source, end - 1 );
+}
+
+/*	a stream is only read up to SOIL_STREAM_LENGTH, so a larger one looks
+	too small to the loaders, tell the two apart by its byte there	*/
+static void SOIL_level_source_check_length( SOIL_level_source *source )
+{
+	if( NULL == source->memory && SOIL_RESULT_DECODE_FAILED == result_code &&
+		SOIL_level_source_probe( source, SOIL_STREAM_LENGTH ) )
+	{
+		SOIL_set_result( SOIL_RESULT_IO_ERROR, "The stream is larger than 2GB" );
+	}
+}
+
+static void SOIL_level_source_close( SOIL_level_source *source )
+{
+	free( source->staging );
+	source->staging = NULL;
+	source->staging_size = 0;
+	source->staged_size = 0;
+}
+
+/*	the bytes one level of a DDS takes per layer or slice	*/
+static unsigned long long SOIL_DDS_slice_size(
+		unsigned int w, unsigned int h, unsigned int row_pitch,
+		int block_compressed, unsigned int block_size )
+{
+	if( block_compressed )
+	{
+		return (unsigned long long)( ( w + 3 ) / 4 ) * ( ( h + 3 ) / 4 ) * block_size;
+	}
+	return (unsigned long long)row_pitch * h;
+}
+
+/*	DX10 arrays, cubemap arrays and volume textures.  An array holds the
+	mip chain of each layer (each face of each cubemap) one after the
+	other, a volume holds all the slices of a level before the next level.
+	The levels get their storage first and are then uploaded straight from
+	the file, one layer at a time when the chains are interleaved.  The
+	levels above first_level are stepped over and never read.	*/
+static unsigned int SOIL_direct_load_DDS_layers(
+		const DDS_header *header,
+		SOIL_level_source *input,
+		unsigned int data_offset,
+		unsigned int data_length,
+		unsigned int array_size,
+		int cubemap,
+		int volume,
+		int block_compressed,
+		unsigned int block_size,
+		unsigned int internal_format,
+		unsigned int external_format,
+		unsigned int format_type,
+		int swizzle_red_blue,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int skip_mips,
+		int max_dimension )
+{
+#if defined( SOIL_IMAGE_ARRAY_SUPPORT )
+	const unsigned int depth = ( volume && header->dwDepth > 0 ) ? header->dwDepth : 1;
+	const unsigned int levels =
+		( ( header->sCaps.dwCaps1 & DDSCAPS_MIPMAP ) && header->dwMipMapCount > 1 ) ?
+			header->dwMipMapCount : 1;
+	const GLenum target = volume ? GL_TEXTURE_3D :
+		cubemap ? SOIL_TEXTURE_CUBE_MAP_ARRAY : GL_TEXTURE_2D_ARRAY;
+	const int has_row_length =
+		( query_unpack_row_length_capability() == SOIL_CAPABILITY_PRESENT );
+	const unsigned int tight_row_pitch = header->dwWidth * block_size;
+	unsigned int source_row_pitch = tight_row_pitch;
+	GLint row_alignment = 1;
+	GLint row_length = 0;
+	GLint unpack_alignment;
+	GLint unpack_row_length = 0;
+	GLint immutable = 0;
+	unsigned long long chain_size = 0;
+	unsigned long long level_offset = 0;
+	unsigned int tex_ID = reuse_texture_ID;
+	unsigned int layers;
+	unsigned int first_level;
+	unsigned int w, h, d, level;
+	int complete = 1;
+
+	/*	six faces for each cubemap of the array	*/
+	if( cubemap && array_size > UINT_MAX / 6 )
+	{
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "Invalid DX10 DDS array size" );
+		return 0;
+	}
+	layers = cubemap ? array_size * 6 : array_size;
+
+	if( query_teximage3d_capability() != SOIL_CAPABILITY_PRESENT ||
+		( block_compressed &&
+		  ( NULL == soil_gl()->soilGlCompressedTexImage3D ||
+		    NULL == soil_gl()->soilGlCompressedTexSubImage3D ) ) )
+	{
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "OpenGL 3D textures not supported" );
+		return 0;
+	}
+	if( cubemap && query_cubemap_array_capability() != SOIL_CAPABILITY_PRESENT )
+	{
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "Cubemap arrays not supported by the OpenGL driver" );
+		return 0;
+	}
+
+	/*	the chains of an array are interleaved, a level too many would
+		shift every layer after the first; block_size is per 4x4 block
+		for compressed formats, so the first row is a row of blocks	*/
+	if( header->dwWidth == 0 || header->dwHeight == 0 ||
+		( block_compressed ? ( ( (unsigned long long)header->dwWidth + 3 ) / 4 ) * block_size :
+			(unsigned long long)header->dwWidth * block_size ) > data_length ||
+		levels > (unsigned int)SOIL_mip_level_count(
+			header->dwWidth > depth ? header->dwWidth : depth, header->dwHeight ) )
+	{
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "Invalid DDS size or mip count" );
+		return 0;
+	}
+
+	/*	only the top level may have padded rows, like a 2D DDS	*/
+	if( !block_compressed && ( header->dwFlags & DDSD_PITCH ) &&
+		header->dwPitchOrLinearSize >= tight_row_pitch )
+	{
+		source_row_pitch = header->dwPitchOrLinearSize;
+		if( !SOIL_DDS_unpack_rows( tight_row_pitch, source_row_pitch, block_size,
+				has_row_length, &row_alignment, &row_length ) )
+		{
+			SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "The OpenGL driver can't unpack the padded rows of this DDS" );
+			return 0;
+		}
+	}
+
+	/*	the chain of one layer, or the whole volume	*/
+	w = header->dwWidth;
+	h = header->dwHeight;
+	d = depth;
+	for( level = 0; level < levels; ++level )
+	{
+		const unsigned long long slice_size = SOIL_DDS_slice_size(
+			w, h, level ? w * block_size : source_row_pitch, block_compressed, block_size );
+		/*	checked as it goes, the sizes in the header can be anything	*/
+		if( slice_size > data_length || slice_size * d > data_length - chain_size )
+		{
+			chain_size = (unsigned long long)data_length + 1;
+			break;
+		}
+		chain_size += slice_size * d;
+		w = SOIL_MIP_SIZE( w );
+		h = SOIL_MIP_SIZE( h );
+		d = volume ? SOIL_MIP_SIZE( d ) : 1;
+	}
+	if( chain_size * ( volume ? 1 : layers ) > data_length ||
+		!SOIL_level_source_has( input, data_offset + chain_size * ( volume ? 1 : layers ) ) )
+	{
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "DDS file was too small for expected image data" );
+		return 0;
+	}
+
+	/*	a volume is skipped by its largest side, slices included	*/
+	first_level = SOIL_first_kept_level( header->dwWidth, header->dwHeight,
+		volume ? depth : 1, levels, skip_mips, max_dimension );
+	w = header->dwWidth;
+	h = header->dwHeight;
+	d = depth;
+	for( level = 0; level < first_level; ++level )
+	{
+		w = SOIL_MIP_SIZE( w );
+		h = SOIL_MIP_SIZE( h );
+		d = volume ? SOIL_MIP_SIZE( d ) : 1;
+	}
+
+	if( tex_ID == 0 ) { glGenTextures( 1, &tex_ID ); }
+	glBindTexture( target, tex_ID );
+
+	/*	immutable storage is filled in place, if the image fits it	*/
+	if( query_tex_storage_capability() == SOIL_CAPABILITY_PRESENT )
+	{
+		glGetTexParameteriv( target, SOIL_GL_TEXTURE_IMMUTABLE_FORMAT, &immutable );
+	}
+	if( immutable &&
+		!SOIL_internal_storage_matches( target, target, internal_format,
+			w, h, volume ? d : layers, levels - first_level, immutable ) )
+	{
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "The image doesn't fit the immutable texture storage" );
+		return 0;
+	}
+	if( !immutable )
+	{
+		SOIL_internal_allocate_levels_3D( target, internal_format, external_format, format_type,
+			block_compressed ? block_size : 0,
+			w, h, volume ? d : layers, levels - first_level );
+	}
+
+	glGetIntegerv( GL_UNPACK_ALIGNMENT, &unpack_alignment );
+	if( unpack_alignment != 1 )
+	{
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+	}
+	if( has_row_length )
+	{
+		glGetIntegerv( GL_UNPACK_ROW_LENGTH, &unpack_row_length );
+		if( unpack_row_length != 0 )
+		{
+			glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 );
+		}
+	}
+
+	w = header->dwWidth;
+	h = header->dwHeight;
+	d = depth;
+	for( level = 0; level < levels; ++level )
+	{
+		const unsigned int row_pitch = level ? w * block_size : source_row_pitch;
+		const unsigned long long slice_size =
+			SOIL_DDS_slice_size( w, h, row_pitch, block_compressed, block_size );
+		/*	a volume level is one upload, so is a single level array in
+			memory, a stream stages it one layer at a time	*/
+		const int whole_level = volume || ( levels == 1 && NULL != input->memory );
+		const unsigned int uploads = whole_level ? 1 : layers;
+		const unsigned int count = volume ? d : ( whole_level ? layers : 1 );
+		unsigned int layer;
+
+		if( level < first_level )
+		{
+			level_offset += slice_size * d;
+			w = SOIL_MIP_SIZE( w );
+			h = SOIL_MIP_SIZE( h );
+			d = volume ? SOIL_MIP_SIZE( d ) : 1;
+			continue;
+		}
+		if( level == 0 && row_alignment != 1 )
+		{
+			glPixelStorei( GL_UNPACK_ALIGNMENT, row_alignment );
+		}
+		if( level == 0 && row_length != 0 )
+		{
+			glPixelStorei( GL_UNPACK_ROW_LENGTH, row_length );
+		}
+		for( layer = 0; layer < uploads; ++layer )
+		{
+			const unsigned char *source = SOIL_level_source_read( input,
+				data_offset + layer * chain_size + level_offset, slice_size * count );
+			if( NULL == source )
+			{
+				complete = 0;
+				break;
+			}
+			if( block_compressed )
+			{
+				SOIL_upload_compressed_tex_sub_image_3D( target, level - first_level, layer, w, h, count,
+					internal_format, (GLsizei)( slice_size * count ), source );
+			}
+			else
+			{
+				/*	the last row of the last slice isn't padded	*/
+				SOIL_upload_tex_sub_image_3D( target, level - first_level, 0, 0, layer, w, h, count,
+					external_format, format_type, source,
+					(size_t)( slice_size * ( count - 1 ) ) + row_pitch * ( h - 1 ) + w * block_size );
+			}
+		}
+		if( level == 0 && row_alignment != 1 )
+		{
+			glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+		}
+		if( level == 0 && row_length != 0 )
+		{
+			glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 );
+		}
+		if( !complete )
+		{
+			break;
+		}
+
+		level_offset += slice_size * d;
+		w = SOIL_MIP_SIZE( w );
+		h = SOIL_MIP_SIZE( h );
+		d = volume ? SOIL_MIP_SIZE( d ) : 1;
+	}
+
+	if( unpack_alignment != 1 )
+	{
+		glPixelStorei( GL_UNPACK_ALIGNMENT, unpack_alignment );
+	}
+	if( unpack_row_length != 0 )
+	{
+		glPixelStorei( GL_UNPACK_ROW_LENGTH, unpack_row_length );
+	}
+	if( !complete )
+	{
+		if( 0 == reuse_texture_ID )
+		{
+			glDeleteTextures( 1, &tex_ID );
+		}
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "DDS file was too small for expected image data" );
+		return 0;
+	}
+
+	/*	sample only the levels in the file	*/
+	glTexParameteri( target, SOIL_TEXTURE_MAX_LEVEL, levels - first_level - 1 );
+	glTexParameteri( target, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+	glTexParameteri( target, GL_TEXTURE_MIN_FILTER, levels - first_level > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR );
+	{
+		const GLint wrap = ( flags & SOIL_FLAG_TEXTURE_REPEATS ) ? GL_REPEAT : SOIL_CLAMP_TO_EDGE;
+		glTexParameteri( target, GL_TEXTURE_WRAP_S, wrap );
+		glTexParameteri( target, GL_TEXTURE_WRAP_T, wrap );
+		glTexParameteri( target, SOIL_TEXTURE_WRAP_R, wrap );
+	}
+	if( query_texture_swizzle_capability() == SOIL_CAPABILITY_PRESENT )
+	{
+		glTexParameteri( target, SOIL_TEXTURE_SWIZZLE_R, swizzle_red_blue ? SOIL_GL_BLUE : SOIL_GL_RED );
+		glTexParameteri( target, SOIL_TEXTURE_SWIZZLE_G, SOIL_GL_GREEN );
+		glTexParameteri( target, SOIL_TEXTURE_SWIZZLE_B, swizzle_red_blue ? SOIL_GL_RED : SOIL_GL_BLUE );
+		glTexParameteri( target, SOIL_TEXTURE_SWIZZLE_A, GL_ALPHA );
+	}
+
+	SOIL_set_result( SOIL_RESULT_OK, "DDS file loaded" );
+	return tex_ID;
+#else
+	(void)header; (void)input; (void)data_offset; (void)data_length; (void)array_size;
+	(void)cubemap; (void)volume; (void)block_compressed; (void)block_size;
+	(void)internal_format; (void)external_format; (void)format_type;
+	(void)swizzle_red_blue; (void)reuse_texture_ID; (void)flags;
+	(void)skip_mips; (void)max_dimension;
+	SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "OpenGL 3D textures not supported" );
+	return 0;
+#endif
+}
+
+/*	the DDS loader, on a file in memory or a stream	*/
+static unsigned int SOIL_internal_direct_load_DDS(
+		SOIL_level_source *input,
 		const unsigned int reuse_texture_ID,
 		const int flags,
-		const int loading_as_cubemap)
+		const int loading_as_cubemap,
+		const int skip_mips,
+		const int max_dimension )
 {
-	/*	1st off, does the filename even exist?	*/
-	if( NULL == buffer )
-	{
-		/*	we can't do it!	*/
-		result_string_pointer = "NULL buffer";
-		return 0;
-	}
-	if( buffer_length < (int)sizeof( DDS_header ) )
+	const int buffer_length = (int)input->length;
+	const unsigned char *bytes = SOIL_level_source_read( input, 0, sizeof( DDS_header ) );
+	if( NULL == bytes )
 	{
-		result_string_pointer = "DDS file was too small to contain the DDS header";
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "DDS file was too small to contain the DDS header" );
 		return 0;
 	}
 
 	// Try reading in the header
 	DDS_header header;
-	memcpy( &header, buffer, sizeof( DDS_header ) );
+	memcpy( &header, bytes, sizeof( DDS_header ) );
 
 	unsigned int buffer_index = sizeof(DDS_header);
 	/*	guilty until proven innocent	*/
-	result_string_pointer = "Failed to read a known DDS header";
+	SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "Failed to read a known DDS header" );
 	/*	validate the header (warning, "goto"'s ahead, shield your eyes!!)	*/
 	const unsigned int magic_bytes = ( 'D' << 0 ) | ( 'D' << 8 ) | ( 'S' << 16 ) | ( ' ' << 24 );
 
@@ -3364,22 +6176,29 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 
 	// DX10 has an extended header
 	DDS_HEADER_DXT10 dx10_header = {0};
+	/*	the elements of an array, 1 for a plain texture	*/
+	unsigned int array_size = 1;
+	int volume = ( header.sCaps.dwCaps2 & DDSCAPS2_VOLUME ) != 0;
 	if (header.sPixelFormat.dwFourCC == DX10) {
-		if( buffer_length - buffer_index < (int)sizeof( DDS_HEADER_DXT10 ) )
+		bytes = SOIL_level_source_read( input, buffer_index, sizeof( DDS_HEADER_DXT10 ) );
+		if( NULL == bytes )
 		{
-			result_string_pointer = "DDS file was too small to contain the DDS DXT10 header";
+			SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "DDS file was too small to contain the DDS DXT10 header" );
 			return 0;
 		}
-		memcpy(&dx10_header, &buffer[buffer_index], sizeof(DDS_HEADER_DXT10));
+		memcpy(&dx10_header, bytes, sizeof(DDS_HEADER_DXT10));
 		buffer_index += sizeof(dx10_header);
-		if( dx10_header.resourceDimension != DDS_DIMENSION_TEXTURE2D )
+		if( dx10_header.resourceDimension != DDS_DIMENSION_TEXTURE2D &&
+			dx10_header.resourceDimension != DDS_DIMENSION_TEXTURE3D )
 		{
-			result_string_pointer = "Only DX10 2D DDS resources are supported";
+			SOIL_set_result( SOIL_RESULT_UNSUPPORTED_FORMAT, "Only DX10 2D and 3D DDS resources are supported" );
 			return 0;
 		}
-		if( dx10_header.arraySize != 1 )
+		volume = ( dx10_header.resourceDimension == DDS_DIMENSION_TEXTURE3D );
+		array_size = dx10_header.arraySize;
+		if( array_size == 0 || ( volume && array_size != 1 ) )
 		{
-			result_string_pointer = "DX10 DDS texture arrays are not supported by this loader";
+			SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "Invalid DX10 DDS array size" );
 			return 0;
 		}
 	}
@@ -3405,7 +6224,7 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 	}
 
 	/*	OK, validated the header, let's load the image data	*/
-	result_string_pointer = "DDS header loaded and validated";
+	SOIL_set_result( SOIL_RESULT_OK, "DDS header loaded and validated" );
 
 	int block_compressed = 0;
 	const int cubemap = ( ( header.sCaps.dwCaps2 & DDSCAPS2_CUBEMAP ) != 0 ) ||
@@ -3426,6 +6245,16 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 		DDS_COMPRESSION_RGTC,
 		DDS_COMPRESSION_BPTC
 	} compression_family = DDS_COMPRESSION_NONE;
+	/*	the Direct3D orders GL can't unpack without help	*/
+	enum
+	{
+		DDS_CONVERT_NONE,
+		DDS_CONVERT_BGR,
+		DDS_CONVERT_ARGB4444,
+		DDS_CONVERT_ARGB1555,
+		DDS_CONVERT_XRGB1555
+	} conversion = DDS_CONVERT_NONE;
+	int swizzle_red_blue = 0;
 
 	if( header.sPixelFormat.dwFourCC == A16B16G16R16 )
 	{
@@ -3480,9 +6309,9 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 			if( ( header.sPixelFormat.dwRBitMask == 0xf800 ) && ( header.sPixelFormat.dwGBitMask == 0x7e0 ) &&
 			    ( header.sPixelFormat.dwBBitMask == 0x1f ) )
 			{
-				// DXGI_FORMAT_B5G6R5_UNORM
-				internal_format = GL_RGBA;
-				format_type = GL_UNSIGNED_SHORT_5_5_5_1;
+				// DXGI_FORMAT_B5G6R5_UNORM, the same bits as GL_UNSIGNED_SHORT_5_6_5
+				internal_format = GL_RGB;
+				format_type = GL_UNSIGNED_SHORT_5_6_5;
 				block_size = 2;
 			}
 			else if( ( header.sPixelFormat.dwRBitMask == 0xf00 ) && ( header.sPixelFormat.dwGBitMask == 0xf0 ) &&
@@ -3492,14 +6321,17 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 				internal_format = GL_RGBA;
 				format_type = GL_UNSIGNED_SHORT_4_4_4_4;
 				block_size = 2;
+				conversion = DDS_CONVERT_ARGB4444;
 			}
 			else if( ( header.sPixelFormat.dwRBitMask == 0x7c00 ) && ( header.sPixelFormat.dwGBitMask == 0x3e0 ) &&
 			         ( header.sPixelFormat.dwBBitMask == 0x1f ) )
 			{
-				// DXGI_FORMAT_B5G5R5A1_UNORM
+				// DXGI_FORMAT_B5G5R5A1_UNORM, or D3DFMT_X1R5G5B5 without the alpha mask
 				internal_format = GL_RGBA;
 				format_type = GL_UNSIGNED_SHORT_5_5_5_1;
 				block_size = 2;
+				conversion = ( header.sPixelFormat.dwAlphaBitMask == 0x8000 ) ?
+					DDS_CONVERT_ARGB1555 : DDS_CONVERT_XRGB1555;
 			}
 			else
 			{
@@ -3516,8 +6348,44 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 				internal_format = GL_RGBA;
 				block_size = 4;
 			}
+			if( header.sPixelFormat.dwRBitMask == 0xff0000 )
+			{
+				conversion = DDS_CONVERT_BGR;
+			}
 		}
 		external_format = internal_format;
+		if( ( conversion != DDS_CONVERT_NONE ) &&
+			( query_BGR_unpack_capability() == SOIL_CAPABILITY_PRESENT ) )
+		{
+			/*	desktop GL unpacks the Direct3D orders as they are	*/
+			switch( conversion )
+			{
+			case DDS_CONVERT_BGR:
+				external_format = ( block_size == 3 ) ? GL_BGR : GL_BGRA;
+				break;
+			case DDS_CONVERT_ARGB4444:
+				external_format = GL_BGRA;
+				format_type = GL_UNSIGNED_SHORT_4_4_4_4_REV;
+				break;
+			case DDS_CONVERT_ARGB1555:
+			case DDS_CONVERT_XRGB1555:
+				/*	the X bit is undefined, GL_RGB ignores it	*/
+				internal_format = ( conversion == DDS_CONVERT_XRGB1555 ) ? GL_RGB : GL_RGBA;
+				external_format = GL_BGRA;
+				format_type = GL_UNSIGNED_SHORT_1_5_5_5_REV;
+				break;
+			default:
+				break;
+			}
+			conversion = DDS_CONVERT_NONE;
+		}
+		else if( ( conversion == DDS_CONVERT_BGR ) &&
+			( query_texture_swizzle_capability() == SOIL_CAPABILITY_PRESENT ) )
+		{
+			/*	GLES 3 has no BGR unpacking, but can sample red and blue swapped	*/
+			swizzle_red_blue = 1;
+			conversion = DDS_CONVERT_NONE;
+		}
 	}
 	else
 	{
@@ -3640,7 +6508,7 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 				srgb_compressed_format = 1;
 				break;
 			default:
-				result_string_pointer = "Unsupported DXGI format for direct DDS upload";
+				SOIL_set_result( SOIL_RESULT_UNSUPPORTED_FORMAT, "Unsupported DXGI format for direct DDS upload" );
 				return 0;
 			}
 			break;
@@ -3650,33 +6518,92 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 	if( floating_point_format &&
 	    query_texture_float_capability() != SOIL_CAPABILITY_PRESENT )
 	{
-		result_string_pointer = "Floating-point textures not supported by the OpenGL driver";
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "Floating-point textures not supported by the OpenGL driver" );
 		return 0;
 	}
 	if( srgb_uncompressed_format &&
 	    query_sRGB_capability() != SOIL_CAPABILITY_PRESENT )
 	{
-		result_string_pointer = "sRGB textures not supported by the OpenGL driver";
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "sRGB textures not supported by the OpenGL driver" );
 		return 0;
 	}
 	if( srgb_compressed_format &&
 	    query_sRGB_capability() != SOIL_CAPABILITY_PRESENT )
 	{
-		result_string_pointer = "sRGB textures not supported by the OpenGL driver";
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "sRGB textures not supported by the OpenGL driver" );
 		return 0;
 	}
 
+	/*	the sizes below are 32 bit, they can't wrap once the top level
+		is known to fit in the file	*/
+	{
+		const unsigned long long tight_row_pitch = (unsigned long long)header.dwWidth * block_size;
+		const unsigned long long top_size = block_compressed ?
+			(unsigned long long)( ( header.dwWidth + 3 ) >> 2 ) * ( ( header.dwHeight + 3 ) >> 2 ) * block_size :
+			( ( ( header.dwFlags & DDSD_PITCH ) && header.dwPitchOrLinearSize >= tight_row_pitch ) ?
+				header.dwPitchOrLinearSize : tight_row_pitch ) * header.dwHeight;
+		if( top_size > (unsigned int)buffer_length - buffer_index )
+		{
+			SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "DDS file was too small for expected image data" );
+			return 0;
+		}
+	}
+
+	/*	the levels above the first kept one stay in the file, the header
+		then describes the image as if it started at that level	*/
+	unsigned int DDS_skipped_size = 0;
+	if( !volume && array_size == 1 &&
+		( header.sCaps.dwCaps1 & DDSCAPS_MIPMAP ) && header.dwMipMapCount > 1 )
+	{
+		const unsigned int first_level = SOIL_first_kept_level(
+			header.dwWidth, header.dwHeight, 1, header.dwMipMapCount, skip_mips, max_dimension );
+		unsigned long long skipped_size = 0;
+		unsigned int w = header.dwWidth;
+		unsigned int h = header.dwHeight;
+		for( unsigned int i = 0; i < first_level; ++i )
+		{
+			const unsigned int tight_row_pitch = w * block_size;
+			const unsigned int row_pitch =
+				( i == 0 && ( header.dwFlags & DDSD_PITCH ) &&
+				  header.dwPitchOrLinearSize >= tight_row_pitch ) ?
+					header.dwPitchOrLinearSize : tight_row_pitch;
+			skipped_size += SOIL_DDS_slice_size( w, h, row_pitch, block_compressed, block_size );
+			if( skipped_size > (unsigned int)buffer_length - buffer_index )
+			{
+				SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "DDS file was too small for expected image data" );
+				return 0;
+			}
+			w = SOIL_MIP_SIZE( w );
+			h = SOIL_MIP_SIZE( h );
+		}
+		if( first_level > 0 )
+		{
+			DDS_skipped_size = (unsigned int)skipped_size;
+			header.dwWidth = w;
+			header.dwHeight = h;
+			header.dwMipMapCount -= first_level;
+			/*	the pitch was the one of the top level	*/
+			header.dwFlags &= ~DDSD_PITCH;
+		}
+	}
+
+	/*	the blocks are converted to another block format when the
+		driver can't sample theirs, TRANSCODE_* or -1	*/
+	int transcode_from = -1;
+	int transcode_to = -1;
 	if( !block_compressed )
 	{
 		DDS_main_size = header.dwWidth * header.dwHeight * block_size;
 	}
 	else
 	{
+		DDS_main_size = ( ( header.dwWidth + 3 ) >> 2 ) * ( ( header.dwHeight + 3 ) >> 2 ) * block_size;
+
 		if( compression_family == DDS_COMPRESSION_RGTC )
 		{
 			if( query_3Dc_capability() != SOIL_CAPABILITY_PRESENT )
 			{
-				result_string_pointer = "Direct upload of RGTC images not supported by the OpenGL driver";
+				SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "Direct upload of RGTC images not supported by the OpenGL driver" );
 				return 0;
 			}
 		}
@@ -3684,21 +6611,68 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 		{
 			if( query_BPTC_capability() != SOIL_CAPABILITY_PRESENT )
 			{
-				result_string_pointer = "Direct upload of BPTC images not supported by the OpenGL driver";
-				return 0;
+				/*	BC7 can become BC3 or ETC2, BC6H has no other float format	*/
+				if( ( internal_format == SOIL_COMPRESSED_RGBA_BPTC_UNORM ||
+				      internal_format == SOIL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM ) &&
+				    SOIL_internal_transcode_target(
+					    TRANSCODE_BC7, 1, srgb_compressed_format, &transcode_to, &internal_format ) )
+				{
+					transcode_from = TRANSCODE_BC7;
+				}
+				else
+				{
+					SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "Direct upload of BPTC images not supported by the OpenGL driver" );
+					return 0;
+				}
 			}
 		}
 		else if( compression_family == DDS_COMPRESSION_S3TC )
 		{
 			if( query_DXT_capability() != SOIL_CAPABILITY_PRESENT )
 			{
-				/*	we can't do it!	*/
-				result_string_pointer = "Direct upload of S3TC images not supported by the OpenGL driver";
-				return 0;
+				const int source_format = ( block_size == 8 ) ? TRANSCODE_BC1 :
+					( internal_format == SOIL_RGBA_S3TC_DXT3 ||
+					  internal_format == SOIL_GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT ) ?
+						TRANSCODE_BC2 : TRANSCODE_BC3;
+				/*	an opaque BC1 image fits ETC2 RGB8, check the top level,
+					a stream keeps it staged for its upload	*/
+				const unsigned char *top_level = ( source_format != TRANSCODE_BC1 ) ? NULL :
+					SOIL_level_source_read( input, buffer_index + DDS_skipped_size, DDS_main_size );
+				const int has_alpha = ( NULL == top_level ) ||
+					transcode_has_alpha( top_level, header.dwWidth, header.dwHeight, TRANSCODE_BC1 );
+				if( SOIL_internal_transcode_target(
+					    source_format, has_alpha, srgb_compressed_format, &transcode_to, &internal_format ) )
+				{
+					transcode_from = source_format;
+				}
+				else
+				{
+					/*	we can't do it!	*/
+					SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "Direct upload of S3TC images not supported by the OpenGL driver" );
+					return 0;
+				}
 			}
 		}
+	}
 
-		DDS_main_size = ( ( header.dwWidth + 3 ) >> 2 ) * ( ( header.dwHeight + 3 ) >> 2 ) * block_size;
+	if( volume || array_size > 1 )
+	{
+		if( loading_as_cubemap )
+		{
+			SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT,
+				volume ? "DDS image was a volume texture" : "DDS image was a texture array" );
+			return 0;
+		}
+		if( transcode_from >= 0 || conversion != DDS_CONVERT_NONE )
+		{
+			SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED,
+				"The OpenGL driver can't take the pixel format of this DDS array or volume as it is" );
+			return 0;
+		}
+		return SOIL_direct_load_DDS_layers( &header, input, buffer_index,
+			(unsigned int)buffer_length - buffer_index, array_size, cubemap, volume,
+			block_compressed, block_size, internal_format, external_format, format_type,
+			swizzle_red_blue, reuse_texture_ID, flags, skip_mips, max_dimension );
 	}
 
 	unsigned int ogl_target_start, ogl_target_end;
@@ -3709,14 +6683,14 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 		if( !loading_as_cubemap )
 		{
 			/*	we can't do it!	*/
-			result_string_pointer = "DDS image was a cubemap";
+			SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "DDS image was a cubemap" );
 			return 0;
 		}
 		/*	can we even handle cubemaps with the OpenGL driver?	*/
 		if( query_cubemap_capability() != SOIL_CAPABILITY_PRESENT )
 		{
 			/*	we can't do it!	*/
-			result_string_pointer = "Direct upload of cubemap images not supported by the OpenGL driver";
+			SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "Direct upload of cubemap images not supported by the OpenGL driver" );
 			return 0;
 		}
 		ogl_target_start = SOIL_TEXTURE_CUBE_MAP_POSITIVE_X;
@@ -3729,7 +6703,7 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 		if( loading_as_cubemap )
 		{
 			/*	we can't do it!	*/
-			result_string_pointer = "DDS image was not a cubemap";
+			SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "DDS image was not a cubemap" );
 			return 0;
 		}
 		ogl_target_start = GL_TEXTURE_2D;
@@ -3807,37 +6781,64 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 	glBindTexture( opengl_texture_type, tex_ID );
 
 	const unsigned int faces = ogl_target_end - ogl_target_start + 1;
-	if ( faces * DDS_source_full_size > (unsigned int)buffer_length - buffer_index )
+	if ( !SOIL_level_source_has( input,
+		buffer_index + (unsigned long long)faces * ( DDS_skipped_size + DDS_source_full_size ) ) )
 	{
 		glDeleteTextures( 1, &tex_ID );
-		result_string_pointer = "DDS file was too small for expected image data";
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "DDS file was too small for expected image data" );
+		return 0;
+	}
+
+	/*	a reused texture of the same size is updated in place	*/
+	const int sub_image = SOIL_internal_prepare_storage(
+		opengl_texture_type, ogl_target_start, 0 != reuse_texture_ID,
+		internal_format, header.dwWidth, header.dwHeight, mipmaps + 1, flags );
+	if( sub_image < 0 )
+	{
 		return 0;
 	}
 
 	if( !block_compressed )
 	{
+		/*	the levels are uploaded straight from the file, GL skips the
+			row padding and unpacks the pixel order, the rows only go
+			through DDS_data when it can't	*/
 		GLint unpack_alignment;
-		unsigned char * DDS_data = (unsigned char*) malloc( DDS_main_size );
-		if( NULL == DDS_data )
-		{
-			result_string_pointer = "malloc failed";
-			return 0;
-		}
+		GLint unpack_row_length = 0;
+		const int has_row_length =
+			( query_unpack_row_length_capability() == SOIL_CAPABILITY_PRESENT );
+		unsigned char * DDS_data = NULL;
+		int failure = SOIL_RESULT_OK;
 		glGetIntegerv( GL_UNPACK_ALIGNMENT, &unpack_alignment );
 		if( unpack_alignment != 1 )
 		{
 			glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
 		}
-		for(unsigned int cf_target = ogl_target_start; cf_target <= ogl_target_end; ++cf_target )
+		if( has_row_length )
+		{
+			glGetIntegerv( GL_UNPACK_ROW_LENGTH, &unpack_row_length );
+			if( unpack_row_length != 0 )
+			{
+				glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 );
+			}
+		}
+		for(unsigned int cf_target = ogl_target_start; failure == SOIL_RESULT_OK && cf_target <= ogl_target_end; ++cf_target )
 		{
 			unsigned int source_offset = 0;
-			for( unsigned int i = 0; i <= mipmaps; ++i )
+			buffer_index += DDS_skipped_size;
+			for( unsigned int i = 0; failure == SOIL_RESULT_OK && i <= mipmaps; ++i )
 			{
 				unsigned int w = header.dwWidth >> i;
 				unsigned int h = header.dwHeight >> i;
 				unsigned int tight_row_pitch;
 				unsigned int source_row_pitch;
 				unsigned int mip_size;
+				const unsigned char *source;
+				const unsigned char *pixels;
+				unsigned int pixels_size;
+				GLint row_alignment = 1;
+				GLint row_length = 0;
+				int repack;
 				if( w < 1 ) { w = 1; }
 				if( h < 1 ) { h = 1; }
 				tight_row_pitch = w * block_size;
@@ -3848,76 +6849,80 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 					source_row_pitch = header.dwPitchOrLinearSize;
 				}
 				mip_size = tight_row_pitch * h;
-				for( unsigned int row = 0; row < h; ++row )
+				source = SOIL_level_source_read( input, buffer_index + source_offset, source_row_pitch * h );
+				source_offset += source_row_pitch * h;
+				if( NULL == source )
 				{
-					memcpy(
-						&DDS_data[row * tight_row_pitch],
-						&buffer[buffer_index + source_offset + row * source_row_pitch],
-						tight_row_pitch );
+					failure = SOIL_RESULT_DECODE_FAILED;
+					break;
 				}
-				source_offset += source_row_pitch * h;
 
-				if( ( header.sPixelFormat.dwRBitMask == 0xff0000 ) &&
-				    ( ( block_size == 3 && internal_format == GL_RGB ) ||
-				      ( block_size == 4 && internal_format == GL_RGBA ) ) )
+				repack = ( conversion != DDS_CONVERT_NONE ) ||
+					!SOIL_DDS_unpack_rows( tight_row_pitch, source_row_pitch, block_size,
+						has_row_length, &row_alignment, &row_length );
+
+				if( repack )
 				{
-					for( unsigned int pixel = 0; pixel < mip_size; pixel += block_size )
+					if( NULL == DDS_data )
 					{
-						unsigned char temp = DDS_data[pixel];
-						DDS_data[pixel] = DDS_data[pixel + 2];
-						DDS_data[pixel + 2] = temp;
+						/*	level 0 is the largest	*/
+						DDS_data = (unsigned char*) malloc( DDS_main_size );
+						if( NULL == DDS_data )
+						{
+							failure = SOIL_RESULT_OUT_OF_MEMORY;
+							break;
+						}
 					}
-				}
-				else if( block_size == 2 &&
-				         ( header.sPixelFormat.dwRBitMask == 0xf800 ||
-				           header.sPixelFormat.dwRBitMask == 0x7c00 ) )
-				{
-					/* convert to R5G5B5A1 */
-					for( unsigned int pixel_offset = 0;
-					     pixel_offset < mip_size; pixel_offset += block_size )
+					for( unsigned int row = 0; row < h; ++row )
 					{
-						unsigned short pixel =
-							DDS_data[pixel_offset] << 0 |
-							DDS_data[pixel_offset + 1] << 8;
-						char r = ( ( pixel & header.sPixelFormat.dwRBitMask ) >> 10 );
-						char g = ( ( pixel & header.sPixelFormat.dwGBitMask ) >> 5 );
-						char b = ( ( pixel & header.sPixelFormat.dwBBitMask ) >> 0 );
-						char a = 1;
-						if( header.sPixelFormat.dwAlphaBitMask != 0 )
-						{ a = ( pixel & header.sPixelFormat.dwAlphaBitMask ) >> 15; }
+						const unsigned char *source_row = &source[row * source_row_pitch];
+						unsigned char *row_data = &DDS_data[row * tight_row_pitch];
+						switch( conversion )
 						{
-							unsigned short pixel_new =
-								( r << 11 ) | ( g << 6 ) | ( b << 1 ) | a;
-							DDS_data[pixel_offset] = ( pixel_new >> 0 ) & 0xff;
-							DDS_data[pixel_offset + 1] = ( pixel_new >> 8 ) & 0xff;
+						case DDS_CONVERT_BGR:
+							convert_BGR_to_RGB( source_row, w, block_size, row_data );
+							break;
+						case DDS_CONVERT_ARGB4444:
+							convert_ARGB16_to_RGBA16( source_row, w, 4, 0, row_data );
+							break;
+						case DDS_CONVERT_ARGB1555:
+							convert_ARGB16_to_RGBA16( source_row, w, 1, 0, row_data );
+							break;
+						case DDS_CONVERT_XRGB1555:
+							convert_ARGB16_to_RGBA16( source_row, w, 1, 1, row_data );
+							break;
+						default:
+							memcpy( row_data, source_row, tight_row_pitch );
+							break;
 						}
 					}
+					pixels = DDS_data;
+					pixels_size = mip_size;
 				}
-				else if( block_size == 2 &&
-				         header.sPixelFormat.dwRBitMask == 0xf00 &&
-				         header.sPixelFormat.dwGBitMask == 0xf0 &&
-				         header.sPixelFormat.dwBBitMask == 0xf &&
-				         header.sPixelFormat.dwAlphaBitMask == 0xf000 )
+				else
 				{
-					for( unsigned int pixel_offset = 0;
-					     pixel_offset < mip_size; pixel_offset += block_size )
-					{
-						unsigned short pixel =
-							DDS_data[pixel_offset] << 0 |
-							DDS_data[pixel_offset + 1] << 8;
-						char r = ( ( pixel & header.sPixelFormat.dwRBitMask ) >> 8 );
-						char g = ( ( pixel & header.sPixelFormat.dwGBitMask ) >> 4 );
-						char b = ( ( pixel & header.sPixelFormat.dwBBitMask ) >> 0 );
-						char a = ( ( pixel & header.sPixelFormat.dwAlphaBitMask ) >> 12 );
-						unsigned short pixel_new =
-							( r << 12 ) | ( g << 8 ) | ( b << 4 ) | a;
-						DDS_data[pixel_offset] = ( pixel_new >> 0 ) & 0xff;
-						DDS_data[pixel_offset + 1] = ( pixel_new >> 8 ) & 0xff;
-					}
+					pixels = source;
+					pixels_size = source_row_pitch * ( h - 1 ) + tight_row_pitch;
 				}
 
-				glTexImage2D( cf_target, i, internal_format, w, h, 0, external_format, format_type,
-				              DDS_data );
+				if( row_alignment != 1 )
+				{
+					glPixelStorei( GL_UNPACK_ALIGNMENT, row_alignment );
+				}
+				if( row_length != 0 )
+				{
+					glPixelStorei( GL_UNPACK_ROW_LENGTH, row_length );
+				}
+				SOIL_upload_tex_image_2D( sub_image, cf_target, i, internal_format, w, h, external_format, format_type,
+				                          pixels, pixels_size );
+				if( row_alignment != 1 )
+				{
+					glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+				}
+				if( row_length != 0 )
+				{
+					glPixelStorei( GL_UNPACK_ROW_LENGTH, 0 );
+				}
 			}
 			buffer_index += DDS_source_full_size;
 		}
@@ -3925,17 +6930,35 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 		{
 			glPixelStorei( GL_UNPACK_ALIGNMENT, unpack_alignment );
 		}
+		if( unpack_row_length != 0 )
+		{
+			glPixelStorei( GL_UNPACK_ROW_LENGTH, unpack_row_length );
+		}
 		SOIL_free_image_data( DDS_data );
+		if( failure != SOIL_RESULT_OK )
+		{
+			if( 0 == reuse_texture_ID )
+			{
+				glDeleteTextures( 1, &tex_ID );
+			}
+			SOIL_set_result( failure, failure == SOIL_RESULT_OUT_OF_MEMORY ? "malloc failed" :
+				"DDS file was too small for expected image data" );
+			return 0;
+		}
 	} else {
 		for(unsigned int cf_target = ogl_target_start; cf_target <= ogl_target_end; ++cf_target )
 		{
+			buffer_index += DDS_skipped_size;
 			/*	upload the main chunk	*/
-			soilGlCompressedTexImage2D( cf_target, 0, internal_format, header.dwWidth, header.dwHeight, 0, DDS_main_size, &buffer[buffer_index] );
+			const unsigned char *blocks = SOIL_level_source_read( input, buffer_index, DDS_main_size );
+			int uploaded = ( NULL != blocks ) &&
+				SOIL_upload_compressed_level( sub_image, cf_target, 0, internal_format, header.dwWidth, header.dwHeight, DDS_main_size, blocks,
+				                              transcode_from, transcode_to );
 
 			unsigned int byte_offset = DDS_main_size;
 
 			/*	upload the mipmaps, if we have them	*/
-			for( unsigned int i = 1; i <= mipmaps; ++i )
+			for( unsigned int i = 1; uploaded && i <= mipmaps; ++i )
 			{
 				unsigned int w = header.dwWidth >> i;
 				unsigned int h = header.dwHeight >> i;
@@ -3944,12 +6967,22 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 
 				/*	upload this mipmap	*/
 				const unsigned int mip_size = ( ( w + 3 ) / 4 ) * ( ( h + 3 ) / 4 ) * block_size;
-				soilGlCompressedTexImage2D( cf_target, i, internal_format, w, h, 0, mip_size,
-				                            &buffer[buffer_index + byte_offset] );
+				blocks = SOIL_level_source_read( input, buffer_index + byte_offset, mip_size );
+				uploaded = ( NULL != blocks ) &&
+					SOIL_upload_compressed_level( sub_image, cf_target, i, internal_format, w, h, mip_size,
+					                              blocks, transcode_from, transcode_to );
 
 				/*	and move to the next mipmap	*/
 				byte_offset += mip_size;
 			}
+			if( !uploaded )
+			{
+				if( 0 == reuse_texture_ID )
+					glDeleteTextures( 1, &tex_ID );
+				if( NULL == blocks )
+					SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "DDS file was too small for expected image data" );
+				return 0;
+			}
 			buffer_index += DDS_full_size;
 		}
 	}
@@ -3987,68 +7020,134 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 		glTexParameteri( opengl_texture_type, SOIL_TEXTURE_WRAP_R, clamp_mode );
 	}
 
-	result_string_pointer = "DDS file loaded";
+	if( query_texture_swizzle_capability() == SOIL_CAPABILITY_PRESENT )
+	{
+		/*	BGR sampled as RGB, and a reused texture may still have a swizzle	*/
+		glTexParameteri( opengl_texture_type, SOIL_TEXTURE_SWIZZLE_R, swizzle_red_blue ? SOIL_GL_BLUE : SOIL_GL_RED );
+		glTexParameteri( opengl_texture_type, SOIL_TEXTURE_SWIZZLE_G, SOIL_GL_GREEN );
+		glTexParameteri( opengl_texture_type, SOIL_TEXTURE_SWIZZLE_B, swizzle_red_blue ? SOIL_GL_RED : SOIL_GL_BLUE );
+		glTexParameteri( opengl_texture_type, SOIL_TEXTURE_SWIZZLE_A, GL_ALPHA );
+	}
+
+	SOIL_set_result( SOIL_RESULT_OK, "DDS file loaded" );
 	return tex_ID;
 }
 
-unsigned int SOIL_direct_load_DDS(
-		const char *filename,
+unsigned int SOIL_direct_load_DDS_from_memory_lod(
+		const unsigned char *const buffer,
+		const int buffer_length,
 		const unsigned int reuse_texture_ID,
 		const int flags,
-		const int loading_as_cubemap )
+		const int loading_as_cubemap,
+		const int skip_mips,
+		const int max_dimension )
 {
-	unsigned int tex_ID = 0;
-	/*	error checks	*/
-	if( NULL == filename )
-	{
-		result_string_pointer = "NULL filename";
-		return 0;
-	}
-	FILE *f = fopen(filename, "rb");
-	if( NULL == f )
+	SOIL_level_source input;
+	/*	1st off, does the filename even exist?	*/
+	if( NULL == buffer )
 	{
-		/*	the file doesn't seem to exist (or be open-able)	*/
-		result_string_pointer = "Can not find DDS file";
+		/*	we can't do it!	*/
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "NULL buffer" );
 		return 0;
 	}
-	fseek( f, 0, SEEK_END );
-	const int buffer_length = ftell(f);
-	if( buffer_length == -1 )
+	SOIL_level_source_memory( &input, buffer, buffer_length );
+	return SOIL_internal_direct_load_DDS( &input, reuse_texture_ID, flags, loading_as_cubemap,
+		skip_mips, max_dimension );
+}
+
+unsigned int SOIL_direct_load_DDS_from_callbacks_lod(
+		const SOIL_io_callbacks *callbacks,
+		void *user,
+		const unsigned int reuse_texture_ID,
+		const int flags,
+		const int loading_as_cubemap,
+		const int skip_mips,
+		const int max_dimension )
+{
+	SOIL_level_source input;
+	unsigned int tex_ID;
+	if( NULL == callbacks || NULL == callbacks->read || NULL == callbacks->skip )
 	{
-		result_string_pointer = "ftell failed";
-		fclose( f );
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "NULL callbacks" );
 		return 0;
 	}
-	fseek( f, 0, SEEK_SET );
-	unsigned char *buffer = (unsigned char*) malloc(buffer_length);
-	if( NULL == buffer )
+	SOIL_level_source_stream( &input, callbacks, user );
+	tex_ID = SOIL_internal_direct_load_DDS( &input, reuse_texture_ID, flags, loading_as_cubemap,
+		skip_mips, max_dimension );
+	if( 0 == tex_ID )
 	{
-		result_string_pointer = "malloc failed";
-		fclose( f );
-		return 0;
+		SOIL_level_source_check_length( &input );
 	}
-	const size_t bytes_read = fread(buffer, 1, buffer_length, f);
-	fclose( f );
-	if( bytes_read < buffer_length )
+	SOIL_level_source_close( &input );
+	return tex_ID;
+}
+
+unsigned int SOIL_direct_load_DDS_from_callbacks(
+		const SOIL_io_callbacks *callbacks,
+		void *user,
+		const unsigned int reuse_texture_ID,
+		const int flags,
+		const int loading_as_cubemap )
+{
+	return SOIL_direct_load_DDS_from_callbacks_lod(
+		callbacks, user, reuse_texture_ID, flags, loading_as_cubemap, 0, 0 );
+}
+
+unsigned int SOIL_direct_load_DDS_from_memory(
+		const unsigned char *const buffer,
+		const int buffer_length,
+		const unsigned int reuse_texture_ID,
+		const int flags,
+		const int loading_as_cubemap )
+{
+	return SOIL_direct_load_DDS_from_memory_lod(
+		buffer, buffer_length, reuse_texture_ID, flags, loading_as_cubemap, 0, 0 );
+}
+
+unsigned int SOIL_direct_load_DDS_lod(
+		const char *filename,
+		const unsigned int reuse_texture_ID,
+		const int flags,
+		const int loading_as_cubemap,
+		const int skip_mips,
+		const int max_dimension )
+{
+	unsigned int tex_ID = 0;
+	file_map map;
+	/*	the blocks go from the mapped file straight to OpenGL, and the
+		skipped levels are never read from the disk	*/
+	if( !SOIL_internal_map_file( filename, &map, skip_mips > 0 || max_dimension > 0,
+			"Can not find DDS file" ) )
 	{
-		result_string_pointer = "fread failed";
-		free(buffer);
 		return 0;
 	}
 	/*	now try to do the loading	*/
-	tex_ID = SOIL_direct_load_DDS_from_memory(
-		buffer, buffer_length,
-		reuse_texture_ID, flags, loading_as_cubemap );
-	SOIL_free_image_data( buffer );
+	tex_ID = SOIL_direct_load_DDS_from_memory_lod(
+		map.data, map.size,
+		reuse_texture_ID, flags, loading_as_cubemap, skip_mips, max_dimension );
+	file_map_close( &map );
 	return tex_ID;
 }
 
-unsigned int SOIL_direct_load_PVR_from_memory( const unsigned char* const buffer, int buffer_length,
+unsigned int SOIL_direct_load_DDS(
+		const char *filename,
+		const unsigned int reuse_texture_ID,
+		const int flags,
+		const int loading_as_cubemap )
+{
+	return SOIL_direct_load_DDS_lod( filename, reuse_texture_ID, flags, loading_as_cubemap, 0, 0 );
+}
+
+/*	the PVR loader, on a file in memory or a stream	*/
+static unsigned int SOIL_internal_direct_load_PVR( SOIL_level_source *input,
 											   unsigned int reuse_texture_ID, int flags,
-											   int loading_as_cubemap ) {
-	if ( buffer_length < 0 || (unsigned long)buffer_length < sizeof( PVR_Texture_Header ) )
+											   int loading_as_cubemap, int skip_mips, int max_dimension ) {
+	const unsigned char *header_bytes = SOIL_level_source_read( input, 0, sizeof( PVR_Texture_Header ) );
+	PVR_Texture_Header header_data;
+	PVR_Texture_Header* header = &header_data;
+	if ( NULL == header_bytes )
 		return 0;
-	PVR_Texture_Header* header = (PVR_Texture_Header*)buffer;
+	memcpy( &header_data, header_bytes, sizeof( PVR_Texture_Header ) );
 	int num_surfs = 1;
 	GLuint tex_ID = 0;
 	GLenum PVR_format = 0;
@@ -4059,24 +7158,25 @@ unsigned int SOIL_direct_load_PVR_from_memory( const unsigned char* const buffer
 	int is_compressed_format_supported = 0;
 	int is_compressed_format = 0;
 	int mipmaps = 0;
+	int first_level = 0;
 	int i;
 	GLint unpack_aligment;
 
 	// Check the header size
 	if ( header->dwHeaderSize != sizeof(PVR_Texture_Header) ) {
 		if ( header->dwHeaderSize == PVRTEX_V1_HEADER_SIZE ) {
-			result_string_pointer = "this is an old pvr ( update the PVR file )";
+			SOIL_set_result( SOIL_RESULT_UNSUPPORTED_FORMAT, "this is an old pvr ( update the PVR file )" );
 
 			if ( loading_as_cubemap ) {
 				if( header->dwpfFlags & PVRTEX_CUBEMAP ) {
 					num_surfs = 6;
 				} else {
-					result_string_pointer = "tried to load a non-cubemap PVR as cubemap";
+					SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "tried to load a non-cubemap PVR as cubemap" );
 					return 0;
 				}
 			}
 		} else {
-			result_string_pointer = "invalid PVR header";
+			SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "invalid PVR header" );
 
 			return 0;
 		}
@@ -4087,7 +7187,7 @@ unsigned int SOIL_direct_load_PVR_from_memory( const unsigned char* const buffer
 				if( header->dwpfFlags & PVRTEX_CUBEMAP ) {
 					num_surfs = 6;
 				} else {
-					result_string_pointer = "tried to load a non-cubemap PVR as cubemap";
+					SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "tried to load a non-cubemap PVR as cubemap" );
 					return 0;
 				}
 			} else {
@@ -4098,7 +7198,7 @@ unsigned int SOIL_direct_load_PVR_from_memory( const unsigned char* const buffer
 
 	// Check the magic identifier
 	if ( header->dwPVR != PVRTEX_IDENTIFIER ) {
-		result_string_pointer = "invalid PVR header";
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "invalid PVR header" );
 		return 0;
 	}
 
@@ -4108,7 +7208,7 @@ unsigned int SOIL_direct_load_PVR_from_memory( const unsigned char* const buffer
 		&& ((header->dwpfFlags & PVRTEX_PIXELTYPE)!=OGL_PVRTC4) )
 	{
 		// We need to load untwiddled textures -- hw will twiddle for us.
-		result_string_pointer = "pvr is not compressed ( untwiddled texture )";
+		SOIL_set_result( SOIL_RESULT_UNSUPPORTED_FORMAT, "pvr is not compressed ( untwiddled texture )" );
 		return 0;
 	}
 
@@ -4131,7 +7231,7 @@ unsigned int SOIL_direct_load_PVR_from_memory( const unsigned char* const buffer
 			PVR_type = GL_RGB;
 			break;
 		case OGL_RGB_555:
-			result_string_pointer = "failed: pixel type OGL_RGB_555 not supported.";
+			SOIL_set_result( SOIL_RESULT_UNSUPPORTED_FORMAT, "failed: pixel type OGL_RGB_555 not supported." );
 			return 0;
 		case OGL_RGB_888:
 			PVR_format = GL_UNSIGNED_BYTE;
@@ -4151,7 +7251,7 @@ unsigned int SOIL_direct_load_PVR_from_memory( const unsigned char* const buffer
 				is_compressed_format_supported = is_compressed_format = 1;
 				PVR_format = header->dwAlphaBitMask==0 ? SOIL_COMPRESSED_RGB_PVRTC_2BPPV1_IMG : SOIL_COMPRESSED_RGBA_PVRTC_2BPPV1_IMG ;	// PVRTC2
 			} else {
-				result_string_pointer = "error: PVRTC2 not supported.Decompress the texture first.";
+				SOIL_set_result( SOIL_RESULT_UNSUPPORTED_FORMAT, "error: PVRTC2 not supported.Decompress the texture first." );
 				return 0;
 			}
 			break;
@@ -4161,7 +7261,7 @@ unsigned int SOIL_direct_load_PVR_from_memory( const unsigned char* const buffer
 				is_compressed_format_supported = is_compressed_format = 1;
 				PVR_format = header->dwAlphaBitMask==0 ? SOIL_COMPRESSED_RGB_PVRTC_4BPPV1_IMG : SOIL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG ;	// PVRTC4
 			} else {
-				result_string_pointer = "error: PVRTC4 not supported. Decompress the texture first.";
+				SOIL_set_result( SOIL_RESULT_UNSUPPORTED_FORMAT, "error: PVRTC4 not supported. Decompress the texture first." );
 				return 0;
 			}
 			break;
@@ -4171,22 +7271,39 @@ unsigned int SOIL_direct_load_PVR_from_memory( const unsigned char* const buffer
 				PVR_type   = GL_BGRA;
 				break;
 			} else {
-				result_string_pointer = "Unable to load GL_BGRA texture as extension GL_IMG_texture_format_BGRA8888 is unsupported.";
+				SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "Unable to load GL_BGRA texture as extension GL_IMG_texture_format_BGRA8888 is unsupported." );
 				return 0;
 			}
 		default:											// NOT SUPPORTED
-			result_string_pointer = "failed: pixel type not supported.";
+			SOIL_set_result( SOIL_RESULT_UNSUPPORTED_FORMAT, "failed: pixel type not supported." );
 			return 0;
 	}
 
 	#ifdef SOIL_GLES1
 	//  check that this data is cube map data or not.
 	if( loading_as_cubemap ) {
-		result_string_pointer = "cube map textures are not available in GLES1.x.";
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "cube map textures are not available in GLES1.x." );
 		return 0;
 	}
 	#endif
 
+	// The level sizes are 32 bit, they can't wrap once the top level is known to fit in the file
+	{
+		unsigned long long top_width = header->dwWidth, top_height = header->dwHeight;
+		if ( is_compressed_format ) {
+			const int is_PVRTC2 = (header->dwpfFlags & PVRTEX_PIXELTYPE)==OGL_PVRTC2;
+			const unsigned int min_width = is_PVRTC2 ? PVRTC2_MIN_TEXWIDTH : PVRTC4_MIN_TEXWIDTH;
+			const unsigned int min_height = is_PVRTC2 ? PVRTC2_MIN_TEXHEIGHT : PVRTC4_MIN_TEXHEIGHT;
+			top_width = top_width < min_width ? min_width : top_width;
+			top_height = top_height < min_height ? min_height : top_height;
+		}
+		if ( header->dwBitCount > 0 &&
+			 top_width * top_height > ( input->length - header->dwHeaderSize ) * 8 / header->dwBitCount ) {
+			SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "PVR file was too small for expected image data" );
+			return 0;
+		}
+	}
+
 	// load the texture up
 	tex_ID = reuse_texture_ID;
 	if( tex_ID == 0 )
@@ -4197,7 +7314,7 @@ unsigned int SOIL_direct_load_PVR_from_memory( const unsigned char* const buffer
 	glBindTexture( opengl_texture_type, tex_ID );
 
 	if( glGetError() ) {
-		result_string_pointer = "failed: glBindTexture() failed.";
+		SOIL_set_result( SOIL_RESULT_GL_ERROR, "failed: glBindTexture() failed." );
 		return 0;
 	}
 
@@ -4207,51 +7324,75 @@ unsigned int SOIL_direct_load_PVR_from_memory( const unsigned char* const buffer
 		glPixelStorei(GL_UNPACK_ALIGNMENT,1);				// Never have row-aligned in headers
 	}
 
+	/*	the levels above first_level are stepped over, the rest become levels 0 to mipmaps	*/
+	if ( header->dwpfFlags & PVRTEX_MIPMAP ) {
+		first_level = (int)SOIL_first_kept_level( header->dwWidth, header->dwHeight, 1,
+			header->dwMipMapCount + 1, skip_mips, max_dimension );
+	}
+	mipmaps = ( ( flags & SOIL_FLAG_MIPMAPS ) && (header->dwpfFlags & PVRTEX_MIPMAP) ) ? header->dwMipMapCount - first_level : 0;
+
 	#define _MAX( a, b ) (( a <= b )? b : a)
 	for(i=0; i<num_surfs; i++) {
-		char *texture_ptr = (char*)buffer + header->dwHeaderSize + header->dwTextureDataSize * i;
-		char *cur_texture_ptr = 0;
+		unsigned long long texture_offset = header->dwHeaderSize + (unsigned long long)header->dwTextureDataSize * i;
+		const unsigned char *cur_texture_ptr = 0;
 		int	mipmap_level;
 		unsigned int width= header->dwWidth, height = header->dwHeight;
 		unsigned int compressed_image_size = 0;
+		unsigned int level_size;
 
-		mipmaps = ( ( flags & SOIL_FLAG_MIPMAPS ) && (header->dwpfFlags & PVRTEX_MIPMAP) ) ? header->dwMipMapCount : 0;
-
-		for(mipmap_level = 0; mipmap_level <= mipmaps; width = _MAX(width/2, (unsigned int)1), height = _MAX(height/2, (unsigned int)1), mipmap_level++ ) {
-			// Do Alpha-swap if needed
-			cur_texture_ptr = texture_ptr;
-
-			// Load the Texture
-			/* If the texture is PVRTC then use GLCompressedTexImage2D */
+		for(mipmap_level = 0; mipmap_level <= first_level + mipmaps; width = _MAX(width/2, (unsigned int)1), height = _MAX(height/2, (unsigned int)1), mipmap_level++ ) {
+			/* Calculate how many bytes this MIP level occupies */
 			if( is_compressed_format ) {
-				/* Calculate how many bytes this MIP level occupies */
 				if ((header->dwpfFlags & PVRTEX_PIXELTYPE)==OGL_PVRTC2) {
 					compressed_image_size = ( _MAX(width, PVRTC2_MIN_TEXWIDTH) * _MAX(height, PVRTC2_MIN_TEXHEIGHT) * header->dwBitCount + 7 ) / 8;
 				} else {// PVRTC4 case
 					compressed_image_size = ( _MAX(width, PVRTC4_MIN_TEXWIDTH) * _MAX(height, PVRTC4_MIN_TEXHEIGHT) * header->dwBitCount + 7 ) / 8;
 				}
+				level_size = compressed_image_size;
+			} else {
+				/* New formula that takes into account bit counts inferior to 8 (e.g. 1 bpp) */
+				level_size = (width * height * header->dwBitCount + 7) / 8;
+			}
+
+			/* Only the uploaded levels are read */
+			if ( mipmap_level >= first_level ) {
+				cur_texture_ptr = SOIL_level_source_read( input, texture_offset, level_size );
+				if ( NULL == cur_texture_ptr ) {
+					SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "PVR file was too small for expected image data" );
+					if ( 1 != unpack_aligment )
+					{
+						glPixelStorei(GL_UNPACK_ALIGNMENT, unpack_aligment);
+					}
+					return 0;
+				}
+			}
 
-				if ( is_compressed_format_supported ) {
+			// Load the Texture
+			/* If the texture is PVRTC then use GLCompressedTexImage2D */
+			if( is_compressed_format ) {
+				if ( mipmap_level < first_level ) {
+					/* Skipped, only its size is needed */
+				} else if ( is_compressed_format_supported ) {
 					/* Load compressed texture data at selected MIP level */
 					if ( loading_as_cubemap ) {
-						soilGlCompressedTexImage2D( SOIL_TEXTURE_CUBE_MAP_POSITIVE_X + i, mipmap_level, PVR_format, width, height, 0, compressed_image_size, cur_texture_ptr );
+						SOIL_upload_compressed_tex_image_2D( 0, SOIL_TEXTURE_CUBE_MAP_POSITIVE_X + i, mipmap_level - first_level, PVR_format, width, height, compressed_image_size, cur_texture_ptr );
 					} else {
-						soilGlCompressedTexImage2D( opengl_texture_type, mipmap_level, PVR_format, width, height, 0, compressed_image_size, cur_texture_ptr );
+						SOIL_upload_compressed_tex_image_2D( 0, opengl_texture_type, mipmap_level - first_level, PVR_format, width, height, compressed_image_size, cur_texture_ptr );
 					}
 				} else {
-					result_string_pointer = "failed: GPU doesnt support compressed textures";
+					SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "failed: GPU doesnt support compressed textures" );
 				}
-			} else {
+			} else if ( mipmap_level >= first_level ) {
 				/* Load uncompressed texture data at selected MIP level */
 				if ( loading_as_cubemap ) {
-					glTexImage2D( SOIL_TEXTURE_CUBE_MAP_POSITIVE_X + i, mipmap_level, PVR_type, width, height, 0, PVR_type, PVR_format, cur_texture_ptr );
+					SOIL_upload_tex_image_2D( 0, SOIL_TEXTURE_CUBE_MAP_POSITIVE_X + i, mipmap_level - first_level, PVR_type, width, height, PVR_type, PVR_format, cur_texture_ptr, level_size );
 				} else {
-					glTexImage2D( opengl_texture_type, mipmap_level, PVR_type, width, height, 0, PVR_type, PVR_format, cur_texture_ptr );
+					SOIL_upload_tex_image_2D( 0, opengl_texture_type, mipmap_level - first_level, PVR_type, width, height, PVR_type, PVR_format, cur_texture_ptr, level_size );
 				}
 			}
 
 			if( glGetError() ) {
-				result_string_pointer = "failed: glCompressedTexImage2D() failed.";
+				SOIL_set_result( SOIL_RESULT_GL_ERROR, "failed: glCompressedTexImage2D() failed." );
 				if ( 1 != unpack_aligment )
 				{
 					glPixelStorei(GL_UNPACK_ALIGNMENT, unpack_aligment);
@@ -4260,13 +7401,7 @@ unsigned int SOIL_direct_load_PVR_from_memory( const unsigned char* const buffer
 			}
 
 			// offset the texture pointer by one mip-map level
-			/* PVRTC case */
-			if ( is_compressed_format ) {
-				texture_ptr += compressed_image_size;
-			} else {
-				/* New formula that takes into account bit counts inferior to 8 (e.g. 1 bpp) */
-				texture_ptr += (width * height * header->dwBitCount + 7) / 8;
-			}
+			texture_offset += level_size;
 		}
 	}
 	#undef _MAX
@@ -4310,54 +7445,80 @@ unsigned int SOIL_direct_load_PVR_from_memory( const unsigned char* const buffer
 	return tex_ID;
 }
 
-unsigned int SOIL_direct_load_PVR(
+unsigned int SOIL_direct_load_PVR_from_memory_lod( const unsigned char* const buffer, int buffer_length,
+											   unsigned int reuse_texture_ID, int flags,
+											   int loading_as_cubemap, int skip_mips, int max_dimension ) {
+	SOIL_level_source input;
+	if ( NULL == buffer ) {
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "NULL buffer" );
+		return 0;
+	}
+	SOIL_level_source_memory( &input, buffer, buffer_length );
+	return SOIL_internal_direct_load_PVR( &input, reuse_texture_ID, flags, loading_as_cubemap, skip_mips, max_dimension );
+}
+
+unsigned int SOIL_direct_load_PVR_from_callbacks_lod( const SOIL_io_callbacks *callbacks, void *user,
+											   unsigned int reuse_texture_ID, int flags,
+											   int loading_as_cubemap, int skip_mips, int max_dimension ) {
+	SOIL_level_source input;
+	unsigned int tex_ID;
+	if ( NULL == callbacks || NULL == callbacks->read || NULL == callbacks->skip ) {
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "NULL callbacks" );
+		return 0;
+	}
+	SOIL_level_source_stream( &input, callbacks, user );
+	tex_ID = SOIL_internal_direct_load_PVR( &input, reuse_texture_ID, flags, loading_as_cubemap, skip_mips, max_dimension );
+	if ( 0 == tex_ID ) {
+		SOIL_level_source_check_length( &input );
+	}
+	SOIL_level_source_close( &input );
+	return tex_ID;
+}
+
+unsigned int SOIL_direct_load_PVR_from_callbacks( const SOIL_io_callbacks *callbacks, void *user,
+											   unsigned int reuse_texture_ID, int flags,
+											   int loading_as_cubemap ) {
+	return SOIL_direct_load_PVR_from_callbacks_lod( callbacks, user, reuse_texture_ID, flags, loading_as_cubemap, 0, 0 );
+}
+
+unsigned int SOIL_direct_load_PVR_from_memory( const unsigned char* const buffer, int buffer_length,
+											   unsigned int reuse_texture_ID, int flags,
+											   int loading_as_cubemap ) {
+	return SOIL_direct_load_PVR_from_memory_lod( buffer, buffer_length, reuse_texture_ID, flags, loading_as_cubemap, 0, 0 );
+}
+
+unsigned int SOIL_direct_load_PVR_lod(
 		const char *filename,
 		unsigned int reuse_texture_ID,
 		int flags,
-		int loading_as_cubemap )
+		int loading_as_cubemap,
+		int skip_mips,
+		int max_dimension )
 {
-	FILE *f;
-	unsigned char *buffer;
-	size_t buffer_length, bytes_read;
+	file_map map;
 	unsigned int tex_ID = 0;
-	/*	error checks	*/
-	if( NULL == filename )
-	{
-		result_string_pointer = "NULL filename";
-		return 0;
-	}
-	f = fopen( filename, "rb" );
-	if( NULL == f )
-	{
-		/*	the file doesn't seem to exist (or be open-able)	*/
-		result_string_pointer = "Can not find PVR file";
-		return 0;
-	}
-	fseek( f, 0, SEEK_END );
-	buffer_length = ftell( f );
-	fseek( f, 0, SEEK_SET );
-	buffer = (unsigned char *) malloc( buffer_length );
-	if( NULL == buffer )
+	if( !SOIL_internal_map_file( filename, &map, skip_mips > 0 || max_dimension > 0,
+			"Can not find PVR file" ) )
 	{
-		result_string_pointer = "malloc failed";
-		fclose( f );
 		return 0;
 	}
-	bytes_read = fread( (void*)buffer, 1, buffer_length, f );
-	fclose( f );
-	if( bytes_read < buffer_length )
-	{
-		/*	huh?	*/
-		buffer_length = bytes_read;
-	}
 	/*	now try to do the loading	*/
-	tex_ID = SOIL_direct_load_PVR_from_memory(
-		(const unsigned char *const)buffer, (int)buffer_length,
-		reuse_texture_ID, flags, loading_as_cubemap );
-	SOIL_free_image_data( buffer );
+	tex_ID = SOIL_direct_load_PVR_from_memory_lod(
+		map.data, map.size,
+		reuse_texture_ID, flags, loading_as_cubemap, skip_mips, max_dimension );
+	file_map_close( &map );
 	return tex_ID;
 }
 
+unsigned int SOIL_direct_load_PVR(
+		const char *filename,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap )
+{
+	return SOIL_direct_load_PVR_lod( filename, reuse_texture_ID, flags, loading_as_cubemap, 0, 0 );
+}
+
 static unsigned int SOIL_direct_upload_compressed_2D(
 		const unsigned char *data,
 		unsigned int data_size,
@@ -4369,29 +7530,37 @@ static unsigned int SOIL_direct_upload_compressed_2D(
 {
 	GLuint tex_ID = reuse_texture_ID;
 	const int created_texture = tex_ID == 0;
+	int sub_image;
 
-	if( NULL == soilGlCompressedTexImage2D )
-		soilGlCompressedTexImage2D = get_glCompressedTexImage2D_addr();
-	if( NULL == soilGlCompressedTexImage2D )
+	if( NULL == soil_gl()->soilGlCompressedTexImage2D )
+		soil_gl()->soilGlCompressedTexImage2D = get_glCompressedTexImage2D_addr();
+	if( NULL == soil_gl()->soilGlCompressedTexImage2D )
 	{
-		result_string_pointer = "glCompressedTexImage2D is unavailable";
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "glCompressedTexImage2D is unavailable" );
 		return 0;
 	}
 	if( created_texture )
 		glGenTextures( 1, &tex_ID );
 	if( tex_ID == 0 )
 	{
-		result_string_pointer = "Could not create an OpenGL texture";
+		SOIL_set_result( SOIL_RESULT_GL_ERROR, "Could not create an OpenGL texture" );
 		return 0;
 	}
 
 	while( glGetError() != GL_NO_ERROR ) {}
 	glBindTexture( GL_TEXTURE_2D, tex_ID );
-	soilGlCompressedTexImage2D(
-		GL_TEXTURE_2D, 0, internal_format, width, height, 0, data_size, data );
+	sub_image = SOIL_internal_prepare_storage(
+		GL_TEXTURE_2D, GL_TEXTURE_2D, !created_texture,
+		internal_format, width, height, 1, flags );
+	if( sub_image < 0 )
+	{
+		return 0;
+	}
+	SOIL_upload_compressed_tex_image_2D(
+		sub_image, GL_TEXTURE_2D, 0, internal_format, width, height, data_size, data );
 	if( glGetError() != GL_NO_ERROR )
 	{
-		result_string_pointer = "glCompressedTexImage2D failed";
+		SOIL_set_result( SOIL_RESULT_GL_ERROR, "glCompressedTexImage2D failed" );
 		if( created_texture )
 			glDeleteTextures( 1, &tex_ID );
 		return 0;
@@ -4405,7 +7574,7 @@ static unsigned int SOIL_direct_upload_compressed_2D(
 	glTexParameteri(
 		GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,
 		( flags & SOIL_FLAG_TEXTURE_REPEATS ) ? GL_REPEAT : SOIL_CLAMP_TO_EDGE );
-	result_string_pointer = "Compressed texture loaded";
+	SOIL_set_result( SOIL_RESULT_OK, "Compressed texture loaded" );
 	return tex_ID;
 }
 
@@ -4414,6 +7583,43 @@ static unsigned int SOIL_read_be16( const unsigned char *data )
 	return ( (unsigned int)data[0] << 8 ) | data[1];
 }
 
+/*	uploads the ETC blocks of a PKM file as a block format the driver has,
+	source_format is a TRANSCODE_* format or -1 when it can't be transcoded	*/
+static unsigned int SOIL_direct_transcode_PKM(
+		const unsigned char *const blocks,
+		unsigned int width,
+		unsigned int height,
+		int source_format,
+		const char *unsupported_error,
+		unsigned int reuse_texture_ID,
+		int flags )
+{
+	int target_format;
+	unsigned int internal_format;
+	unsigned char *transcoded;
+	int transcoded_size;
+	unsigned int tex_id;
+
+	if( source_format < 0 ||
+	    !SOIL_internal_transcode_target( source_format, transcode_has_alpha( blocks, width, height, source_format ), 0,
+	                                     &target_format, &internal_format ) )
+	{
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, unsupported_error );
+		return 0;
+	}
+	transcoded = transcode_image( blocks, width, height, source_format, target_format, &transcoded_size );
+	if( NULL == transcoded )
+	{
+		SOIL_set_result( SOIL_RESULT_OUT_OF_MEMORY, "Could not transcode the texture blocks" );
+		return 0;
+	}
+	tex_id = SOIL_direct_upload_compressed_2D(
+		transcoded, (unsigned int)transcoded_size, width, height,
+		internal_format, reuse_texture_ID, flags );
+	free( transcoded );
+	return tex_id;
+}
+
 unsigned int SOIL_direct_load_PKM_from_memory(
 		const unsigned char *const buffer,
 		int buffer_length,
@@ -4431,17 +7637,17 @@ unsigned int SOIL_direct_load_PKM_from_memory(
 
 	if( NULL == buffer )
 	{
-		result_string_pointer = "NULL PKM buffer";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "NULL PKM buffer" );
 		return 0;
 	}
 	if( buffer_length < PKM_HEADER_SIZE )
 	{
-		result_string_pointer = "PKM file is too small to contain a header";
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "PKM file is too small to contain a header" );
 		return 0;
 	}
 	if( memcmp( buffer, "PKM 10", 6 ) != 0 && memcmp( buffer, "PKM 20", 6 ) != 0 )
 	{
-		result_string_pointer = "Unsupported PKM version";
+		SOIL_set_result( SOIL_RESULT_UNSUPPORTED_FORMAT, "Unsupported PKM version" );
 		return 0;
 	}
 
@@ -4454,7 +7660,7 @@ unsigned int SOIL_direct_load_PKM_from_memory(
 	    encoded_width != ( ( width + 3 ) & ~3u ) ||
 	    encoded_height != ( ( height + 3 ) & ~3u ) )
 	{
-		result_string_pointer = "Invalid PKM dimensions";
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "Invalid PKM dimensions" );
 		return 0;
 	}
 
@@ -4494,13 +7700,13 @@ unsigned int SOIL_direct_load_PKM_from_memory(
 		block_size = 16;
 		break;
 	default:
-		result_string_pointer = "Unsupported PKM texture format";
+		SOIL_set_result( SOIL_RESULT_UNSUPPORTED_FORMAT, "Unsupported PKM texture format" );
 		return 0;
 	}
 	if( memcmp( buffer, "PKM 10", 6 ) == 0 &&
 	    format != PKM_FORMAT_ETC1_RGB8 )
 	{
-		result_string_pointer = "PKM 1.0 only supports ETC1 RGB8";
+		SOIL_set_result( SOIL_RESULT_UNSUPPORTED_FORMAT, "PKM 1.0 only supports ETC1 RGB8" );
 		return 0;
 	}
 
@@ -4508,7 +7714,7 @@ unsigned int SOIL_direct_load_PKM_from_memory(
 	if( payload_size > 0x7fffffffu ||
 	    (size_t)buffer_length != PKM_HEADER_SIZE + payload_size )
 	{
-		result_string_pointer = "PKM payload size does not match its header";
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "PKM payload size does not match its header" );
 		return 0;
 	}
 	if( format == PKM_FORMAT_ETC1_RGB8 )
@@ -4518,16 +7724,26 @@ unsigned int SOIL_direct_load_PKM_from_memory(
 		if( !etc1_supported &&
 		    query_ETC2_EAC_capability() != SOIL_CAPABILITY_PRESENT )
 		{
-			result_string_pointer = "ETC1 texture compression is not supported by this OpenGL context";
-			return 0;
+			return SOIL_direct_transcode_PKM( buffer + PKM_HEADER_SIZE, width, height, TRANSCODE_ETC1,
+				"ETC1 texture compression is not supported by this OpenGL context", reuse_texture_ID, flags );
 		}
 		if( !etc1_supported )
 			internal_format = SOIL_GL_COMPRESSED_RGB8_ETC2;
 	}
 	else if( query_ETC2_EAC_capability() != SOIL_CAPABILITY_PRESENT )
 	{
-		result_string_pointer = "ETC2/EAC texture compression is not supported by this OpenGL context";
-		return 0;
+		int source_format = -1;
+		switch( format )
+		{
+		case PKM_FORMAT_ETC2_RGB8:		source_format = TRANSCODE_ETC2_RGB8; break;
+		case PKM_FORMAT_ETC2_RGBA8_OLD:
+		case PKM_FORMAT_ETC2_RGBA8:		source_format = TRANSCODE_ETC2_RGBA8; break;
+		case PKM_FORMAT_ETC2_RGB8A1:	source_format = TRANSCODE_ETC2_RGB8A1; break;
+		case PKM_FORMAT_EAC_R11:		source_format = TRANSCODE_EAC_R11; break;
+		case PKM_FORMAT_EAC_RG11:		source_format = TRANSCODE_EAC_RG11; break;
+		}
+		return SOIL_direct_transcode_PKM( buffer + PKM_HEADER_SIZE, width, height, source_format,
+			"ETC2/EAC texture compression is not supported by this OpenGL context", reuse_texture_ID, flags );
 	}
 
 	return SOIL_direct_upload_compressed_2D(
@@ -4543,47 +7759,15 @@ static unsigned int SOIL_direct_load_compressed_file(
 			const unsigned char *const, int, unsigned int, int ),
 		const char *not_found_error )
 {
-	FILE *file;
-	unsigned char *buffer;
-	long file_size;
-	size_t bytes_read;
+	file_map map;
 	unsigned int texture;
 
-	if( NULL == filename )
-	{
-		result_string_pointer = "NULL filename";
-		return 0;
-	}
-	file = fopen( filename, "rb" );
-	if( NULL == file )
-	{
-		result_string_pointer = not_found_error;
-		return 0;
-	}
-	if( fseek( file, 0, SEEK_END ) != 0 || ( file_size = ftell( file ) ) < 0 ||
-	    file_size > 0x7fffffffL || fseek( file, 0, SEEK_SET ) != 0 )
-	{
-		result_string_pointer = "Could not determine compressed texture file size";
-		fclose( file );
-		return 0;
-	}
-	buffer = (unsigned char *)malloc( (size_t)file_size );
-	if( NULL == buffer )
-	{
-		result_string_pointer = "malloc failed";
-		fclose( file );
-		return 0;
-	}
-	bytes_read = fread( buffer, 1, (size_t)file_size, file );
-	fclose( file );
-	if( bytes_read != (size_t)file_size )
+	if( !SOIL_internal_map_file( filename, &map, 0, not_found_error ) )
 	{
-		result_string_pointer = "Could not read the complete compressed texture file";
-		SOIL_free_image_data( buffer );
 		return 0;
 	}
-	texture = memory_loader( buffer, (int)file_size, reuse_texture_ID, flags );
-	SOIL_free_image_data( buffer );
+	texture = memory_loader( map.data, map.size, reuse_texture_ID, flags );
+	file_map_close( &map );
 	return texture;
 }
 
@@ -4655,18 +7839,18 @@ unsigned int SOIL_direct_load_ASTC_from_memory(
 
 	if( NULL == buffer )
 	{
-		result_string_pointer = "NULL ASTC buffer";
+		SOIL_set_result( SOIL_RESULT_INVALID_ARGUMENT, "NULL ASTC buffer" );
 		return 0;
 	}
 	if( buffer_length < 16 )
 	{
-		result_string_pointer = "ASTC file is too small to contain a header";
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "ASTC file is too small to contain a header" );
 		return 0;
 	}
 	if( buffer[0] != 0x13 || buffer[1] != 0xAB ||
 	    buffer[2] != 0xA1 || buffer[3] != 0x5C )
 	{
-		result_string_pointer = "Invalid ASTC file magic";
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "Invalid ASTC file magic" );
 		return 0;
 	}
 
@@ -4674,20 +7858,20 @@ unsigned int SOIL_direct_load_ASTC_from_memory(
 	block_y = buffer[5];
 	if( buffer[6] != 1 || SOIL_read_le24( buffer + 13 ) != 1 )
 	{
-		result_string_pointer = "3D ASTC textures are not supported";
+		SOIL_set_result( SOIL_RESULT_UNSUPPORTED_FORMAT, "3D ASTC textures are not supported" );
 		return 0;
 	}
 	format_index = SOIL_ASTC_format_index( block_x, block_y );
 	if( format_index < 0 )
 	{
-		result_string_pointer = "Unsupported ASTC 2D block footprint";
+		SOIL_set_result( SOIL_RESULT_UNSUPPORTED_FORMAT, "Unsupported ASTC 2D block footprint" );
 		return 0;
 	}
 	width = SOIL_read_le24( buffer + 7 );
 	height = SOIL_read_le24( buffer + 10 );
 	if( width == 0 || height == 0 )
 	{
-		result_string_pointer = "Invalid ASTC dimensions";
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "Invalid ASTC dimensions" );
 		return 0;
 	}
 	blocks_x = ( (size_t)width + block_x - 1 ) / block_x;
@@ -4695,18 +7879,18 @@ unsigned int SOIL_direct_load_ASTC_from_memory(
 	if( blocks_x > ( (size_t)-1 ) / blocks_y ||
 	    blocks_x * blocks_y > ( (size_t)-1 ) / 16 )
 	{
-		result_string_pointer = "ASTC dimensions overflow the payload size";
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "ASTC dimensions overflow the payload size" );
 		return 0;
 	}
 	payload_size = blocks_x * blocks_y * 16;
 	if( payload_size > 0x7fffffffu || (size_t)buffer_length != 16 + payload_size )
 	{
-		result_string_pointer = "ASTC payload size does not match its header";
+		SOIL_set_result( SOIL_RESULT_DECODE_FAILED, "ASTC payload size does not match its header" );
 		return 0;
 	}
 	if( query_ASTC_LDR_capability() != SOIL_CAPABILITY_PRESENT )
 	{
-		result_string_pointer = "ASTC LDR texture compression is not supported by this OpenGL context";
+		SOIL_set_result( SOIL_RESULT_GL_UNSUPPORTED, "ASTC LDR texture compression is not supported by this OpenGL context" );
 		return 0;
 	}
 
@@ -4732,7 +7916,7 @@ unsigned int SOIL_direct_load_ASTC(
 int query_NPOT_capability( void )
 {
 	/*	check for the capability	*/
-	if( has_NPOT_capability == SOIL_CAPABILITY_UNKNOWN )
+	if( soil_gl()->has_NPOT_capability == SOIL_CAPABILITY_UNKNOWN )
 	{
 		/*	we haven't yet checked for the capability, do so	*/
 		if( (0 == SOIL_GL_ExtensionSupported( "GL_ARB_texture_non_power_of_two" ) ) &&
@@ -4741,25 +7925,25 @@ int query_NPOT_capability( void )
 		  )
 		{
 			/*	not there, flag the failure	*/
-			has_NPOT_capability = SOIL_CAPABILITY_NONE;
+			soil_gl()->has_NPOT_capability = SOIL_CAPABILITY_NONE;
 		} else
 		{
 			/*	it's there!	*/
-			has_NPOT_capability = SOIL_CAPABILITY_PRESENT;
+			soil_gl()->has_NPOT_capability = SOIL_CAPABILITY_PRESENT;
 		}
 
 		#if defined( __emscripten__ ) || defined( EMSCRIPTEN )
-		has_NPOT_capability = SOIL_CAPABILITY_PRESENT;
+		soil_gl()->has_NPOT_capability = SOIL_CAPABILITY_PRESENT;
 		#endif
 	}
 	/*	let the user know if we can do non-power-of-two textures or not	*/
-	return has_NPOT_capability;
+	return soil_gl()->has_NPOT_capability;
 }
 
 int query_tex_rectangle_capability( void )
 {
 	/*	check for the capability	*/
-	if( has_tex_rectangle_capability == SOIL_CAPABILITY_UNKNOWN )
+	if( soil_gl()->has_tex_rectangle_capability == SOIL_CAPABILITY_UNKNOWN )
 	{
 		/*	we haven't yet checked for the capability, do so	*/
 		if(
@@ -4769,21 +7953,21 @@ int query_tex_rectangle_capability( void )
 			!isAtLeastGL3() )
 		{
 			/*	not there, flag the failure	*/
-			has_tex_rectangle_capability = SOIL_CAPABILITY_NONE;
+			soil_gl()->has_tex_rectangle_capability = SOIL_CAPABILITY_NONE;
 		} else
 		{
 			/*	it's there!	*/
-			has_tex_rectangle_capability = SOIL_CAPABILITY_PRESENT;
+			soil_gl()->has_tex_rectangle_capability = SOIL_CAPABILITY_PRESENT;
 		}
 	}
 	/*	let the user know if we can do texture rectangles or not	*/
-	return has_tex_rectangle_capability;
+	return soil_gl()->has_tex_rectangle_capability;
 }
 
 int query_cubemap_capability( void )
 {
 	/*	check for the capability	*/
-	if( has_cubemap_capability == SOIL_CAPABILITY_UNKNOWN )
+	if( soil_gl()->has_cubemap_capability == SOIL_CAPABILITY_UNKNOWN )
 	{
 		/*	we haven't yet checked for the capability, do so	*/
 		if(
@@ -4793,15 +7977,15 @@ int query_cubemap_capability( void )
 		  )
 		{
 			/*	not there, flag the failure	*/
-			has_cubemap_capability = SOIL_CAPABILITY_NONE;
+			soil_gl()->has_cubemap_capability = SOIL_CAPABILITY_NONE;
 		} else
 		{
 			/*	it's there!	*/
-			has_cubemap_capability = SOIL_CAPABILITY_PRESENT;
+			soil_gl()->has_cubemap_capability = SOIL_CAPABILITY_PRESENT;
 		}
 	}
 	/*	let the user know if we can do cubemaps or not	*/
-	return has_cubemap_capability;
+	return soil_gl()->has_cubemap_capability;
 }
 
 static P_SOIL_GLCOMPRESSEDTEXIMAGE2DPROC get_glCompressedTexImage2D_addr()
@@ -4821,7 +8005,7 @@ static P_SOIL_GLCOMPRESSEDTEXIMAGE2DPROC get_glCompressedTexImage2D_addr()
 int query_DXT_capability( void )
 {
 	/*	check for the capability	*/
-	if( has_DXT_capability == SOIL_CAPABILITY_UNKNOWN )
+	if( soil_gl()->has_DXT_capability == SOIL_CAPABILITY_UNKNOWN )
 	{
 		/*	we haven't yet checked for the capability, do so	*/
 		if (	0 == SOIL_GL_ExtensionSupported(
@@ -4836,7 +8020,7 @@ int query_DXT_capability( void )
 			)
 		{
 			/*	not there, flag the failure	*/
-			has_DXT_capability = SOIL_CAPABILITY_NONE;
+			soil_gl()->has_DXT_capability = SOIL_CAPABILITY_NONE;
 		} else
 		{
 			P_SOIL_GLCOMPRESSEDTEXIMAGE2DPROC ext_addr = get_glCompressedTexImage2D_addr();
@@ -4850,22 +8034,22 @@ int query_DXT_capability( void )
 					this means I can upload and have the OpenGL drive do the
 					conversion, but I can't use my own routines or load DDS files
 					from disk and upload them directly [8^(	*/
-				has_DXT_capability = SOIL_CAPABILITY_NONE;
+				soil_gl()->has_DXT_capability = SOIL_CAPABILITY_NONE;
 			} else
 			{
 				/*	all's well!	*/
-				soilGlCompressedTexImage2D = ext_addr;
-				has_DXT_capability = SOIL_CAPABILITY_PRESENT;
+				soil_gl()->soilGlCompressedTexImage2D = ext_addr;
+				soil_gl()->has_DXT_capability = SOIL_CAPABILITY_PRESENT;
 			}
 		}
 	}
 	/*	let the user know if we can do DXT or not	*/
-	return has_DXT_capability;
+	return soil_gl()->has_DXT_capability;
 }
 
 int query_3Dc_capability(void) {
 	/*	check for the capability	*/
-	if (has_3Dc_capability == SOIL_CAPABILITY_UNKNOWN)
+	if (soil_gl()->has_3Dc_capability == SOIL_CAPABILITY_UNKNOWN)
 	{
 		/*	we haven't yet checked for the capability, do so	*/
 		if (0 == SOIL_GL_ExtensionSupported(
@@ -4876,7 +8060,7 @@ int query_3Dc_capability(void) {
 				"GL_EXT_texture_compression_rgtc")
 			) {
 			/*	not there, flag the failure	*/
-			has_3Dc_capability = SOIL_CAPABILITY_NONE;
+			soil_gl()->has_3Dc_capability = SOIL_CAPABILITY_NONE;
 		} else
 		{
 			P_SOIL_GLCOMPRESSEDTEXIMAGE2DPROC ext_addr = get_glCompressedTexImage2D_addr();
@@ -4890,109 +8074,109 @@ int query_3Dc_capability(void) {
 					this means I can upload and have the OpenGL drive do the
 					conversion, but I can't use my own routines or load DDS files
 					from disk and upload them directly [8^(	*/
-				has_3Dc_capability = SOIL_CAPABILITY_NONE;
+				soil_gl()->has_3Dc_capability = SOIL_CAPABILITY_NONE;
 			} else
 			{
 				/*	all's well!	*/
-				soilGlCompressedTexImage2D = ext_addr;
-				has_3Dc_capability = SOIL_CAPABILITY_PRESENT;
+				soil_gl()->soilGlCompressedTexImage2D = ext_addr;
+				soil_gl()->has_3Dc_capability = SOIL_CAPABILITY_PRESENT;
 			}
 		}
 	}
 	/*	let the user know if we can do DXT or not	*/
-	return has_3Dc_capability;
+	return soil_gl()->has_3Dc_capability;
 }
 
 int query_BPTC_capability(void) {
-	if (has_BPTC_capability == SOIL_CAPABILITY_UNKNOWN)
+	if (soil_gl()->has_BPTC_capability == SOIL_CAPABILITY_UNKNOWN)
 	{
 		if (0 == SOIL_GL_ExtensionSupported("GL_ARB_texture_compression_bptc") &&
 		    0 == SOIL_GL_ExtensionSupported("GL_EXT_texture_compression_bptc"))
 		{
-			has_BPTC_capability = SOIL_CAPABILITY_NONE;
+			soil_gl()->has_BPTC_capability = SOIL_CAPABILITY_NONE;
 		}
 		else
 		{
 			P_SOIL_GLCOMPRESSEDTEXIMAGE2DPROC ext_addr = get_glCompressedTexImage2D_addr();
 			if (NULL == ext_addr)
 			{
-				has_BPTC_capability = SOIL_CAPABILITY_NONE;
+				soil_gl()->has_BPTC_capability = SOIL_CAPABILITY_NONE;
 			}
 			else
 			{
-				soilGlCompressedTexImage2D = ext_addr;
-				has_BPTC_capability = SOIL_CAPABILITY_PRESENT;
+				soil_gl()->soilGlCompressedTexImage2D = ext_addr;
+				soil_gl()->has_BPTC_capability = SOIL_CAPABILITY_PRESENT;
 			}
 		}
 	}
-	return has_BPTC_capability;
+	return soil_gl()->has_BPTC_capability;
 }
 
 int query_texture_float_capability(void) {
-	if (has_texture_float_capability == SOIL_CAPABILITY_UNKNOWN)
+	if (soil_gl()->has_texture_float_capability == SOIL_CAPABILITY_UNKNOWN)
 	{
 		if (0 == SOIL_GL_ExtensionSupported("GL_ARB_texture_float") &&
 		    !isAtLeastGL3())
 		{
-			has_texture_float_capability = SOIL_CAPABILITY_NONE;
+			soil_gl()->has_texture_float_capability = SOIL_CAPABILITY_NONE;
 		}
 		else
 		{
-			has_texture_float_capability = SOIL_CAPABILITY_PRESENT;
+			soil_gl()->has_texture_float_capability = SOIL_CAPABILITY_PRESENT;
 		}
 	}
-	return has_texture_float_capability;
+	return soil_gl()->has_texture_float_capability;
 }
 
 int query_PVR_capability( void )
 {
 	/*	check for the capability	*/
-	if( has_PVR_capability == SOIL_CAPABILITY_UNKNOWN )
+	if( soil_gl()->has_PVR_capability == SOIL_CAPABILITY_UNKNOWN )
 	{
 		/*	we haven't yet checked for the capability, do so	*/
 		if (0 == SOIL_GL_ExtensionSupported(
 				"GL_IMG_texture_compression_pvrtc" ) )
 		{
 			/*	not there, flag the failure	*/
-			has_PVR_capability = SOIL_CAPABILITY_NONE;
+			soil_gl()->has_PVR_capability = SOIL_CAPABILITY_NONE;
 		} else
 		{
-			if ( NULL == soilGlCompressedTexImage2D ) {
-				soilGlCompressedTexImage2D = get_glCompressedTexImage2D_addr();
+			if ( NULL == soil_gl()->soilGlCompressedTexImage2D ) {
+				soil_gl()->soilGlCompressedTexImage2D = get_glCompressedTexImage2D_addr();
 			}
 
 			/*	it's there!	*/
-			has_PVR_capability = SOIL_CAPABILITY_PRESENT;
+			soil_gl()->has_PVR_capability = SOIL_CAPABILITY_PRESENT;
 		}
 	}
 	/*	let the user know if we can do cubemaps or not	*/
-	return has_PVR_capability;
+	return soil_gl()->has_PVR_capability;
 }
 
 int query_BGRA8888_capability( void )
 {
 	/*	check for the capability	*/
-	if( has_BGRA8888_capability == SOIL_CAPABILITY_UNKNOWN )
+	if( soil_gl()->has_BGRA8888_capability == SOIL_CAPABILITY_UNKNOWN )
 	{
 		/*	we haven't yet checked for the capability, do so	*/
 		if (0 == SOIL_GL_ExtensionSupported(
 				"GL_IMG_texture_format_BGRA8888" ) )
 		{
 			/*	not there, flag the failure	*/
-			has_BGRA8888_capability = SOIL_CAPABILITY_NONE;
+			soil_gl()->has_BGRA8888_capability = SOIL_CAPABILITY_NONE;
 		} else
 		{
 			/*	it's there!	*/
-			has_BGRA8888_capability = SOIL_CAPABILITY_PRESENT;
+			soil_gl()->has_BGRA8888_capability = SOIL_CAPABILITY_PRESENT;
 		}
 	}
 	/*	let the user know if we can do cubemaps or not	*/
-	return has_BGRA8888_capability;
+	return soil_gl()->has_BGRA8888_capability;
 }
 
 int query_sRGB_capability( void )
 {
-	if ( has_sRGB_capability == SOIL_CAPABILITY_UNKNOWN )
+	if ( soil_gl()->has_sRGB_capability == SOIL_CAPABILITY_UNKNOWN )
 	{
 		if (0 == SOIL_GL_ExtensionSupported( "GL_EXT_texture_sRGB" ) &&
 			0 == SOIL_GL_ExtensionSupported( "GL_EXT_sRGB" ) &&
@@ -5000,39 +8184,39 @@ int query_sRGB_capability( void )
 			!isAtLeastGL3()
 		   )
 		{
-			has_sRGB_capability = SOIL_CAPABILITY_NONE;
+			soil_gl()->has_sRGB_capability = SOIL_CAPABILITY_NONE;
 		} else
 		{
-			has_sRGB_capability = SOIL_CAPABILITY_PRESENT;
+			soil_gl()->has_sRGB_capability = SOIL_CAPABILITY_PRESENT;
 		}
 	}
 
-	return has_sRGB_capability;
+	return soil_gl()->has_sRGB_capability;
 }
 
 int query_ETC1_capability( void )
 {
 	/*	check for the capability	*/
-	if( has_ETC1_capability == SOIL_CAPABILITY_UNKNOWN )
+	if( soil_gl()->has_ETC1_capability == SOIL_CAPABILITY_UNKNOWN )
 	{
 		/*	we haven't yet checked for the capability, do so	*/
 		if (0 == SOIL_GL_ExtensionSupported(
 				"GL_OES_compressed_ETC1_RGB8_texture" ) )
 		{
 			/*	not there, flag the failure	*/
-			has_ETC1_capability = SOIL_CAPABILITY_NONE;
+			soil_gl()->has_ETC1_capability = SOIL_CAPABILITY_NONE;
 		} else
 		{
-			if ( NULL == soilGlCompressedTexImage2D ) {
-				soilGlCompressedTexImage2D = get_glCompressedTexImage2D_addr();
+			if ( NULL == soil_gl()->soilGlCompressedTexImage2D ) {
+				soil_gl()->soilGlCompressedTexImage2D = get_glCompressedTexImage2D_addr();
 			}
 
 			/*	it's there!	*/
-			has_ETC1_capability = SOIL_CAPABILITY_PRESENT;
+			soil_gl()->has_ETC1_capability = SOIL_CAPABILITY_PRESENT;
 		}
 	}
 	/*	let the user know if we can do cubemaps or not	*/
-	return has_ETC1_capability;
+	return soil_gl()->has_ETC1_capability;
 }
 
 static void SOIL_GL_version( int *major, int *minor, int *is_es )
@@ -5056,7 +8240,7 @@ static void SOIL_GL_version( int *major, int *minor, int *is_es )
 
 static int query_ETC2_EAC_capability( void )
 {
-	if( has_ETC2_EAC_capability == SOIL_CAPABILITY_UNKNOWN )
+	if( soil_gl()->has_ETC2_EAC_capability == SOIL_CAPABILITY_UNKNOWN )
 	{
 		int major;
 		int minor;
@@ -5066,32 +8250,32 @@ static int query_ETC2_EAC_capability( void )
 		    ( !is_es && ( major > 4 || ( major == 4 && minor >= 3 ) ) ) ||
 		    SOIL_GL_ExtensionSupported( "GL_ARB_ES3_compatibility" ) )
 		{
-			has_ETC2_EAC_capability = SOIL_CAPABILITY_PRESENT;
+			soil_gl()->has_ETC2_EAC_capability = SOIL_CAPABILITY_PRESENT;
 		}
 		else
 		{
-			has_ETC2_EAC_capability = SOIL_CAPABILITY_NONE;
+			soil_gl()->has_ETC2_EAC_capability = SOIL_CAPABILITY_NONE;
 		}
 	}
-	return has_ETC2_EAC_capability;
+	return soil_gl()->has_ETC2_EAC_capability;
 }
 
 static int query_ASTC_LDR_capability( void )
 {
-	if( has_ASTC_LDR_capability == SOIL_CAPABILITY_UNKNOWN )
+	if( soil_gl()->has_ASTC_LDR_capability == SOIL_CAPABILITY_UNKNOWN )
 	{
 		if( SOIL_GL_ExtensionSupported( "GL_KHR_texture_compression_astc_ldr" ) ||
 		    SOIL_GL_ExtensionSupported( "GL_KHR_texture_compression_astc_hdr" ) ||
 		    SOIL_GL_ExtensionSupported( "GL_OES_texture_compression_astc" ) )
 		{
-			has_ASTC_LDR_capability = SOIL_CAPABILITY_PRESENT;
+			soil_gl()->has_ASTC_LDR_capability = SOIL_CAPABILITY_PRESENT;
 		}
 		else
 		{
-			has_ASTC_LDR_capability = SOIL_CAPABILITY_NONE;
+			soil_gl()->has_ASTC_LDR_capability = SOIL_CAPABILITY_NONE;
 		}
 	}
-	return has_ASTC_LDR_capability;
+	return soil_gl()->has_ASTC_LDR_capability;
 }
 
 int query_gen_mipmap_capability( void )
@@ -5099,7 +8283,7 @@ int query_gen_mipmap_capability( void )
 	/* check for the capability   */
 	P_SOIL_GLGENERATEMIPMAPPROC ext_addr = NULL;
 
-	if( has_gen_mipmap_capability == SOIL_CAPABILITY_UNKNOWN )
+	if( soil_gl()->has_gen_mipmap_capability == SOIL_CAPABILITY_UNKNOWN )
 	{
 		if (	0 == SOIL_GL_ExtensionSupported( "GL_ARB_framebuffer_object" ) &&
 				0 == SOIL_GL_ExtensionSupported( "GL_EXT_framebuffer_object" ) &&
@@ -5108,7 +8292,7 @@ int query_gen_mipmap_capability( void )
 		   )
 		{
 			/* not there, flag the failure */
-			has_gen_mipmap_capability = SOIL_CAPABILITY_NONE;
+			soil_gl()->has_gen_mipmap_capability = SOIL_CAPABILITY_NONE;
 		}
 		else
 		{
@@ -5140,42 +8324,376 @@ int query_gen_mipmap_capability( void )
 		if(ext_addr == NULL)
 		{
 			/* this should never happen */
-			has_gen_mipmap_capability = SOIL_CAPABILITY_NONE;
+			soil_gl()->has_gen_mipmap_capability = SOIL_CAPABILITY_NONE;
 		} else
 		{
 			/* it's there! */
-			has_gen_mipmap_capability = SOIL_CAPABILITY_PRESENT;
-			soilGlGenerateMipmap = ext_addr;
+			soil_gl()->has_gen_mipmap_capability = SOIL_CAPABILITY_PRESENT;
+			soil_gl()->soilGlGenerateMipmap = ext_addr;
 		}
 	}
 
-	return has_gen_mipmap_capability;
+	return soil_gl()->has_gen_mipmap_capability;
 }
 
 int query_teximage3d_capability(void)
 {
 #if defined( SOIL_IMAGE_ARRAY_SUPPORT )
-	if (has_teximage3d_capability == SOIL_CAPABILITY_UNKNOWN)
+	if (soil_gl()->has_teximage3d_capability == SOIL_CAPABILITY_UNKNOWN)
 	{
 
-		soilGlTexImage3D = (P_SOIL_GLTEXIMAGE3DPROC)
+		soil_gl()->soilGlTexImage3D = (P_SOIL_GLTEXIMAGE3DPROC)
 			SOIL_GL_GetProcAddress("glTexImage3D");
 
-		soilGlTexSubImage3D = (P_SOIL_GLTEXSUBIMAGE3DPROC)
+		soil_gl()->soilGlTexSubImage3D = (P_SOIL_GLTEXSUBIMAGE3DPROC)
 			SOIL_GL_GetProcAddress("glTexSubImage3D");
 
-		if (soilGlTexImage3D && soilGlTexSubImage3D)
+		/*	only the direct DDS loader needs these, for block compressed arrays	*/
+		soil_gl()->soilGlCompressedTexImage3D = (P_SOIL_GLCOMPRESSEDTEXIMAGE3DPROC)
+			SOIL_GL_GetProcAddress("glCompressedTexImage3D");
+
+		soil_gl()->soilGlCompressedTexSubImage3D = (P_SOIL_GLCOMPRESSEDTEXSUBIMAGE3DPROC)
+			SOIL_GL_GetProcAddress("glCompressedTexSubImage3D");
+
+		if (soil_gl()->soilGlTexImage3D && soil_gl()->soilGlTexSubImage3D)
 		{
-			has_teximage3d_capability = SOIL_CAPABILITY_PRESENT;
+			soil_gl()->has_teximage3d_capability = SOIL_CAPABILITY_PRESENT;
 		}
 		else
 		{
-			has_teximage3d_capability = SOIL_CAPABILITY_NONE;
+			soil_gl()->has_teximage3d_capability = SOIL_CAPABILITY_NONE;
 		}
 	}
 
-	return has_teximage3d_capability;
+	return soil_gl()->has_teximage3d_capability;
 #else
 	return SOIL_CAPABILITY_NONE;
 #endif
 }
+
+/*	the core entry point, or the ARB one on older drivers	*/
+static void *SOIL_GL_GetProcAddressARB( const char *proc, const char *arb_proc )
+{
+	void *func = SOIL_GL_GetProcAddress( proc );
+
+	if( NULL == func && NULL != arb_proc )
+	{
+		func = SOIL_GL_GetProcAddress( arb_proc );
+	}
+
+	return func;
+}
+
+static int query_PBO_capability( void )
+{
+	if( soil_gl()->has_PBO_capability == SOIL_CAPABILITY_UNKNOWN )
+	{
+#if defined( SOIL_GLES1 )
+		soil_gl()->has_PBO_capability = SOIL_CAPABILITY_NONE;
+#else
+		SOIL_GL_state *gl = soil_gl();
+		int major, minor, is_es;
+		int core;
+
+		/*	part of OpenGL 2.1 and OpenGL ES 3.0	*/
+		SOIL_GL_version( &major, &minor, &is_es );
+		core = is_es ? major >= 3 : ( major > 2 || ( major == 2 && minor >= 1 ) );
+
+		if( !core &&
+			0 == SOIL_GL_ExtensionSupported( "GL_ARB_pixel_buffer_object" ) &&
+			0 == SOIL_GL_ExtensionSupported( "GL_EXT_pixel_buffer_object" ) &&
+			0 == SOIL_GL_ExtensionSupported( "GL_NV_pixel_buffer_object" ) )
+		{
+			gl->has_PBO_capability = SOIL_CAPABILITY_NONE;
+			return SOIL_CAPABILITY_NONE;
+		}
+
+		gl->soilGlGenBuffers = (P_SOIL_GLGENBUFFERSPROC)SOIL_GL_GetProcAddressARB( "glGenBuffers", "glGenBuffersARB" );
+		gl->soilGlDeleteBuffers = (P_SOIL_GLDELETEBUFFERSPROC)SOIL_GL_GetProcAddressARB( "glDeleteBuffers", "glDeleteBuffersARB" );
+		gl->soilGlBindBuffer = (P_SOIL_GLBINDBUFFERPROC)SOIL_GL_GetProcAddressARB( "glBindBuffer", "glBindBufferARB" );
+		gl->soilGlBufferData = (P_SOIL_GLBUFFERDATAPROC)SOIL_GL_GetProcAddressARB( "glBufferData", "glBufferDataARB" );
+		gl->soilGlMapBuffer = (P_SOIL_GLMAPBUFFERPROC)SOIL_GL_GetProcAddressARB( "glMapBuffer", "glMapBufferARB" );
+		gl->soilGlMapBufferRange = (P_SOIL_GLMAPBUFFERRANGEPROC)SOIL_GL_GetProcAddressARB( "glMapBufferRange", "glMapBufferRangeEXT" );
+		gl->soilGlUnmapBuffer = (P_SOIL_GLUNMAPBUFFERPROC)SOIL_GL_GetProcAddressARB( "glUnmapBuffer", "glUnmapBufferARB" );
+
+		/*	fences are optional, they let a buffer be rewritten in place	*/
+		gl->soilGlFenceSync = (P_SOIL_GLFENCESYNCPROC)SOIL_GL_GetProcAddress( "glFenceSync" );
+		gl->soilGlClientWaitSync = (P_SOIL_GLCLIENTWAITSYNCPROC)SOIL_GL_GetProcAddress( "glClientWaitSync" );
+		gl->soilGlDeleteSync = (P_SOIL_GLDELETESYNCPROC)SOIL_GL_GetProcAddress( "glDeleteSync" );
+		if( NULL == gl->soilGlClientWaitSync || NULL == gl->soilGlDeleteSync )
+		{
+			gl->soilGlFenceSync = NULL;
+		}
+
+		if( NULL != gl->soilGlGenBuffers && NULL != gl->soilGlDeleteBuffers &&
+			NULL != gl->soilGlBindBuffer && NULL != gl->soilGlBufferData &&
+			NULL != gl->soilGlUnmapBuffer &&
+			( NULL != gl->soilGlMapBuffer || NULL != gl->soilGlMapBufferRange ) )
+		{
+			gl->has_PBO_capability = SOIL_CAPABILITY_PRESENT;
+		}
+		else
+		{
+			gl->has_PBO_capability = SOIL_CAPABILITY_NONE;
+		}
+#endif
+	}
+
+	return soil_gl()->has_PBO_capability;
+}
+
+static int query_tex_storage_capability( void )
+{
+	if( soil_gl()->has_tex_storage_capability == SOIL_CAPABILITY_UNKNOWN )
+	{
+#if defined( SOIL_GLES1 )
+		soil_gl()->has_tex_storage_capability = SOIL_CAPABILITY_NONE;
+#else
+		SOIL_GL_state *gl = soil_gl();
+		int major, minor, is_es;
+		int core;
+
+		/*	part of OpenGL 4.2 and OpenGL ES 3.0	*/
+		SOIL_GL_version( &major, &minor, &is_es );
+		core = is_es ? major >= 3 : ( major > 4 || ( major == 4 && minor >= 2 ) );
+
+		if( core ||
+			SOIL_GL_ExtensionSupported( "GL_ARB_texture_storage" ) ||
+			SOIL_GL_ExtensionSupported( "GL_EXT_texture_storage" ) )
+		{
+			gl->soilGlTexStorage2D = (P_SOIL_GLTEXSTORAGE2DPROC)SOIL_GL_GetProcAddressARB( "glTexStorage2D", "glTexStorage2DEXT" );
+		}
+
+		/*	the in place updates of compressed levels only need OpenGL 1.3	*/
+		gl->soilGlCompressedTexSubImage2D = (P_SOIL_GLCOMPRESSEDTEXSUBIMAGE2DPROC)SOIL_GL_GetProcAddressARB( "glCompressedTexSubImage2D", "glCompressedTexSubImage2DARB" );
+
+		gl->has_tex_storage_capability = NULL != gl->soilGlTexStorage2D ?
+			SOIL_CAPABILITY_PRESENT : SOIL_CAPABILITY_NONE;
+#endif
+	}
+
+	return soil_gl()->has_tex_storage_capability;
+}
+
+static int query_texture_swizzle_capability( void )
+{
+	if( soil_gl()->has_texture_swizzle_capability == SOIL_CAPABILITY_UNKNOWN )
+	{
+		int major, minor, is_es;
+
+		/*	part of OpenGL 3.3 and OpenGL ES 3.0	*/
+		SOIL_GL_version( &major, &minor, &is_es );
+		if( ( is_es ? major >= 3 : ( major > 3 || ( major == 3 && minor >= 3 ) ) ) ||
+			SOIL_GL_ExtensionSupported( "GL_ARB_texture_swizzle" ) ||
+			SOIL_GL_ExtensionSupported( "GL_EXT_texture_swizzle" ) )
+		{
+			soil_gl()->has_texture_swizzle_capability = SOIL_CAPABILITY_PRESENT;
+		}
+		else
+		{
+			soil_gl()->has_texture_swizzle_capability = SOIL_CAPABILITY_NONE;
+		}
+	}
+
+	return soil_gl()->has_texture_swizzle_capability;
+}
+
+static int query_BGR_unpack_capability( void )
+{
+	if( soil_gl()->has_BGR_unpack_capability == SOIL_CAPABILITY_UNKNOWN )
+	{
+		int major, minor, is_es;
+
+		/*	GL_BGR(A) and the _REV packed types are part of OpenGL 1.2,
+			OpenGL ES only has the RGBA orders	*/
+		SOIL_GL_version( &major, &minor, &is_es );
+		soil_gl()->has_BGR_unpack_capability =
+			( !is_es && ( major > 1 || ( major == 1 && minor >= 2 ) ) ) ?
+				SOIL_CAPABILITY_PRESENT : SOIL_CAPABILITY_NONE;
+	}
+
+	return soil_gl()->has_BGR_unpack_capability;
+}
+
+static int query_unpack_row_length_capability( void )
+{
+	if( soil_gl()->has_unpack_row_length_capability == SOIL_CAPABILITY_UNKNOWN )
+	{
+		int major, minor, is_es;
+
+		/*	in every OpenGL, OpenGL ES 3.0 or with GL_EXT_unpack_subimage	*/
+		SOIL_GL_version( &major, &minor, &is_es );
+		if( ( is_es ? major >= 3 : major >= 1 ) ||
+			SOIL_GL_ExtensionSupported( "GL_EXT_unpack_subimage" ) )
+		{
+			soil_gl()->has_unpack_row_length_capability = SOIL_CAPABILITY_PRESENT;
+		}
+		else
+		{
+			soil_gl()->has_unpack_row_length_capability = SOIL_CAPABILITY_NONE;
+		}
+	}
+
+	return soil_gl()->has_unpack_row_length_capability;
+}
+
+static int query_cubemap_array_capability( void )
+{
+	if( soil_gl()->has_cubemap_array_capability == SOIL_CAPABILITY_UNKNOWN )
+	{
+		int major, minor, is_es;
+
+		/*	part of OpenGL 4.0 and OpenGL ES 3.2	*/
+		SOIL_GL_version( &major, &minor, &is_es );
+		if( ( is_es ? ( major > 3 || ( major == 3 && minor >= 2 ) ) : major >= 4 ) ||
+			SOIL_GL_ExtensionSupported( "GL_ARB_texture_cube_map_array" ) ||
+			SOIL_GL_ExtensionSupported( "GL_EXT_texture_cube_map_array" ) ||
+			SOIL_GL_ExtensionSupported( "GL_OES_texture_cube_map_array" ) )
+		{
+			soil_gl()->has_cubemap_array_capability = SOIL_CAPABILITY_PRESENT;
+		}
+		else
+		{
+			soil_gl()->has_cubemap_array_capability = SOIL_CAPABILITY_NONE;
+		}
+	}
+
+	return soil_gl()->has_cubemap_array_capability;
+}
+
+/*	context taking variants, they only bind the context around the call	*/
+#define SOIL_CONTEXT_CALL( context, call ) \
+	SOIL_Context *previous = SOIL_bind_context( context ); \
+	unsigned int result = call; \
+	SOIL_bind_context( previous ); \
+	return result
+
+unsigned int SOIL_load_OGL_texture_ctx( SOIL_Context *context, const char *filename, int force_channels, unsigned int reuse_texture_ID, unsigned int flags )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_load_OGL_texture( filename, force_channels, reuse_texture_ID, flags ) );
+}
+
+unsigned int SOIL_load_OGL_texture_from_memory_ctx( SOIL_Context *context, const unsigned char *const buffer, int buffer_length, int force_channels, unsigned int reuse_texture_ID, unsigned int flags )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_load_OGL_texture_from_memory( buffer, buffer_length, force_channels, reuse_texture_ID, flags ) );
+}
+
+unsigned int SOIL_load_OGL_cubemap_ctx( SOIL_Context *context, const char *x_pos_file, const char *x_neg_file, const char *y_pos_file, const char *y_neg_file, const char *z_pos_file, const char *z_neg_file, int force_channels, unsigned int reuse_texture_ID, unsigned int flags )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_load_OGL_cubemap( x_pos_file, x_neg_file, y_pos_file, y_neg_file, z_pos_file, z_neg_file, force_channels, reuse_texture_ID, flags ) );
+}
+
+unsigned int SOIL_load_OGL_single_cubemap_ctx( SOIL_Context *context, const char *filename, const char face_order[6], int force_channels, unsigned int reuse_texture_ID, unsigned int flags )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_load_OGL_single_cubemap( filename, face_order, force_channels, reuse_texture_ID, flags ) );
+}
+
+unsigned int SOIL_load_OGL_HDR_texture_f32_ctx( SOIL_Context *context, const char *filename, int hdr_texture_format, unsigned int reuse_texture_ID, unsigned int flags )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_load_OGL_HDR_texture_f32( filename, hdr_texture_format, reuse_texture_ID, flags ) );
+}
+
+unsigned int SOIL_load_OGL_HDR_texture_f32_from_memory_ctx( SOIL_Context *context, const unsigned char *const buffer, int buffer_length, int hdr_texture_format, unsigned int reuse_texture_ID, unsigned int flags )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_load_OGL_HDR_texture_f32_from_memory( buffer, buffer_length, hdr_texture_format, reuse_texture_ID, flags ) );
+}
+
+unsigned int SOIL_create_OGL_texture_ctx( SOIL_Context *context, const unsigned char *const data, int *width, int *height, int channels, unsigned int reuse_texture_ID, unsigned int flags )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_create_OGL_texture( data, width, height, channels, reuse_texture_ID, flags ) );
+}
+
+unsigned int SOIL_create_OGL_single_cubemap_ctx( SOIL_Context *context, const unsigned char *const data, int width, int height, int channels, const char face_order[6], unsigned int reuse_texture_ID, unsigned int flags )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_create_OGL_single_cubemap( data, width, height, channels, face_order, reuse_texture_ID, flags ) );
+}
+
+unsigned int SOIL_upload_image_array_to_gl_ctx( SOIL_Context *context, const SOIL_ImageArray *imgArray, unsigned int reuse_texture_ID, unsigned int flags )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_upload_image_array_to_gl( imgArray, reuse_texture_ID, flags ) );
+}
+
+unsigned int SOIL_direct_load_DDS_ctx( SOIL_Context *context, const char *filename, unsigned int reuse_texture_ID, int flags, int loading_as_cubemap )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_direct_load_DDS( filename, reuse_texture_ID, flags, loading_as_cubemap ) );
+}
+
+unsigned int SOIL_direct_load_DDS_from_memory_ctx( SOIL_Context *context, const unsigned char *const buffer, int buffer_length, unsigned int reuse_texture_ID, int flags, int loading_as_cubemap )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_direct_load_DDS_from_memory( buffer, buffer_length, reuse_texture_ID, flags, loading_as_cubemap ) );
+}
+
+unsigned int SOIL_direct_load_DDS_lod_ctx( SOIL_Context *context, const char *filename, unsigned int reuse_texture_ID, int flags, int loading_as_cubemap, int skip_mips, int max_dimension )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_direct_load_DDS_lod( filename, reuse_texture_ID, flags, loading_as_cubemap, skip_mips, max_dimension ) );
+}
+
+unsigned int SOIL_direct_load_DDS_from_memory_lod_ctx( SOIL_Context *context, const unsigned char *const buffer, int buffer_length, unsigned int reuse_texture_ID, int flags, int loading_as_cubemap, int skip_mips, int max_dimension )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_direct_load_DDS_from_memory_lod( buffer, buffer_length, reuse_texture_ID, flags, loading_as_cubemap, skip_mips, max_dimension ) );
+}
+
+unsigned int SOIL_direct_load_DDS_from_callbacks_ctx( SOIL_Context *context, const SOIL_io_callbacks *callbacks, void *user, unsigned int reuse_texture_ID, int flags, int loading_as_cubemap )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_direct_load_DDS_from_callbacks( callbacks, user, reuse_texture_ID, flags, loading_as_cubemap ) );
+}
+
+unsigned int SOIL_direct_load_DDS_from_callbacks_lod_ctx( SOIL_Context *context, const SOIL_io_callbacks *callbacks, void *user, unsigned int reuse_texture_ID, int flags, int loading_as_cubemap, int skip_mips, int max_dimension )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_direct_load_DDS_from_callbacks_lod( callbacks, user, reuse_texture_ID, flags, loading_as_cubemap, skip_mips, max_dimension ) );
+}
+
+unsigned int SOIL_direct_load_PVR_ctx( SOIL_Context *context, const char *filename, unsigned int reuse_texture_ID, int flags, int loading_as_cubemap )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_direct_load_PVR( filename, reuse_texture_ID, flags, loading_as_cubemap ) );
+}
+
+unsigned int SOIL_direct_load_PVR_from_memory_ctx( SOIL_Context *context, const unsigned char *const buffer, int buffer_length, unsigned int reuse_texture_ID, int flags, int loading_as_cubemap )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_direct_load_PVR_from_memory( buffer, buffer_length, reuse_texture_ID, flags, loading_as_cubemap ) );
+}
+
+unsigned int SOIL_direct_load_PVR_lod_ctx( SOIL_Context *context, const char *filename, unsigned int reuse_texture_ID, int flags, int loading_as_cubemap, int skip_mips, int max_dimension )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_direct_load_PVR_lod( filename, reuse_texture_ID, flags, loading_as_cubemap, skip_mips, max_dimension ) );
+}
+
+unsigned int SOIL_direct_load_PVR_from_memory_lod_ctx( SOIL_Context *context, const unsigned char *const buffer, int buffer_length, unsigned int reuse_texture_ID, int flags, int loading_as_cubemap, int skip_mips, int max_dimension )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_direct_load_PVR_from_memory_lod( buffer, buffer_length, reuse_texture_ID, flags, loading_as_cubemap, skip_mips, max_dimension ) );
+}
+
+unsigned int SOIL_direct_load_PVR_from_callbacks_ctx( SOIL_Context *context, const SOIL_io_callbacks *callbacks, void *user, unsigned int reuse_texture_ID, int flags, int loading_as_cubemap )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_direct_load_PVR_from_callbacks( callbacks, user, reuse_texture_ID, flags, loading_as_cubemap ) );
+}
+
+unsigned int SOIL_direct_load_PVR_from_callbacks_lod_ctx( SOIL_Context *context, const SOIL_io_callbacks *callbacks, void *user, unsigned int reuse_texture_ID, int flags, int loading_as_cubemap, int skip_mips, int max_dimension )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_direct_load_PVR_from_callbacks_lod( callbacks, user, reuse_texture_ID, flags, loading_as_cubemap, skip_mips, max_dimension ) );
+}
+
+unsigned int SOIL_direct_load_PKM_ctx( SOIL_Context *context, const char *filename, unsigned int reuse_texture_ID, int flags )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_direct_load_PKM( filename, reuse_texture_ID, flags ) );
+}
+
+unsigned int SOIL_direct_load_PKM_from_memory_ctx( SOIL_Context *context, const unsigned char *const buffer, int buffer_length, unsigned int reuse_texture_ID, int flags )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_direct_load_PKM_from_memory( buffer, buffer_length, reuse_texture_ID, flags ) );
+}
+
+unsigned int SOIL_direct_load_ASTC_ctx( SOIL_Context *context, const char *filename, unsigned int reuse_texture_ID, int flags )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_direct_load_ASTC( filename, reuse_texture_ID, flags ) );
+}
+
+unsigned int SOIL_direct_load_ASTC_from_memory_ctx( SOIL_Context *context, const unsigned char *const buffer, int buffer_length, unsigned int reuse_texture_ID, int flags )
+{
+	SOIL_CONTEXT_CALL( context, SOIL_direct_load_ASTC_from_memory( buffer, buffer_length, reuse_texture_ID, flags ) );
+}
+
+int SOIL_GL_ExtensionSupported_ctx( SOIL_Context *context, const char *extension )
+{
+	SOIL_CONTEXT_CALL( context, (unsigned int)SOIL_GL_ExtensionSupported( extension ) );
+}
@@ -26,6 +26,7 @@
 	- PNG		load & save
 	- JPG		load & save
 	- QOI		load & save
+	- PKM		load & save
 	- PSD		load
 	- HDR		load
 	- PIC		load
@@ -47,6 +48,7 @@
 #define HEADER_SIMPLE_OPENGL_IMAGE_LIBRARY
 
 #include "image_array_helper.h"
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -88,6 +90,9 @@ enum
 	If the value passed into reuse_texture_ID > 0 then
 	SOIL will just re-use that texture ID (great for
 	reloading image assets in-game!)
+	When the image has the size and format of the texture
+	already there, the texture is updated in place with
+	glTexSubImage2D instead of being reallocated.
 **/
 enum
 {
@@ -107,12 +112,17 @@ enum
 	SOIL_FLAG_TEXTURE_REPEATS: otherwise will clamp
 	SOIL_FLAG_MULTIPLY_ALPHA: for using (GL_ONE,GL_ONE_MINUS_SRC_ALPHA) blending
 	SOIL_FLAG_INVERT_Y: flip the image vertically
-	SOIL_FLAG_COMPRESS_TO_DXT: if the card can display them, will convert RGB to DXT1, RGBA to DXT5
+	SOIL_FLAG_COMPRESS_TO_DXT: if the card can display them, will convert RGB to DXT1, RGBA to DXT5, and L to BC4 and LA to BC5 ( if RGTC and texture swizzles are supported, otherwise to DXT1 and DXT5 )
 	SOIL_FLAG_DDS_LOAD_DIRECT: will load DDS files directly without _ANY_ additional processing ( if supported )
 	SOIL_FLAG_NTSC_SAFE_RGB: clamps RGB components to the range [16,235]
 	SOIL_FLAG_CoCg_Y: Google YCoCg; RGB=>CoYCg, RGBA=>CoCgAY
 	SOIL_FLAG_TEXTURE_RECTANGE: uses ARB_texture_rectangle ; pixel indexed & no repeat or MIPmaps or cubemaps
 	SOIL_FLAG_PVR_LOAD_DIRECT: will load PVR files directly without _ANY_ additional processing ( if supported )
+	SOIL_FLAG_IMMUTABLE_STORAGE: allocates the texture with glTexStorage2D ( if supported ); reloading it into the same ID then requires the same size and format
+	SOIL_FLAG_DXT_DETERMINISTIC: with SOIL_FLAG_COMPRESS_TO_DXT, uses the scalar single threaded DXT encoder, whose output doesn't depend on the CPU
+	SOIL_FLAG_DXT_HIGH_QUALITY: with SOIL_FLAG_COMPRESS_TO_DXT, uses the much slower cluster fit DXT encoder, for the best quality ( with SOIL_FLAG_COMPRESS_TO_BC7, the multi-mode BC7 encoder )
+	SOIL_FLAG_COMPRESS_TO_BC7: if the card supports BPTC, will convert any image to BC7 ( mode 6 only, unless SOIL_FLAG_DXT_HIGH_QUALITY ), otherwise acts as SOIL_FLAG_COMPRESS_TO_DXT
+	SOIL_FLAG_COMPRESS_TO_ETC2: if the card supports ETC2, will convert RGB / L images to ETC2 RGB8 and RGBA / LA images to ETC2 RGBA8 ( EAC alpha ), otherwise acts as SOIL_FLAG_COMPRESS_TO_DXT ( SOIL_FLAG_COMPRESS_TO_BC7 wins when both are set )
 **/
 enum
 {
@@ -129,7 +139,12 @@ enum
 	SOIL_FLAG_PVR_LOAD_DIRECT = 1024,
 	SOIL_FLAG_ETC1_LOAD_DIRECT = 2048,
 	SOIL_FLAG_GL_MIPMAPS = 4096,
-	SOIL_FLAG_SRGB_COLOR_SPACE = 8192
+	SOIL_FLAG_SRGB_COLOR_SPACE = 8192,
+	SOIL_FLAG_IMMUTABLE_STORAGE = 16384,
+	SOIL_FLAG_DXT_DETERMINISTIC = 32768,
+	SOIL_FLAG_DXT_HIGH_QUALITY = 65536,
+	SOIL_FLAG_COMPRESS_TO_BC7 = 131072,
+	SOIL_FLAG_COMPRESS_TO_ETC2 = 262144
 };
 
 /**
@@ -138,6 +153,7 @@ enum
 	(BMP supports uncompressed RGB)
 	(DDS supports DXT1 and DXT5)
 	(PNG supports RGB / RGBA)
+	(PKM supports ETC2 RGB8 / RGBA8)
 **/
 enum
 {
@@ -146,7 +162,36 @@ enum
 	SOIL_SAVE_TYPE_PNG = 2,
 	SOIL_SAVE_TYPE_DDS = 3,
 	SOIL_SAVE_TYPE_JPG = 4,
-	SOIL_SAVE_TYPE_QOI = 5
+	SOIL_SAVE_TYPE_QOI = 5,
+	SOIL_SAVE_TYPE_PKM = 6
+};
+
+/**
+	The result codes reported by SOIL_last_result_code().
+
+	SOIL_RESULT_OK: the last call succeeded
+	SOIL_RESULT_INVALID_ARGUMENT: a parameter was NULL, out of range or inconsistent
+	SOIL_RESULT_FILE_NOT_FOUND: the file could not be opened
+	SOIL_RESULT_IO_ERROR: reading or writing a file failed
+	SOIL_RESULT_OUT_OF_MEMORY: an allocation failed
+	SOIL_RESULT_DECODE_FAILED: the image data is corrupt or could not be decoded
+	SOIL_RESULT_UNSUPPORTED_FORMAT: the file is valid but uses a format SOIL can't handle
+	SOIL_RESULT_GL_UNSUPPORTED: the OpenGL context lacks a required capability
+	SOIL_RESULT_GL_ERROR: an OpenGL call failed
+	SOIL_RESULT_PROCESSING_FAILED: resizing or mipmapping the image failed
+**/
+enum
+{
+	SOIL_RESULT_OK = 0,
+	SOIL_RESULT_INVALID_ARGUMENT = 1,
+	SOIL_RESULT_FILE_NOT_FOUND = 2,
+	SOIL_RESULT_IO_ERROR = 3,
+	SOIL_RESULT_OUT_OF_MEMORY = 4,
+	SOIL_RESULT_DECODE_FAILED = 5,
+	SOIL_RESULT_UNSUPPORTED_FORMAT = 6,
+	SOIL_RESULT_GL_UNSUPPORTED = 7,
+	SOIL_RESULT_GL_ERROR = 8,
+	SOIL_RESULT_PROCESSING_FAILED = 9
 };
 
 /**
@@ -184,11 +229,17 @@ enum
 	The source Radiance HDR image is always decoded to linear 32-bit float RGB.
 	SOIL_HDR_TEXTURE_RGB16F reduces GPU memory use while
 	SOIL_HDR_TEXTURE_RGB32F preserves the decoded precision.
+	SOIL_HDR_TEXTURE_BC6H compresses each level to BC6H (unsigned float) on
+	the CPU, 1 byte per texel or 8:1 versus RGB16F; negative values clamp to 0
+	and values above 65504 saturate. Without BPTC support it falls back to
+	RGB16F, and SOIL_FLAG_GL_MIPMAPS is replaced by SOIL_FLAG_MIPMAPS since
+	drivers can't generate the mipmaps of compressed textures.
 **/
 enum
 {
 	SOIL_HDR_TEXTURE_RGB16F = 0,
-	SOIL_HDR_TEXTURE_RGB32F = 1
+	SOIL_HDR_TEXTURE_RGB32F = 1,
+	SOIL_HDR_TEXTURE_BC6H = 2
 };
 
 /**
@@ -294,8 +345,8 @@ unsigned int
 	the image into an 8-bit fake-HDR representation.
 
 	\param filename the name of the Radiance HDR file to upload
-	\param hdr_texture_format SOIL_HDR_TEXTURE_RGB16F or
-	       SOIL_HDR_TEXTURE_RGB32F
+	\param hdr_texture_format SOIL_HDR_TEXTURE_RGB16F,
+	       SOIL_HDR_TEXTURE_RGB32F or SOIL_HDR_TEXTURE_BC6H
 	\param reuse_texture_ID 0-generate a new texture ID, otherwise reuse it
 	\param flags may contain SOIL_FLAG_POWER_OF_TWO | SOIL_FLAG_MIPMAPS |
 	       SOIL_FLAG_GL_MIPMAPS | SOIL_FLAG_TEXTURE_REPEATS |
@@ -536,6 +587,214 @@ unsigned char*
 		int force_channels
 	);
 
+/**
+	Describes one image of a batch.  Set filename to load from disk,
+	or leave it NULL and set buffer and buffer_length to load from memory.
+**/
+typedef struct
+{
+	const char *filename;
+	const unsigned char *buffer;
+	int buffer_length;
+	int force_channels;
+} SOIL_LoadDesc;
+
+/**
+	The outcome of one image of a batch.  data is NULL if the image failed,
+	result_code and result_string then tell why (see SOIL_last_result_code()).
+	Free data with SOIL_free_image_data.
+**/
+typedef struct
+{
+	unsigned char *data;
+	int width, height, channels;
+	int result_code;
+	const char *result_string;
+} SOIL_Image;
+
+/**
+	A pool of decoding threads, reusable across batches.
+**/
+typedef struct SOIL_ThreadPool SOIL_ThreadPool;
+
+/**
+	Creates a thread pool.
+	\param thread_count the number of threads, 0 uses one per processor
+	\return the pool, or NULL if it could not be created
+**/
+SOIL_ThreadPool *
+	SOIL_create_thread_pool
+	(
+		int thread_count
+	);
+
+/**
+	Waits for the queued work and frees the pool.
+**/
+void
+	SOIL_free_thread_pool
+	(
+		SOIL_ThreadPool *pool
+	);
+
+/**
+	Decodes count images concurrently with SOIL_load_image semantics.
+	Uses a pool shared by the process, created on first use with one
+	thread per processor.
+	\param descs the images to load
+	\param images receives the result of every image, in the same order
+	\return the number of images that loaded successfully
+**/
+int
+	SOIL_load_images_batch
+	(
+		const SOIL_LoadDesc *descs,
+		int count,
+		SOIL_Image *images
+	);
+
+/**
+	Same as SOIL_load_images_batch, on the given pool.
+	The calling thread helps decoding until the batch is done.
+**/
+int
+	SOIL_load_images_batch_pool
+	(
+		SOIL_ThreadPool *pool,
+		const SOIL_LoadDesc *descs,
+		int count,
+		SOIL_Image *images
+	);
+
+/**
+	The state of an asynchronous texture request
+**/
+enum
+{
+	SOIL_ASYNC_DECODING = 0,
+	SOIL_ASYNC_UPLOADING = 1,
+	SOIL_ASYNC_COMPLETE = 2,
+	SOIL_ASYNC_FAILED = 3,
+	SOIL_ASYNC_CANCELLED = 4
+};
+
+/**
+	An asynchronous texture request.  Decoding and every CPU step of
+	SOIL_load_OGL_texture (flipping, color transforms, resizing, MIPmaps
+	and DXT compression) run on the shared thread pool, the OpenGL thread
+	only uploads the prepared levels from SOIL_async_pump().
+	All the SOIL_async functions must be called from the thread that owns
+	the OpenGL context.
+**/
+typedef struct SOIL_AsyncTexture SOIL_AsyncTexture;
+
+/**
+	Starts loading an image as a texture, see SOIL_load_OGL_texture().
+	Images are decoded with SOIL_load_image, the direct DDS, PVR and
+	PKM uploads aren't used.
+	\return the request, or NULL if out of memory.  Release it with SOIL_async_free
+**/
+SOIL_AsyncTexture *
+	SOIL_load_OGL_texture_async
+	(
+		const char *filename,
+		int force_channels,
+		unsigned int reuse_texture_ID,
+		unsigned int flags
+	);
+
+/**
+	Same as SOIL_load_OGL_texture_async, from memory.
+	The buffer must stay valid until the request leaves SOIL_ASYNC_DECODING.
+**/
+SOIL_AsyncTexture *
+	SOIL_load_OGL_texture_from_memory_async
+	(
+		const unsigned char *const buffer,
+		int buffer_length,
+		int force_channels,
+		unsigned int reuse_texture_ID,
+		unsigned int flags
+	);
+
+/**
+	Uploads prepared requests in submission order until budget_us
+	microseconds have passed.  Large textures are uploaded one MIPmap level
+	at a time, and at least one level is uploaded per call.
+	\return the number of textures completed by this call
+**/
+int
+	SOIL_async_pump
+	(
+		unsigned int budget_us
+	);
+
+/**
+	\return the state of the request, one of the SOIL_ASYNC_ values
+**/
+int
+	SOIL_async_poll
+	(
+		SOIL_AsyncTexture *request
+	);
+
+/**
+	Blocks until the request is decoded (helping the thread pool while
+	waiting), then uploads it right away.  The request's result becomes
+	the last result of the calling thread.
+	\return the texture ID, 0 if the request failed or was cancelled
+**/
+unsigned int
+	SOIL_async_wait
+	(
+		SOIL_AsyncTexture *request
+	);
+
+/**
+	Cancels a request that hasn't completed yet.  A texture name that
+	SOIL generated for a partly uploaded request is deleted.
+	\return 1 if the request was cancelled, 0 if it had already finished
+**/
+int
+	SOIL_async_cancel
+	(
+		SOIL_AsyncTexture *request
+	);
+
+/**
+	\return the texture ID of a completed request, 0 otherwise
+**/
+unsigned int
+	SOIL_async_texture_id
+	(
+		SOIL_AsyncTexture *request
+	);
+
+/**
+	\return the result of the request, see SOIL_last_result_code() and SOIL_last_result()
+**/
+int
+	SOIL_async_result_code
+	(
+		SOIL_AsyncTexture *request
+	);
+
+const char *
+	SOIL_async_result
+	(
+		SOIL_AsyncTexture *request
+	);
+
+/**
+	Releases the request, cancelling it if it hasn't completed.
+	The texture of a completed request is left alone.
+**/
+void
+	SOIL_async_free
+	(
+		SOIL_AsyncTexture *request
+	);
+
 /**
 	Saves an image from an array of unsigned chars (RGBA) to disk
 	\param quality parameter only used for SOIL_SAVE_TYPE_JPG files, values accepted between 0 and 100.
@@ -561,6 +820,24 @@ int
 	);
 
 
+/**
+	Saves an image from an array of unsigned chars (RGBA) to a DDS file
+	( DXT1 for RGB, DXT5 for RGBA, BC4 for L and BC5 for LA, or BC7 for any of them ), and measures the compression error.
+	\param flags can be SOIL_FLAG_DXT_HIGH_QUALITY ( cluster fit, for offline baking ) | SOIL_FLAG_DXT_DETERMINISTIC | SOIL_FLAG_COMPRESS_TO_BC7
+	\param rmse if not NULL, receives the root mean square error of the saved image
+	\param psnr if not NULL, receives the peak signal to noise ratio of the saved image in dB ( HUGE_VAL if lossless )
+	\return 0 if failed, otherwise returns 1
+**/
+int
+	SOIL_save_image_DDS
+	(
+		const char *filename,
+		int width, int height, int channels,
+		const unsigned char *const data,
+		unsigned int flags,
+		double *rmse, double *psnr
+	);
+
 /**
 	Saves an image from an array of unsigned chars (RGBA) to a memory buffer in the target format.
 	Free the buffer with SOIL_free_image_data.
@@ -715,6 +992,8 @@ unsigned int SOIL_upload_image_array_to_gl(
 	This function returns a pointer to a string describing the last thing
 	that happened inside SOIL.  It can be used to determine why an image
 	failed to load.
+	The result is tracked per thread, so it always describes the last
+	SOIL call made from the calling thread.
 **/
 const char*
 	SOIL_last_result
@@ -722,6 +1001,17 @@ const char*
 		void
 	);
 
+/**
+	This function returns one of the SOIL_RESULT_* codes for the last
+	thing that happened inside SOIL on the calling thread.  It pairs with
+	the message returned by SOIL_last_result().
+**/
+int
+	SOIL_last_result_code
+	(
+		void
+	);
+
 /** @return The address of the GL function proc, or NULL if the function is not found. */
 void *
 	SOIL_GL_GetProcAddress
@@ -736,7 +1026,26 @@ int
 		const char *extension
 	);
 
-/** Loads the DDS texture directly to the GPU memory ( if supported ) */
+/**
+	Reads a file for the _from_callbacks loaders, laid out like
+	stbi_io_callbacks so the same callbacks serve both.  read fills data
+	with up to size bytes and returns how many it read, skip moves the
+	position n bytes ahead, or back when n is negative, and eof returns
+	nonzero at the end of the file.
+**/
+typedef struct
+{
+	int ( *read )( void *user, char *data, int size );
+	void ( *skip )( void *user, int n );
+	int ( *eof )( void *user );
+} SOIL_io_callbacks;
+
+/**
+	Loads the DDS texture directly to the GPU memory ( if supported )
+	DX10 arrays come back as a GL_TEXTURE_2D_ARRAY, DX10 cubemap arrays as a
+	GL_TEXTURE_CUBE_MAP_ARRAY and volume textures as a GL_TEXTURE_3D, with
+	loading_as_cubemap 0.
+**/
 unsigned int SOIL_direct_load_DDS(
 		const char *filename,
 		unsigned int reuse_texture_ID,
@@ -751,6 +1060,62 @@ unsigned int SOIL_direct_load_DDS_from_memory(
 		int flags,
 		int loading_as_cubemap );
 
+/**
+	Loads the DDS texture directly to the GPU memory ( if supported ),
+	leaving out the largest levels to fit a memory budget.  The levels
+	stored in the file from skip_mips down are uploaded as levels 0, 1, ...
+	and more are left out until no side of the top one is larger than
+	max_dimension ( 0 for no limit ).  The smallest stored level is
+	always kept, and the skipped levels are never read, the file is
+	mapped without read ahead.
+**/
+unsigned int SOIL_direct_load_DDS_lod(
+		const char *filename,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap,
+		int skip_mips,
+		int max_dimension );
+
+/** SOIL_direct_load_DDS_lod from a DDS file in memory */
+unsigned int SOIL_direct_load_DDS_from_memory_lod(
+		const unsigned char *const buffer,
+		int buffer_length,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap,
+		int skip_mips,
+		int max_dimension );
+
+/**
+	Loads the DDS texture directly to the GPU memory ( if supported ),
+	reading the file through callbacks instead of taking all of it in
+	memory.  The header gives where each level is, and the levels are
+	read one at a time into a staging buffer that is reused, so at most
+	one level of one face or layer (of a volume texture, one level with
+	all its slices) is in memory.  skip must be able to
+	move back: the last byte of the image is read first, to check the
+	size in the header, and the chains of an array are interleaved.
+	Only the first 2GB of a stream are read, a larger file fails with
+	SOIL_RESULT_IO_ERROR.
+**/
+unsigned int SOIL_direct_load_DDS_from_callbacks(
+		const SOIL_io_callbacks *callbacks,
+		void *user,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap );
+
+/** SOIL_direct_load_DDS_lod through callbacks, the skipped levels are stepped over */
+unsigned int SOIL_direct_load_DDS_from_callbacks_lod(
+		const SOIL_io_callbacks *callbacks,
+		void *user,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap,
+		int skip_mips,
+		int max_dimension );
+
 /** Loads the PVR texture directly to the GPU memory ( if supported ) */
 unsigned int SOIL_direct_load_PVR(
 		const char *filename,
@@ -766,6 +1131,43 @@ unsigned int SOIL_direct_load_PVR_from_memory(
 		int flags,
 		int loading_as_cubemap );
 
+/** Loads the PVR texture leaving out the largest levels, like SOIL_direct_load_DDS_lod */
+unsigned int SOIL_direct_load_PVR_lod(
+		const char *filename,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap,
+		int skip_mips,
+		int max_dimension );
+
+/** SOIL_direct_load_PVR_lod from a PVR file in memory */
+unsigned int SOIL_direct_load_PVR_from_memory_lod(
+		const unsigned char *const buffer,
+		int buffer_length,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap,
+		int skip_mips,
+		int max_dimension );
+
+/** Loads the PVR texture through callbacks, a level at a time, like SOIL_direct_load_DDS_from_callbacks */
+unsigned int SOIL_direct_load_PVR_from_callbacks(
+		const SOIL_io_callbacks *callbacks,
+		void *user,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap );
+
+/** SOIL_direct_load_PVR_lod through callbacks, the skipped levels are stepped over */
+unsigned int SOIL_direct_load_PVR_from_callbacks_lod(
+		const SOIL_io_callbacks *callbacks,
+		void *user,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap,
+		int skip_mips,
+		int max_dimension );
+
 /** Loads a PKM 1.0 or PKM 2.0 texture directly to GPU memory (if supported). */
 unsigned int SOIL_direct_load_PKM(const char *filename,
 		unsigned int reuse_texture_ID,
@@ -799,6 +1201,287 @@ unsigned int SOIL_direct_load_ASTC_from_memory(const unsigned char *const buffer
 		unsigned int reuse_texture_ID,
 		int flags );
 
+/**
+	Memory hooks used for everything a SOIL_Context owns (the context
+	itself, its extension set and its scratch buffers).
+	Image data returned to the caller is always allocated with malloc, so
+	SOIL_free_image_data() stays valid whichever context loaded it.
+**/
+typedef struct
+{
+	void *(*allocate)( size_t size, void *user_data );
+	void (*release)( void *memory, void *user_data );
+	void *user_data;
+} SOIL_Allocator;
+
+/**
+	A SOIL context holds a snapshot of one OpenGL context's capabilities
+	(taken once, with the extensions kept in a hash set), the resolved
+	OpenGL entry points, the allocator hooks and reusable scratch memory.
+	Without a context SOIL keeps using its process wide cache, which assumes
+	a single OpenGL context.
+**/
+typedef struct SOIL_Context SOIL_Context;
+
+/**
+	Creates a context for the OpenGL context that is current on the calling
+	thread and snapshots all its capabilities.
+	\param allocator the memory hooks, or NULL to use malloc and free
+	\return the new context, or NULL if the allocation failed
+**/
+SOIL_Context *
+	SOIL_create_context
+	(
+		const SOIL_Allocator *allocator
+	);
+
+/**
+	Releases a context and everything it owns.  It must not be bound on any thread.
+	If PBO uploads were enabled for it, its OpenGL context must be current.
+**/
+void
+	SOIL_free_context
+	(
+		SOIL_Context *context
+	);
+
+/**
+	Binds a context to the calling thread, every SOIL call made from this
+	thread then uses it.  Pass NULL to go back to the process wide cache.
+	\return the context that was bound before
+**/
+SOIL_Context *
+	SOIL_bind_context
+	(
+		SOIL_Context *context
+	);
+
+/**
+	Sources every texture upload from a ring of pixel buffer objects.
+	The pixels are copied into a mapped buffer and OpenGL reads them from
+	there, so the uploads no longer wait for the driver to copy client
+	memory.  Applies to the bound context, or to the process wide cache,
+	and to the OpenGL context that is current on the calling thread.
+	\param ring_size the number of buffers (at most 8), 0 deletes them and goes back to plain uploads
+	\return 1 if PBO uploads are on, 0 if disabled or unsupported
+**/
+int
+	SOIL_enable_PBO_uploads
+	(
+		int ring_size
+	);
+
+/**
+	Context taking variants of the OpenGL entry points.  Each one binds the
+	context for the duration of the call, see SOIL_bind_context() for the
+	rest of the API.
+**/
+unsigned int SOIL_load_OGL_texture_ctx(
+		SOIL_Context *context,
+		const char *filename,
+		int force_channels,
+		unsigned int reuse_texture_ID,
+		unsigned int flags );
+
+unsigned int SOIL_load_OGL_texture_from_memory_ctx(
+		SOIL_Context *context,
+		const unsigned char *const buffer,
+		int buffer_length,
+		int force_channels,
+		unsigned int reuse_texture_ID,
+		unsigned int flags );
+
+unsigned int SOIL_load_OGL_cubemap_ctx(
+		SOIL_Context *context,
+		const char *x_pos_file,
+		const char *x_neg_file,
+		const char *y_pos_file,
+		const char *y_neg_file,
+		const char *z_pos_file,
+		const char *z_neg_file,
+		int force_channels,
+		unsigned int reuse_texture_ID,
+		unsigned int flags );
+
+unsigned int SOIL_load_OGL_single_cubemap_ctx(
+		SOIL_Context *context,
+		const char *filename,
+		const char face_order[6],
+		int force_channels,
+		unsigned int reuse_texture_ID,
+		unsigned int flags );
+
+unsigned int SOIL_load_OGL_HDR_texture_f32_ctx(
+		SOIL_Context *context,
+		const char *filename,
+		int hdr_texture_format,
+		unsigned int reuse_texture_ID,
+		unsigned int flags );
+
+unsigned int SOIL_load_OGL_HDR_texture_f32_from_memory_ctx(
+		SOIL_Context *context,
+		const unsigned char *const buffer,
+		int buffer_length,
+		int hdr_texture_format,
+		unsigned int reuse_texture_ID,
+		unsigned int flags );
+
+unsigned int SOIL_create_OGL_texture_ctx(
+		SOIL_Context *context,
+		const unsigned char *const data,
+		int *width, int *height, int channels,
+		unsigned int reuse_texture_ID,
+		unsigned int flags );
+
+unsigned int SOIL_create_OGL_single_cubemap_ctx(
+		SOIL_Context *context,
+		const unsigned char *const data,
+		int width, int height, int channels,
+		const char face_order[6],
+		unsigned int reuse_texture_ID,
+		unsigned int flags );
+
+unsigned int SOIL_upload_image_array_to_gl_ctx(
+		SOIL_Context *context,
+		const SOIL_ImageArray *imgArray,
+		unsigned int reuse_texture_ID,
+		unsigned int flags );
+
+unsigned int SOIL_direct_load_DDS_ctx(
+		SOIL_Context *context,
+		const char *filename,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap );
+
+unsigned int SOIL_direct_load_DDS_from_memory_ctx(
+		SOIL_Context *context,
+		const unsigned char *const buffer,
+		int buffer_length,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap );
+
+unsigned int SOIL_direct_load_DDS_lod_ctx(
+		SOIL_Context *context,
+		const char *filename,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap,
+		int skip_mips,
+		int max_dimension );
+
+unsigned int SOIL_direct_load_DDS_from_memory_lod_ctx(
+		SOIL_Context *context,
+		const unsigned char *const buffer,
+		int buffer_length,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap,
+		int skip_mips,
+		int max_dimension );
+
+unsigned int SOIL_direct_load_DDS_from_callbacks_ctx(
+		SOIL_Context *context,
+		const SOIL_io_callbacks *callbacks,
+		void *user,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap );
+
+unsigned int SOIL_direct_load_DDS_from_callbacks_lod_ctx(
+		SOIL_Context *context,
+		const SOIL_io_callbacks *callbacks,
+		void *user,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap,
+		int skip_mips,
+		int max_dimension );
+
+unsigned int SOIL_direct_load_PVR_ctx(
+		SOIL_Context *context,
+		const char *filename,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap );
+
+unsigned int SOIL_direct_load_PVR_from_memory_ctx(
+		SOIL_Context *context,
+		const unsigned char *const buffer,
+		int buffer_length,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap );
+
+unsigned int SOIL_direct_load_PVR_lod_ctx(
+		SOIL_Context *context,
+		const char *filename,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap,
+		int skip_mips,
+		int max_dimension );
+
+unsigned int SOIL_direct_load_PVR_from_memory_lod_ctx(
+		SOIL_Context *context,
+		const unsigned char *const buffer,
+		int buffer_length,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap,
+		int skip_mips,
+		int max_dimension );
+
+unsigned int SOIL_direct_load_PVR_from_callbacks_ctx(
+		SOIL_Context *context,
+		const SOIL_io_callbacks *callbacks,
+		void *user,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap );
+
+unsigned int SOIL_direct_load_PVR_from_callbacks_lod_ctx(
+		SOIL_Context *context,
+		const SOIL_io_callbacks *callbacks,
+		void *user,
+		unsigned int reuse_texture_ID,
+		int flags,
+		int loading_as_cubemap,
+		int skip_mips,
+		int max_dimension );
+
+unsigned int SOIL_direct_load_PKM_ctx(
+		SOIL_Context *context,
+		const char *filename,
+		unsigned int reuse_texture_ID,
+		int flags );
+
+unsigned int SOIL_direct_load_PKM_from_memory_ctx(
+		SOIL_Context *context,
+		const unsigned char *const buffer,
+		int buffer_length,
+		unsigned int reuse_texture_ID,
+		int flags );
+
+unsigned int SOIL_direct_load_ASTC_ctx(
+		SOIL_Context *context,
+		const char *filename,
+		unsigned int reuse_texture_ID,
+		int flags );
+
+unsigned int SOIL_direct_load_ASTC_from_memory_ctx(
+		SOIL_Context *context,
+		const unsigned char *const buffer,
+		int buffer_length,
+		unsigned int reuse_texture_ID,
+		int flags );
+
+/** Same as SOIL_GL_ExtensionSupported(), answered from the context's extension set. */
+int SOIL_GL_ExtensionSupported_ctx(
+		SOIL_Context *context,
+		const char *extension );
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,424 @@
+/*
+	read only file input for the loaders
+
+	MIT license
+*/
+
+#if !defined( _WIN32 ) && !defined( _POSIX_C_SOURCE ) && !defined( __APPLE__ )
+	/*	posix_madvise on strict C builds	*/
+	#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "file_map.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#if defined( _WIN32 )
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+	#define FILE_MAP_WIN32
+#elif defined( __unix__ ) || defined( __unix ) || defined( __APPLE__ ) || defined( __HAIKU__ )
+	#include <sys/types.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <errno.h>
+	#if !defined( SOIL_NO_MMAP )
+		#include <sys/mman.h>
+	#endif
+	#define FILE_MAP_POSIX
+#endif
+
+/*	below this a read is cheaper than setting up and tearing down a mapping	*/
+#define FILE_MAP_MIN_MAPPED_SIZE	(64 * 1024)
+
+static void
+	file_map_clear
+	(
+		file_map *map
+	)
+{
+	map->data = NULL;
+	map->size = 0;
+	map->mapped = 0;
+}
+
+/*	a buffer for the whole file, never NULL for an empty file	*/
+static unsigned char*
+	file_map_alloc
+	(
+		size_t size
+	)
+{
+	return (unsigned char*)malloc( size > 0 ? size : 1 );
+}
+
+#if defined( FILE_MAP_WIN32 )
+
+int
+	file_map_open
+	(
+		const char *filename,
+		file_map *map
+	)
+{
+	HANDLE file;
+	LARGE_INTEGER file_size;
+	unsigned char *buffer;
+	DWORD total = 0;
+	file_map_clear( map );
+	if( NULL == filename )
+	{
+		return FILE_MAP_NOT_FOUND;
+	}
+	file = CreateFileA( filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+	if( INVALID_HANDLE_VALUE == file )
+	{
+		return FILE_MAP_NOT_FOUND;
+	}
+	if( !GetFileSizeEx( file, &file_size ) || file_size.QuadPart < 0 )
+	{
+		CloseHandle( file );
+		return FILE_MAP_READ_FAILED;
+	}
+	if( file_size.QuadPart > 0x7fffffff )
+	{
+		CloseHandle( file );
+		return FILE_MAP_TOO_LARGE;
+	}
+#if !defined( SOIL_NO_MMAP )
+	if( file_size.QuadPart >= FILE_MAP_MIN_MAPPED_SIZE )
+	{
+		/*	the view keeps the file open once the handles are closed	*/
+		HANDLE mapping = CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL );
+		void *view = mapping ? MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) : NULL;
+		if( mapping )
+		{
+			CloseHandle( mapping );
+		}
+		if( NULL != view )
+		{
+			CloseHandle( file );
+			map->data = (const unsigned char*)view;
+			map->size = (int)file_size.QuadPart;
+			map->mapped = 1;
+			return FILE_MAP_OK;
+		}
+	}
+#endif
+	buffer = file_map_alloc( (size_t)file_size.QuadPart );
+	if( NULL == buffer )
+	{
+		CloseHandle( file );
+		return FILE_MAP_OUT_OF_MEMORY;
+	}
+	while( total < (DWORD)file_size.QuadPart )
+	{
+		DWORD bytes_read = 0;
+		if( !ReadFile( file, buffer + total, (DWORD)file_size.QuadPart - total, &bytes_read, NULL ) ||
+			0 == bytes_read )
+		{
+			break;
+		}
+		total += bytes_read;
+	}
+	CloseHandle( file );
+	if( total != (DWORD)file_size.QuadPart )
+	{
+		free( buffer );
+		return FILE_MAP_READ_FAILED;
+	}
+	map->data = buffer;
+	map->size = (int)total;
+	return FILE_MAP_OK;
+}
+
+/*	a view is only read as it is touched, there's nothing to hold back	*/
+int
+	file_map_open_lazy
+	(
+		const char *filename,
+		file_map *map
+	)
+{
+	return file_map_open( filename, map );
+}
+
+void
+	file_map_close
+	(
+		file_map *map
+	)
+{
+	if( map->mapped )
+	{
+		UnmapViewOfFile( (LPCVOID)map->data );
+	}
+	else
+	{
+		free( (void*)map->data );
+	}
+	file_map_clear( map );
+}
+
+#elif defined( FILE_MAP_POSIX )
+
+/*	pipes and devices don't know their size, read them until the end	*/
+static int
+	file_map_read_stream
+	(
+		int fd,
+		file_map *map
+	)
+{
+	size_t capacity = 64 * 1024;
+	size_t total = 0;
+	unsigned char *buffer = file_map_alloc( capacity );
+	while( NULL != buffer )
+	{
+		ssize_t bytes_read;
+		if( total == capacity )
+		{
+			unsigned char *grown;
+			if( capacity > 0x7fffffff / 2 )
+			{
+				free( buffer );
+				close( fd );
+				return FILE_MAP_TOO_LARGE;
+			}
+			grown = (unsigned char*)realloc( buffer, capacity * 2 );
+			if( NULL == grown )
+			{
+				break;
+			}
+			buffer = grown;
+			capacity *= 2;
+		}
+		bytes_read = read( fd, buffer + total, capacity - total );
+		if( bytes_read < 0 && EINTR == errno )
+		{
+			continue;
+		}
+		if( bytes_read < 0 )
+		{
+			free( buffer );
+			close( fd );
+			return FILE_MAP_READ_FAILED;
+		}
+		if( 0 == bytes_read )
+		{
+			close( fd );
+			map->data = buffer;
+			map->size = (int)total;
+			return FILE_MAP_OK;
+		}
+		total += (size_t)bytes_read;
+	}
+	free( buffer );
+	close( fd );
+	return FILE_MAP_OUT_OF_MEMORY;
+}
+
+static int
+	file_map_open_posix
+	(
+		const char *filename,
+		file_map *map,
+		int read_ahead
+	)
+{
+	struct stat info;
+	unsigned char *buffer;
+	size_t total = 0;
+	int fd;
+	file_map_clear( map );
+	if( NULL == filename )
+	{
+		return FILE_MAP_NOT_FOUND;
+	}
+	fd = open( filename, O_RDONLY );
+	if( fd < 0 )
+	{
+		return FILE_MAP_NOT_FOUND;
+	}
+	if( fstat( fd, &info ) != 0 || info.st_size < 0 )
+	{
+		close( fd );
+		return FILE_MAP_READ_FAILED;
+	}
+	if( (unsigned long long)info.st_size > 0x7fffffffULL )
+	{
+		close( fd );
+		return FILE_MAP_TOO_LARGE;
+	}
+#if !defined( SOIL_NO_MMAP )
+	if( S_ISREG( info.st_mode ) && info.st_size >= FILE_MAP_MIN_MAPPED_SIZE )
+	{
+		/*	the mapping keeps the file open once fd is closed	*/
+		void *view = mmap( NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+		if( MAP_FAILED != view )
+		{
+			close( fd );
+			if( read_ahead )
+			{
+				/*	the loaders go through the whole file right away	*/
+				posix_madvise( view, (size_t)info.st_size, POSIX_MADV_WILLNEED );
+			}
+			map->data = (const unsigned char*)view;
+			map->size = (int)info.st_size;
+			map->mapped = 1;
+			return FILE_MAP_OK;
+		}
+	}
+#endif
+	if( !S_ISREG( info.st_mode ) )
+	{
+		return file_map_read_stream( fd, map );
+	}
+	buffer = file_map_alloc( (size_t)info.st_size );
+	if( NULL == buffer )
+	{
+		close( fd );
+		return FILE_MAP_OUT_OF_MEMORY;
+	}
+	while( total < (size_t)info.st_size )
+	{
+		const ssize_t bytes_read = read( fd, buffer + total, (size_t)info.st_size - total );
+		if( bytes_read < 0 && EINTR == errno )
+		{
+			continue;
+		}
+		if( bytes_read <= 0 )
+		{
+			break;
+		}
+		total += (size_t)bytes_read;
+	}
+	close( fd );
+	if( total != (size_t)info.st_size )
+	{
+		free( buffer );
+		return FILE_MAP_READ_FAILED;
+	}
+	map->data = buffer;
+	map->size = (int)total;
+	return FILE_MAP_OK;
+}
+
+int
+	file_map_open
+	(
+		const char *filename,
+		file_map *map
+	)
+{
+	return file_map_open_posix( filename, map, 1 );
+}
+
+int
+	file_map_open_lazy
+	(
+		const char *filename,
+		file_map *map
+	)
+{
+	return file_map_open_posix( filename, map, 0 );
+}
+
+void
+	file_map_close
+	(
+		file_map *map
+	)
+{
+#if !defined( SOIL_NO_MMAP )
+	if( map->mapped )
+	{
+		munmap( (void*)map->data, (size_t)map->size );
+	}
+	else
+#endif
+	{
+		free( (void*)map->data );
+	}
+	file_map_clear( map );
+}
+
+#else
+
+/*	no mapping on this platform, read the file with stdio	*/
+int
+	file_map_open
+	(
+		const char *filename,
+		file_map *map
+	)
+{
+	FILE *file;
+	long file_size;
+	unsigned char *buffer;
+	size_t bytes_read;
+	file_map_clear( map );
+	if( NULL == filename )
+	{
+		return FILE_MAP_NOT_FOUND;
+	}
+	file = fopen( filename, "rb" );
+	if( NULL == file )
+	{
+		return FILE_MAP_NOT_FOUND;
+	}
+	if( fseek( file, 0, SEEK_END ) != 0 || ( file_size = ftell( file ) ) < 0 ||
+		fseek( file, 0, SEEK_SET ) != 0 )
+	{
+		fclose( file );
+		return FILE_MAP_READ_FAILED;
+	}
+	if( file_size > 0x7fffffffL )
+	{
+		fclose( file );
+		return FILE_MAP_TOO_LARGE;
+	}
+	buffer = file_map_alloc( (size_t)file_size );
+	if( NULL == buffer )
+	{
+		fclose( file );
+		return FILE_MAP_OUT_OF_MEMORY;
+	}
+	bytes_read = fread( buffer, 1, (size_t)file_size, file );
+	fclose( file );
+	if( bytes_read != (size_t)file_size )
+	{
+		free( buffer );
+		return FILE_MAP_READ_FAILED;
+	}
+	map->data = buffer;
+	map->size = (int)file_size;
+	return FILE_MAP_OK;
+}
+
+int
+	file_map_open_lazy
+	(
+		const char *filename,
+		file_map *map
+	)
+{
+	return file_map_open( filename, map );
+}
+
+void
+	file_map_close
+	(
+		file_map *map
+	)
+{
+	free( (void*)map->data );
+	file_map_clear( map );
+}
+
+#endif
@@ -0,0 +1,82 @@
+/*
+	Read only file input for the loaders
+
+	A file is mapped into memory when it is large enough for that to pay
+	off, so the loaders read the page cache directly instead of a copy of
+	the file.  Small files, and files the system refuses to map (pipes,
+	some network or virtual file systems), are read into a buffer instead.
+
+	Define SOIL_NO_MMAP to always read the files into a buffer.
+
+	MIT license
+*/
+
+#ifndef HEADER_FILE_MAP
+#define HEADER_FILE_MAP
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+	The results of file_map_open.
+**/
+enum
+{
+	FILE_MAP_OK = 0,
+	FILE_MAP_NOT_FOUND = 1,
+	FILE_MAP_READ_FAILED = 2,
+	FILE_MAP_TOO_LARGE = 3,
+	FILE_MAP_OUT_OF_MEMORY = 4
+};
+
+/**
+	The contents of a file.  data stays valid until file_map_close and
+	must not be written to, it may be mapped read only.
+**/
+typedef struct
+{
+	const unsigned char *data;
+	int size;
+	int mapped;
+} file_map;
+
+/**
+	Maps or reads a whole file.  Files larger than 2GB are refused, the
+	loaders take the size of their buffers as an int.
+	\return FILE_MAP_OK, or one of the errors above, map is then empty
+**/
+int
+	file_map_open
+	(
+		const char *filename,
+		file_map *map
+	);
+
+/**
+	Like file_map_open, but a mapped file isn't read ahead, its pages are
+	only read from the disk once they are touched.  For the loaders that
+	step over parts of the file, like the levels skipped by the _lod
+	loaders of SOIL2.
+**/
+int
+	file_map_open_lazy
+	(
+		const char *filename,
+		file_map *map
+	);
+
+/**
+	Unmaps or frees the contents of a file, and empties map.
+**/
+void
+	file_map_close
+	(
+		file_map *map
+	);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEADER_FILE_MAP	*/
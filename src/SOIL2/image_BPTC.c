@@ -0,0 +1,1799 @@
+/*
+	BPTC (BC7) compression and decompression
+
+	The encoder fits one line per subset with the principal axis of
+	the pixels, quantizes the endpoints trying every p-bit combination,
+	and refits the endpoints once by least squares from the indices.
+
+	MIT license
+*/
+
+#include "image_BPTC.h"
+#include "thread_pool.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*	images with at least this many blocks are split across the thread pool	*/
+#define BPTC_THREADED_MIN_BLOCKS	256
+/*	2 subset partitions tried per mode by BPTC_COMPRESS_MULTI_MODE	*/
+#define BC7_PARTITION_CANDIDATES	4
+
+/*	the layout of each BC7 mode	*/
+typedef struct
+{
+	int subsets;
+	int partition_bits;
+	int rotation_bits;
+	int index_selection_bits;
+	int color_bits;
+	int alpha_bits;
+	/*	a p-bit per endpoint, or one shared by the 2 endpoints of a subset	*/
+	int endpoint_pbits;
+	int shared_pbits;
+	int index_bits;
+	int index_bits2;
+} BC7_mode_info;
+
+static const BC7_mode_info BC7_modes[8] =
+{
+	{ 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+	{ 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+	{ 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+	{ 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+	{ 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+	{ 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+	{ 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+	{ 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 }
+};
+
+/*	bit p is the subset of pixel p	*/
+static const unsigned short BC7_partitions2[64] =
+{
+	0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+	0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+	0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+	0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+	0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+	0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+	0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+	0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+};
+
+/*	bits 2p and 2p+1 are the subset of pixel p	*/
+static const unsigned int BC7_partitions3[64] =
+{
+	0xaa685050, 0x6a5a5040, 0x5a5a4200, 0x5450a0a8, 0xa5a50000, 0xa0a05050, 0x5555a0a0, 0x5a5a5050,
+	0xaa550000, 0xaa555500, 0xaaaa5500, 0x90909090, 0x94949494, 0xa4a4a4a4, 0xa9a59450, 0x2a0a4250,
+	0xa5945040, 0x0a425054, 0xa5a5a500, 0x55a0a0a0, 0xa8a85454, 0x6a6a4040, 0xa4a45000, 0x1a1a0500,
+	0x0050a4a4, 0xaaa59090, 0x14696914, 0x69691400, 0xa08585a0, 0xaa821414, 0x50a4a450, 0x6a5a0200,
+	0xa9a58000, 0x5090a0a8, 0xa8a09050, 0x24242424, 0x00aa5500, 0x24924924, 0x24499224, 0x50a50a50,
+	0x500aa550, 0xaaaa4444, 0x66660000, 0xa5a0a5a0, 0x50a050a0, 0x69286928, 0x44aaaa44, 0x66666600,
+	0xaa444444, 0x54a854a8, 0x95809580, 0x96969600, 0xa85454a8, 0x80959580, 0xaa141414, 0x96960000,
+	0xaaaa1414, 0xa05050a0, 0xa0a5a5a0, 0x96000000, 0x40804080, 0xa9a8a9a8, 0xaaaaaa44, 0x2a4a5254
+};
+
+/*	the anchor pixel of subset 1 of the 2 subset partitions	*/
+static const unsigned char BC7_anchors2[64] =
+{
+	15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+	15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+	15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+	 6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15
+};
+
+/*	the anchor pixels of subsets 1 and 2 of the 3 subset partitions	*/
+static const unsigned char BC7_anchors3[2][64] =
+{
+	{
+		 3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+		 3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+		 8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+		 3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3
+	},
+	{
+		15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+		15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+		15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+		15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8
+	}
+};
+
+static const int BC7_weights2[4] = { 0, 21, 43, 64 };
+static const int BC7_weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+static const int BC7_weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+/*	a range of block rows to encode, from 8 bit or float pixels	*/
+typedef struct
+{
+	const unsigned char *uncompressed;
+	const float *uncompressed_float;
+	int width, height, channels;
+	unsigned char *compressed;
+	unsigned int options;
+	int first_row, last_row;
+} BPTC_encode_job;
+
+/*	the quantized line of one subset and the index of each pixel	*/
+typedef struct
+{
+	int endpoints[2][4];
+	int pbits[2];
+	int indices[16];
+	int error;
+} BC7_subset_fit;
+
+/********* Helper Functions *********/
+static const int*
+	BC7_weights
+	(
+		int index_bits
+	)
+{
+	return (index_bits == 2) ? BC7_weights2 :
+		((index_bits == 3) ? BC7_weights3 : BC7_weights4);
+}
+
+static int
+	BC7_subset
+	(
+		int subsets, int partition, int p
+	)
+{
+	if( subsets == 2 )
+	{
+		return (BC7_partitions2[partition] >> p) & 1;
+	} else if( subsets == 3 )
+	{
+		return (BC7_partitions3[partition] >> (2 * p)) & 3;
+	}
+	return 0;
+}
+
+static int
+	BC7_anchor
+	(
+		int subsets, int partition, int subset
+	)
+{
+	if( subset == 0 )
+	{
+		return 0;
+	} else if( subsets == 2 )
+	{
+		return BC7_anchors2[partition];
+	}
+	return BC7_anchors3[subset - 1][partition];
+}
+
+/*	expand a precision bit value to 8 bits by replicating its high bits	*/
+static int
+	BC7_expand
+	(
+		int value, int precision
+	)
+{
+	value <<= 8 - precision;
+	return value | (value >> precision);
+}
+
+static int
+	BC7_interpolate
+	(
+		int e0, int e1, int weight
+	)
+{
+	return ((64 - weight) * e0 + weight * e1 + 32) >> 6;
+}
+
+static unsigned int
+	BC7_read_bits
+	(
+		const unsigned char *const block,
+		int *position, int count
+	)
+{
+	unsigned int value = 0;
+	int i;
+	for( i = 0; i < count; ++i, ++*position )
+	{
+		value |= (unsigned int)((block[*position >> 3] >> (*position & 7)) & 1) << i;
+	}
+	return value;
+}
+
+/*	the block must start zeroed	*/
+static void
+	BC7_write_bits
+	(
+		unsigned char *const block,
+		int *position, unsigned int value, int count
+	)
+{
+	int i;
+	for( i = 0; i < count; ++i, ++*position )
+	{
+		block[*position >> 3] |= (unsigned char)(((value >> i) & 1) << (*position & 7));
+	}
+}
+
+/********* Decoder *********/
+void
+	BC7_decode_block
+	(
+		const unsigned char compressed[16],
+		unsigned char uncompressed[16*4]
+	)
+{
+	const BC7_mode_info *info;
+	int endpoints[3][2][4];
+	int pbits[3][2];
+	int indices[2][16];
+	int mode, position, partition, rotation, index_selection;
+	int s, e, c, p, bits, precision;
+	/*	the mode is the number of 0 bits before the first 1	*/
+	for( mode = 0; (mode < 8) && !(compressed[0] & (1 << mode)); ++mode );
+	if( mode == 8 )
+	{
+		memset( uncompressed, 0, 16*4 );
+		return;
+	}
+	info = &BC7_modes[mode];
+	position = mode + 1;
+	partition = BC7_read_bits( compressed, &position, info->partition_bits );
+	rotation = BC7_read_bits( compressed, &position, info->rotation_bits );
+	index_selection = BC7_read_bits( compressed, &position, info->index_selection_bits );
+	/*	all the reds, then the greens, blues and alphas	*/
+	for( c = 0; c < 4; ++c )
+	{
+		bits = (c < 3) ? info->color_bits : info->alpha_bits;
+		for( s = 0; s < info->subsets; ++s )
+		{
+			for( e = 0; e < 2; ++e )
+			{
+				endpoints[s][e][c] = BC7_read_bits( compressed, &position, bits );
+			}
+		}
+	}
+	/*	the p-bits follow, one per endpoint or one per subset	*/
+	for( s = 0; s < info->subsets; ++s )
+	{
+		pbits[s][0] = pbits[s][1] = -1;
+		if( info->endpoint_pbits )
+		{
+			pbits[s][0] = BC7_read_bits( compressed, &position, 1 );
+			pbits[s][1] = BC7_read_bits( compressed, &position, 1 );
+		} else if( info->shared_pbits )
+		{
+			pbits[s][0] = pbits[s][1] = BC7_read_bits( compressed, &position, 1 );
+		}
+	}
+	/*	append the p-bits and expand to 8 bits, modes without alpha are opaque	*/
+	for( s = 0; s < info->subsets; ++s )
+	{
+		for( e = 0; e < 2; ++e )
+		{
+			for( c = 0; c < 4; ++c )
+			{
+				bits = (c < 3) ? info->color_bits : info->alpha_bits;
+				if( bits == 0 )
+				{
+					endpoints[s][e][c] = 255;
+					continue;
+				}
+				precision = bits;
+				if( pbits[s][e] >= 0 )
+				{
+					endpoints[s][e][c] = (endpoints[s][e][c] << 1) | pbits[s][e];
+					++precision;
+				}
+				endpoints[s][e][c] = BC7_expand( endpoints[s][e][c], precision );
+			}
+		}
+	}
+	/*	the anchor index of each subset drops its high bit	*/
+	for( p = 0; p < 16; ++p )
+	{
+		s = BC7_subset( info->subsets, partition, p );
+		bits = info->index_bits - (p == BC7_anchor( info->subsets, partition, s ) ? 1 : 0);
+		indices[0][p] = BC7_read_bits( compressed, &position, bits );
+	}
+	if( info->index_bits2 )
+	{
+		for( p = 0; p < 16; ++p )
+		{
+			indices[1][p] = BC7_read_bits( compressed, &position, info->index_bits2 - (p == 0 ? 1 : 0) );
+		}
+	}
+	for( p = 0; p < 16; ++p )
+	{
+		const int *color_weights, *alpha_weights;
+		int color_index, alpha_index, swap;
+		unsigned char *out = &uncompressed[p * 4];
+		s = BC7_subset( info->subsets, partition, p );
+		color_weights = alpha_weights = BC7_weights( info->index_bits );
+		color_index = alpha_index = indices[0][p];
+		if( info->index_bits2 )
+		{
+			alpha_weights = BC7_weights( info->index_bits2 );
+			alpha_index = indices[1][p];
+			if( index_selection )
+			{
+				color_weights = alpha_weights;
+				alpha_weights = BC7_weights( info->index_bits );
+				color_index = indices[1][p];
+				alpha_index = indices[0][p];
+			}
+		}
+		for( c = 0; c < 3; ++c )
+		{
+			out[c] = (unsigned char)BC7_interpolate( endpoints[s][0][c], endpoints[s][1][c], color_weights[color_index] );
+		}
+		out[3] = (unsigned char)BC7_interpolate( endpoints[s][0][3], endpoints[s][1][3], alpha_weights[alpha_index] );
+		if( rotation )
+		{
+			swap = out[3];
+			out[3] = out[rotation - 1];
+			out[rotation - 1] = (unsigned char)swap;
+		}
+	}
+}
+
+/********* Encoder *********/
+/*	the palette of a quantized line and the error of the nearest indices	*/
+static int
+	BC7_assign_indices
+	(
+		const int pixels[16][4], unsigned int mask,
+		int first, int components, int index_bits,
+		const int endpoints[2][4],
+		int indices[16]
+	)
+{
+	const int *weights = BC7_weights( index_bits );
+	const int steps = 1 << index_bits;
+	int palette[16][4];
+	int direction[4];
+	int length = 0, error = 0;
+	int p, k, c;
+	for( k = 0; k < steps; ++k )
+	{
+		for( c = first; c < first + components; ++c )
+		{
+			palette[k][c] = BC7_interpolate( endpoints[0][c], endpoints[1][c], weights[k] );
+		}
+	}
+	for( c = first; c < first + components; ++c )
+	{
+		direction[c] = endpoints[1][c] - endpoints[0][c];
+		length += direction[c] * direction[c];
+	}
+	for( p = 0; p < 16; ++p )
+	{
+		int best = 0, best_error = 0x7FFFFFFF;
+		int nearest = 0;
+		if( !(mask & (1 << p)) )
+		{
+			continue;
+		}
+		/*	the weights are close to even, so only the steps around the
+			projection on the line are worth measuring	*/
+		if( length > 0 )
+		{
+			int t = 0;
+			for( c = first; c < first + components; ++c )
+			{
+				t += (pixels[p][c] - endpoints[0][c]) * direction[c];
+			}
+			nearest = (t * (steps - 1) * 2 + length) / (2 * length);
+			nearest = nearest < 0 ? 0 : (nearest > steps - 1 ? steps - 1 : nearest);
+		}
+		for( k = (nearest > 0 ? nearest - 1 : 0); k <= (nearest < steps - 1 ? nearest + 1 : steps - 1); ++k )
+		{
+			int d, e = 0;
+			for( c = first; c < first + components; ++c )
+			{
+				d = palette[k][c] - pixels[p][c];
+				e += d * d;
+			}
+			if( e < best_error )
+			{
+				best_error = e;
+				best = k;
+			}
+		}
+		indices[p] = best;
+		error += best_error;
+	}
+	return error;
+}
+
+/*	the best quantization of a line over all the p-bit choices	*/
+static void
+	BC7_quantize_subset
+	(
+		const int pixels[16][4], unsigned int mask,
+		int first, int components,
+		int bits, int endpoint_pbits, int shared_pbits, int index_bits,
+		float line[2][4],
+		BC7_subset_fit *fit
+	)
+{
+	const int combinations = endpoint_pbits ? 4 : (shared_pbits ? 2 : 1);
+	const int precision = bits + ((endpoint_pbits || shared_pbits) ? 1 : 0);
+	const int max_value = (1 << bits) - 1;
+	BC7_subset_fit trial;
+	int combination, e, c, q, d;
+	fit->error = 0x7FFFFFFF;
+	for( combination = 0; combination < combinations; ++combination )
+	{
+		trial.pbits[0] = combination & 1;
+		trial.pbits[1] = endpoint_pbits ? (combination >> 1) : trial.pbits[0];
+		for( e = 0; e < 2; ++e )
+		{
+			const int p = (precision > bits) ? trial.pbits[e] : 0;
+			for( c = first; c < first + components; ++c )
+			{
+				/*	the nearest code and its neighbours, measured after expansion	*/
+				int best = 0, best_error = 0x7FFFFFFF;
+				float scaled = line[e][c] * ((1 << precision) - 1) / 255.0f;
+				int guess = (int)floorf( (precision > bits ? (scaled - p) * 0.5f : scaled) + 0.5f );
+				for( q = guess - 1; q <= guess + 1; ++q )
+				{
+					int code = q < 0 ? 0 : (q > max_value ? max_value : q);
+					int value = BC7_expand( (precision > bits) ? ((code << 1) | p) : code, precision );
+					d = value - (int)floorf( line[e][c] + 0.5f );
+					if( d * d < best_error )
+					{
+						best_error = d * d;
+						best = code;
+					}
+				}
+				trial.endpoints[e][c] = best;
+			}
+		}
+		{
+			/*	measure with the expanded endpoints	*/
+			int expanded[2][4];
+			for( e = 0; e < 2; ++e )
+			{
+				for( c = first; c < first + components; ++c )
+				{
+					q = trial.endpoints[e][c];
+					expanded[e][c] = BC7_expand( (precision > bits) ? ((q << 1) | trial.pbits[e]) : q, precision );
+				}
+			}
+			trial.error = BC7_assign_indices( pixels, mask, first, components, index_bits,
+				(const int (*)[4])expanded, trial.indices );
+		}
+		if( trial.error < fit->error )
+		{
+			*fit = trial;
+		}
+	}
+}
+
+/*	fit a line to the pixels in mask, quantize it, then refit it from the indices	*/
+static void
+	BC7_fit_subset
+	(
+		const int pixels[16][4], unsigned int mask,
+		int first, int components,
+		int bits, int endpoint_pbits, int shared_pbits, int index_bits,
+		BC7_subset_fit *fit
+	)
+{
+	const int *weights = BC7_weights( index_bits );
+	float mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	float axis[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	float covariance[4][4];
+	float line[2][4];
+	float t, t_min, t_max, length, farthest;
+	BC7_subset_fit refit;
+	int count = 0;
+	int p, c, d, iteration;
+	memset( fit, 0, sizeof( BC7_subset_fit ) );
+	memset( covariance, 0, sizeof( covariance ) );
+	for( p = 0; p < 16; ++p )
+	{
+		if( mask & (1 << p) )
+		{
+			for( c = first; c < first + components; ++c )
+			{
+				mean[c] += pixels[p][c];
+			}
+			++count;
+		}
+	}
+	if( count == 0 )
+	{
+		return;
+	}
+	for( c = first; c < first + components; ++c )
+	{
+		mean[c] /= count;
+	}
+	/*	the covariance, and the pixel farthest from the mean to start the power method	*/
+	farthest = -1.0f;
+	for( p = 0; p < 16; ++p )
+	{
+		float distance = 0.0f;
+		if( !(mask & (1 << p)) )
+		{
+			continue;
+		}
+		for( c = first; c < first + components; ++c )
+		{
+			for( d = first; d < first + components; ++d )
+			{
+				covariance[c][d] += (pixels[p][c] - mean[c]) * (pixels[p][d] - mean[d]);
+			}
+			distance += (pixels[p][c] - mean[c]) * (pixels[p][c] - mean[c]);
+		}
+		if( distance > farthest )
+		{
+			farthest = distance;
+			for( c = first; c < first + components; ++c )
+			{
+				axis[c] = pixels[p][c] - mean[c];
+			}
+		}
+	}
+	for( iteration = 0; iteration < 8; ++iteration )
+	{
+		float next[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		length = 0.0f;
+		for( c = first; c < first + components; ++c )
+		{
+			for( d = first; d < first + components; ++d )
+			{
+				next[c] += covariance[c][d] * axis[d];
+			}
+			length += next[c] * next[c];
+		}
+		if( length <= 1e-12f )
+		{
+			break;
+		}
+		length = 1.0f / sqrtf( length );
+		for( c = first; c < first + components; ++c )
+		{
+			axis[c] = next[c] * length;
+		}
+	}
+	length = 0.0f;
+	for( c = first; c < first + components; ++c )
+	{
+		length += axis[c] * axis[c];
+	}
+	if( length > 1e-12f )
+	{
+		length = 1.0f / sqrtf( length );
+	}
+	/*	the extents of the pixels along the axis	*/
+	t_min = t_max = 0.0f;
+	for( p = 0; p < 16; ++p )
+	{
+		if( !(mask & (1 << p)) )
+		{
+			continue;
+		}
+		t = 0.0f;
+		for( c = first; c < first + components; ++c )
+		{
+			t += (pixels[p][c] - mean[c]) * axis[c] * length;
+		}
+		if( t < t_min ) t_min = t;
+		if( t > t_max ) t_max = t;
+	}
+	for( c = first; c < first + components; ++c )
+	{
+		line[0][c] = mean[c] + t_min * axis[c] * length;
+		line[1][c] = mean[c] + t_max * axis[c] * length;
+		line[0][c] = line[0][c] < 0.0f ? 0.0f : (line[0][c] > 255.0f ? 255.0f : line[0][c]);
+		line[1][c] = line[1][c] < 0.0f ? 0.0f : (line[1][c] > 255.0f ? 255.0f : line[1][c]);
+	}
+	BC7_quantize_subset( pixels, mask, first, components,
+		bits, endpoint_pbits, shared_pbits, index_bits, line, fit );
+	if( fit->error == 0 )
+	{
+		return;
+	}
+	/*	least squares endpoints for the chosen indices	*/
+	{
+		float aa = 0.0f, ab = 0.0f, bb = 0.0f, determinant;
+		float xa[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float xb[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		for( p = 0; p < 16; ++p )
+		{
+			float w1, w0;
+			if( !(mask & (1 << p)) )
+			{
+				continue;
+			}
+			w1 = weights[fit->indices[p]] / 64.0f;
+			w0 = 1.0f - w1;
+			aa += w0 * w0;
+			ab += w0 * w1;
+			bb += w1 * w1;
+			for( c = first; c < first + components; ++c )
+			{
+				xa[c] += w0 * pixels[p][c];
+				xb[c] += w1 * pixels[p][c];
+			}
+		}
+		determinant = aa * bb - ab * ab;
+		if( fabsf( determinant ) < 1e-6f )
+		{
+			return;
+		}
+		determinant = 1.0f / determinant;
+		for( c = first; c < first + components; ++c )
+		{
+			line[0][c] = (bb * xa[c] - ab * xb[c]) * determinant;
+			line[1][c] = (aa * xb[c] - ab * xa[c]) * determinant;
+			line[0][c] = line[0][c] < 0.0f ? 0.0f : (line[0][c] > 255.0f ? 255.0f : line[0][c]);
+			line[1][c] = line[1][c] < 0.0f ? 0.0f : (line[1][c] > 255.0f ? 255.0f : line[1][c]);
+		}
+	}
+	BC7_quantize_subset( pixels, mask, first, components,
+		bits, endpoint_pbits, shared_pbits, index_bits, line, &refit );
+	if( refit.error < fit->error )
+	{
+		*fit = refit;
+	}
+}
+
+/*	swap the endpoints when the anchor index would need its high bit	*/
+static void
+	BC7_fix_anchor
+	(
+		BC7_subset_fit *fit,
+		int subsets, int partition, int subset, int index_bits
+	)
+{
+	const int anchor = BC7_anchor( subsets, partition, subset );
+	const int max_index = (1 << index_bits) - 1;
+	int p, c, swap;
+	if( !(fit->indices[anchor] >> (index_bits - 1)) )
+	{
+		return;
+	}
+	for( c = 0; c < 4; ++c )
+	{
+		swap = fit->endpoints[0][c];
+		fit->endpoints[0][c] = fit->endpoints[1][c];
+		fit->endpoints[1][c] = swap;
+	}
+	swap = fit->pbits[0];
+	fit->pbits[0] = fit->pbits[1];
+	fit->pbits[1] = swap;
+	for( p = 0; p < 16; ++p )
+	{
+		if( BC7_subset( subsets, partition, p ) == subset )
+		{
+			fit->indices[p] = max_index - fit->indices[p];
+		}
+	}
+}
+
+/*	modes 1, 3, 6 and 7: one set of indices for all the components	*/
+static void
+	BC7_encode_lines
+	(
+		const int pixels[16][4], unsigned int mask,
+		int mode, int partition,
+		unsigned char out[16]
+	)
+{
+	const BC7_mode_info *info = &BC7_modes[mode];
+	const int components = info->alpha_bits ? 4 : 3;
+	BC7_subset_fit fits[3];
+	int indices[16];
+	int s, e, c, p, position;
+	unsigned int subset_mask;
+	for( s = 0; s < info->subsets; ++s )
+	{
+		subset_mask = 0;
+		for( p = 0; p < 16; ++p )
+		{
+			if( BC7_subset( info->subsets, partition, p ) == s )
+			{
+				subset_mask |= 1 << p;
+			}
+		}
+		BC7_fit_subset( pixels, mask & subset_mask, 0, components, info->color_bits,
+			info->endpoint_pbits, info->shared_pbits, info->index_bits, &fits[s] );
+		BC7_fix_anchor( &fits[s], info->subsets, partition, s, info->index_bits );
+	}
+	for( p = 0; p < 16; ++p )
+	{
+		indices[p] = fits[BC7_subset( info->subsets, partition, p )].indices[p];
+	}
+	memset( out, 0, 16 );
+	position = 0;
+	BC7_write_bits( out, &position, 1 << mode, mode + 1 );
+	BC7_write_bits( out, &position, partition, info->partition_bits );
+	for( c = 0; c < components; ++c )
+	{
+		for( s = 0; s < info->subsets; ++s )
+		{
+			for( e = 0; e < 2; ++e )
+			{
+				BC7_write_bits( out, &position, fits[s].endpoints[e][c], info->color_bits );
+			}
+		}
+	}
+	for( s = 0; s < info->subsets; ++s )
+	{
+		BC7_write_bits( out, &position, fits[s].pbits[0], 1 );
+		if( info->endpoint_pbits )
+		{
+			BC7_write_bits( out, &position, fits[s].pbits[1], 1 );
+		}
+	}
+	for( p = 0; p < 16; ++p )
+	{
+		s = BC7_subset( info->subsets, partition, p );
+		BC7_write_bits( out, &position, indices[p],
+			info->index_bits - (p == BC7_anchor( info->subsets, partition, s ) ? 1 : 0) );
+	}
+}
+
+/*	mode 5 without rotation: a 7 bit color line and a separate 8 bit alpha line	*/
+static void
+	BC7_encode_mode5
+	(
+		const int pixels[16][4], unsigned int mask,
+		unsigned char out[16]
+	)
+{
+	BC7_subset_fit color, alpha;
+	int c, e, p, position;
+	BC7_fit_subset( pixels, mask, 0, 3, 7, 0, 0, 2, &color );
+	BC7_fix_anchor( &color, 1, 0, 0, 2 );
+	BC7_fit_subset( pixels, mask, 3, 1, 8, 0, 0, 2, &alpha );
+	BC7_fix_anchor( &alpha, 1, 0, 0, 2 );
+	memset( out, 0, 16 );
+	position = 0;
+	BC7_write_bits( out, &position, 1 << 5, 6 );
+	BC7_write_bits( out, &position, 0, 2 );
+	for( c = 0; c < 3; ++c )
+	{
+		for( e = 0; e < 2; ++e )
+		{
+			BC7_write_bits( out, &position, color.endpoints[e][c], 7 );
+		}
+	}
+	for( e = 0; e < 2; ++e )
+	{
+		BC7_write_bits( out, &position, alpha.endpoints[e][3], 8 );
+	}
+	for( p = 0; p < 16; ++p )
+	{
+		BC7_write_bits( out, &position, color.indices[p], p ? 2 : 1 );
+	}
+	for( p = 0; p < 16; ++p )
+	{
+		BC7_write_bits( out, &position, alpha.indices[p], p ? 2 : 1 );
+	}
+}
+
+/*	the squared RGBA error of an encoded block over the pixels in mask	*/
+static int
+	BC7_block_error
+	(
+		const int pixels[16][4], unsigned int mask,
+		const unsigned char block[16]
+	)
+{
+	unsigned char decoded[16*4];
+	int error = 0;
+	int p, c, d;
+	BC7_decode_block( block, decoded );
+	for( p = 0; p < 16; ++p )
+	{
+		if( mask & (1 << p) )
+		{
+			for( c = 0; c < 4; ++c )
+			{
+				d = decoded[p * 4 + c] - pixels[p][c];
+				error += d * d;
+			}
+		}
+	}
+	return error;
+}
+
+/*	how far the pixels in mask are from their best line (the covariance
+	trace minus its largest eigenvalue, which is the residual)	*/
+static float
+	BC7_line_residual
+	(
+		const int pixels[16][4], unsigned int mask,
+		int components
+	)
+{
+	float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	float covariance[4][4];
+	float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	float trace = 0.0f, eigenvalue = 0.0f, length;
+	int count = 0;
+	int p, c, d, iteration;
+	memset( covariance, 0, sizeof( covariance ) );
+	for( p = 0; p < 16; ++p )
+	{
+		if( mask & (1 << p) )
+		{
+			for( c = 0; c < components; ++c )
+			{
+				sum[c] += pixels[p][c];
+				for( d = c; d < components; ++d )
+				{
+					covariance[c][d] += (float)pixels[p][c] * pixels[p][d];
+				}
+			}
+			++count;
+		}
+	}
+	if( count < 2 )
+	{
+		return 0.0f;
+	}
+	for( c = 0; c < components; ++c )
+	{
+		for( d = c; d < components; ++d )
+		{
+			covariance[c][d] -= sum[c] * sum[d] / count;
+			covariance[d][c] = covariance[c][d];
+		}
+		trace += covariance[c][c];
+	}
+	for( iteration = 0; iteration < 4; ++iteration )
+	{
+		float next[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		length = 0.0f;
+		for( c = 0; c < components; ++c )
+		{
+			for( d = 0; d < components; ++d )
+			{
+				next[c] += covariance[c][d] * axis[d];
+			}
+			length += next[c] * next[c];
+		}
+		if( length <= 1e-12f )
+		{
+			return trace;
+		}
+		eigenvalue = sqrtf( length );
+		for( c = 0; c < components; ++c )
+		{
+			axis[c] = next[c] / eigenvalue;
+		}
+	}
+	return trace - eigenvalue;
+}
+
+static void
+	BC7_compress_block
+	(
+		const int pixels[16][4], unsigned int mask,
+		unsigned int options,
+		unsigned char out[16]
+	)
+{
+	unsigned char trial[16];
+	int best_error, error;
+	int candidates[BC7_PARTITION_CANDIDATES];
+	float residuals[BC7_PARTITION_CANDIDATES];
+	int has_alpha = 0;
+	int p, i, j, partition, components;
+	BC7_encode_lines( pixels, mask, 6, 0, out );
+	if( !(options & BPTC_COMPRESS_MULTI_MODE) )
+	{
+		return;
+	}
+	best_error = BC7_block_error( pixels, mask, out );
+	if( best_error == 0 )
+	{
+		return;
+	}
+	for( p = 0; p < 16; ++p )
+	{
+		if( (mask & (1 << p)) && (pixels[p][3] != 255) )
+		{
+			has_alpha = 1;
+		}
+	}
+	if( has_alpha )
+	{
+		BC7_encode_mode5( pixels, mask, trial );
+		error = BC7_block_error( pixels, mask, trial );
+		if( error < best_error )
+		{
+			best_error = error;
+			memcpy( out, trial, 16 );
+		}
+	}
+	/*	rank the 2 subset partitions by how well each half fits a line	*/
+	components = has_alpha ? 4 : 3;
+	for( i = 0; i < BC7_PARTITION_CANDIDATES; ++i )
+	{
+		candidates[i] = -1;
+		residuals[i] = 0.0f;
+	}
+	for( partition = 0; partition < 64; ++partition )
+	{
+		const unsigned int ones = BC7_partitions2[partition];
+		float residual = BC7_line_residual( pixels, mask & ~ones, components ) +
+			BC7_line_residual( pixels, mask & ones, components );
+		for( i = 0; i < BC7_PARTITION_CANDIDATES; ++i )
+		{
+			if( (candidates[i] < 0) || (residual < residuals[i]) )
+			{
+				for( j = BC7_PARTITION_CANDIDATES - 1; j > i; --j )
+				{
+					candidates[j] = candidates[j - 1];
+					residuals[j] = residuals[j - 1];
+				}
+				candidates[i] = partition;
+				residuals[i] = residual;
+				break;
+			}
+		}
+	}
+	for( i = 0; i < BC7_PARTITION_CANDIDATES; ++i )
+	{
+		/*	mode 7 for alpha, modes 1 (3 bit indices) and 3 (7 bit endpoints) otherwise	*/
+		for( j = has_alpha ? 7 : 1; j <= (has_alpha ? 7 : 3); j += 2 )
+		{
+			BC7_encode_lines( pixels, mask, j, candidates[i], trial );
+			error = BC7_block_error( pixels, mask, trial );
+			if( error < best_error )
+			{
+				best_error = error;
+				memcpy( out, trial, 16 );
+			}
+		}
+	}
+}
+
+/*	a 4x4 block as RGBA, and the mask of the pixels inside the image	*/
+static unsigned int
+	BC7_gather_block
+	(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int i, int j,
+		int pixels[16][4]
+	)
+{
+	unsigned int mask = 0;
+	int x, y, c, p;
+	for( y = 0; y < 4; ++y )
+	{
+		for( x = 0; x < 4; ++x )
+		{
+			const unsigned char *src;
+			p = y * 4 + x;
+			if( (j + y < height) && (i + x < width) )
+			{
+				src = &uncompressed[((j + y) * width + (i + x)) * channels];
+				mask |= 1 << p;
+			} else
+			{
+				/*	padding, ignored by the fit	*/
+				src = &uncompressed[(j * width + i) * channels];
+			}
+			if( channels < 3 )
+			{
+				pixels[p][0] = pixels[p][1] = pixels[p][2] = src[0];
+				pixels[p][3] = (channels == 2) ? src[1] : 255;
+			} else
+			{
+				for( c = 0; c < 3; ++c )
+				{
+					pixels[p][c] = src[c];
+				}
+				pixels[p][3] = (channels == 4) ? src[3] : 255;
+			}
+		}
+	}
+	return mask;
+}
+
+static void
+	BC7_encode_rows
+	(
+		void *argument
+	)
+{
+	const BPTC_encode_job *job = (const BPTC_encode_job*)argument;
+	const int blocks_wide = (job->width + 3) >> 2;
+	int pixels[16][4];
+	unsigned int mask;
+	int i, row;
+	for( row = job->first_row; row < job->last_row; ++row )
+	{
+		unsigned char *out = job->compressed + (size_t)row * blocks_wide * 16;
+		for( i = 0; i < blocks_wide; ++i, out += 16 )
+		{
+			mask = BC7_gather_block( job->uncompressed, job->width, job->height,
+				job->channels, i * 4, row * 4, pixels );
+			BC7_compress_block( (const int (*)[4])pixels, mask, job->options, out );
+		}
+	}
+}
+
+/********* BC6H *********/
+/*	bits first to last (in either order) of a component of an endpoint,
+	endpoints 0 and 1 are the first region, 2 and 3 the second	*/
+typedef struct
+{
+	unsigned char endpoint, channel, first, last;
+} BC6H_run;
+
+typedef struct
+{
+	/*	the 2 or 5 mode bits	*/
+	int value, value_bits;
+	int regions;
+	/*	the other endpoints are stored as deltas from endpoint 0	*/
+	int transformed;
+	int endpoint_bits;
+	int delta_bits[3];
+	BC6H_run runs[24];
+} BC6H_mode_info;
+
+#define BC6H_R( e, first, last )	{ e, 0, first, last }
+#define BC6H_G( e, first, last )	{ e, 1, first, last }
+#define BC6H_B( e, first, last )	{ e, 2, first, last }
+#define BC6H_END	{ 4, 0, 0, 0 }
+
+static const BC6H_mode_info BC6H_modes[14] =
+{
+	{ 0x00, 2, 2, 1, 10, { 5, 5, 5 }, {
+		BC6H_G( 2, 4, 4 ), BC6H_B( 2, 4, 4 ), BC6H_B( 3, 4, 4 ), BC6H_R( 0, 0, 9 ), BC6H_G( 0, 0, 9 ), BC6H_B( 0, 0, 9 ),
+		BC6H_R( 1, 0, 4 ), BC6H_G( 3, 4, 4 ), BC6H_G( 2, 0, 3 ), BC6H_G( 1, 0, 4 ), BC6H_B( 3, 0, 0 ), BC6H_G( 3, 0, 3 ),
+		BC6H_B( 1, 0, 4 ), BC6H_B( 3, 1, 1 ), BC6H_B( 2, 0, 3 ), BC6H_R( 2, 0, 4 ), BC6H_B( 3, 2, 2 ), BC6H_R( 3, 0, 4 ),
+		BC6H_B( 3, 3, 3 ), BC6H_END } },
+	{ 0x01, 2, 2, 1, 7, { 6, 6, 6 }, {
+		BC6H_G( 2, 5, 5 ), BC6H_G( 3, 4, 4 ), BC6H_G( 3, 5, 5 ), BC6H_R( 0, 0, 6 ), BC6H_B( 3, 0, 0 ), BC6H_B( 3, 1, 1 ),
+		BC6H_B( 2, 4, 4 ), BC6H_G( 0, 0, 6 ), BC6H_B( 2, 5, 5 ), BC6H_B( 3, 2, 2 ), BC6H_G( 2, 4, 4 ), BC6H_B( 0, 0, 6 ),
+		BC6H_B( 3, 3, 3 ), BC6H_B( 3, 5, 5 ), BC6H_B( 3, 4, 4 ), BC6H_R( 1, 0, 5 ), BC6H_G( 2, 0, 3 ), BC6H_G( 1, 0, 5 ),
+		BC6H_G( 3, 0, 3 ), BC6H_B( 1, 0, 5 ), BC6H_B( 2, 0, 3 ), BC6H_R( 2, 0, 5 ), BC6H_R( 3, 0, 5 ), BC6H_END } },
+	{ 0x02, 5, 2, 1, 11, { 5, 4, 4 }, {
+		BC6H_R( 0, 0, 9 ), BC6H_G( 0, 0, 9 ), BC6H_B( 0, 0, 9 ), BC6H_R( 1, 0, 4 ), BC6H_R( 0, 10, 10 ), BC6H_G( 2, 0, 3 ),
+		BC6H_G( 1, 0, 3 ), BC6H_G( 0, 10, 10 ), BC6H_B( 3, 0, 0 ), BC6H_G( 3, 0, 3 ), BC6H_B( 1, 0, 3 ), BC6H_B( 0, 10, 10 ),
+		BC6H_B( 3, 1, 1 ), BC6H_B( 2, 0, 3 ), BC6H_R( 2, 0, 4 ), BC6H_B( 3, 2, 2 ), BC6H_R( 3, 0, 4 ), BC6H_B( 3, 3, 3 ),
+		BC6H_END } },
+	{ 0x06, 5, 2, 1, 11, { 4, 5, 4 }, {
+		BC6H_R( 0, 0, 9 ), BC6H_G( 0, 0, 9 ), BC6H_B( 0, 0, 9 ), BC6H_R( 1, 0, 3 ), BC6H_R( 0, 10, 10 ), BC6H_G( 3, 4, 4 ),
+		BC6H_G( 2, 0, 3 ), BC6H_G( 1, 0, 4 ), BC6H_G( 0, 10, 10 ), BC6H_G( 3, 0, 3 ), BC6H_B( 1, 0, 3 ), BC6H_B( 0, 10, 10 ),
+		BC6H_B( 3, 1, 1 ), BC6H_B( 2, 0, 3 ), BC6H_R( 2, 0, 3 ), BC6H_B( 3, 0, 0 ), BC6H_B( 3, 2, 2 ), BC6H_R( 3, 0, 3 ),
+		BC6H_G( 2, 4, 4 ), BC6H_B( 3, 3, 3 ), BC6H_END } },
+	{ 0x0A, 5, 2, 1, 11, { 4, 4, 5 }, {
+		BC6H_R( 0, 0, 9 ), BC6H_G( 0, 0, 9 ), BC6H_B( 0, 0, 9 ), BC6H_R( 1, 0, 3 ), BC6H_R( 0, 10, 10 ), BC6H_B( 2, 4, 4 ),
+		BC6H_G( 2, 0, 3 ), BC6H_G( 1, 0, 3 ), BC6H_G( 0, 10, 10 ), BC6H_B( 3, 0, 0 ), BC6H_G( 3, 0, 3 ), BC6H_B( 1, 0, 4 ),
+		BC6H_B( 0, 10, 10 ), BC6H_B( 2, 0, 3 ), BC6H_R( 2, 0, 3 ), BC6H_B( 3, 1, 1 ), BC6H_B( 3, 2, 2 ), BC6H_R( 3, 0, 3 ),
+		BC6H_B( 3, 4, 4 ), BC6H_B( 3, 3, 3 ), BC6H_END } },
+	{ 0x0E, 5, 2, 1, 9, { 5, 5, 5 }, {
+		BC6H_R( 0, 0, 8 ), BC6H_B( 2, 4, 4 ), BC6H_G( 0, 0, 8 ), BC6H_G( 2, 4, 4 ), BC6H_B( 0, 0, 8 ), BC6H_B( 3, 4, 4 ),
+		BC6H_R( 1, 0, 4 ), BC6H_G( 3, 4, 4 ), BC6H_G( 2, 0, 3 ), BC6H_G( 1, 0, 4 ), BC6H_B( 3, 0, 0 ), BC6H_G( 3, 0, 3 ),
+		BC6H_B( 1, 0, 4 ), BC6H_B( 3, 1, 1 ), BC6H_B( 2, 0, 3 ), BC6H_R( 2, 0, 4 ), BC6H_B( 3, 2, 2 ), BC6H_R( 3, 0, 4 ),
+		BC6H_B( 3, 3, 3 ), BC6H_END } },
+	{ 0x12, 5, 2, 1, 8, { 6, 5, 5 }, {
+		BC6H_R( 0, 0, 7 ), BC6H_G( 3, 4, 4 ), BC6H_B( 2, 4, 4 ), BC6H_G( 0, 0, 7 ), BC6H_B( 3, 2, 2 ), BC6H_G( 2, 4, 4 ),
+		BC6H_B( 0, 0, 7 ), BC6H_B( 3, 3, 3 ), BC6H_B( 3, 4, 4 ), BC6H_R( 1, 0, 5 ), BC6H_G( 2, 0, 3 ), BC6H_G( 1, 0, 4 ),
+		BC6H_B( 3, 0, 0 ), BC6H_G( 3, 0, 3 ), BC6H_B( 1, 0, 4 ), BC6H_B( 3, 1, 1 ), BC6H_B( 2, 0, 3 ), BC6H_R( 2, 0, 5 ),
+		BC6H_R( 3, 0, 5 ), BC6H_END } },
+	{ 0x16, 5, 2, 1, 8, { 5, 6, 5 }, {
+		BC6H_R( 0, 0, 7 ), BC6H_B( 3, 0, 0 ), BC6H_B( 2, 4, 4 ), BC6H_G( 0, 0, 7 ), BC6H_G( 2, 5, 5 ), BC6H_G( 2, 4, 4 ),
+		BC6H_B( 0, 0, 7 ), BC6H_G( 3, 5, 5 ), BC6H_B( 3, 4, 4 ), BC6H_R( 1, 0, 4 ), BC6H_G( 3, 4, 4 ), BC6H_G( 2, 0, 3 ),
+		BC6H_G( 1, 0, 5 ), BC6H_G( 3, 0, 3 ), BC6H_B( 1, 0, 4 ), BC6H_B( 3, 1, 1 ), BC6H_B( 2, 0, 3 ), BC6H_R( 2, 0, 4 ),
+		BC6H_B( 3, 2, 2 ), BC6H_R( 3, 0, 4 ), BC6H_B( 3, 3, 3 ), BC6H_END } },
+	{ 0x1A, 5, 2, 1, 8, { 5, 5, 6 }, {
+		BC6H_R( 0, 0, 7 ), BC6H_B( 3, 1, 1 ), BC6H_B( 2, 4, 4 ), BC6H_G( 0, 0, 7 ), BC6H_B( 2, 5, 5 ), BC6H_G( 2, 4, 4 ),
+		BC6H_B( 0, 0, 7 ), BC6H_B( 3, 5, 5 ), BC6H_B( 3, 4, 4 ), BC6H_R( 1, 0, 4 ), BC6H_G( 3, 4, 4 ), BC6H_G( 2, 0, 3 ),
+		BC6H_G( 1, 0, 4 ), BC6H_B( 3, 0, 0 ), BC6H_G( 3, 0, 3 ), BC6H_B( 1, 0, 5 ), BC6H_B( 2, 0, 3 ), BC6H_R( 2, 0, 4 ),
+		BC6H_B( 3, 2, 2 ), BC6H_R( 3, 0, 4 ), BC6H_B( 3, 3, 3 ), BC6H_END } },
+	{ 0x1E, 5, 2, 0, 6, { 6, 6, 6 }, {
+		BC6H_R( 0, 0, 5 ), BC6H_G( 3, 4, 4 ), BC6H_B( 3, 0, 0 ), BC6H_B( 3, 1, 1 ), BC6H_B( 2, 4, 4 ), BC6H_G( 0, 0, 5 ),
+		BC6H_G( 2, 5, 5 ), BC6H_B( 2, 5, 5 ), BC6H_B( 3, 2, 2 ), BC6H_G( 2, 4, 4 ), BC6H_B( 0, 0, 5 ), BC6H_G( 3, 5, 5 ),
+		BC6H_B( 3, 3, 3 ), BC6H_B( 3, 5, 5 ), BC6H_B( 3, 4, 4 ), BC6H_R( 1, 0, 5 ), BC6H_G( 2, 0, 3 ), BC6H_G( 1, 0, 5 ),
+		BC6H_G( 3, 0, 3 ), BC6H_B( 1, 0, 5 ), BC6H_B( 2, 0, 3 ), BC6H_R( 2, 0, 5 ), BC6H_R( 3, 0, 5 ), BC6H_END } },
+	{ 0x03, 5, 1, 0, 10, { 10, 10, 10 }, {
+		BC6H_R( 0, 0, 9 ), BC6H_G( 0, 0, 9 ), BC6H_B( 0, 0, 9 ), BC6H_R( 1, 0, 9 ), BC6H_G( 1, 0, 9 ), BC6H_B( 1, 0, 9 ),
+		BC6H_END } },
+	{ 0x07, 5, 1, 1, 11, { 9, 9, 9 }, {
+		BC6H_R( 0, 0, 9 ), BC6H_G( 0, 0, 9 ), BC6H_B( 0, 0, 9 ), BC6H_R( 1, 0, 8 ), BC6H_R( 0, 10, 10 ), BC6H_G( 1, 0, 8 ),
+		BC6H_G( 0, 10, 10 ), BC6H_B( 1, 0, 8 ), BC6H_B( 0, 10, 10 ), BC6H_END } },
+	{ 0x0B, 5, 1, 1, 12, { 8, 8, 8 }, {
+		BC6H_R( 0, 0, 9 ), BC6H_G( 0, 0, 9 ), BC6H_B( 0, 0, 9 ), BC6H_R( 1, 0, 7 ), BC6H_R( 0, 11, 10 ), BC6H_G( 1, 0, 7 ),
+		BC6H_G( 0, 11, 10 ), BC6H_B( 1, 0, 7 ), BC6H_B( 0, 11, 10 ), BC6H_END } },
+	{ 0x0F, 5, 1, 1, 16, { 4, 4, 4 }, {
+		BC6H_R( 0, 0, 9 ), BC6H_G( 0, 0, 9 ), BC6H_B( 0, 0, 9 ), BC6H_R( 1, 0, 3 ), BC6H_R( 0, 15, 10 ), BC6H_G( 1, 0, 3 ),
+		BC6H_G( 0, 15, 10 ), BC6H_B( 1, 0, 3 ), BC6H_B( 0, 15, 10 ), BC6H_END } }
+};
+
+#undef BC6H_R
+#undef BC6H_G
+#undef BC6H_B
+#undef BC6H_END
+
+/*	the first one region mode, 10 bit endpoints without deltas	*/
+#define BC6H_FIRST_ONE_REGION_MODE	10
+
+static int
+	BC6H_sign_extend
+	(
+		int value, int bits
+	)
+{
+	return (value & (1 << (bits - 1))) ? value - (1 << bits) : value;
+}
+
+/*	endpoint to the 16 bit interpolation range	*/
+static int
+	BC6H_unquantize
+	(
+		int value, int bits, int is_signed
+	)
+{
+	int negative = 0;
+	if( !is_signed )
+	{
+		if( (bits >= 15) || (value == 0) )
+		{
+			return value;
+		}
+		if( value == (1 << bits) - 1 )
+		{
+			return 0xFFFF;
+		}
+		return ((value << 16) + 0x8000) >> bits;
+	}
+	if( bits >= 16 )
+	{
+		return value;
+	}
+	if( value < 0 )
+	{
+		negative = 1;
+		value = -value;
+	}
+	if( value == 0 )
+	{
+		return 0;
+	}
+	if( value >= (1 << (bits - 1)) - 1 )
+	{
+		value = 0x7FFF;
+	} else
+	{
+		value = ((value << 15) + 0x4000) >> (bits - 1);
+	}
+	return negative ? -value : value;
+}
+
+/*	an interpolated value to the bits of a half float	*/
+static int
+	BC6H_finish
+	(
+		int value, int is_signed
+	)
+{
+	if( !is_signed )
+	{
+		return (value * 31) >> 6;
+	}
+	return (value < 0) ? (0x8000 | (((-value) * 31) >> 5)) : ((value * 31) >> 5);
+}
+
+static float
+	BC6H_half_to_float
+	(
+		int half
+	)
+{
+	const int exponent = (half >> 10) & 0x1F;
+	const int mantissa = half & 0x3FF;
+	float value;
+	if( exponent == 0 )
+	{
+		value = ldexpf( (float)mantissa, -24 );
+	} else if( exponent == 31 )
+	{
+		value = mantissa ? (float)NAN : (float)INFINITY;
+	} else
+	{
+		value = ldexpf( (float)(mantissa | 0x400), exponent - 25 );
+	}
+	return (half & 0x8000) ? -value : value;
+}
+
+/*	the bits of the nearest positive half float, saturated to 65504	*/
+static int
+	BC6H_float_to_half
+	(
+		float value
+	)
+{
+	int exponent;
+	float mantissa;
+	if( !(value > 0.0f) )
+	{
+		/*	negative, zero and NaN	*/
+		return 0;
+	}
+	if( value >= 65504.0f )
+	{
+		return 0x7BFF;
+	}
+	mantissa = frexpf( value, &exponent );
+	if( exponent < -13 )
+	{
+		/*	subnormal, in steps of 2^-24	*/
+		return (int)floorf( ldexpf( value, 24 ) + 0.5f );
+	}
+	/*	mantissa is in [0.5, 1), rounding may carry into the exponent	*/
+	return ((exponent + 14) << 10) + (int)floorf( ldexpf( mantissa, 11 ) + 0.5f ) - 0x400;
+}
+
+void
+	BC6H_decode_block
+	(
+		const unsigned char compressed[16],
+		int is_signed,
+		float uncompressed[16*3]
+	)
+{
+	const BC6H_mode_info *info = NULL;
+	const BC6H_run *run;
+	int endpoints[4][3];
+	int mode, value, position, partition, e, c, p, b;
+	position = 0;
+	value = BC7_read_bits( compressed, &position, 2 );
+	if( value & 2 )
+	{
+		value |= BC7_read_bits( compressed, &position, 3 ) << 2;
+	}
+	for( mode = 0; mode < 14; ++mode )
+	{
+		if( BC6H_modes[mode].value == value )
+		{
+			info = &BC6H_modes[mode];
+			break;
+		}
+	}
+	if( NULL == info )
+	{
+		/*	the reserved modes decode to black	*/
+		memset( uncompressed, 0, 16*3*sizeof( float ) );
+		return;
+	}
+	memset( endpoints, 0, sizeof( endpoints ) );
+	for( run = info->runs; run->endpoint < 4; ++run )
+	{
+		const int step = (run->first <= run->last) ? 1 : -1;
+		for( b = run->first; ; b += step )
+		{
+			endpoints[run->endpoint][run->channel] |= BC7_read_bits( compressed, &position, 1 ) << b;
+			if( b == run->last )
+			{
+				break;
+			}
+		}
+	}
+	partition = (info->regions == 2) ? BC7_read_bits( compressed, &position, 5 ) : 0;
+	for( c = 0; c < 3; ++c )
+	{
+		if( is_signed )
+		{
+			endpoints[0][c] = BC6H_sign_extend( endpoints[0][c], info->endpoint_bits );
+		}
+		for( e = 1; e < info->regions * 2; ++e )
+		{
+			if( info->transformed )
+			{
+				/*	the deltas are always signed	*/
+				endpoints[e][c] = BC6H_sign_extend( endpoints[e][c], info->delta_bits[c] );
+				endpoints[e][c] = (endpoints[0][c] + endpoints[e][c]) & ((1 << info->endpoint_bits) - 1);
+			}
+			if( is_signed )
+			{
+				endpoints[e][c] = BC6H_sign_extend( endpoints[e][c], info->endpoint_bits );
+			}
+		}
+		for( e = 0; e < info->regions * 2; ++e )
+		{
+			endpoints[e][c] = BC6H_unquantize( endpoints[e][c], info->endpoint_bits, is_signed );
+		}
+	}
+	for( p = 0; p < 16; ++p )
+	{
+		const int s = BC7_subset( info->regions, partition, p );
+		const int index_bits = (info->regions == 2) ? 3 : 4;
+		const int index = BC7_read_bits( compressed, &position,
+			index_bits - (p == BC7_anchor( info->regions, partition, s ) ? 1 : 0) );
+		const int weight = BC7_weights( index_bits )[index];
+		for( c = 0; c < 3; ++c )
+		{
+			uncompressed[p*3 + c] = BC6H_half_to_float( BC6H_finish(
+				BC7_interpolate( endpoints[s*2][c], endpoints[s*2 + 1][c], weight ), is_signed ) );
+		}
+	}
+}
+
+/*	one region encoder: the endpoints, indices and error of a mode	*/
+typedef struct
+{
+	int mode;
+	int endpoints[2][3];
+	int indices[16];
+	double error;
+} BC6H_fit;
+
+/*	the nearest endpoint, measured after unquantization	*/
+static int
+	BC6H_quantize
+	(
+		float value, int bits
+	)
+{
+	const int max_value = (1 << bits) - 1;
+	int best = 0, q;
+	float best_error = 1e30f;
+	int guess = (int)floorf( value * max_value / 65535.0f + 0.5f );
+	for( q = guess - 1; q <= guess + 1; ++q )
+	{
+		const int code = q < 0 ? 0 : (q > max_value ? max_value : q);
+		const float d = BC6H_unquantize( code, bits, 0 ) - value;
+		if( d * d < best_error )
+		{
+			best_error = d * d;
+			best = code;
+		}
+	}
+	return best;
+}
+
+/*	quantize a line for a one region mode and pick the nearest indices,
+	the error is measured on the half float bits, which are close to
+	logarithmic	*/
+static void
+	BC6H_fit_mode
+	(
+		const int halves[16][3], unsigned int mask,
+		int mode, float line[2][3],
+		BC6H_fit *fit
+	)
+{
+	const BC6H_mode_info *info = &BC6H_modes[mode];
+	const int bits = info->endpoint_bits;
+	int palette[16][3];
+	int unquantized[2][3];
+	int p, k, c, e;
+	fit->mode = mode;
+	fit->error = 0.0;
+	for( c = 0; c < 3; ++c )
+	{
+		fit->endpoints[0][c] = BC6H_quantize( line[0][c], bits );
+		fit->endpoints[1][c] = BC6H_quantize( line[1][c], bits );
+		if( info->transformed )
+		{
+			/*	keep the second endpoint within reach of the delta	*/
+			const int reach = 1 << (info->delta_bits[c] - 1);
+			int delta = fit->endpoints[1][c] - fit->endpoints[0][c];
+			delta = delta < -reach ? -reach : (delta > reach - 1 ? reach - 1 : delta);
+			fit->endpoints[1][c] = fit->endpoints[0][c] + delta;
+		}
+		for( e = 0; e < 2; ++e )
+		{
+			unquantized[e][c] = BC6H_unquantize( fit->endpoints[e][c], bits, 0 );
+		}
+		for( k = 0; k < 16; ++k )
+		{
+			palette[k][c] = BC6H_finish( BC7_interpolate( unquantized[0][c], unquantized[1][c], BC7_weights4[k] ), 0 );
+		}
+	}
+	for( p = 0; p < 16; ++p )
+	{
+		double best_error = 1e300;
+		fit->indices[p] = 0;
+		for( k = 0; k < 16; ++k )
+		{
+			double d, error = 0.0;
+			for( c = 0; c < 3; ++c )
+			{
+				d = palette[k][c] - halves[p][c];
+				error += d * d;
+			}
+			if( error < best_error )
+			{
+				best_error = error;
+				fit->indices[p] = k;
+			}
+		}
+		if( mask & (1 << p) )
+		{
+			fit->error += best_error;
+		}
+	}
+	/*	the anchor index drops its high bit	*/
+	if( fit->indices[0] & 8 )
+	{
+		for( c = 0; c < 3; ++c )
+		{
+			const int swap = fit->endpoints[0][c];
+			fit->endpoints[0][c] = fit->endpoints[1][c];
+			fit->endpoints[1][c] = swap;
+			if( info->transformed &&
+				(fit->endpoints[0][c] - fit->endpoints[1][c] == 1 << (info->delta_bits[c] - 1)) )
+			{
+				/*	the reversed delta is out of reach	*/
+				fit->error = 1e300;
+			}
+		}
+		for( p = 0; p < 16; ++p )
+		{
+			fit->indices[p] = 15 - fit->indices[p];
+		}
+	}
+}
+
+static void
+	BC6H_write_block
+	(
+		const BC6H_fit *fit,
+		unsigned char out[16]
+	)
+{
+	const BC6H_mode_info *info = &BC6H_modes[fit->mode];
+	const BC6H_run *run;
+	int stored[2][3];
+	int position = 0;
+	int c, p, b;
+	for( c = 0; c < 3; ++c )
+	{
+		stored[0][c] = fit->endpoints[0][c];
+		stored[1][c] = info->transformed ?
+			((fit->endpoints[1][c] - fit->endpoints[0][c]) & ((1 << info->delta_bits[c]) - 1)) :
+			fit->endpoints[1][c];
+	}
+	memset( out, 0, 16 );
+	BC7_write_bits( out, &position, info->value, info->value_bits );
+	for( run = info->runs; run->endpoint < 4; ++run )
+	{
+		const int step = (run->first <= run->last) ? 1 : -1;
+		for( b = run->first; ; b += step )
+		{
+			BC7_write_bits( out, &position, (stored[run->endpoint][run->channel] >> b) & 1, 1 );
+			if( b == run->last )
+			{
+				break;
+			}
+		}
+	}
+	for( p = 0; p < 16; ++p )
+	{
+		BC7_write_bits( out, &position, fit->indices[p], p ? 4 : 3 );
+	}
+}
+
+/*	the fast tier: one line through the block in the half float domain,
+	quantized with each of the one region modes (10 bit endpoints, or an
+	11, 12 or 16 bit endpoint and a 9, 8 or 4 bit delta)	*/
+static void
+	BC6H_compress_block
+	(
+		const int halves[16][3], unsigned int mask,
+		unsigned char out[16]
+	)
+{
+	float mean[3] = { 0.0f, 0.0f, 0.0f };
+	float axis[3] = { 0.0f, 0.0f, 0.0f };
+	float covariance[3][3];
+	float scaled[16][3];
+	float line[2][3];
+	float t, t_min, t_max, t_first, length, farthest;
+	BC6H_fit best, trial;
+	int count = 0;
+	int p, c, d, mode, iteration;
+	/*	to the interpolation range, where finishing multiplies by 31/64	*/
+	for( p = 0; p < 16; ++p )
+	{
+		for( c = 0; c < 3; ++c )
+		{
+			scaled[p][c] = halves[p][c] * (64.0f / 31.0f);
+			if( mask & (1 << p) )
+			{
+				mean[c] += scaled[p][c];
+			}
+		}
+		count += (mask >> p) & 1;
+	}
+	for( c = 0; c < 3; ++c )
+	{
+		mean[c] /= count;
+	}
+	memset( covariance, 0, sizeof( covariance ) );
+	farthest = -1.0f;
+	for( p = 0; p < 16; ++p )
+	{
+		float distance = 0.0f;
+		if( !(mask & (1 << p)) )
+		{
+			continue;
+		}
+		for( c = 0; c < 3; ++c )
+		{
+			for( d = 0; d < 3; ++d )
+			{
+				covariance[c][d] += (scaled[p][c] - mean[c]) * (scaled[p][d] - mean[d]);
+			}
+			distance += (scaled[p][c] - mean[c]) * (scaled[p][c] - mean[c]);
+		}
+		if( distance > farthest )
+		{
+			farthest = distance;
+			for( c = 0; c < 3; ++c )
+			{
+				axis[c] = scaled[p][c] - mean[c];
+			}
+		}
+	}
+	for( iteration = 0; iteration < 8; ++iteration )
+	{
+		float next[3] = { 0.0f, 0.0f, 0.0f };
+		length = 0.0f;
+		for( c = 0; c < 3; ++c )
+		{
+			for( d = 0; d < 3; ++d )
+			{
+				next[c] += covariance[c][d] * axis[d];
+			}
+			length += next[c] * next[c];
+		}
+		if( length <= 1e-12f )
+		{
+			break;
+		}
+		length = 1.0f / sqrtf( length );
+		for( c = 0; c < 3; ++c )
+		{
+			axis[c] = next[c] * length;
+		}
+	}
+	length = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+	length = (length > 1e-12f) ? 1.0f / sqrtf( length ) : 0.0f;
+	t_min = t_max = t_first = 0.0f;
+	for( p = 0; p < 16; ++p )
+	{
+		t = 0.0f;
+		for( c = 0; c < 3; ++c )
+		{
+			t += (scaled[p][c] - mean[c]) * axis[c] * length;
+		}
+		if( p == 0 )
+		{
+			t_first = t;
+		}
+		if( mask & (1 << p) )
+		{
+			if( t < t_min ) t_min = t;
+			if( t > t_max ) t_max = t;
+		}
+	}
+	if( t_first > (t_min + t_max) * 0.5f )
+	{
+		/*	so pixel 0, the anchor, is nearer to the first endpoint	*/
+		t = t_min;
+		t_min = t_max;
+		t_max = t;
+	}
+	for( c = 0; c < 3; ++c )
+	{
+		line[0][c] = mean[c] + t_min * axis[c] * length;
+		line[1][c] = mean[c] + t_max * axis[c] * length;
+		line[0][c] = line[0][c] < 0.0f ? 0.0f : (line[0][c] > 65535.0f ? 65535.0f : line[0][c]);
+		line[1][c] = line[1][c] < 0.0f ? 0.0f : (line[1][c] > 65535.0f ? 65535.0f : line[1][c]);
+	}
+	BC6H_fit_mode( halves, mask, BC6H_FIRST_ONE_REGION_MODE, line, &best );
+	for( mode = BC6H_FIRST_ONE_REGION_MODE + 1; mode < 14; ++mode )
+	{
+		BC6H_fit_mode( halves, mask, mode, line, &trial );
+		if( trial.error < best.error )
+		{
+			best = trial;
+		}
+	}
+	if( best.error > 0.0 )
+	{
+		/*	least squares endpoints for the chosen indices	*/
+		float aa = 0.0f, ab = 0.0f, bb = 0.0f, determinant;
+		float xa[3] = { 0.0f, 0.0f, 0.0f };
+		float xb[3] = { 0.0f, 0.0f, 0.0f };
+		for( p = 0; p < 16; ++p )
+		{
+			float w1, w0;
+			if( !(mask & (1 << p)) )
+			{
+				continue;
+			}
+			w1 = BC7_weights4[best.indices[p]] / 64.0f;
+			w0 = 1.0f - w1;
+			aa += w0 * w0;
+			ab += w0 * w1;
+			bb += w1 * w1;
+			for( c = 0; c < 3; ++c )
+			{
+				xa[c] += w0 * scaled[p][c];
+				xb[c] += w1 * scaled[p][c];
+			}
+		}
+		determinant = aa * bb - ab * ab;
+		if( fabsf( determinant ) > 1e-6f )
+		{
+			determinant = 1.0f / determinant;
+			for( c = 0; c < 3; ++c )
+			{
+				line[0][c] = (bb * xa[c] - ab * xb[c]) * determinant;
+				line[1][c] = (aa * xb[c] - ab * xa[c]) * determinant;
+				line[0][c] = line[0][c] < 0.0f ? 0.0f : (line[0][c] > 65535.0f ? 65535.0f : line[0][c]);
+				line[1][c] = line[1][c] < 0.0f ? 0.0f : (line[1][c] > 65535.0f ? 65535.0f : line[1][c]);
+			}
+			for( mode = BC6H_FIRST_ONE_REGION_MODE; mode < 14; ++mode )
+			{
+				BC6H_fit_mode( halves, mask, mode, line, &trial );
+				if( trial.error < best.error )
+				{
+					best = trial;
+				}
+			}
+		}
+	}
+	BC6H_write_block( &best, out );
+}
+
+static void
+	BC6H_encode_rows
+	(
+		void *argument
+	)
+{
+	const BPTC_encode_job *job = (const BPTC_encode_job*)argument;
+	const int blocks_wide = (job->width + 3) >> 2;
+	int halves[16][3];
+	unsigned int mask;
+	int i, row, x, y, c, p;
+	for( row = job->first_row; row < job->last_row; ++row )
+	{
+		unsigned char *out = job->compressed + (size_t)row * blocks_wide * 16;
+		for( i = 0; i < blocks_wide; ++i, out += 16 )
+		{
+			/*	the pixels as half floats, the padding is ignored by the fit	*/
+			mask = 0;
+			for( y = 0; y < 4; ++y )
+			{
+				for( x = 0; x < 4; ++x )
+				{
+					const float *src;
+					p = y * 4 + x;
+					if( (row * 4 + y < job->height) && (i * 4 + x < job->width) )
+					{
+						src = &job->uncompressed_float[((size_t)(row * 4 + y) * job->width + (i * 4 + x)) * job->channels];
+						mask |= 1 << p;
+					} else
+					{
+						src = &job->uncompressed_float[((size_t)(row * 4) * job->width + (i * 4)) * job->channels];
+					}
+					for( c = 0; c < 3; ++c )
+					{
+						halves[p][c] = BC6H_float_to_half( src[job->channels < 3 ? 0 : c] );
+					}
+				}
+			}
+			BC6H_compress_block( (const int (*)[3])halves, mask, out );
+		}
+	}
+}
+
+/*	split the block rows of single across the shared thread pool	*/
+static unsigned char*
+	BPTC_convert_image
+	(
+		BPTC_encode_job *single,
+		int *out_size,
+		thread_pool_task encode_rows
+	)
+{
+	BPTC_encode_job *jobs;
+	struct SOIL_ThreadPool *pool;
+	thread_pool_group group;
+	int block_rows, blocks, job_count, i;
+	/*	error check	*/
+	*out_size = 0;
+	if( (single->width < 1) || (single->height < 1) ||
+		((NULL == single->uncompressed) && (NULL == single->uncompressed_float)) ||
+		(single->channels < 1) || (single->channels > 4) )
+	{
+		return NULL;
+	}
+	/*	16 bytes per 4x4 pixel block	*/
+	block_rows = (single->height+3) >> 2;
+	blocks = ((single->width+3) >> 2) * block_rows;
+	*out_size = blocks * 16;
+	single->compressed = (unsigned char*)malloc( *out_size );
+	if( NULL == single->compressed )
+	{
+		*out_size = 0;
+		return NULL;
+	}
+	single->first_row = 0;
+	single->last_row = block_rows;
+	pool = (blocks >= BPTC_THREADED_MIN_BLOCKS) ? thread_pool_shared() : NULL;
+	job_count = pool ? thread_pool_thread_count( pool ) * 4 : 1;
+	if( job_count > block_rows )
+	{
+		job_count = block_rows;
+	}
+	jobs = job_count > 1 ? (BPTC_encode_job*)malloc( job_count * sizeof( BPTC_encode_job ) ) : NULL;
+	if( NULL == jobs )
+	{
+		encode_rows( single );
+		return single->compressed;
+	}
+	thread_pool_group_init( &group );
+	for( i = 0; i < job_count; ++i )
+	{
+		jobs[i] = *single;
+		jobs[i].first_row = (int)( (long long)block_rows * i / job_count );
+		jobs[i].last_row = (int)( (long long)block_rows * (i + 1) / job_count );
+		if( !thread_pool_submit( pool, &group, encode_rows, &jobs[i] ) )
+		{
+			/*	out of memory queueing, do it here	*/
+			encode_rows( &jobs[i] );
+		}
+	}
+	thread_pool_wait( pool, &group );
+	free( jobs );
+	return single->compressed;
+}
+
+/********* Actual Exposed Functions *********/
+unsigned char*
+	convert_image_to_BC7
+	(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int *out_size, unsigned int options
+	)
+{
+	BPTC_encode_job single;
+	memset( &single, 0, sizeof( BPTC_encode_job ) );
+	single.uncompressed = uncompressed;
+	single.width = width;
+	single.height = height;
+	single.channels = channels;
+	single.options = options;
+	return BPTC_convert_image( &single, out_size, BC7_encode_rows );
+}
+
+unsigned char*
+	convert_image_to_BC6H
+	(
+		const float *const uncompressed,
+		int width, int height, int channels,
+		int *out_size, unsigned int options
+	)
+{
+	BPTC_encode_job single;
+	memset( &single, 0, sizeof( BPTC_encode_job ) );
+	single.uncompressed_float = uncompressed;
+	single.width = width;
+	single.height = height;
+	single.channels = channels;
+	single.options = options;
+	return BPTC_convert_image( &single, out_size, BC6H_encode_rows );
+}
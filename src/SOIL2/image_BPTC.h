@@ -0,0 +1,81 @@
+/*
+	BPTC (BC7 and BC6H) compression and decompression
+
+	MIT license
+*/
+
+#ifndef HEADER_IMAGE_BPTC
+#define HEADER_IMAGE_BPTC
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+	Options of convert_image_to_BC7.
+	By default only mode 6 (one RGBA line per block, 16 steps) is tried,
+	which is fast enough for load time.
+	BPTC_COMPRESS_MULTI_MODE is the bake time tier: opaque blocks also
+	try the 2 subset modes 1 and 3, blocks with alpha the modes 5 and 7,
+	each on the partitions that best fit 2 lines, and the block keeps
+	the mode with the smallest error.
+**/
+enum
+{
+	BPTC_COMPRESS_MULTI_MODE = 1
+};
+
+/**
+	take an image and convert it to BC7, the 16 byte blocks are split
+	across the shared thread pool for large images
+**/
+unsigned char*
+	convert_image_to_BC7
+	(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int *out_size, unsigned int options
+	);
+
+/**
+	Decodes a 16 byte BC7 block (any mode) to 4x4 RGBA pixels.
+	Blocks with a reserved mode decode to transparent black.
+**/
+void
+	BC7_decode_block
+	(
+		const unsigned char compressed[16],
+		unsigned char uncompressed[16*4]
+	);
+
+/**
+	take an RGB(A) float image and convert it to BC6H (unsigned float),
+	negative values clamp to 0 and large ones to 65504, alpha is ignored.
+	Only the one region modes are tried, which is fast enough for load time.
+**/
+unsigned char*
+	convert_image_to_BC6H
+	(
+		const float *const uncompressed,
+		int width, int height, int channels,
+		int *out_size, unsigned int options
+	);
+
+/**
+	Decodes a 16 byte BC6H block (any mode) to 4x4 RGB float pixels,
+	is_signed selects the signed (SF16) variant.
+	Blocks with a reserved mode decode to black.
+**/
+void
+	BC6H_decode_block
+	(
+		const unsigned char compressed[16],
+		int is_signed,
+		float uncompressed[16*3]
+	);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEADER_IMAGE_BPTC	*/
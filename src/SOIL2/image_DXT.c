@@ -8,6 +8,9 @@
 */
 
 #include "image_DXT.h"
+#include "image_BPTC.h"
+#include "image_simd.h"
+#include "thread_pool.h"
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
@@ -38,6 +41,63 @@ void compress_DDS_alpha_block(
 				const unsigned char *const uncompressed,
 				unsigned char compressed[8] );
 
+int rgb_to_565( int r, int g, int b );
+void rgb_888_from_565( unsigned int c, int *r, int *g, int *b );
+
+/*	images with at least this many blocks are split across the thread pool	*/
+#define DXT_THREADED_MIN_BLOCKS	4096
+/*	blocks encoded together by the vector kernels, one per lane	*/
+#define DXT_BATCH_BLOCKS	8
+
+/*	a range of block rows to encode	*/
+typedef struct
+{
+	const unsigned char *uncompressed;
+	int width, height, channels;
+	unsigned char *compressed;
+	/*	DXT_FORMAT_*, 8 or 16 bytes per block	*/
+	int format, block_size;
+	unsigned int options;
+	int first_row, last_row;
+} DXT_encode_job;
+
+/*	component c of pixel p of block b is pixels[c][p][b]	*/
+typedef struct
+{
+	float pixels[4][16][DXT_BATCH_BLOCKS];
+	/*	the master colors before clamping	*/
+	int c0[3][DXT_BATCH_BLOCKS], c1[3][DXT_BATCH_BLOCKS];
+	/*	the 565 master colors and the line between them	*/
+	int enc_c0[DXT_BATCH_BLOCKS], enc_c1[DXT_BATCH_BLOCKS];
+	float line[3][DXT_BATCH_BLOCKS];
+	float offset[DXT_BATCH_BLOCKS];
+	unsigned int color_bits[DXT_BATCH_BLOCKS];
+	/*	the alpha limits and the indices of pixels 0-7 and 8-15	*/
+	int alpha_max[DXT_BATCH_BLOCKS], alpha_min[DXT_BATCH_BLOCKS];
+	unsigned int alpha_bits[2][DXT_BATCH_BLOCKS];
+} DXT_batch;
+
+typedef void (*DXT_batch_func)( DXT_batch *batch );
+
+typedef struct
+{
+	DXT_batch_func color_endpoints;
+	DXT_batch_func color_indices;
+	DXT_batch_func alpha;
+} DXT_kernels;
+
+static unsigned char* convert_image_to_DXT( const unsigned char *const uncompressed,
+		int width, int height, int channels, int *out_size, int format, unsigned int options );
+static void DXT_encode_rows( void *argument );
+static void DXT_gather_block( const unsigned char *const uncompressed,
+		int width, int height, int channels, int i, int j, unsigned char ublock[16*4] );
+static void DXT_gather_channel( const unsigned char *const uncompressed,
+		int width, int height, int channels, int i, int j, int channel, unsigned char ublock[16*4] );
+static void DXT_color_palette( int enc_c0, int enc_c1, int palette[4][3] );
+static void DXT_alpha_palette( int a0, int a1, int palette[8] );
+static void DXT_color_lines( DXT_batch *batch );
+static const DXT_kernels* DXT_pick_kernels( void );
+
 /********* Actual Exposed Functions *********/
 int
 	save_image_as_DDS
@@ -46,12 +106,26 @@ int
 		int width, int height, int channels,
 		const unsigned char *const data
 	)
+{
+	return save_image_as_DDS_ex( filename, width, height, channels, data, 0, NULL );
+}
+
+int
+	save_image_as_DDS_ex
+	(
+		const char *filename,
+		int width, int height, int channels,
+		const unsigned char *const data,
+		unsigned int options,
+		DXT_error *error
+	)
 {
 	/*	variables	*/
 	FILE *fout;
 	unsigned char *DDS_data;
 	DDS_header header;
-	int DDS_size;
+	DDS_HEADER_DXT10 header10;
+	int DDS_size, format;
 	/*	error check	*/
 	if( (NULL == filename) ||
 		(width < 1) || (height < 1) ||
@@ -61,14 +135,37 @@ int
 		return 0;
 	}
 	/*	Convert the image	*/
-	if( (channels & 1) == 1 )
+	if( options & DXT_COMPRESS_BC7 )
+	{
+		format = DXT_FORMAT_BC7;
+	} else if( (options & DXT_COMPRESS_RGTC) && (channels < 3) )
+	{
+		/*	luminance (and alpha), BC4 or BC5	*/
+		format = (channels == 1) ? DXT_FORMAT_BC4 : DXT_FORMAT_BC5;
+	} else if( (channels & 1) == 1 )
 	{
 		/*	no alpha, just use DXT1	*/
-		DDS_data = convert_image_to_DXT1( data, width, height, channels, &DDS_size );
+		format = DXT_FORMAT_DXT1;
 	} else
 	{
 		/*	has alpha, so use DXT5	*/
-		DDS_data = convert_image_to_DXT5( data, width, height, channels, &DDS_size );
+		format = DXT_FORMAT_DXT5;
+	}
+	if( format == DXT_FORMAT_BC7 )
+	{
+		DDS_data = convert_image_to_BC7( data, width, height, channels, &DDS_size,
+			(options & DXT_COMPRESS_CLUSTER_FIT) ? BPTC_COMPRESS_MULTI_MODE : 0 );
+	} else
+	{
+		DDS_data = convert_image_to_DXT( data, width, height, channels, &DDS_size, format, options );
+	}
+	if( NULL == DDS_data )
+	{
+		return 0;
+	}
+	if( NULL != error )
+	{
+		DXT_measure_error( data, width, height, channels, DDS_data, format, error );
 	}
 	/*	save it	*/
 	memset( &header, 0, sizeof( DDS_header ) );
@@ -80,17 +177,42 @@ int
 	header.dwPitchOrLinearSize = DDS_size;
 	header.sPixelFormat.dwSize = 32;
 	header.sPixelFormat.dwFlags = DDPF_FOURCC;
-	if( (channels & 1) == 1 )
+	switch( format )
 	{
+	case DXT_FORMAT_DXT1:
 		header.sPixelFormat.dwFourCC = ('D' << 0) | ('X' << 8) | ('T' << 16) | ('1' << 24);
-	} else
-	{
+		break;
+	case DXT_FORMAT_DXT5:
 		header.sPixelFormat.dwFourCC = ('D' << 0) | ('X' << 8) | ('T' << 16) | ('5' << 24);
+		break;
+	case DXT_FORMAT_BC4:
+		header.sPixelFormat.dwFourCC = ('A' << 0) | ('T' << 8) | ('I' << 16) | ('1' << 24);
+		break;
+	case DXT_FORMAT_BC7:
+		/*	only the DX10 header can say BC7	*/
+		header.sPixelFormat.dwFourCC = ('D' << 0) | ('X' << 8) | ('1' << 16) | ('0' << 24);
+		break;
+	default:
+		header.sPixelFormat.dwFourCC = ('A' << 0) | ('T' << 8) | ('I' << 16) | ('2' << 24);
+		break;
 	}
 	header.sCaps.dwCaps1 = DDSCAPS_TEXTURE;
 	/*	write it out	*/
 	fout = fopen( filename, "wb");
+	if( NULL == fout )
+	{
+		free( DDS_data );
+		return 0;
+	}
 	fwrite( &header, sizeof( DDS_header ), 1, fout );
+	if( format == DXT_FORMAT_BC7 )
+	{
+		memset( &header10, 0, sizeof( DDS_HEADER_DXT10 ) );
+		header10.dxgiFormat = DXGI_FORMAT_BC7_UNORM;
+		header10.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+		header10.arraySize = 1;
+		fwrite( &header10, sizeof( DDS_HEADER_DXT10 ), 1, fout );
+	}
 	fwrite( DDS_data, 1, DDS_size, fout );
 	fclose( fout );
 	/*	done	*/
@@ -98,16 +220,29 @@ int
 	return 1;
 }
 
-unsigned char* convert_image_to_DXT1(
+/*	DXT_COMPRESS_DETERMINISTIC or the fast path: the block rows are split
+	across the thread pool and each row is encoded 8 blocks at a time
+	(DXT_COMPRESS_CLUSTER_FIT and BC4 / BC5 are threaded too, but one
+	block at a time)	*/
+static unsigned char*
+	convert_image_to_DXT
+	(
 		const unsigned char *const uncompressed,
 		int width, int height, int channels,
-		int *out_size )
+		int *out_size, int format,
+		unsigned int options
+	)
 {
 	unsigned char *compressed;
-	int i, j, x, y;
-	unsigned char ublock[16*3];
-	unsigned char cblock[8];
-	int index = 0, chan_step = 1;
+	DXT_encode_job single;
+	DXT_encode_job *jobs;
+	struct SOIL_ThreadPool *pool;
+	thread_pool_group group;
+	const int block_size = ((format == DXT_FORMAT_DXT1) || (format == DXT_FORMAT_BC4)) ? 8 : 16;
+	int block_rows, blocks, job_count, i;
+	/*	the cluster fit is costly enough to split much smaller images	*/
+	const int threaded_min_blocks = (options & DXT_COMPRESS_CLUSTER_FIT) ?
+		DXT_THREADED_MIN_BLOCKS / 16 : DXT_THREADED_MIN_BLOCKS;
 	/*	error check	*/
 	*out_size = 0;
 	if( (width < 1) || (height < 1) ||
@@ -116,159 +251,234 @@ unsigned char* convert_image_to_DXT1(
 	{
 		return NULL;
 	}
-	/*	for channels == 1 or 2, I do not step forward for R,G,B values	*/
-	if( channels < 3 )
-	{
-		chan_step = 0;
-	}
 	/*	get the RAM for the compressed image
-		(8 bytes per 4x4 pixel block)	*/
-	*out_size = ((width+3) >> 2) * ((height+3) >> 2) * 8;
+		(8 or 16 bytes per 4x4 pixel block)	*/
+	block_rows = (height+3) >> 2;
+	blocks = ((width+3) >> 2) * block_rows;
+	*out_size = blocks * block_size;
 	compressed = (unsigned char*)malloc( *out_size );
-	/*	go through each block	*/
-	for( j = 0; j < height; j += 4 )
+	if( NULL == compressed )
 	{
-		for( i = 0; i < width; i += 4 )
+		*out_size = 0;
+		return NULL;
+	}
+	single.uncompressed = uncompressed;
+	single.width = width;
+	single.height = height;
+	single.channels = channels;
+	single.compressed = compressed;
+	single.format = format;
+	single.block_size = block_size;
+	single.options = options;
+	single.first_row = 0;
+	single.last_row = block_rows;
+	/*	small images and the reference encoder stay on this thread	*/
+	pool = NULL;
+	if( !(options & DXT_COMPRESS_DETERMINISTIC) && (blocks >= threaded_min_blocks) )
+	{
+		pool = thread_pool_shared();
+	}
+	job_count = pool ? thread_pool_thread_count( pool ) * 4 : 1;
+	if( job_count > block_rows )
+	{
+		job_count = block_rows;
+	}
+	jobs = job_count > 1 ? (DXT_encode_job*)malloc( job_count * sizeof( DXT_encode_job ) ) : NULL;
+	if( NULL == jobs )
+	{
+		DXT_encode_rows( &single );
+		return compressed;
+	}
+	thread_pool_group_init( &group );
+	for( i = 0; i < job_count; ++i )
+	{
+		jobs[i] = single;
+		jobs[i].first_row = (int)( (long long)block_rows * i / job_count );
+		jobs[i].last_row = (int)( (long long)block_rows * (i + 1) / job_count );
+		if( !thread_pool_submit( pool, &group, DXT_encode_rows, &jobs[i] ) )
 		{
-			/*	copy this block into a new one	*/
-			int idx = 0;
-			int mx = 4, my = 4;
-			if( j+4 >= height )
-			{
-				my = height - j;
-			}
-			if( i+4 >= width )
-			{
-				mx = width - i;
-			}
-			for( y = 0; y < my; ++y )
-			{
-				for( x = 0; x < mx; ++x )
-				{
-					ublock[idx++] = uncompressed[(j+y)*width*channels+(i+x)*channels];
-					ublock[idx++] = uncompressed[(j+y)*width*channels+(i+x)*channels+chan_step];
-					ublock[idx++] = uncompressed[(j+y)*width*channels+(i+x)*channels+chan_step+chan_step];
-				}
-				for( x = mx; x < 4; ++x )
-				{
-					ublock[idx++] = ublock[0];
-					ublock[idx++] = ublock[1];
-					ublock[idx++] = ublock[2];
-				}
-			}
-			for( y = my; y < 4; ++y )
-			{
-				for( x = 0; x < 4; ++x )
-				{
-					ublock[idx++] = ublock[0];
-					ublock[idx++] = ublock[1];
-					ublock[idx++] = ublock[2];
-				}
-			}
-			/*	compress the block	*/
-			compress_DDS_color_block( 3, ublock, cblock );
-			/*	copy the data from the block into the main block	*/
-			for( x = 0; x < 8; ++x )
-			{
-				compressed[index++] = cblock[x];
-			}
+			/*	out of memory queueing, do it here	*/
+			DXT_encode_rows( &jobs[i] );
 		}
 	}
+	thread_pool_wait( pool, &group );
+	free( jobs );
 	return compressed;
 }
 
+unsigned char* convert_image_to_DXT1(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int *out_size )
+{
+	return convert_image_to_DXT( uncompressed, width, height, channels, out_size, DXT_FORMAT_DXT1, 0 );
+}
+
 unsigned char* convert_image_to_DXT5(
 		const unsigned char *const uncompressed,
 		int width, int height, int channels,
 		int *out_size )
 {
-	unsigned char *compressed;
-	int i, j, x, y;
+	return convert_image_to_DXT( uncompressed, width, height, channels, out_size, DXT_FORMAT_DXT5, 0 );
+}
+
+unsigned char* convert_image_to_DXT1_ex(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int *out_size, unsigned int options )
+{
+	return convert_image_to_DXT( uncompressed, width, height, channels, out_size, DXT_FORMAT_DXT1, options );
+}
+
+unsigned char* convert_image_to_DXT5_ex(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int *out_size, unsigned int options )
+{
+	return convert_image_to_DXT( uncompressed, width, height, channels, out_size, DXT_FORMAT_DXT5, options );
+}
+
+unsigned char* convert_image_to_BC4(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int *out_size, unsigned int options )
+{
+	return convert_image_to_DXT( uncompressed, width, height, channels, out_size, DXT_FORMAT_BC4, options );
+}
+
+unsigned char* convert_image_to_BC5(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int *out_size, unsigned int options )
+{
+	return convert_image_to_DXT( uncompressed, width, height, channels, out_size, DXT_FORMAT_BC5, options );
+}
+
+/*	the 3 bit index of pixel p in a DXT5 alpha or BC4 block	*/
+static int
+	DXT_alpha_index
+	(
+		const unsigned char *const block,
+		int p
+	)
+{
+	const int bit = 16 + p*3;
+	return ((block[bit >> 3] | (block[1 + (bit >> 3)] << 8)) >> (bit & 7)) & 7;
+}
+
+int
+	DXT_measure_error
+	(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		const unsigned char *const compressed,
+		int format,
+		DXT_error *error
+	)
+{
+	static const int compared_channels[] = { 3, 4, 1, 2, 4 };
+	const int block_size = ((format == DXT_FORMAT_DXT1) || (format == DXT_FORMAT_BC4)) ? 8 : 16;
+	/*	BC7 leaves the alpha of opaque images out	*/
+	const int compared = ((format == DXT_FORMAT_BC7) && (channels & 1)) ? 3 : compared_channels[format];
+	const unsigned char *block = compressed;
 	unsigned char ublock[16*4];
-	unsigned char cblock[8];
-	int index = 0, chan_step = 1;
-	int has_alpha;
+	double sum = 0.0;
+	int i, j, p, c;
 	/*	error check	*/
-	*out_size = 0;
 	if( (width < 1) || (height < 1) ||
-		(NULL == uncompressed) ||
-		(channels < 1) || ( channels > 4) )
-	{
-		return NULL;
-	}
-	/*	for channels == 1 or 2, I do not step forward for R,G,B vales	*/
-	if( channels < 3 )
+		(NULL == uncompressed) || (NULL == compressed) || (NULL == error) ||
+		(channels < 1) || (channels > 4) ||
+		(format < DXT_FORMAT_DXT1) || (format > DXT_FORMAT_BC7) )
 	{
-		chan_step = 0;
+		return 0;
 	}
-	/*	# channels = 1 or 3 have no alpha, 2 & 4 do have alpha	*/
-	has_alpha = 1 - (channels & 1);
-	/*	get the RAM for the compressed image
-		(16 bytes per 4x4 pixel block)	*/
-	*out_size = ((width+3) >> 2) * ((height+3) >> 2) * 16;
-	compressed = (unsigned char*)malloc( *out_size );
-	/*	go through each block	*/
 	for( j = 0; j < height; j += 4 )
 	{
 		for( i = 0; i < width; i += 4 )
 		{
-			/*	local variables, and my block counter	*/
-			int idx = 0;
-			int mx = 4, my = 4;
-			if( j+4 >= height )
-			{
-				my = height - j;
-			}
-			if( i+4 >= width )
+			int alpha[8];
+			int colors[4][3];
+			if( format == DXT_FORMAT_BC7 )
 			{
-				mx = width - i;
-			}
-			for( y = 0; y < my; ++y )
-			{
-				for( x = 0; x < mx; ++x )
+				unsigned char decoded[16*4];
+				DXT_gather_block( uncompressed, width, height, channels, i, j, ublock );
+				BC7_decode_block( block, decoded );
+				for( p = 0; p < 16; ++p )
 				{
-					ublock[idx++] = uncompressed[(j+y)*width*channels+(i+x)*channels];
-					ublock[idx++] = uncompressed[(j+y)*width*channels+(i+x)*channels+chan_step];
-					ublock[idx++] = uncompressed[(j+y)*width*channels+(i+x)*channels+chan_step+chan_step];
-					ublock[idx++] =
-						has_alpha * uncompressed[(j+y)*width*channels+(i+x)*channels+channels-1]
-						+ (1-has_alpha)*255;
+					if( (i + (p & 3) < width) && (j + (p >> 2) < height) )
+					{
+						for( c = 0; c < compared; ++c )
+						{
+							const double d = ublock[p*4+c] - decoded[p*4+c];
+							sum += d * d;
+						}
+					}
 				}
-				for( x = mx; x < 4; ++x )
+				block += block_size;
+				continue;
+			}
+			if( format >= DXT_FORMAT_BC4 )
+			{
+				/*	1 or 2 channels, each coded like DXT5 alpha	*/
+				for( c = 0; c < compared_channels[format]; ++c )
 				{
-					ublock[idx++] = ublock[0];
-					ublock[idx++] = ublock[1];
-					ublock[idx++] = ublock[2];
-					ublock[idx++] = ublock[3];
+					DXT_gather_channel( uncompressed, width, height, channels, i, j, c, ublock );
+					DXT_alpha_palette( block[c*8], block[c*8+1], alpha );
+					for( p = 0; p < 16; ++p )
+					{
+						if( (i + (p & 3) < width) && (j + (p >> 2) < height) )
+						{
+							const double d = ublock[p*4+3] - alpha[DXT_alpha_index( block + c*8, p )];
+							sum += d * d;
+						}
+					}
 				}
+				block += block_size;
+				continue;
 			}
-			for( y = my; y < 4; ++y )
 			{
-				for( x = 0; x < 4; ++x )
+				const int c0 = block[block_size-8] | (block[block_size-7] << 8);
+				const int c1 = block[block_size-6] | (block[block_size-5] << 8);
+				DXT_gather_block( uncompressed, width, height, channels, i, j, ublock );
+				DXT_color_palette( c0, c1, colors );
+				if( (format == DXT_FORMAT_DXT1) && (c0 <= c1) )
 				{
-					ublock[idx++] = ublock[0];
-					ublock[idx++] = ublock[1];
-					ublock[idx++] = ublock[2];
-					ublock[idx++] = ublock[3];
+					/*	DXT1's 3 color mode	*/
+					for( c = 0; c < 3; ++c )
+					{
+						colors[2][c] = (colors[0][c] + colors[1][c]) / 2;
+						colors[3][c] = 0;
+					}
 				}
 			}
-			/*	now compress the alpha block	*/
-			compress_DDS_alpha_block( ublock, cblock );
-			/*	copy the data from the compressed alpha block into the main buffer	*/
-			for( x = 0; x < 8; ++x )
+			if( format == DXT_FORMAT_DXT5 )
 			{
-				compressed[index++] = cblock[x];
+				DXT_alpha_palette( block[0], block[1], alpha );
 			}
-			/*	then compress the color block	*/
-			compress_DDS_color_block( 4, ublock, cblock );
-			/*	copy the data from the compressed color block into the main buffer	*/
-			for( x = 0; x < 8; ++x )
+			for( p = 0; p < 16; ++p )
 			{
-				compressed[index++] = cblock[x];
+				const int index = (block[block_size-4 + (p >> 2)] >> ((p & 3) * 2)) & 3;
+				if( (i + (p & 3) >= width) || (j + (p >> 2) >= height) )
+				{
+					continue;
+				}
+				for( c = 0; c < 3; ++c )
+				{
+					const double d = ublock[p*4+c] - colors[index][c];
+					sum += d * d;
+				}
+				if( format == DXT_FORMAT_DXT5 )
+				{
+					const double d = ublock[p*4+3] - alpha[DXT_alpha_index( block, p )];
+					sum += d * d;
+				}
 			}
+			block += block_size;
 		}
 	}
-	return compressed;
+	error->RMSE = sqrt( sum / ((double)width * height * compared) );
+	error->PSNR = (error->RMSE > 0.0) ? 20.0 * log10( 255.0 / error->RMSE ) : HUGE_VAL;
+	return 1;
 }
 
 /********* Helper Functions *********/
@@ -627,3 +837,1230 @@ void
 	}
 	/*	done compressing to DXT1	*/
 }
+
+/********* Cluster Fit Encoder *********/
+/*
+	The 4 colors of a block in index order, decoded like
+	stbi_decode_DXT_color_block does (c0 > c1, or DXT5).
+*/
+static void
+	DXT_color_palette
+	(
+		int enc_c0, int enc_c1,
+		int palette[4][3]
+	)
+{
+	int i;
+	rgb_888_from_565( enc_c0, &palette[0][0], &palette[0][1], &palette[0][2] );
+	rgb_888_from_565( enc_c1, &palette[1][0], &palette[1][1], &palette[1][2] );
+	for( i = 0; i < 3; ++i )
+	{
+		palette[2][i] = (2*palette[0][i] + palette[1][i]) / 3;
+		palette[3][i] = (palette[0][i] + 2*palette[1][i]) / 3;
+	}
+}
+
+/*
+	Picks the nearest palette color for each RGBA pixel, returns
+	the summed squared error of the pixels in mask.
+*/
+static int
+	DXT_color_indices
+	(
+		const unsigned char *const uncompressed,
+		unsigned int mask,
+		int palette[4][3],
+		int indices[16]
+	)
+{
+	int i, k, error = 0;
+	for( i = 0; i < 16; ++i )
+	{
+		int best = 0, best_error = 0x7FFFFFFF;
+		for( k = 0; k < 4; ++k )
+		{
+			int dr = uncompressed[i*4+0] - palette[k][0];
+			int dg = uncompressed[i*4+1] - palette[k][1];
+			int db = uncompressed[i*4+2] - palette[k][2];
+			int e = dr*dr + dg*dg + db*db;
+			if( e < best_error )
+			{
+				best_error = e;
+				best = k;
+			}
+		}
+		indices[i] = best;
+		if( mask & (1u << i) )
+		{
+			error += best_error;
+		}
+	}
+	return error;
+}
+
+/*
+	Rounds a master color to 565, clamping it first.
+*/
+static int
+	DXT_float_to_565
+	(
+		const float color[3]
+	)
+{
+	int c[3], i;
+	for( i = 0; i < 3; ++i )
+	{
+		c[i] = (int)(color[i] + 0.5f);
+		if( c[i] < 0 )
+		{
+			c[i] = 0;
+		} else if( c[i] > 255 )
+		{
+			c[i] = 255;
+		}
+	}
+	return rgb_to_565( c[0], c[1], c[2] );
+}
+
+/*
+	Tries the master colors c0 and c1 on the block, keeping them
+	if they beat best_error.  c0 must end up greater than c1 or
+	DXT1 would switch to its 3 color mode.
+*/
+static void
+	DXT_try_master_colors
+	(
+		const unsigned char *const uncompressed,
+		unsigned int mask,
+		int c0, int c1,
+		int *best_error, int best_colors[2], int best_indices[16]
+	)
+{
+	int palette[4][3];
+	int indices[16];
+	int error, i;
+	if( c0 < c1 )
+	{
+		i = c0;
+		c0 = c1;
+		c1 = i;
+	}
+	DXT_color_palette( c0, c1, palette );
+	/*	with c0 == c1 every entry is c0 and all the indices are 0,
+		which also means c0 in the 3 color mode	*/
+	error = DXT_color_indices( uncompressed, mask, palette, indices );
+	if( error < *best_error )
+	{
+		*best_error = error;
+		best_colors[0] = c0;
+		best_colors[1] = c1;
+		for( i = 0; i < 16; ++i )
+		{
+			best_indices[i] = indices[i];
+		}
+	}
+}
+
+/*
+	Least squares master colors for pixels that sit at fraction
+	weight[index] of the way from c1 to c0, for the pixels in mask.
+	\return 0 if the pixels do not pin down 2 colors
+*/
+static int
+	DXT_fit_master_colors
+	(
+		const unsigned char *const uncompressed,
+		unsigned int mask,
+		const int indices[16],
+		int *c0, int *c1
+	)
+{
+	static const float weight[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+	float alpha2 = 0.0f, beta2 = 0.0f, alphabeta = 0.0f;
+	float alpha_x[3] = { 0.0f, 0.0f, 0.0f }, beta_x[3] = { 0.0f, 0.0f, 0.0f };
+	float a[3], b[3], det;
+	int i, k;
+	for( i = 0; i < 16; ++i )
+	{
+		const float w = weight[indices[i]];
+		if( !(mask & (1u << i)) )
+		{
+			continue;
+		}
+		alpha2 += w * w;
+		beta2 += (1.0f - w) * (1.0f - w);
+		alphabeta += w * (1.0f - w);
+		for( k = 0; k < 3; ++k )
+		{
+			alpha_x[k] += w * uncompressed[i*4+k];
+			beta_x[k] += (1.0f - w) * uncompressed[i*4+k];
+		}
+	}
+	det = alpha2 * beta2 - alphabeta * alphabeta;
+	if( fabs( det ) < 1e-4f )
+	{
+		return 0;
+	}
+	det = 1.0f / det;
+	for( k = 0; k < 3; ++k )
+	{
+		a[k] = (alpha_x[k] * beta2 - beta_x[k] * alphabeta) * det;
+		b[k] = (beta_x[k] * alpha2 - alpha_x[k] * alphabeta) * det;
+	}
+	*c0 = DXT_float_to_565( a );
+	*c1 = DXT_float_to_565( b );
+	return 1;
+}
+
+/*
+	Like compress_DDS_color_block (RGBA input), but slow and pretty:
+	the pixels are sorted along the principal axis and every split
+	of that order into the 4 palette entries gets its least squares
+	master colors.  The best split, a refit of it with the final
+	indices and the range fit of compress_DDS_color_block are then
+	compared on the decoded palette, so the result is never worse
+	than the fast encoder's.  Only the pixels in mask are fitted,
+	the others are the padding of edge blocks.
+*/
+static void
+	compress_DDS_color_block_cluster_fit
+	(
+		const unsigned char *const uncompressed,
+		unsigned int mask,
+		unsigned char compressed[8]
+	)
+{
+	int order[16];
+	float dots[16];
+	/*	prefix sums of the sorted pixels	*/
+	float sums[17][3];
+	float point[3], direction[3];
+	float best_a[3] = { 0.0f, 0.0f, 0.0f }, best_b[3] = { 0.0f, 0.0f, 0.0f };
+	float best_fit = 1e30f;
+	int best_error = 0x7FFFFFFF;
+	int best_colors[2] = { 0, 0 };
+	int best_indices[16];
+	int i, j, k, c, c0, c1, n = 0;
+	/*	the range fit, what the fast encoder does	*/
+	LSE_master_colors_max_min( &c0, &c1, 4, uncompressed );
+	DXT_try_master_colors( uncompressed, mask, c0, c1, &best_error, best_colors, best_indices );
+	/*	sort the pixels along the color line	*/
+	compute_color_line_STDEV( uncompressed, 4, point, direction );
+	for( i = 0; i < 16; ++i )
+	{
+		float dot =
+			direction[0] * uncompressed[i*4+0] +
+			direction[1] * uncompressed[i*4+1] +
+			direction[2] * uncompressed[i*4+2];
+		if( !(mask & (1u << i)) )
+		{
+			continue;
+		}
+		for( j = n; (j > 0) && (dots[j-1] < dot); --j )
+		{
+			dots[j] = dots[j-1];
+			order[j] = order[j-1];
+		}
+		dots[j] = dot;
+		order[j] = i;
+		++n;
+	}
+	sums[0][0] = sums[0][1] = sums[0][2] = 0.0f;
+	for( i = 0; i < n; ++i )
+	{
+		for( c = 0; c < 3; ++c )
+		{
+			sums[i+1][c] = sums[i][c] + uncompressed[order[i]*4+c];
+		}
+	}
+	/*	the first i sorted pixels get c0, up to j get 2/3 c0 + 1/3 c1,
+		up to k get 1/3 c0 + 2/3 c1 and the rest c1	*/
+	for( i = 0; i <= n; ++i )
+	{
+		for( j = i; j <= n; ++j )
+		{
+			for( k = j; k <= n; ++k )
+			{
+				const float n2 = (float)(j - i), n3 = (float)(k - j);
+				const float alpha2 = i + (4.0f * n2 + n3) * (1.0f / 9.0f);
+				const float beta2 = (n - k) + (n2 + 4.0f * n3) * (1.0f / 9.0f);
+				const float alphabeta = (n2 + n3) * (2.0f / 9.0f);
+				float det = alpha2 * beta2 - alphabeta * alphabeta;
+				float a[3], b[3], fit = 0.0f;
+				if( det < 1e-4f )
+				{
+					continue;
+				}
+				det = 1.0f / det;
+				for( c = 0; c < 3; ++c )
+				{
+					const float alpha_x = sums[i][c] +
+						(2.0f * (sums[j][c] - sums[i][c]) + (sums[k][c] - sums[j][c])) * (1.0f / 3.0f);
+					const float beta_x = sums[n][c] - alpha_x;
+					a[c] = (alpha_x * beta2 - beta_x * alphabeta) * det;
+					b[c] = (beta_x * alpha2 - alpha_x * alphabeta) * det;
+					/*	the squared error, less the constant sum of x^2	*/
+					fit += a[c] * a[c] * alpha2 + b[c] * b[c] * beta2 +
+						2.0f * (a[c] * b[c] * alphabeta - a[c] * alpha_x - b[c] * beta_x);
+				}
+				if( fit < best_fit )
+				{
+					best_fit = fit;
+					for( c = 0; c < 3; ++c )
+					{
+						best_a[c] = a[c];
+						best_b[c] = b[c];
+					}
+				}
+			}
+		}
+	}
+	if( best_fit < 1e30f )
+	{
+		DXT_try_master_colors( uncompressed, mask,
+			DXT_float_to_565( best_a ), DXT_float_to_565( best_b ),
+			&best_error, best_colors, best_indices );
+	}
+	/*	refit the winner to the indices the 565 colors really got	*/
+	if( DXT_fit_master_colors( uncompressed, mask, best_indices, &c0, &c1 ) )
+	{
+		DXT_try_master_colors( uncompressed, mask, c0, c1, &best_error, best_colors, best_indices );
+	}
+	compressed[0] = (best_colors[0] >> 0) & 255;
+	compressed[1] = (best_colors[0] >> 8) & 255;
+	compressed[2] = (best_colors[1] >> 0) & 255;
+	compressed[3] = (best_colors[1] >> 8) & 255;
+	compressed[4] = 0;
+	compressed[5] = 0;
+	compressed[6] = 0;
+	compressed[7] = 0;
+	for( i = 0; i < 16; ++i )
+	{
+		compressed[4 + (i >> 2)] |= best_indices[i] << ((i & 3) * 2);
+	}
+}
+
+/*
+	The 8 alpha values of a DXT5 block, decoded like
+	stbi_decode_DXT45_alpha_block does.
+*/
+static void
+	DXT_alpha_palette
+	(
+		int a0, int a1,
+		int palette[8]
+	)
+{
+	int i;
+	palette[0] = a0;
+	palette[1] = a1;
+	if( a0 > a1 )
+	{
+		for( i = 1; i < 7; ++i )
+		{
+			palette[1+i] = ((7-i)*a0 + i*a1) / 7;
+		}
+	} else
+	{
+		for( i = 1; i < 5; ++i )
+		{
+			palette[1+i] = ((5-i)*a0 + i*a1) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+/*
+	Picks the nearest alpha of the palette for each pixel and packs
+	the 3 bit indices, returns the summed squared error of the pixels
+	in mask.
+*/
+static int
+	DXT_alpha_indices
+	(
+		const unsigned char *const uncompressed,
+		unsigned int mask,
+		int a0, int a1,
+		unsigned char compressed[8]
+	)
+{
+	int palette[8];
+	int i, k, error = 0;
+	DXT_alpha_palette( a0, a1, palette );
+	compressed[0] = a0;
+	compressed[1] = a1;
+	for( i = 2; i < 8; ++i )
+	{
+		compressed[i] = 0;
+	}
+	for( i = 0; i < 16; ++i )
+	{
+		int best = 0, best_error = 256*256;
+		int bit = 16 + i*3;
+		for( k = 0; k < 8; ++k )
+		{
+			int e = (uncompressed[i*4+3] - palette[k]) * (uncompressed[i*4+3] - palette[k]);
+			if( e < best_error )
+			{
+				best_error = e;
+				best = k;
+			}
+		}
+		compressed[bit >> 3] |= best << (bit & 7);
+		if( (bit & 7) > 5 )
+		{
+			compressed[1 + (bit >> 3)] |= best >> (8 - (bit & 7));
+		}
+		if( mask & (1u << i) )
+		{
+			error += best_error;
+		}
+	}
+	return error;
+}
+
+/*
+	Like compress_DDS_alpha_block, but with the nearest index for
+	each pixel instead of a truncated one, and the 6 step mode
+	(which has exact 0 and 255) is tried for blocks that use them.
+	Only the pixels in mask count.
+*/
+static void
+	compress_DDS_alpha_block_cluster_fit
+	(
+		const unsigned char *const uncompressed,
+		unsigned int mask,
+		unsigned char compressed[8]
+	)
+{
+	unsigned char candidate[8];
+	int a_max = 0, a_min = 255;
+	int inner_max = 0, inner_min = 255;
+	int i, error;
+	for( i = 0; i < 16; ++i )
+	{
+		const int a = uncompressed[i*4+3];
+		if( !(mask & (1u << i)) )
+		{
+			continue;
+		}
+		if( a > a_max )
+		{
+			a_max = a;
+		}
+		if( a < a_min )
+		{
+			a_min = a;
+		}
+		if( (a > 0) && (a < 255) )
+		{
+			if( a > inner_max )
+			{
+				inner_max = a;
+			}
+			if( a < inner_min )
+			{
+				inner_min = a;
+			}
+		}
+	}
+	error = DXT_alpha_indices( uncompressed, mask, a_max, a_min, compressed );
+	if( (error > 0) && ((a_min == 0) || (a_max == 255)) )
+	{
+		if( inner_min > inner_max )
+		{
+			/*	only 0 and 255	*/
+			inner_min = inner_max = 0;
+		}
+		if( DXT_alpha_indices( uncompressed, mask, inner_min, inner_max, candidate ) < error )
+		{
+			memcpy( compressed, candidate, 8 );
+		}
+	}
+}
+
+/********* Block Row Encoder *********/
+/*
+	Copies the 4x4 block at pixel (i,j) as RGBA, the missing
+	pixels of edge blocks repeat the first one, and alpha is
+	255 for images without it.
+*/
+static void
+	DXT_gather_block
+	(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int i, int j,
+		unsigned char ublock[16*4]
+	)
+{
+	int x, y;
+	int idx = 0;
+	int mx = 4, my = 4;
+	/*	for channels == 1 or 2, I do not step forward for R,G,B values	*/
+	const int chan_step = channels < 3 ? 0 : 1;
+	/*	# channels = 1 or 3 have no alpha, 2 & 4 do have alpha	*/
+	const int has_alpha = 1 - (channels & 1);
+	if( j+4 >= height )
+	{
+		my = height - j;
+	}
+	if( i+4 >= width )
+	{
+		mx = width - i;
+	}
+	for( y = 0; y < my; ++y )
+	{
+		const unsigned char *row = uncompressed + ((j+y)*width + i)*channels;
+		for( x = 0; x < mx; ++x )
+		{
+			ublock[idx++] = row[x*channels];
+			ublock[idx++] = row[x*channels+chan_step];
+			ublock[idx++] = row[x*channels+chan_step+chan_step];
+			ublock[idx++] = has_alpha ? row[x*channels+channels-1] : 255;
+		}
+		for( x = mx; x < 4; ++x )
+		{
+			ublock[idx++] = ublock[0];
+			ublock[idx++] = ublock[1];
+			ublock[idx++] = ublock[2];
+			ublock[idx++] = ublock[3];
+		}
+	}
+	for( y = my; y < 4; ++y )
+	{
+		for( x = 0; x < 4; ++x )
+		{
+			ublock[idx++] = ublock[0];
+			ublock[idx++] = ublock[1];
+			ublock[idx++] = ublock[2];
+			ublock[idx++] = ublock[3];
+		}
+	}
+}
+
+/*
+	Copies one channel of the 4x4 block at pixel (i,j) to the alpha
+	of ublock, for the BC4 and BC5 encoders.  A channel the image
+	doesn't have repeats its last one.
+*/
+static void
+	DXT_gather_channel
+	(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int i, int j, int channel,
+		unsigned char ublock[16*4]
+	)
+{
+	int x, y;
+	if( channel >= channels )
+	{
+		channel = channels - 1;
+	}
+	for( y = 0; y < 4; ++y )
+	{
+		for( x = 0; x < 4; ++x )
+		{
+			/*	the missing pixels of edge blocks repeat the first one	*/
+			const int inside = (i+x < width) && (j+y < height);
+			ublock[(y*4+x)*4+3] = uncompressed[
+				(inside ? (j+y)*width + i+x : j*width + i) * channels + channel];
+		}
+	}
+}
+
+/*	the pixels of the block at pixel (i,j) that are inside the image	*/
+static unsigned int
+	DXT_block_mask
+	(
+		int width, int height,
+		int i, int j
+	)
+{
+	const int mx = (width - i < 4) ? width - i : 4;
+	const int my = (height - j < 4) ? height - j : 4;
+	unsigned int mask = 0;
+	int p;
+	for( p = 0; p < 16; ++p )
+	{
+		if( ((p & 3) < mx) && ((p >> 2) < my) )
+		{
+			mask |= 1u << p;
+		}
+	}
+	return mask;
+}
+
+static void
+	DXT_encode_rows
+	(
+		void *argument
+	)
+{
+	const DXT_encode_job *job = (const DXT_encode_job*)argument;
+	const int blocks_x = (job->width + 3) >> 2;
+	const DXT_kernels *kernels = (job->options & (DXT_COMPRESS_DETERMINISTIC | DXT_COMPRESS_CLUSTER_FIT)) ?
+		NULL : DXT_pick_kernels();
+	unsigned char ublock[16*4];
+	DXT_batch batch;
+	int row, bx, b, c, p;
+	for( row = job->first_row; row < job->last_row; ++row )
+	{
+		unsigned char *out = job->compressed + (size_t)row * blocks_x * job->block_size;
+		if( (job->format == DXT_FORMAT_BC4) || (job->format == DXT_FORMAT_BC5) )
+		{
+			/*	each channel is coded like DXT5 alpha	*/
+			for( bx = 0; bx < blocks_x; ++bx )
+			{
+				const unsigned int mask = DXT_block_mask( job->width, job->height, bx*4, row*4 );
+				for( c = 0; c < job->block_size / 8; ++c )
+				{
+					DXT_gather_channel( job->uncompressed, job->width, job->height, job->channels,
+						bx*4, row*4, c, ublock );
+					if( job->options & DXT_COMPRESS_CLUSTER_FIT )
+					{
+						compress_DDS_alpha_block_cluster_fit( ublock, mask, out );
+					} else
+					{
+						compress_DDS_alpha_block( ublock, out );
+					}
+					out += 8;
+				}
+			}
+			continue;
+		}
+		if( job->options & DXT_COMPRESS_CLUSTER_FIT )
+		{
+			for( bx = 0; bx < blocks_x; ++bx )
+			{
+				const unsigned int mask = DXT_block_mask( job->width, job->height, bx*4, row*4 );
+				DXT_gather_block( job->uncompressed, job->width, job->height, job->channels,
+					bx*4, row*4, ublock );
+				if( job->block_size == 16 )
+				{
+					compress_DDS_alpha_block_cluster_fit( ublock, mask, out );
+					out += 8;
+				}
+				compress_DDS_color_block_cluster_fit( ublock, mask, out );
+				out += 8;
+			}
+			continue;
+		}
+		if( NULL == kernels )
+		{
+			/*	one block at a time, the reference encoder	*/
+			for( bx = 0; bx < blocks_x; ++bx )
+			{
+				DXT_gather_block( job->uncompressed, job->width, job->height, job->channels,
+					bx*4, row*4, ublock );
+				if( job->block_size == 16 )
+				{
+					compress_DDS_alpha_block( ublock, out );
+					out += 8;
+				}
+				compress_DDS_color_block( 4, ublock, out );
+				out += 8;
+			}
+			continue;
+		}
+		for( bx = 0; bx < blocks_x; bx += DXT_BATCH_BLOCKS )
+		{
+			int count = blocks_x - bx;
+			if( count > DXT_BATCH_BLOCKS )
+			{
+				count = DXT_BATCH_BLOCKS;
+			}
+			/*	transpose the blocks, a short batch repeats its last block	*/
+			for( b = 0; b < DXT_BATCH_BLOCKS; ++b )
+			{
+				if( b < count )
+				{
+					DXT_gather_block( job->uncompressed, job->width, job->height, job->channels,
+						(bx+b)*4, row*4, ublock );
+				}
+				for( p = 0; p < 16; ++p )
+				{
+					for( c = 0; c < 4; ++c )
+					{
+						batch.pixels[c][p][b] = (float)ublock[p*4+c];
+					}
+				}
+			}
+			kernels->color_endpoints( &batch );
+			DXT_color_lines( &batch );
+			kernels->color_indices( &batch );
+			if( job->block_size == 16 )
+			{
+				kernels->alpha( &batch );
+			}
+			for( b = 0; b < count; ++b )
+			{
+				if( job->block_size == 16 )
+				{
+					out[0] = (unsigned char)batch.alpha_max[b];
+					out[1] = (unsigned char)batch.alpha_min[b];
+					out[2] = (unsigned char)(batch.alpha_bits[0][b] >> 0);
+					out[3] = (unsigned char)(batch.alpha_bits[0][b] >> 8);
+					out[4] = (unsigned char)(batch.alpha_bits[0][b] >> 16);
+					out[5] = (unsigned char)(batch.alpha_bits[1][b] >> 0);
+					out[6] = (unsigned char)(batch.alpha_bits[1][b] >> 8);
+					out[7] = (unsigned char)(batch.alpha_bits[1][b] >> 16);
+					out += 8;
+				}
+				out[0] = (unsigned char)(batch.enc_c0[b] >> 0);
+				out[1] = (unsigned char)(batch.enc_c0[b] >> 8);
+				out[2] = (unsigned char)(batch.enc_c1[b] >> 0);
+				out[3] = (unsigned char)(batch.enc_c1[b] >> 8);
+				out[4] = (unsigned char)(batch.color_bits[b] >> 0);
+				out[5] = (unsigned char)(batch.color_bits[b] >> 8);
+				out[6] = (unsigned char)(batch.color_bits[b] >> 16);
+				out[7] = (unsigned char)(batch.color_bits[b] >> 24);
+				out += 8;
+			}
+		}
+	}
+}
+
+/*
+	The scalar step between the vector ones, per block: clamp and
+	quantize the master colors to 565, then set up the line the
+	pixels are projected on, like compress_DDS_color_block.
+*/
+static void
+	DXT_color_lines
+	(
+		DXT_batch *batch
+	)
+{
+	int b, i;
+	for( b = 0; b < DXT_BATCH_BLOCKS; ++b )
+	{
+		int c0[3], c1[3];
+		float vec_len2 = 0.0f;
+		for( i = 0; i < 3; ++i )
+		{
+			c0[i] = batch->c0[i][b] < 0 ? 0 : (batch->c0[i][b] > 255 ? 255 : batch->c0[i][b]);
+			c1[i] = batch->c1[i][b] < 0 ? 0 : (batch->c1[i][b] > 255 ? 255 : batch->c1[i][b]);
+		}
+		/*	the larger 565 value is color 0	*/
+		batch->enc_c0[b] = rgb_to_565( c0[0], c0[1], c0[2] );
+		batch->enc_c1[b] = rgb_to_565( c1[0], c1[1], c1[2] );
+		if( batch->enc_c0[b] < batch->enc_c1[b] )
+		{
+			int swap = batch->enc_c0[b];
+			batch->enc_c0[b] = batch->enc_c1[b];
+			batch->enc_c1[b] = swap;
+		}
+		rgb_888_from_565( batch->enc_c0[b], &c0[0], &c0[1], &c0[2] );
+		rgb_888_from_565( batch->enc_c1[b], &c1[0], &c1[1], &c1[2] );
+		for( i = 0; i < 3; ++i )
+		{
+			batch->line[i][b] = (float)(c1[i] - c0[i]);
+			vec_len2 += batch->line[i][b] * batch->line[i][b];
+		}
+		if( vec_len2 > 0.0f )
+		{
+			vec_len2 = 1.0f / vec_len2;
+		}
+		for( i = 0; i < 3; ++i )
+		{
+			batch->line[i][b] *= vec_len2;
+		}
+		batch->offset[b] = batch->line[0][b]*c0[0] + batch->line[1][b]*c0[1] + batch->line[2][b]*c0[2];
+	}
+}
+
+#if defined( SOIL_SIMD_SSE2 )
+/*
+	The vector stages follow the scalar encoder operation for operation,
+	each lane is one block.  The sums are of 8 bit values and their
+	products, exact in floats whatever the order.
+*/
+static void
+	DXT_color_endpoints_SSE2
+	(
+		DXT_batch *batch
+	)
+{
+	int lane, p, i;
+	for( lane = 0; lane < DXT_BATCH_BLOCKS; lane += 4 )
+	{
+		const __m128 sixteen = _mm_set1_ps( 16.0f );
+		__m128 s[3], ss[3], srg, srb, sgb;
+		__m128 d[3], v[3], vec_len2, dot;
+		__m128 dot_min = _mm_setzero_ps(), dot_max = _mm_setzero_ps();
+		for( i = 0; i < 3; ++i )
+		{
+			s[i] = ss[i] = _mm_setzero_ps();
+		}
+		srg = srb = sgb = _mm_setzero_ps();
+		for( p = 0; p < 16; ++p )
+		{
+			const __m128 r = _mm_loadu_ps( &batch->pixels[0][p][lane] );
+			const __m128 g = _mm_loadu_ps( &batch->pixels[1][p][lane] );
+			const __m128 b = _mm_loadu_ps( &batch->pixels[2][p][lane] );
+			s[0] = _mm_add_ps( s[0], r );
+			s[1] = _mm_add_ps( s[1], g );
+			s[2] = _mm_add_ps( s[2], b );
+			ss[0] = _mm_add_ps( ss[0], _mm_mul_ps( r, r ) );
+			ss[1] = _mm_add_ps( ss[1], _mm_mul_ps( g, g ) );
+			ss[2] = _mm_add_ps( ss[2], _mm_mul_ps( b, b ) );
+			srg = _mm_add_ps( srg, _mm_mul_ps( r, g ) );
+			srb = _mm_add_ps( srb, _mm_mul_ps( r, b ) );
+			sgb = _mm_add_ps( sgb, _mm_mul_ps( g, b ) );
+		}
+		/*	averages, and the covariance matrix	*/
+		for( i = 0; i < 3; ++i )
+		{
+			s[i] = _mm_mul_ps( s[i], _mm_set1_ps( 1.0f / 16.0f ) );
+			ss[i] = _mm_sub_ps( ss[i], _mm_mul_ps( _mm_mul_ps( sixteen, s[i] ), s[i] ) );
+		}
+		srg = _mm_sub_ps( srg, _mm_mul_ps( _mm_mul_ps( sixteen, s[0] ), s[1] ) );
+		srb = _mm_sub_ps( srb, _mm_mul_ps( _mm_mul_ps( sixteen, s[0] ), s[2] ) );
+		sgb = _mm_sub_ps( sgb, _mm_mul_ps( _mm_mul_ps( sixteen, s[1] ), s[2] ) );
+		/*	3 steps of the power method	*/
+		v[0] = _mm_set1_ps( 1.0f );
+		v[1] = _mm_set1_ps( 2.718281828f );
+		v[2] = _mm_set1_ps( 3.141592654f );
+		for( i = 0; i < 3; ++i )
+		{
+			d[0] = _mm_add_ps( _mm_add_ps( _mm_mul_ps( v[0], ss[0] ), _mm_mul_ps( v[1], srg ) ), _mm_mul_ps( v[2], srb ) );
+			d[1] = _mm_add_ps( _mm_add_ps( _mm_mul_ps( v[0], srg ), _mm_mul_ps( v[1], ss[1] ) ), _mm_mul_ps( v[2], sgb ) );
+			d[2] = _mm_add_ps( _mm_add_ps( _mm_mul_ps( v[0], srb ), _mm_mul_ps( v[1], sgb ) ), _mm_mul_ps( v[2], ss[2] ) );
+			v[0] = d[0];
+			v[1] = d[1];
+			v[2] = d[2];
+		}
+		vec_len2 = _mm_div_ps( _mm_set1_ps( 1.0f ), _mm_add_ps( _mm_add_ps( _mm_add_ps(
+			_mm_set1_ps( 0.00001f ), _mm_mul_ps( d[0], d[0] ) ), _mm_mul_ps( d[1], d[1] ) ), _mm_mul_ps( d[2], d[2] ) ) );
+		/*	the extents along the line	*/
+		for( p = 0; p < 16; ++p )
+		{
+			dot = _mm_add_ps( _mm_add_ps(
+				_mm_mul_ps( d[0], _mm_loadu_ps( &batch->pixels[0][p][lane] ) ),
+				_mm_mul_ps( d[1], _mm_loadu_ps( &batch->pixels[1][p][lane] ) ) ),
+				_mm_mul_ps( d[2], _mm_loadu_ps( &batch->pixels[2][p][lane] ) ) );
+			dot_min = p ? _mm_min_ps( dot_min, dot ) : dot;
+			dot_max = p ? _mm_max_ps( dot_max, dot ) : dot;
+		}
+		dot = _mm_add_ps( _mm_add_ps( _mm_mul_ps( d[0], s[0] ), _mm_mul_ps( d[1], s[1] ) ), _mm_mul_ps( d[2], s[2] ) );
+		dot_min = _mm_mul_ps( _mm_sub_ps( dot_min, dot ), vec_len2 );
+		dot_max = _mm_mul_ps( _mm_sub_ps( dot_max, dot ), vec_len2 );
+		for( i = 0; i < 3; ++i )
+		{
+			const __m128 base = _mm_add_ps( _mm_set1_ps( 0.5f ), s[i] );
+			_mm_storeu_si128( (__m128i*)&batch->c0[i][lane], _mm_cvttps_epi32( _mm_add_ps( base, _mm_mul_ps( dot_max, d[i] ) ) ) );
+			_mm_storeu_si128( (__m128i*)&batch->c1[i][lane], _mm_cvttps_epi32( _mm_add_ps( base, _mm_mul_ps( dot_min, d[i] ) ) ) );
+		}
+	}
+}
+
+static void
+	DXT_color_indices_SSE2
+	(
+		DXT_batch *batch
+	)
+{
+	int lane, p;
+	for( lane = 0; lane < DXT_BATCH_BLOCKS; lane += 4 )
+	{
+		const __m128 l0 = _mm_loadu_ps( &batch->line[0][lane] );
+		const __m128 l1 = _mm_loadu_ps( &batch->line[1][lane] );
+		const __m128 l2 = _mm_loadu_ps( &batch->line[2][lane] );
+		const __m128 offset = _mm_loadu_ps( &batch->offset[lane] );
+		__m128i bits = _mm_setzero_si128();
+		for( p = 0; p < 16; ++p )
+		{
+			const __m128 dot = _mm_sub_ps( _mm_add_ps( _mm_add_ps(
+				_mm_mul_ps( l0, _mm_loadu_ps( &batch->pixels[0][p][lane] ) ),
+				_mm_mul_ps( l1, _mm_loadu_ps( &batch->pixels[1][p][lane] ) ) ),
+				_mm_mul_ps( l2, _mm_loadu_ps( &batch->pixels[2][p][lane] ) ) ), offset );
+			/*	map to [0,3], then the DXT order 0, 2, 3, 1	*/
+			const __m128i value = _mm_cvttps_epi32( _mm_min_ps( _mm_max_ps(
+				_mm_add_ps( _mm_mul_ps( dot, _mm_set1_ps( 3.0f ) ), _mm_set1_ps( 0.5f ) ),
+				_mm_setzero_ps() ), _mm_set1_ps( 3.0f ) ) );
+			const __m128i high = _mm_srli_epi32( value, 1 );
+			const __m128i code = _mm_or_si128( high,
+				_mm_slli_epi32( _mm_and_si128( _mm_xor_si128( value, high ), _mm_set1_epi32( 1 ) ), 1 ) );
+			bits = _mm_or_si128( bits, _mm_sll_epi32( code, _mm_cvtsi32_si128( 2*p ) ) );
+		}
+		_mm_storeu_si128( (__m128i*)&batch->color_bits[lane], bits );
+	}
+}
+
+static void
+	DXT_alpha_SSE2
+	(
+		DXT_batch *batch
+	)
+{
+	int lane, p;
+	for( lane = 0; lane < DXT_BATCH_BLOCKS; lane += 4 )
+	{
+		__m128 a_max = _mm_loadu_ps( &batch->pixels[3][0][lane] );
+		__m128 a_min = a_max;
+		__m128 scale;
+		__m128i bits[2];
+		for( p = 1; p < 16; ++p )
+		{
+			const __m128 a = _mm_loadu_ps( &batch->pixels[3][p][lane] );
+			a_max = _mm_max_ps( a_max, a );
+			a_min = _mm_min_ps( a_min, a );
+		}
+		/*	a flat block divides by 0 like the scalar one, every value lands on index 0	*/
+		scale = _mm_div_ps( _mm_set1_ps( 7.9999f ), _mm_sub_ps( a_max, a_min ) );
+		bits[0] = bits[1] = _mm_setzero_si128();
+		for( p = 0; p < 16; ++p )
+		{
+			const __m128i value = _mm_and_si128( _mm_cvttps_epi32( _mm_mul_ps(
+				_mm_sub_ps( _mm_loadu_ps( &batch->pixels[3][p][lane] ), a_min ), scale ) ), _mm_set1_epi32( 7 ) );
+			/*	the DXT order 1, 7, 6, 5, 4, 3, 2, 0 is 8 - value with 0 and 1 swapped	*/
+			__m128i code = _mm_and_si128( _mm_sub_epi32( _mm_set1_epi32( 8 ), value ), _mm_set1_epi32( 7 ) );
+			code = _mm_xor_si128( code, _mm_and_si128( _mm_cmplt_epi32( code, _mm_set1_epi32( 2 ) ), _mm_set1_epi32( 1 ) ) );
+			bits[p >> 3] = _mm_or_si128( bits[p >> 3], _mm_sll_epi32( code, _mm_cvtsi32_si128( 3*(p & 7) ) ) );
+		}
+		_mm_storeu_si128( (__m128i*)&batch->alpha_max[lane], _mm_cvttps_epi32( a_max ) );
+		_mm_storeu_si128( (__m128i*)&batch->alpha_min[lane], _mm_cvttps_epi32( a_min ) );
+		_mm_storeu_si128( (__m128i*)&batch->alpha_bits[0][lane], bits[0] );
+		_mm_storeu_si128( (__m128i*)&batch->alpha_bits[1][lane], bits[1] );
+	}
+}
+#endif
+
+#if defined( SOIL_SIMD_AVX2 )
+/*	the SSE2 stages on 8 blocks at once	*/
+static SOIL_SIMD_TARGET_AVX2 void
+	DXT_color_endpoints_AVX2
+	(
+		DXT_batch *batch
+	)
+{
+	const __m256 sixteen = _mm256_set1_ps( 16.0f );
+	__m256 s[3], ss[3], srg, srb, sgb;
+	__m256 d[3], v[3], vec_len2, dot;
+	__m256 dot_min = _mm256_setzero_ps(), dot_max = _mm256_setzero_ps();
+	int p, i;
+	for( i = 0; i < 3; ++i )
+	{
+		s[i] = ss[i] = _mm256_setzero_ps();
+	}
+	srg = srb = sgb = _mm256_setzero_ps();
+	for( p = 0; p < 16; ++p )
+	{
+		const __m256 r = _mm256_loadu_ps( batch->pixels[0][p] );
+		const __m256 g = _mm256_loadu_ps( batch->pixels[1][p] );
+		const __m256 b = _mm256_loadu_ps( batch->pixels[2][p] );
+		s[0] = _mm256_add_ps( s[0], r );
+		s[1] = _mm256_add_ps( s[1], g );
+		s[2] = _mm256_add_ps( s[2], b );
+		ss[0] = _mm256_add_ps( ss[0], _mm256_mul_ps( r, r ) );
+		ss[1] = _mm256_add_ps( ss[1], _mm256_mul_ps( g, g ) );
+		ss[2] = _mm256_add_ps( ss[2], _mm256_mul_ps( b, b ) );
+		srg = _mm256_add_ps( srg, _mm256_mul_ps( r, g ) );
+		srb = _mm256_add_ps( srb, _mm256_mul_ps( r, b ) );
+		sgb = _mm256_add_ps( sgb, _mm256_mul_ps( g, b ) );
+	}
+	for( i = 0; i < 3; ++i )
+	{
+		s[i] = _mm256_mul_ps( s[i], _mm256_set1_ps( 1.0f / 16.0f ) );
+		ss[i] = _mm256_sub_ps( ss[i], _mm256_mul_ps( _mm256_mul_ps( sixteen, s[i] ), s[i] ) );
+	}
+	srg = _mm256_sub_ps( srg, _mm256_mul_ps( _mm256_mul_ps( sixteen, s[0] ), s[1] ) );
+	srb = _mm256_sub_ps( srb, _mm256_mul_ps( _mm256_mul_ps( sixteen, s[0] ), s[2] ) );
+	sgb = _mm256_sub_ps( sgb, _mm256_mul_ps( _mm256_mul_ps( sixteen, s[1] ), s[2] ) );
+	v[0] = _mm256_set1_ps( 1.0f );
+	v[1] = _mm256_set1_ps( 2.718281828f );
+	v[2] = _mm256_set1_ps( 3.141592654f );
+	for( i = 0; i < 3; ++i )
+	{
+		d[0] = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( v[0], ss[0] ), _mm256_mul_ps( v[1], srg ) ), _mm256_mul_ps( v[2], srb ) );
+		d[1] = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( v[0], srg ), _mm256_mul_ps( v[1], ss[1] ) ), _mm256_mul_ps( v[2], sgb ) );
+		d[2] = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( v[0], srb ), _mm256_mul_ps( v[1], sgb ) ), _mm256_mul_ps( v[2], ss[2] ) );
+		v[0] = d[0];
+		v[1] = d[1];
+		v[2] = d[2];
+	}
+	vec_len2 = _mm256_div_ps( _mm256_set1_ps( 1.0f ), _mm256_add_ps( _mm256_add_ps( _mm256_add_ps(
+		_mm256_set1_ps( 0.00001f ), _mm256_mul_ps( d[0], d[0] ) ), _mm256_mul_ps( d[1], d[1] ) ), _mm256_mul_ps( d[2], d[2] ) ) );
+	for( p = 0; p < 16; ++p )
+	{
+		dot = _mm256_add_ps( _mm256_add_ps(
+			_mm256_mul_ps( d[0], _mm256_loadu_ps( batch->pixels[0][p] ) ),
+			_mm256_mul_ps( d[1], _mm256_loadu_ps( batch->pixels[1][p] ) ) ),
+			_mm256_mul_ps( d[2], _mm256_loadu_ps( batch->pixels[2][p] ) ) );
+		dot_min = p ? _mm256_min_ps( dot_min, dot ) : dot;
+		dot_max = p ? _mm256_max_ps( dot_max, dot ) : dot;
+	}
+	dot = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( d[0], s[0] ), _mm256_mul_ps( d[1], s[1] ) ), _mm256_mul_ps( d[2], s[2] ) );
+	dot_min = _mm256_mul_ps( _mm256_sub_ps( dot_min, dot ), vec_len2 );
+	dot_max = _mm256_mul_ps( _mm256_sub_ps( dot_max, dot ), vec_len2 );
+	for( i = 0; i < 3; ++i )
+	{
+		const __m256 base = _mm256_add_ps( _mm256_set1_ps( 0.5f ), s[i] );
+		_mm256_storeu_si256( (__m256i*)batch->c0[i], _mm256_cvttps_epi32( _mm256_add_ps( base, _mm256_mul_ps( dot_max, d[i] ) ) ) );
+		_mm256_storeu_si256( (__m256i*)batch->c1[i], _mm256_cvttps_epi32( _mm256_add_ps( base, _mm256_mul_ps( dot_min, d[i] ) ) ) );
+	}
+}
+
+static SOIL_SIMD_TARGET_AVX2 void
+	DXT_color_indices_AVX2
+	(
+		DXT_batch *batch
+	)
+{
+	const __m256 l0 = _mm256_loadu_ps( batch->line[0] );
+	const __m256 l1 = _mm256_loadu_ps( batch->line[1] );
+	const __m256 l2 = _mm256_loadu_ps( batch->line[2] );
+	const __m256 offset = _mm256_loadu_ps( batch->offset );
+	__m256i bits = _mm256_setzero_si256();
+	int p;
+	for( p = 0; p < 16; ++p )
+	{
+		const __m256 dot = _mm256_sub_ps( _mm256_add_ps( _mm256_add_ps(
+			_mm256_mul_ps( l0, _mm256_loadu_ps( batch->pixels[0][p] ) ),
+			_mm256_mul_ps( l1, _mm256_loadu_ps( batch->pixels[1][p] ) ) ),
+			_mm256_mul_ps( l2, _mm256_loadu_ps( batch->pixels[2][p] ) ) ), offset );
+		const __m256i value = _mm256_cvttps_epi32( _mm256_min_ps( _mm256_max_ps(
+			_mm256_add_ps( _mm256_mul_ps( dot, _mm256_set1_ps( 3.0f ) ), _mm256_set1_ps( 0.5f ) ),
+			_mm256_setzero_ps() ), _mm256_set1_ps( 3.0f ) ) );
+		const __m256i high = _mm256_srli_epi32( value, 1 );
+		const __m256i code = _mm256_or_si256( high,
+			_mm256_slli_epi32( _mm256_and_si256( _mm256_xor_si256( value, high ), _mm256_set1_epi32( 1 ) ), 1 ) );
+		bits = _mm256_or_si256( bits, _mm256_sll_epi32( code, _mm_cvtsi32_si128( 2*p ) ) );
+	}
+	_mm256_storeu_si256( (__m256i*)batch->color_bits, bits );
+}
+
+static SOIL_SIMD_TARGET_AVX2 void
+	DXT_alpha_AVX2
+	(
+		DXT_batch *batch
+	)
+{
+	__m256 a_max = _mm256_loadu_ps( batch->pixels[3][0] );
+	__m256 a_min = a_max;
+	__m256 scale;
+	__m256i bits[2];
+	int p;
+	for( p = 1; p < 16; ++p )
+	{
+		const __m256 a = _mm256_loadu_ps( batch->pixels[3][p] );
+		a_max = _mm256_max_ps( a_max, a );
+		a_min = _mm256_min_ps( a_min, a );
+	}
+	scale = _mm256_div_ps( _mm256_set1_ps( 7.9999f ), _mm256_sub_ps( a_max, a_min ) );
+	bits[0] = bits[1] = _mm256_setzero_si256();
+	for( p = 0; p < 16; ++p )
+	{
+		const __m256i value = _mm256_and_si256( _mm256_cvttps_epi32( _mm256_mul_ps(
+			_mm256_sub_ps( _mm256_loadu_ps( batch->pixels[3][p] ), a_min ), scale ) ), _mm256_set1_epi32( 7 ) );
+		__m256i code = _mm256_and_si256( _mm256_sub_epi32( _mm256_set1_epi32( 8 ), value ), _mm256_set1_epi32( 7 ) );
+		code = _mm256_xor_si256( code, _mm256_and_si256( _mm256_cmpgt_epi32( _mm256_set1_epi32( 2 ), code ), _mm256_set1_epi32( 1 ) ) );
+		bits[p >> 3] = _mm256_or_si256( bits[p >> 3], _mm256_sll_epi32( code, _mm_cvtsi32_si128( 3*(p & 7) ) ) );
+	}
+	_mm256_storeu_si256( (__m256i*)batch->alpha_max, _mm256_cvttps_epi32( a_max ) );
+	_mm256_storeu_si256( (__m256i*)batch->alpha_min, _mm256_cvttps_epi32( a_min ) );
+	_mm256_storeu_si256( (__m256i*)batch->alpha_bits[0], bits[0] );
+	_mm256_storeu_si256( (__m256i*)batch->alpha_bits[1], bits[1] );
+}
+#endif
+
+#if defined( SOIL_SIMD_NEON )
+/*	ARMv7 NEON has no division	*/
+static float32x4_t
+	DXT_div_NEON( float32x4_t a, float32x4_t b )
+{
+#if defined( __aarch64__ ) || defined( _M_ARM64 )
+	return vdivq_f32( a, b );
+#else
+	float x[4], y[4];
+	int i;
+	vst1q_f32( x, a );
+	vst1q_f32( y, b );
+	for( i = 0; i < 4; ++i )
+	{
+		x[i] /= y[i];
+	}
+	return vld1q_f32( x );
+#endif
+}
+
+static void
+	DXT_color_endpoints_NEON
+	(
+		DXT_batch *batch
+	)
+{
+	int lane, p, i;
+	for( lane = 0; lane < DXT_BATCH_BLOCKS; lane += 4 )
+	{
+		const float32x4_t sixteen = vdupq_n_f32( 16.0f );
+		float32x4_t s[3], ss[3], srg, srb, sgb;
+		float32x4_t d[3], v[3], vec_len2, dot;
+		float32x4_t dot_min = vdupq_n_f32( 0.0f ), dot_max = vdupq_n_f32( 0.0f );
+		for( i = 0; i < 3; ++i )
+		{
+			s[i] = ss[i] = vdupq_n_f32( 0.0f );
+		}
+		srg = srb = sgb = vdupq_n_f32( 0.0f );
+		for( p = 0; p < 16; ++p )
+		{
+			const float32x4_t r = vld1q_f32( &batch->pixels[0][p][lane] );
+			const float32x4_t g = vld1q_f32( &batch->pixels[1][p][lane] );
+			const float32x4_t b = vld1q_f32( &batch->pixels[2][p][lane] );
+			s[0] = vaddq_f32( s[0], r );
+			s[1] = vaddq_f32( s[1], g );
+			s[2] = vaddq_f32( s[2], b );
+			ss[0] = vaddq_f32( ss[0], vmulq_f32( r, r ) );
+			ss[1] = vaddq_f32( ss[1], vmulq_f32( g, g ) );
+			ss[2] = vaddq_f32( ss[2], vmulq_f32( b, b ) );
+			srg = vaddq_f32( srg, vmulq_f32( r, g ) );
+			srb = vaddq_f32( srb, vmulq_f32( r, b ) );
+			sgb = vaddq_f32( sgb, vmulq_f32( g, b ) );
+		}
+		for( i = 0; i < 3; ++i )
+		{
+			s[i] = vmulq_f32( s[i], vdupq_n_f32( 1.0f / 16.0f ) );
+			ss[i] = vsubq_f32( ss[i], vmulq_f32( vmulq_f32( sixteen, s[i] ), s[i] ) );
+		}
+		srg = vsubq_f32( srg, vmulq_f32( vmulq_f32( sixteen, s[0] ), s[1] ) );
+		srb = vsubq_f32( srb, vmulq_f32( vmulq_f32( sixteen, s[0] ), s[2] ) );
+		sgb = vsubq_f32( sgb, vmulq_f32( vmulq_f32( sixteen, s[1] ), s[2] ) );
+		v[0] = vdupq_n_f32( 1.0f );
+		v[1] = vdupq_n_f32( 2.718281828f );
+		v[2] = vdupq_n_f32( 3.141592654f );
+		for( i = 0; i < 3; ++i )
+		{
+			d[0] = vaddq_f32( vaddq_f32( vmulq_f32( v[0], ss[0] ), vmulq_f32( v[1], srg ) ), vmulq_f32( v[2], srb ) );
+			d[1] = vaddq_f32( vaddq_f32( vmulq_f32( v[0], srg ), vmulq_f32( v[1], ss[1] ) ), vmulq_f32( v[2], sgb ) );
+			d[2] = vaddq_f32( vaddq_f32( vmulq_f32( v[0], srb ), vmulq_f32( v[1], sgb ) ), vmulq_f32( v[2], ss[2] ) );
+			v[0] = d[0];
+			v[1] = d[1];
+			v[2] = d[2];
+		}
+		vec_len2 = DXT_div_NEON( vdupq_n_f32( 1.0f ), vaddq_f32( vaddq_f32( vaddq_f32(
+			vdupq_n_f32( 0.00001f ), vmulq_f32( d[0], d[0] ) ), vmulq_f32( d[1], d[1] ) ), vmulq_f32( d[2], d[2] ) ) );
+		for( p = 0; p < 16; ++p )
+		{
+			dot = vaddq_f32( vaddq_f32(
+				vmulq_f32( d[0], vld1q_f32( &batch->pixels[0][p][lane] ) ),
+				vmulq_f32( d[1], vld1q_f32( &batch->pixels[1][p][lane] ) ) ),
+				vmulq_f32( d[2], vld1q_f32( &batch->pixels[2][p][lane] ) ) );
+			dot_min = p ? vminq_f32( dot_min, dot ) : dot;
+			dot_max = p ? vmaxq_f32( dot_max, dot ) : dot;
+		}
+		dot = vaddq_f32( vaddq_f32( vmulq_f32( d[0], s[0] ), vmulq_f32( d[1], s[1] ) ), vmulq_f32( d[2], s[2] ) );
+		dot_min = vmulq_f32( vsubq_f32( dot_min, dot ), vec_len2 );
+		dot_max = vmulq_f32( vsubq_f32( dot_max, dot ), vec_len2 );
+		for( i = 0; i < 3; ++i )
+		{
+			const float32x4_t base = vaddq_f32( vdupq_n_f32( 0.5f ), s[i] );
+			vst1q_s32( &batch->c0[i][lane], vcvtq_s32_f32( vaddq_f32( base, vmulq_f32( dot_max, d[i] ) ) ) );
+			vst1q_s32( &batch->c1[i][lane], vcvtq_s32_f32( vaddq_f32( base, vmulq_f32( dot_min, d[i] ) ) ) );
+		}
+	}
+}
+
+static void
+	DXT_color_indices_NEON
+	(
+		DXT_batch *batch
+	)
+{
+	int lane, p;
+	for( lane = 0; lane < DXT_BATCH_BLOCKS; lane += 4 )
+	{
+		const float32x4_t l0 = vld1q_f32( &batch->line[0][lane] );
+		const float32x4_t l1 = vld1q_f32( &batch->line[1][lane] );
+		const float32x4_t l2 = vld1q_f32( &batch->line[2][lane] );
+		const float32x4_t offset = vld1q_f32( &batch->offset[lane] );
+		uint32x4_t bits = vdupq_n_u32( 0 );
+		for( p = 0; p < 16; ++p )
+		{
+			const float32x4_t dot = vsubq_f32( vaddq_f32( vaddq_f32(
+				vmulq_f32( l0, vld1q_f32( &batch->pixels[0][p][lane] ) ),
+				vmulq_f32( l1, vld1q_f32( &batch->pixels[1][p][lane] ) ) ),
+				vmulq_f32( l2, vld1q_f32( &batch->pixels[2][p][lane] ) ) ), offset );
+			const uint32x4_t value = vreinterpretq_u32_s32( vcvtq_s32_f32( vminq_f32( vmaxq_f32(
+				vaddq_f32( vmulq_f32( dot, vdupq_n_f32( 3.0f ) ), vdupq_n_f32( 0.5f ) ),
+				vdupq_n_f32( 0.0f ) ), vdupq_n_f32( 3.0f ) ) ) );
+			const uint32x4_t high = vshrq_n_u32( value, 1 );
+			const uint32x4_t code = vorrq_u32( high,
+				vshlq_n_u32( vandq_u32( veorq_u32( value, high ), vdupq_n_u32( 1 ) ), 1 ) );
+			bits = vorrq_u32( bits, vshlq_u32( code, vdupq_n_s32( 2*p ) ) );
+		}
+		vst1q_u32( &batch->color_bits[lane], bits );
+	}
+}
+
+static void
+	DXT_alpha_NEON
+	(
+		DXT_batch *batch
+	)
+{
+	int lane, p;
+	for( lane = 0; lane < DXT_BATCH_BLOCKS; lane += 4 )
+	{
+		float32x4_t a_max = vld1q_f32( &batch->pixels[3][0][lane] );
+		float32x4_t a_min = a_max;
+		float32x4_t scale;
+		uint32x4_t bits[2];
+		for( p = 1; p < 16; ++p )
+		{
+			const float32x4_t a = vld1q_f32( &batch->pixels[3][p][lane] );
+			a_max = vmaxq_f32( a_max, a );
+			a_min = vminq_f32( a_min, a );
+		}
+		scale = DXT_div_NEON( vdupq_n_f32( 7.9999f ), vsubq_f32( a_max, a_min ) );
+		bits[0] = bits[1] = vdupq_n_u32( 0 );
+		for( p = 0; p < 16; ++p )
+		{
+			/*	a flat block gives NaN, which converts to 0 here	*/
+			const uint32x4_t value = vandq_u32( vreinterpretq_u32_s32( vcvtq_s32_f32( vmulq_f32(
+				vsubq_f32( vld1q_f32( &batch->pixels[3][p][lane] ), a_min ), scale ) ) ), vdupq_n_u32( 7 ) );
+			uint32x4_t code = vandq_u32( vsubq_u32( vdupq_n_u32( 8 ), value ), vdupq_n_u32( 7 ) );
+			code = veorq_u32( code, vandq_u32( vcltq_u32( code, vdupq_n_u32( 2 ) ), vdupq_n_u32( 1 ) ) );
+			bits[p >> 3] = vorrq_u32( bits[p >> 3], vshlq_u32( code, vdupq_n_s32( 3*(p & 7) ) ) );
+		}
+		vst1q_s32( &batch->alpha_max[lane], vcvtq_s32_f32( a_max ) );
+		vst1q_s32( &batch->alpha_min[lane], vcvtq_s32_f32( a_min ) );
+		vst1q_u32( &batch->alpha_bits[0][lane], bits[0] );
+		vst1q_u32( &batch->alpha_bits[1][lane], bits[1] );
+	}
+}
+#endif
+
+/*	the best kernels for this CPU, NULL without any	*/
+static const DXT_kernels*
+	DXT_pick_kernels
+	(
+		void
+	)
+{
+#if defined( SOIL_SIMD_SSE2 )
+	static const DXT_kernels SSE2 = { DXT_color_endpoints_SSE2, DXT_color_indices_SSE2, DXT_alpha_SSE2 };
+#endif
+#if defined( SOIL_SIMD_AVX2 )
+	static const DXT_kernels AVX2 = { DXT_color_endpoints_AVX2, DXT_color_indices_AVX2, DXT_alpha_AVX2 };
+#endif
+#if defined( SOIL_SIMD_NEON )
+	static const DXT_kernels NEON = { DXT_color_endpoints_NEON, DXT_color_indices_NEON, DXT_alpha_NEON };
+#endif
+	const DXT_kernels *best = NULL;
+#if defined( SOIL_SIMD_NEON )
+	best = &NEON;
+#endif
+#if defined( SOIL_SIMD_SSE2 )
+	best = &SSE2;
+#endif
+#if defined( SOIL_SIMD_AVX2 )
+	if( image_simd_has_AVX2() )
+	{
+		best = &AVX2;
+	}
+#endif
+	return best;
+}
@@ -12,6 +12,10 @@
 
 #include <stdint.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**
 	Converts an image from an array of unsigned chars (RGB or RGBA) to
 	DXT1 or DXT5, then saves the converted image to disk.
@@ -47,6 +51,140 @@ convert_image_to_DXT5
     int *out_size
 );
 
+/**
+	Options of convert_image_to_DXT1_ex and convert_image_to_DXT5_ex.
+	By default several blocks are encoded at once with the SSE2, AVX2
+	or NEON kernels, and large images are split across the shared
+	thread pool.
+	DXT_COMPRESS_DETERMINISTIC uses the scalar reference encoder on the
+	calling thread instead, so the output only depends on the pixels
+	and not on the instruction set (the vector kernels follow the
+	reference, but may round differently where the compiler fuses
+	the reference's multiply-adds).
+	DXT_COMPRESS_CLUSTER_FIT is the high quality tier, for offline
+	baking: every block is fitted by trying all the ways of splitting
+	its pixels (sorted along the principal axis) between the 4 palette
+	colors, and gets the nearest palette index for each pixel.  It is
+	about two orders of magnitude slower than the default range fit,
+	and never has a larger error.
+	DXT_COMPRESS_RGTC makes save_image_as_DDS_ex store 1 and 2 channel
+	images as BC4 and BC5 (ATI1 and ATI2) instead of DXT1 and DXT5.
+	DXT_COMPRESS_BC7 makes save_image_as_DDS_ex store any image as BC7
+	(with a DX10 header), DXT_COMPRESS_CLUSTER_FIT then selects the
+	multi-mode BC7 encoder (see image_BPTC.h).
+**/
+enum
+{
+	DXT_COMPRESS_DETERMINISTIC = 1,
+	DXT_COMPRESS_CLUSTER_FIT = 2,
+	DXT_COMPRESS_RGTC = 4,
+	DXT_COMPRESS_BC7 = 8
+};
+
+/**
+	The block formats of the encoder.
+	BC4 holds the 1st channel, BC5 the 1st and the 2nd (luminance and
+	alpha, or the red and green of a normal map), each coded like the
+	alpha of DXT5.  BC7 holds RGBA.
+**/
+enum
+{
+	DXT_FORMAT_DXT1 = 0,
+	DXT_FORMAT_DXT5 = 1,
+	DXT_FORMAT_BC4 = 2,
+	DXT_FORMAT_BC5 = 3,
+	DXT_FORMAT_BC7 = 4
+};
+
+/**
+	The error of a compressed image against the original, over the
+	RGB channels for DXT1, the RGBA channels for DXT5, the channels
+	BC4 and BC5 hold, and for BC7 the RGBA channels if the image has
+	alpha and the RGB channels otherwise.
+	PSNR is in dB, and HUGE_VAL if the image is lossless.
+**/
+typedef struct
+{
+	double RMSE;
+	double PSNR;
+} DXT_error;
+
+/**
+	save_image_as_DDS with DXT_COMPRESS_* options.
+	\param error if not NULL, receives the error of the saved image
+	\return 0 if failed, otherwise returns 1
+**/
+int
+save_image_as_DDS_ex
+(
+    const char *filename,
+    int width, int height, int channels,
+    const unsigned char *const data,
+    unsigned int options,
+    DXT_error *error
+);
+
+/**
+	convert_image_to_DXT1 with DXT_COMPRESS_* options
+**/
+unsigned char*
+convert_image_to_DXT1_ex
+(
+    const unsigned char *const uncompressed,
+    int width, int height, int channels,
+    int *out_size, unsigned int options
+);
+
+/**
+	convert_image_to_DXT5 with DXT_COMPRESS_* options
+**/
+unsigned char*
+convert_image_to_DXT5_ex
+(
+    const unsigned char *const uncompressed,
+    int width, int height, int channels,
+    int *out_size, unsigned int options
+);
+
+/**
+	take an image and convert its 1st channel to BC4 (RGTC1),
+	with DXT_COMPRESS_* options
+**/
+unsigned char*
+convert_image_to_BC4
+(
+    const unsigned char *const uncompressed,
+    int width, int height, int channels,
+    int *out_size, unsigned int options
+);
+
+/**
+	take an image and convert its 1st and 2nd channels to BC5 (RGTC2),
+	with DXT_COMPRESS_* options
+**/
+unsigned char*
+convert_image_to_BC5
+(
+    const unsigned char *const uncompressed,
+    int width, int height, int channels,
+    int *out_size, unsigned int options
+);
+
+/**
+	Decodes an image of one of the DXT_FORMAT_* formats and measures
+	its error against the uncompressed one.
+	\return 0 if failed, otherwise returns 1
+**/
+int
+DXT_measure_error
+(
+    const unsigned char *const uncompressed,
+    int width, int height, int channels,
+    const unsigned char *const compressed,
+    int format,
+    DXT_error *error
+);
+
 //	A bunch of DirectDraw Surface structures and flags
 typedef struct  
 {
@@ -221,6 +359,7 @@ typedef struct {
 } DDS_HEADER_DXT10;
 
 #define DDS_DIMENSION_TEXTURE2D 3
+#define DDS_DIMENSION_TEXTURE3D 4
 #define DDS_RESOURCE_MISC_TEXTURECUBE 0x4
 
 /*	the following constants were copied directly off the MSDN website	*/
@@ -259,4 +398,8 @@ typedef struct {
 #define DDSCAPS2_CUBEMAP_NEGATIVEZ	0x00008000
 #define DDSCAPS2_VOLUME	0x00200000
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* HEADER_IMAGE_DXT	*/
@@ -0,0 +1,875 @@
+/*
+	ETC1 and ETC2 compression, and PKM writing
+
+	The ETC1 encoder uses the average of each half block as its base
+	color and tries every intensity table on it, for both splits and
+	both base color modes.  ETC2 also tries the planar mode, fitted by
+	least squares, and adds EAC alpha.  The half block search has SSE2
+	and NEON kernels which pick the same indices as the plain C one, so
+	the output doesn't depend on the CPU.
+
+	MIT license
+*/
+
+#include "image_ETC.h"
+#include "image_simd.h"
+#include "pkm_helper.h"
+#include "thread_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*	images with at least this many blocks are split across the thread pool	*/
+#define ETC_THREADED_MIN_BLOCKS	256
+
+/*	the intensity modifiers, in the order of the pixel indices	*/
+static const int ETC_modifiers[8][4] =
+{
+	{  2,   8,  -2,   -8 },
+	{  5,  17,  -5,  -17 },
+	{  9,  29,  -9,  -29 },
+	{ 13,  42, -13,  -42 },
+	{ 18,  60, -18,  -60 },
+	{ 24,  80, -24,  -80 },
+	{ 33, 106, -33, -106 },
+	{ 47, 183, -47, -183 }
+};
+
+/*	the 3 bit deltas of the differential mode	*/
+static const int ETC_deltas[8] = { 0, 1, 2, 3, -4, -3, -2, -1 };
+
+static const int EAC_modifiers[16][8] =
+{
+	{ -3, -6,  -9, -15, 2, 5, 8, 14 },
+	{ -3, -7, -10, -13, 2, 6, 9, 12 },
+	{ -2, -5,  -8, -13, 1, 4, 7, 12 },
+	{ -2, -4,  -6, -13, 1, 3, 5, 12 },
+	{ -3, -6,  -8, -12, 2, 5, 7, 11 },
+	{ -3, -7,  -9, -11, 2, 6, 8, 10 },
+	{ -4, -7,  -8, -11, 3, 6, 7, 10 },
+	{ -3, -5,  -8, -11, 2, 4, 7, 10 },
+	{ -2, -6,  -8, -10, 1, 5, 7,  9 },
+	{ -2, -5,  -8, -10, 1, 4, 7,  9 },
+	{ -2, -4,  -8, -10, 1, 3, 7,  9 },
+	{ -2, -5,  -7, -10, 1, 4, 6,  9 },
+	{ -3, -4,  -7, -10, 2, 3, 6,  9 },
+	{ -1, -2,  -3, -10, 0, 1, 2,  9 },
+	{ -4, -6,  -8,  -9, 3, 5, 7,  8 },
+	{ -3, -5,  -7,  -9, 2, 4, 6,  8 }
+};
+
+/*	the EAC table holding a 0 modifier, for constant alpha	*/
+#define EAC_CONSTANT_TABLE	13
+#define EAC_CONSTANT_INDEX	4
+
+/*	the column major pixel numbers (x*4 + y) of the left, right,
+	top and bottom halves, the order of the index bits	*/
+static const int ETC_half_positions[4][8] =
+{
+	{ 0, 1, 2, 3, 4, 5, 6, 7 },
+	{ 8, 9, 10, 11, 12, 13, 14, 15 },
+	{ 0, 1, 4, 5, 8, 9, 12, 13 },
+	{ 2, 3, 6, 7, 10, 11, 14, 15 }
+};
+
+/*	the 8 pixels of half a block, by channel	*/
+typedef struct
+{
+	short pixels[3][8];
+	int sum[3];
+} ETC_half;
+
+/*	squared error of half a block against a base color and an
+	intensity table, and the index of each pixel unless indices is NULL	*/
+typedef unsigned int (*ETC_half_error_func)( const ETC_half *half, const int base[3], int table, unsigned char indices[8] );
+
+typedef struct
+{
+	unsigned int error;
+	int differential;
+	int flip;
+	/*	4 or 5 bits per channel	*/
+	int base[2][3];
+	int table[2];
+	unsigned char indices[2][8];
+} ETC1_fit;
+
+typedef struct
+{
+	const unsigned char *uncompressed;
+	int width, height, channels;
+	unsigned char *compressed;
+	/*	PKM_FORMAT_ETC1_RGB8, PKM_FORMAT_ETC2_RGB8 or PKM_FORMAT_ETC2_RGBA8	*/
+	int format;
+	int first_row, last_row;
+} ETC_encode_job;
+
+static int
+	ETC_clamp
+	(
+		int value
+	)
+{
+	return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+static void
+	ETC_palette
+	(
+		const int base[3], int table,
+		int palette[4][3]
+	)
+{
+	int k, c;
+	for( k = 0; k < 4; ++k )
+	{
+		for( c = 0; c < 3; ++c )
+		{
+			palette[k][c] = ETC_clamp( base[c] + ETC_modifiers[table][k] );
+		}
+	}
+}
+
+#if !defined( SOIL_SIMD_SSE2 ) && !defined( SOIL_SIMD_NEON )
+static unsigned int
+	ETC_half_error
+	(
+		const ETC_half *half, const int base[3], int table,
+		unsigned char indices[8]
+	)
+{
+	int palette[4][3];
+	unsigned int total = 0;
+	int p, k, c, index = 0;
+	ETC_palette( base, table, palette );
+	for( p = 0; p < 8; ++p )
+	{
+		unsigned int best = 0xFFFFFFFFu;
+		for( k = 0; k < 4; ++k )
+		{
+			unsigned int error = 0;
+			for( c = 0; c < 3; ++c )
+			{
+				const int d = half->pixels[c][p] - palette[k][c];
+				error += (unsigned int)(d * d);
+			}
+			if( error < best )
+			{
+				best = error;
+				index = k;
+			}
+		}
+		if( indices )
+		{
+			indices[p] = (unsigned char)index;
+		}
+		total += best;
+	}
+	return total;
+}
+#elif defined( SOIL_SIMD_SSE2 )
+/*	the 8 pixels in 16 bit lanes, the errors in two 32 bit halves	*/
+static unsigned int
+	ETC_half_error_SSE2
+	(
+		const ETC_half *half, const int base[3], int table,
+		unsigned char indices[8]
+	)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i r = _mm_loadu_si128( (const __m128i*)half->pixels[0] );
+	const __m128i g = _mm_loadu_si128( (const __m128i*)half->pixels[1] );
+	const __m128i b = _mm_loadu_si128( (const __m128i*)half->pixels[2] );
+	__m128i best_lo = _mm_set1_epi32( 0x7FFFFFFF ), best_hi = best_lo;
+	__m128i index_lo = zero, index_hi = zero, sum;
+	int palette[4][3];
+	int lanes[8];
+	int k, p;
+	ETC_palette( base, table, palette );
+	for( k = 0; k < 4; ++k )
+	{
+		const __m128i dr = _mm_sub_epi16( r, _mm_set1_epi16( (short)palette[k][0] ) );
+		const __m128i dg = _mm_sub_epi16( g, _mm_set1_epi16( (short)palette[k][1] ) );
+		const __m128i db = _mm_sub_epi16( b, _mm_set1_epi16( (short)palette[k][2] ) );
+		const __m128i rg_lo = _mm_unpacklo_epi16( dr, dg );
+		const __m128i rg_hi = _mm_unpackhi_epi16( dr, dg );
+		const __m128i b_lo = _mm_unpacklo_epi16( db, zero );
+		const __m128i b_hi = _mm_unpackhi_epi16( db, zero );
+		const __m128i error_lo = _mm_add_epi32( _mm_madd_epi16( rg_lo, rg_lo ), _mm_madd_epi16( b_lo, b_lo ) );
+		const __m128i error_hi = _mm_add_epi32( _mm_madd_epi16( rg_hi, rg_hi ), _mm_madd_epi16( b_hi, b_hi ) );
+		/*	strictly less, the first best index wins like the plain C	*/
+		const __m128i less_lo = _mm_cmplt_epi32( error_lo, best_lo );
+		const __m128i less_hi = _mm_cmplt_epi32( error_hi, best_hi );
+		const __m128i index = _mm_set1_epi32( k );
+		best_lo = _mm_or_si128( _mm_and_si128( less_lo, error_lo ), _mm_andnot_si128( less_lo, best_lo ) );
+		best_hi = _mm_or_si128( _mm_and_si128( less_hi, error_hi ), _mm_andnot_si128( less_hi, best_hi ) );
+		index_lo = _mm_or_si128( _mm_and_si128( less_lo, index ), _mm_andnot_si128( less_lo, index_lo ) );
+		index_hi = _mm_or_si128( _mm_and_si128( less_hi, index ), _mm_andnot_si128( less_hi, index_hi ) );
+	}
+	if( indices )
+	{
+		_mm_storeu_si128( (__m128i*)&lanes[0], index_lo );
+		_mm_storeu_si128( (__m128i*)&lanes[4], index_hi );
+		for( p = 0; p < 8; ++p )
+		{
+			indices[p] = (unsigned char)lanes[p];
+		}
+	}
+	sum = _mm_add_epi32( best_lo, best_hi );
+	sum = _mm_add_epi32( sum, _mm_shuffle_epi32( sum, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+	sum = _mm_add_epi32( sum, _mm_shuffle_epi32( sum, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+	return (unsigned int)_mm_cvtsi128_si32( sum );
+}
+#else
+/*	the 8 pixels in 16 bit lanes, the errors in two 32 bit halves	*/
+static unsigned int
+	ETC_half_error_NEON
+	(
+		const ETC_half *half, const int base[3], int table,
+		unsigned char indices[8]
+	)
+{
+	const int16x8_t r = vld1q_s16( half->pixels[0] );
+	const int16x8_t g = vld1q_s16( half->pixels[1] );
+	const int16x8_t b = vld1q_s16( half->pixels[2] );
+	uint32x4_t best_lo = vdupq_n_u32( 0xFFFFFFFFu ), best_hi = best_lo;
+	uint32x4_t index_lo = vdupq_n_u32( 0 ), index_hi = index_lo;
+	uint32x2_t sum;
+	unsigned int lanes[8];
+	int palette[4][3];
+	int k, p;
+	ETC_palette( base, table, palette );
+	for( k = 0; k < 4; ++k )
+	{
+		const int16x8_t dr = vsubq_s16( r, vdupq_n_s16( (short)palette[k][0] ) );
+		const int16x8_t dg = vsubq_s16( g, vdupq_n_s16( (short)palette[k][1] ) );
+		const int16x8_t db = vsubq_s16( b, vdupq_n_s16( (short)palette[k][2] ) );
+		const uint32x4_t error_lo = vreinterpretq_u32_s32( vmlal_s16( vmlal_s16(
+			vmull_s16( vget_low_s16( dr ), vget_low_s16( dr ) ),
+			vget_low_s16( dg ), vget_low_s16( dg ) ),
+			vget_low_s16( db ), vget_low_s16( db ) ) );
+		const uint32x4_t error_hi = vreinterpretq_u32_s32( vmlal_s16( vmlal_s16(
+			vmull_s16( vget_high_s16( dr ), vget_high_s16( dr ) ),
+			vget_high_s16( dg ), vget_high_s16( dg ) ),
+			vget_high_s16( db ), vget_high_s16( db ) ) );
+		/*	strictly less, the first best index wins like the plain C	*/
+		const uint32x4_t less_lo = vcltq_u32( error_lo, best_lo );
+		const uint32x4_t less_hi = vcltq_u32( error_hi, best_hi );
+		const uint32x4_t index = vdupq_n_u32( (unsigned int)k );
+		best_lo = vbslq_u32( less_lo, error_lo, best_lo );
+		best_hi = vbslq_u32( less_hi, error_hi, best_hi );
+		index_lo = vbslq_u32( less_lo, index, index_lo );
+		index_hi = vbslq_u32( less_hi, index, index_hi );
+	}
+	if( indices )
+	{
+		vst1q_u32( &lanes[0], index_lo );
+		vst1q_u32( &lanes[4], index_hi );
+		for( p = 0; p < 8; ++p )
+		{
+			indices[p] = (unsigned char)lanes[p];
+		}
+	}
+	/*	vaddvq_u32 is AArch64 only, the pairwise add also builds for ARMv7	*/
+	sum = vadd_u32( vget_low_u32( best_lo ), vget_high_u32( best_lo ) );
+	sum = vadd_u32( sum, vadd_u32( vget_low_u32( best_hi ), vget_high_u32( best_hi ) ) );
+	sum = vpadd_u32( sum, sum );
+	return vget_lane_u32( sum, 0 );
+}
+#endif
+
+/*	the best kernel for this CPU	*/
+static ETC_half_error_func
+	ETC_pick_kernel
+	(
+		void
+	)
+{
+#if defined( SOIL_SIMD_SSE2 )
+	return ETC_half_error_SSE2;
+#elif defined( SOIL_SIMD_NEON )
+	return ETC_half_error_NEON;
+#else
+	return ETC_half_error;
+#endif
+}
+
+/*	4x4 RGBA pixels, row major, edges replicated past the image	*/
+static void
+	ETC_gather_block
+	(
+		const ETC_encode_job *job, int block_x, int block_y,
+		unsigned char pixels[16][4]
+	)
+{
+	int x, y, c;
+	for( y = 0; y < 4; ++y )
+	{
+		const int sy = (block_y * 4 + y < job->height) ? block_y * 4 + y : job->height - 1;
+		for( x = 0; x < 4; ++x )
+		{
+			const int sx = (block_x * 4 + x < job->width) ? block_x * 4 + x : job->width - 1;
+			const unsigned char *src = &job->uncompressed[((size_t)sy * job->width + sx) * job->channels];
+			unsigned char *dst = pixels[y * 4 + x];
+			if( job->channels < 3 )
+			{
+				dst[0] = dst[1] = dst[2] = src[0];
+				dst[3] = (job->channels == 2) ? src[1] : 255;
+			} else
+			{
+				for( c = 0; c < 3; ++c )
+				{
+					dst[c] = src[c];
+				}
+				dst[3] = (job->channels == 4) ? src[3] : 255;
+			}
+		}
+	}
+}
+
+/*	the best table of a half for a base color, returns its error	*/
+static unsigned int
+	ETC1_fit_half
+	(
+		const ETC_half *half, const int base[3],
+		ETC_half_error_func half_error,
+		int *table, unsigned char indices[8]
+	)
+{
+	unsigned int best = 0xFFFFFFFFu;
+	int t;
+	for( t = 0; t < 8; ++t )
+	{
+		const unsigned int error = half_error( half, base, t, NULL );
+		if( error < best )
+		{
+			best = error;
+			*table = t;
+		}
+	}
+	half_error( half, base, *table, indices );
+	return best;
+}
+
+/*	one of the 4 combinations of split and base color mode, returns
+	0 when the differential mode had to pull the base colors together	*/
+static int
+	ETC1_fit_mode
+	(
+		const ETC_half halves[4], int flip, int differential,
+		ETC_half_error_func half_error,
+		ETC1_fit *fit
+	)
+{
+	int in_reach = 1;
+	int s, c;
+	fit->flip = flip;
+	fit->differential = differential;
+	fit->error = 0;
+	for( c = 0; c < 3; ++c )
+	{
+		for( s = 0; s < 2; ++s )
+		{
+			/*	the average, rounded to 4 or 5 bits	*/
+			fit->base[s][c] = differential ?
+				(halves[flip * 2 + s].sum[c] * 31 + 1020) / 2040 :
+				(halves[flip * 2 + s].sum[c] * 15 + 1020) / 2040;
+		}
+		if( differential )
+		{
+			/*	the second base color has to be within reach of the delta	*/
+			const int delta = fit->base[1][c] - fit->base[0][c];
+			if( (delta < -4) || (delta > 3) )
+			{
+				fit->base[1][c] = fit->base[0][c] + (delta < -4 ? -4 : 3);
+				in_reach = 0;
+			}
+		}
+	}
+	for( s = 0; s < 2; ++s )
+	{
+		int expanded[3];
+		for( c = 0; c < 3; ++c )
+		{
+			expanded[c] = differential ?
+				(fit->base[s][c] << 3) | (fit->base[s][c] >> 2) :
+				(fit->base[s][c] << 4) | fit->base[s][c];
+		}
+		fit->error += ETC1_fit_half( &halves[flip * 2 + s], expanded, half_error,
+			&fit->table[s], fit->indices[s] );
+	}
+	return in_reach;
+}
+
+static unsigned int
+	ETC1_compress_block
+	(
+		const unsigned char pixels[16][4],
+		ETC_half_error_func half_error,
+		unsigned char out[8]
+	)
+{
+	ETC_half halves[4];
+	ETC1_fit best, trial;
+	unsigned int msb = 0, lsb = 0;
+	int h, j, c, s, flip;
+	/*	split the block into its 4 possible halves	*/
+	for( h = 0; h < 4; ++h )
+	{
+		for( c = 0; c < 3; ++c )
+		{
+			halves[h].sum[c] = 0;
+		}
+		for( j = 0; j < 8; ++j )
+		{
+			const int i = ETC_half_positions[h][j];
+			/*	column major to row major	*/
+			const unsigned char *pixel = pixels[(i & 3) * 4 + (i >> 2)];
+			for( c = 0; c < 3; ++c )
+			{
+				halves[h].pixels[c][j] = pixel[c];
+				halves[h].sum[c] += pixel[c];
+			}
+		}
+	}
+	/*	4 bit base colors only help when the 5 bit ones are out of reach	*/
+	for( flip = 0; flip < 2; ++flip )
+	{
+		const int in_reach = ETC1_fit_mode( halves, flip, 1, half_error, &trial );
+		if( flip == 0 || trial.error < best.error )
+		{
+			best = trial;
+		}
+		if( !in_reach )
+		{
+			ETC1_fit_mode( halves, flip, 0, half_error, &trial );
+			if( trial.error < best.error )
+			{
+				best = trial;
+			}
+		}
+	}
+	for( c = 0; c < 3; ++c )
+	{
+		out[c] = best.differential ?
+			(unsigned char)((best.base[0][c] << 3) | ((best.base[1][c] - best.base[0][c]) & 7)) :
+			(unsigned char)((best.base[0][c] << 4) | best.base[1][c]);
+	}
+	out[3] = (unsigned char)((best.table[0] << 5) | (best.table[1] << 2) | (best.differential << 1) | best.flip);
+	for( s = 0; s < 2; ++s )
+	{
+		for( j = 0; j < 8; ++j )
+		{
+			const int i = ETC_half_positions[best.flip * 2 + s][j];
+			lsb |= (unsigned int)(best.indices[s][j] & 1) << i;
+			msb |= (unsigned int)(best.indices[s][j] >> 1) << i;
+		}
+	}
+	out[4] = (unsigned char)(msb >> 8);
+	out[5] = (unsigned char)msb;
+	out[6] = (unsigned char)(lsb >> 8);
+	out[7] = (unsigned char)lsb;
+	return best.error;
+}
+
+/*	6 or 7 bit planar mode components, as the decoder expands them	*/
+static int
+	ETC2_planar_expand
+	(
+		int value, int bits
+	)
+{
+	return (bits == 7) ? (value << 1) | (value >> 6) : (value << 2) | (value >> 4);
+}
+
+/*	the planar mode: a color at the origin and at the right and bottom
+	edges, interpolated across the block.  Returns its error.	*/
+static unsigned int
+	ETC2_planar_block
+	(
+		const unsigned char pixels[16][4],
+		unsigned char out[8]
+	)
+{
+	/*	the normal equations of the weights (4-x-y, x, y) / 4	*/
+	float m[3][3], rhs[3][3], inverse[3][3], determinant;
+	int origin[3], horizontal[3], vertical[3];
+	unsigned int error = 0;
+	int x, y, i, j, c;
+	memset( m, 0, sizeof( m ) );
+	memset( rhs, 0, sizeof( rhs ) );
+	for( y = 0; y < 4; ++y )
+	{
+		for( x = 0; x < 4; ++x )
+		{
+			const float w[3] = { (4 - x - y) * 0.25f, x * 0.25f, y * 0.25f };
+			for( i = 0; i < 3; ++i )
+			{
+				for( j = 0; j < 3; ++j )
+				{
+					m[i][j] += w[i] * w[j];
+				}
+				for( c = 0; c < 3; ++c )
+				{
+					rhs[c][i] += w[i] * pixels[y * 4 + x][c];
+				}
+			}
+		}
+	}
+	determinant =
+		m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+		m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+		m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+	for( i = 0; i < 3; ++i )
+	{
+		for( j = 0; j < 3; ++j )
+		{
+			/*	the cofactors, transposed	*/
+			const int i1 = (j + 1) % 3, i2 = (j + 2) % 3;
+			const int j1 = (i + 1) % 3, j2 = (i + 2) % 3;
+			inverse[i][j] = (m[i1][j1] * m[i2][j2] - m[i1][j2] * m[i2][j1]) / determinant;
+		}
+	}
+	for( c = 0; c < 3; ++c )
+	{
+		const int bits = (c == 1) ? 7 : 6;
+		const float scale = (float)((1 << bits) - 1) / 255.0f;
+		int *targets[3];
+		targets[0] = &origin[c];
+		targets[1] = &horizontal[c];
+		targets[2] = &vertical[c];
+		for( i = 0; i < 3; ++i )
+		{
+			const float value = inverse[i][0] * rhs[c][0] + inverse[i][1] * rhs[c][1] + inverse[i][2] * rhs[c][2];
+			int q = (int)(value * scale + 0.5f);
+			if( value < 0.0f )
+			{
+				q = 0;
+			}
+			*targets[i] = q > (1 << bits) - 1 ? (1 << bits) - 1 : q;
+		}
+	}
+	for( y = 0; y < 4; ++y )
+	{
+		for( x = 0; x < 4; ++x )
+		{
+			for( c = 0; c < 3; ++c )
+			{
+				const int bits = (c == 1) ? 7 : 6;
+				const int o = ETC2_planar_expand( origin[c], bits );
+				const int h = ETC2_planar_expand( horizontal[c], bits );
+				const int v = ETC2_planar_expand( vertical[c], bits );
+				const int d = ETC_clamp( (x * (h - o) + y * (v - o) + 4 * o + 2) >> 2 ) - pixels[y * 4 + x][c];
+				error += (unsigned int)(d * d);
+			}
+		}
+	}
+	out[0] = (unsigned char)((origin[0] << 1) | (origin[1] >> 6));
+	out[1] = (unsigned char)(((origin[1] & 0x3F) << 1) | (origin[2] >> 5));
+	out[2] = (unsigned char)((((origin[2] >> 3) & 3) << 3) | ((origin[2] >> 1) & 3));
+	out[3] = (unsigned char)(((origin[2] & 1) << 7) | ((horizontal[0] >> 1) << 2) | 2 | (horizontal[0] & 1));
+	out[4] = (unsigned char)((horizontal[1] << 1) | (horizontal[2] >> 5));
+	out[5] = (unsigned char)(((horizontal[2] & 0x1F) << 3) | (vertical[0] >> 3));
+	out[6] = (unsigned char)(((vertical[0] & 7) << 5) | (vertical[1] >> 2));
+	out[7] = (unsigned char)(((vertical[1] & 3) << 6) | vertical[2]);
+	/*	the unused bits keep red and green in range and make blue
+		overflow, which is what tells the decoder it's planar	*/
+	if( (out[0] >> 3) + ETC_deltas[out[0] & 7] < 0 )
+	{
+		out[0] |= 0x80;
+	}
+	if( (out[1] >> 3) + ETC_deltas[out[1] & 7] < 0 )
+	{
+		out[1] |= 0x80;
+	}
+	if( ((out[2] >> 3) & 3) + (out[2] & 3) >= 4 )
+	{
+		out[2] |= 0xE0;
+	} else
+	{
+		out[2] |= 0x04;
+	}
+	return error;
+}
+
+/*	EAC alpha: a base, a multiplier and one of 16 tables of 8 modifiers	*/
+static void
+	EAC_compress_block
+	(
+		const unsigned char pixels[16][4],
+		unsigned char out[8]
+	)
+{
+	int alpha_min = 255, alpha_max = 0;
+	int best_base = 0, best_multiplier = 1, best_table = EAC_CONSTANT_TABLE;
+	unsigned int best_error = 0xFFFFFFFFu;
+	unsigned char best_indices[16];
+	unsigned long long bits;
+	int p, t, k, multiplier;
+	for( p = 0; p < 16; ++p )
+	{
+		alpha_min = pixels[p][3] < alpha_min ? pixels[p][3] : alpha_min;
+		alpha_max = pixels[p][3] > alpha_max ? pixels[p][3] : alpha_max;
+	}
+	if( alpha_min == alpha_max )
+	{
+		/*	a multiplier of 0 isn't allowed, use the 0 modifier	*/
+		best_base = alpha_min;
+		memset( best_indices, EAC_CONSTANT_INDEX, 16 );
+	} else
+	{
+		for( t = 0; t < 16; ++t )
+		{
+			/*	the modifiers 3 and 7 are the extremes	*/
+			const int low = EAC_modifiers[t][3], high = EAC_modifiers[t][7];
+			const int guess = ((alpha_max - alpha_min) * 2 + (high - low)) / ((high - low) * 2);
+			for( multiplier = guess - 1; multiplier <= guess + 1; ++multiplier )
+			{
+				unsigned char indices[16];
+				unsigned int error = 0;
+				int base;
+				if( (multiplier < 1) || (multiplier > 15) )
+				{
+					continue;
+				}
+				/*	center the span of the table on the span of the alpha	*/
+				base = ETC_clamp( ((alpha_min + alpha_max) - (low + high) * multiplier + 1) >> 1 );
+				for( p = 0; p < 16 && error < best_error; ++p )
+				{
+					/*	the pixels column major, like the indices	*/
+					const int alpha = pixels[(p & 3) * 4 + (p >> 2)][3];
+					int best = 0x7FFFFFFF;
+					for( k = 0; k < 8; ++k )
+					{
+						const int d = ETC_clamp( base + EAC_modifiers[t][k] * multiplier ) - alpha;
+						if( d * d < best )
+						{
+							best = d * d;
+							indices[p] = (unsigned char)k;
+						}
+					}
+					error += (unsigned int)best;
+				}
+				if( error < best_error )
+				{
+					best_error = error;
+					best_base = base;
+					best_multiplier = multiplier;
+					best_table = t;
+					memcpy( best_indices, indices, 16 );
+				}
+			}
+		}
+	}
+	bits = ((unsigned long long)best_base << 56) |
+		((unsigned long long)((best_multiplier << 4) | best_table) << 48);
+	for( p = 0; p < 16; ++p )
+	{
+		bits |= (unsigned long long)best_indices[p] << (45 - p * 3);
+	}
+	for( p = 0; p < 8; ++p )
+	{
+		out[p] = (unsigned char)(bits >> (56 - p * 8));
+	}
+}
+
+static void
+	ETC_encode_rows
+	(
+		void *argument
+	)
+{
+	const ETC_encode_job *job = (const ETC_encode_job*)argument;
+	const ETC_half_error_func half_error = ETC_pick_kernel();
+	const int blocks_wide = (job->width + 3) >> 2;
+	const int block_size = (job->format == PKM_FORMAT_ETC2_RGBA8) ? 16 : 8;
+	unsigned char pixels[16][4];
+	unsigned char planar[8];
+	int row, i;
+	for( row = job->first_row; row < job->last_row; ++row )
+	{
+		unsigned char *out = job->compressed + (size_t)row * blocks_wide * block_size;
+		for( i = 0; i < blocks_wide; ++i, out += block_size )
+		{
+			unsigned char *color = out;
+			unsigned int error;
+			ETC_gather_block( job, i, row, pixels );
+			if( job->format == PKM_FORMAT_ETC2_RGBA8 )
+			{
+				/*	the alpha block comes first	*/
+				EAC_compress_block( (const unsigned char (*)[4])pixels, out );
+				color = out + 8;
+			}
+			error = ETC1_compress_block( (const unsigned char (*)[4])pixels, half_error, color );
+			if( (job->format != PKM_FORMAT_ETC1_RGB8) && (error > 0) &&
+				(ETC2_planar_block( (const unsigned char (*)[4])pixels, planar ) < error) )
+			{
+				memcpy( color, planar, 8 );
+			}
+		}
+	}
+}
+
+/*	split the block rows of single across the shared thread pool	*/
+static unsigned char*
+	ETC_convert_image
+	(
+		ETC_encode_job *single,
+		int *out_size
+	)
+{
+	ETC_encode_job *jobs;
+	struct SOIL_ThreadPool *pool;
+	thread_pool_group group;
+	int block_rows, blocks, job_count, i;
+	/*	error check	*/
+	*out_size = 0;
+	if( (single->width < 1) || (single->height < 1) ||
+		(NULL == single->uncompressed) ||
+		(single->channels < 1) || (single->channels > 4) )
+	{
+		return NULL;
+	}
+	block_rows = (single->height+3) >> 2;
+	blocks = ((single->width+3) >> 2) * block_rows;
+	*out_size = blocks * ((single->format == PKM_FORMAT_ETC2_RGBA8) ? 16 : 8);
+	single->compressed = (unsigned char*)malloc( *out_size );
+	if( NULL == single->compressed )
+	{
+		*out_size = 0;
+		return NULL;
+	}
+	single->first_row = 0;
+	single->last_row = block_rows;
+	pool = (blocks >= ETC_THREADED_MIN_BLOCKS) ? thread_pool_shared() : NULL;
+	job_count = pool ? thread_pool_thread_count( pool ) * 4 : 1;
+	if( job_count > block_rows )
+	{
+		job_count = block_rows;
+	}
+	jobs = job_count > 1 ? (ETC_encode_job*)malloc( job_count * sizeof( ETC_encode_job ) ) : NULL;
+	if( NULL == jobs )
+	{
+		ETC_encode_rows( single );
+		return single->compressed;
+	}
+	thread_pool_group_init( &group );
+	for( i = 0; i < job_count; ++i )
+	{
+		jobs[i] = *single;
+		jobs[i].first_row = (int)( (long long)block_rows * i / job_count );
+		jobs[i].last_row = (int)( (long long)block_rows * (i + 1) / job_count );
+		if( !thread_pool_submit( pool, &group, ETC_encode_rows, &jobs[i] ) )
+		{
+			/*	out of memory queueing, do it here	*/
+			ETC_encode_rows( &jobs[i] );
+		}
+	}
+	thread_pool_wait( pool, &group );
+	free( jobs );
+	return single->compressed;
+}
+
+/********* Actual Exposed Functions *********/
+unsigned char*
+	convert_image_to_ETC1
+	(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int *out_size
+	)
+{
+	ETC_encode_job single;
+	memset( &single, 0, sizeof( ETC_encode_job ) );
+	single.uncompressed = uncompressed;
+	single.width = width;
+	single.height = height;
+	single.channels = channels;
+	single.format = PKM_FORMAT_ETC1_RGB8;
+	return ETC_convert_image( &single, out_size );
+}
+
+unsigned char*
+	convert_image_to_ETC2
+	(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int *out_size
+	)
+{
+	ETC_encode_job single;
+	memset( &single, 0, sizeof( ETC_encode_job ) );
+	single.uncompressed = uncompressed;
+	single.width = width;
+	single.height = height;
+	single.channels = channels;
+	single.format = ((channels & 1) == 1) ? PKM_FORMAT_ETC2_RGB8 : PKM_FORMAT_ETC2_RGBA8;
+	return ETC_convert_image( &single, out_size );
+}
+
+int
+	save_image_as_PKM
+	(
+		const char *filename,
+		int width, int height, int channels,
+		const unsigned char *const data,
+		unsigned int options
+	)
+{
+	FILE *fout;
+	unsigned char *ETC_data;
+	unsigned char header[PKM_HEADER_SIZE];
+	int ETC_size, format;
+	/*	error check, the header has 16 bit padded sizes	*/
+	if( (NULL == filename) ||
+		(width < 1) || (height < 1) ||
+		(width > 65532) || (height > 65532) ||
+		(channels < 1) || (channels > 4) ||
+		(data == NULL ) )
+	{
+		return 0;
+	}
+	if( options & ETC_COMPRESS_ETC1 )
+	{
+		format = PKM_FORMAT_ETC1_RGB8;
+		ETC_data = convert_image_to_ETC1( data, width, height, channels, &ETC_size );
+	} else
+	{
+		format = ((channels & 1) == 1) ? PKM_FORMAT_ETC2_RGB8 : PKM_FORMAT_ETC2_RGBA8;
+		ETC_data = convert_image_to_ETC2( data, width, height, channels, &ETC_size );
+	}
+	if( NULL == ETC_data )
+	{
+		return 0;
+	}
+	/*	"PKM 10" or "PKM 20", then big endian format and sizes	*/
+	memcpy( header, (format == PKM_FORMAT_ETC1_RGB8) ? "PKM 10" : "PKM 20", 6 );
+	header[6] = (unsigned char)(format >> 8);
+	header[7] = (unsigned char)format;
+	header[8] = (unsigned char)(((width + 3) & ~3) >> 8);
+	header[9] = (unsigned char)((width + 3) & ~3);
+	header[10] = (unsigned char)(((height + 3) & ~3) >> 8);
+	header[11] = (unsigned char)((height + 3) & ~3);
+	header[12] = (unsigned char)(width >> 8);
+	header[13] = (unsigned char)width;
+	header[14] = (unsigned char)(height >> 8);
+	header[15] = (unsigned char)height;
+	/*	write it out	*/
+	fout = fopen( filename, "wb" );
+	if( NULL == fout )
+	{
+		free( ETC_data );
+		return 0;
+	}
+	if( (fwrite( header, 1, PKM_HEADER_SIZE, fout ) != PKM_HEADER_SIZE) ||
+		(fwrite( ETC_data, 1, ETC_size, fout ) != (size_t)ETC_size) )
+	{
+		fclose( fout );
+		free( ETC_data );
+		return 0;
+	}
+	fclose( fout );
+	/*	done	*/
+	free( ETC_data );
+	return 1;
+}
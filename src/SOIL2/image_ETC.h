@@ -0,0 +1,72 @@
+/*
+	ETC1 and ETC2 compression, and PKM writing
+
+	MIT license
+*/
+
+#ifndef HEADER_IMAGE_ETC
+#define HEADER_IMAGE_ETC
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+	Options of save_image_as_PKM.
+	ETC_COMPRESS_ETC1 writes a PKM 1.0 file with ETC1 blocks, which
+	OpenGL ES 2 devices can load, the alpha channel is dropped.
+	By default a PKM 2.0 file is written, ETC2 RGB8 for L and RGB
+	images, ETC2 RGBA8 (EAC alpha) for LA and RGBA images.
+**/
+enum
+{
+	ETC_COMPRESS_ETC1 = 1
+};
+
+/**
+	take an image and convert it to ETC1, 8 bytes per 4x4 block,
+	any alpha is dropped.  The blocks use the individual and the
+	differential modes, with either split, and the base colors are
+	the averages of the halves.
+**/
+unsigned char*
+	convert_image_to_ETC1
+	(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int *out_size
+	);
+
+/**
+	take an image and convert it to ETC2: RGB8 (8 bytes per block) for
+	1 and 3 channels, RGBA8 (16 bytes per block, EAC alpha first) for
+	2 and 4 channels.  On top of the ETC1 modes the planar mode is
+	tried, which holds smooth gradients much better.
+**/
+unsigned char*
+	convert_image_to_ETC2
+	(
+		const unsigned char *const uncompressed,
+		int width, int height, int channels,
+		int *out_size
+	);
+
+/**
+	saves an image as a PKM file, ETC2 unless ETC_COMPRESS_ETC1.
+	Images larger than 65532 pixels in either dimension can't be saved.
+	Returns 0 on failure.
+**/
+int
+	save_image_as_PKM
+	(
+		const char *filename,
+		int width, int height, int channels,
+		const unsigned char *const data,
+		unsigned int options
+	);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEADER_IMAGE_ETC	*/
@@ -2,10 +2,9 @@
 #include "image_array.h"
 #include <stdlib.h>
 #include <string.h>
+#include "SOIL2.h"
 #include "image_helper.h"
 
-extern const char *result_string_pointer;
-
 static void image_array_invert_rows(
 	void *data,
 	int height,
@@ -69,21 +68,6 @@ void image_array_free_f32( float **data, int layers )
 	}
 }
 
-void image_array_invert_y(SOIL_ImageArray* imgArray){
-	int layer;
-
-	if (!imgArray || !imgArray->data)
-		return;
-
-	for( layer = 0; layer < imgArray->layers; ++layer )
-	{
-		image_array_invert_rows(
-			imgArray->data[layer],
-			imgArray->height,
-			(size_t)imgArray->width * (size_t)imgArray->channels );
-	}
-}
-
 void image_array_invert_y_f32(
 	float **data,
 	int layers,
@@ -106,106 +90,44 @@ void image_array_invert_y_f32(
 	}
 }
 
-void image_array_premultiply_alpha(SOIL_ImageArray* imgArray){
-
-	if (!imgArray || !imgArray->data)
-		return;
-
-	const size_t numPixels = (size_t)(imgArray->width) * (size_t)(imgArray->height);
-
-	for (int layer = 0; layer < imgArray->layers; ++layer) {
-
-		unsigned char *image = imgArray->data[layer];
-
-		if (!image) continue;
-
-		for (size_t i = 0; i < numPixels; ++i) {
-			unsigned char *pixel = image + i * (size_t)(imgArray->channels);
-
-			if (imgArray->channels >= 4) {
-				float alpha = pixel[3] / 255.0f;
-				pixel[0] = (unsigned char)(pixel[0] * alpha);
-				pixel[1] = (unsigned char)(pixel[1] * alpha);
-				pixel[2] = (unsigned char)(pixel[2] * alpha);
-			}
-		}
-	}
-}
-
-void image_array_to_NTSC_safe(SOIL_ImageArray* imgArray){
+int image_array_transform(SOIL_ImageArray* imgArray, unsigned int operations){
+	int layer;
 
 	if (!imgArray || !imgArray->data)
-		return;
-
-	const size_t numPixels = (size_t)(imgArray->width) * (size_t)(imgArray->height);
-
-	for (int layer = 0; layer < imgArray->layers; ++layer) {
+		return 0;
 
+	for( layer = 0; layer < imgArray->layers; ++layer )
+	{
 		unsigned char *image = imgArray->data[layer];
 
-		if (!image) continue;
-
-		for (size_t i = 0; i < numPixels; ++i) {
-			unsigned char *pixel = image + i * (size_t)(imgArray->channels);
-
-			if (imgArray->channels >= 3) {
-				unsigned char r = pixel[0];
-				unsigned char g = pixel[1];
-				unsigned char b = pixel[2];
-
-				unsigned char y  = (unsigned char)(0.299f * r + 0.587f * g + 0.114f * b);
-				unsigned char co = (unsigned char)(r - b + 128);
-				unsigned char cg = (unsigned char)(-0.168736f * r - 0.331264f * g + 0.5f * b + 128);
-
-				pixel[0] = co;
-				pixel[1] = cg;
-				pixel[2] = y;
-			}
+		if( image != NULL &&
+			!transform_image( image, imgArray->width, imgArray->height,
+				imgArray->channels, image, operations ) )
+		{
+			return 0;
 		}
 	}
 
+	return 1;
 }
 
-void image_array_to_YCoCg(SOIL_ImageArray* imgArray){
-
-	if (!imgArray || !imgArray->data)
-		return;
-
-	const size_t numPixels = (size_t)(imgArray->width) * (size_t)(imgArray->height);
-
-	for (int layer = 0; layer < imgArray->layers; ++layer) {
-
-		unsigned char *image = imgArray->data[layer];
-
-		if (!image) continue;
-
-		for (size_t i = 0; i < numPixels; ++i) {
-			unsigned char *pixel = image + i * (size_t)(imgArray->channels);
-
-			if (imgArray->channels >= 3) {
-				unsigned char r = pixel[0];
-				unsigned char g = pixel[1];
-				unsigned char b = pixel[2];
-
-				int y  = (  r + ( 2 * g ) +   b ) >> 2;
-				int co = (  r           -   b ) >> 1;
-				int cg = ( -r + ( 2 * g ) -   b ) >> 2;
-
-				pixel[0] = (unsigned char)(co + 128);
-				pixel[1] = (unsigned char)(cg + 128);
-				pixel[2] = (unsigned char)(y);
-			}
-		}
-	}
+/* The power of two a side is resampled to.  The maximum size is not
+   always a power of 2, so past it the side is halved back down. */
+static int image_array_POT_size(int size, int max_size)
+{
+    int pot = image_next_power_of_two(size);
+    while (pot > max_size && pot > 1)
+        pot /= 2;
+    return pot;
 }
 
-int image_array_resize_POT(SOIL_ImageArray *imgArray)
+int image_array_resize_POT(SOIL_ImageArray *imgArray, int max_size)
 {
     if (!imgArray || !imgArray->data)
         return 1;
 
-    int new_w = image_next_power_of_two(imgArray->width);
-    int new_h = image_next_power_of_two(imgArray->height);
+    int new_w = image_array_POT_size(imgArray->width, max_size);
+    int new_h = image_array_POT_size(imgArray->height, max_size);
 
     if (new_w == imgArray->width && new_h == imgArray->height)
         return 1;
@@ -223,15 +145,26 @@ int image_array_resize_POT(SOIL_ImageArray *imgArray)
         if (!dst)
             return 0;
 
-        up_scale_image(
-            src,
-            imgArray->width,
-            imgArray->height,
-            imgArray->channels,
-            dst,
-            new_w,
-            new_h
-        );
+        if (new_w <= imgArray->width && new_h <= imgArray->height)
+            down_scale_image(
+                src,
+                imgArray->width,
+                imgArray->height,
+                imgArray->channels,
+                dst,
+                new_w,
+                new_h
+            );
+        else
+            up_scale_image(
+                src,
+                imgArray->width,
+                imgArray->height,
+                imgArray->channels,
+                dst,
+                new_w,
+                new_h
+            );
 
         free(src);
         imgArray->data[layer] = dst;
@@ -301,7 +234,8 @@ int image_array_resize_POT_f32(
 	int layers,
 	int channels,
 	int *width,
-	int *height
+	int *height,
+	int max_size
 )
 {
 	if( width == NULL || height == NULL )
@@ -309,8 +243,8 @@ int image_array_resize_POT_f32(
 		return 0;
 	}
 
-	const int new_width = image_next_power_of_two( *width );
-	const int new_height = image_next_power_of_two( *height );
+	const int new_width = image_array_POT_size( *width, max_size );
+	const int new_height = image_array_POT_size( *height, max_size );
 
 	if( !image_array_resize_f32(
 		data, layers, channels, *width, *height, new_width, new_height ) )
@@ -323,6 +257,63 @@ int image_array_resize_POT_f32(
 	return 1;
 }
 
+int image_array_make_next_mipmap_into_f32(
+	const float *data,
+	int channels,
+	int width,
+	int height,
+	float *mipmap,
+	int *new_width,
+	int *new_height
+)
+{
+	int x, y, channel, u, v;
+
+	if( data == NULL || mipmap == NULL || channels < 1 || width < 1 ||
+		height < 1 || new_width == NULL || new_height == NULL )
+	{
+		return 0;
+	}
+
+	*new_width = width > 1 ? width / 2 : 1;
+	*new_height = height > 1 ? height / 2 : 1;
+
+	for( y = 0; y < *new_height; ++y )
+	{
+		int y_index[3];
+		float y_weight[3];
+		const int y_taps = mipmap_axis_taps(
+			y, height, *new_height, y_index, y_weight );
+		float *out = mipmap + (size_t)y * (*new_width) * channels;
+		for( x = 0; x < *new_width; ++x )
+		{
+			int x_index[3];
+			float x_weight[3];
+			const int x_taps = mipmap_axis_taps(
+				x, width, *new_width, x_index, x_weight );
+			for( channel = 0; channel < channels; ++channel )
+			{
+				float sum = 0.0f;
+				for( v = 0; v < y_taps; ++v )
+				{
+					const float *row =
+						data + (size_t)y_index[v] * width * channels + channel;
+					float row_sum = 0.0f;
+					for( u = 0; u < x_taps; ++u )
+					{
+						row_sum += row[x_index[u] * channels] * x_weight[u];
+					}
+					sum += row_sum * y_weight[v];
+				}
+				out[channel] = sum;
+			}
+			out += channels;
+		}
+	}
+
+	return 1;
+}
+
 float *image_array_make_next_mipmap_f32(
 	const float *data,
 	int channels,
@@ -333,7 +324,8 @@ float *image_array_make_next_mipmap_f32(
 )
 {
 	float *mipmap;
-	int x, y, channel;
+	const int mip_width = width > 1 ? width / 2 : 1;
+	const int mip_height = height > 1 ? height / 2 : 1;
 
 	if( data == NULL || channels < 1 || width < 1 || height < 1 ||
 		new_width == NULL || new_height == NULL )
@@ -341,35 +333,16 @@ float *image_array_make_next_mipmap_f32(
 		return NULL;
 	}
 
-	*new_width = width > 1 ? (width + 1) / 2 : 1;
-	*new_height = height > 1 ? (height + 1) / 2 : 1;
 	mipmap = (float *)malloc(
-		(size_t)(*new_width) * (size_t)(*new_height) *
+		(size_t)mip_width * (size_t)mip_height *
 		(size_t)channels * sizeof(float) );
 	if( mipmap == NULL )
 	{
 		return NULL;
 	}
 
-	for( y = 0; y < *new_height; ++y )
-	{
-		for( x = 0; x < *new_width; ++x )
-		{
-			const int x0 = x * 2;
-			const int y0 = y * 2;
-			const int x1 = x0 + 1 < width ? x0 + 1 : x0;
-			const int y1 = y0 + 1 < height ? y0 + 1 : y0;
-			for( channel = 0; channel < channels; ++channel )
-			{
-				mipmap[(y * (*new_width) + x) * channels + channel] =
-					(data[(y0 * width + x0) * channels + channel] +
-					 data[(y0 * width + x1) * channels + channel] +
-					 data[(y1 * width + x0) * channels + channel] +
-					 data[(y1 * width + x1) * channels + channel]) * 0.25f;
-			}
-		}
-	}
-
+	image_array_make_next_mipmap_into_f32(
+		data, channels, width, height, mipmap, new_width, new_height );
 	return mipmap;
 }
 
@@ -382,17 +355,8 @@ int image_array_reduce_to_max(SOIL_ImageArray *imgArray, int max_size)
         imgArray->height <= max_size)
         return 1;
 
-    int reduce_block_x = 1;
-    int reduce_block_y = 1;
-
-    if (imgArray->width > max_size)
-        reduce_block_x = imgArray->width / max_size;
-
-    if (imgArray->height > max_size)
-        reduce_block_y = imgArray->height / max_size;
-
-    int new_w = imgArray->width  / reduce_block_x;
-    int new_h = imgArray->height / reduce_block_y;
+    int new_w = imgArray->width  > max_size ? max_size : imgArray->width;
+    int new_h = imgArray->height > max_size ? max_size : imgArray->height;
 
     for (int layer = 0; layer < imgArray->layers; ++layer) {
 
@@ -407,14 +371,14 @@ int image_array_reduce_to_max(SOIL_ImageArray *imgArray, int max_size)
         if (!dst)
             return 0;
 
-        mipmap_image(
+        down_scale_image(
             src,
             imgArray->width,
             imgArray->height,
             imgArray->channels,
             dst,
-            reduce_block_x,
-            reduce_block_y
+            new_w,
+            new_h
         );
 
         free(src);
@@ -441,10 +405,7 @@ SOIL_ImageArray extract_image_array_from_atlas_grid(
         return result;
 
     if (atlasW % cols != 0 || atlasH % rows != 0)
-    {
-        result_string_pointer = "Atlas cannot be evenly divided by grid";
         return result;
-    }
 
     int tile_w = atlasW / cols;
     int tile_h = atlasH / rows;
@@ -33,10 +33,6 @@ void SOIL_image_array_free(SOIL_ImageArray *imgArray);
 /* Frees floating-point image layers and clears their pointers. */
 void image_array_free_f32( float **data, int layers );
 
-/* Vertically flips all layers in-place.
-   Does nothing if imgArray is NULL or invalid. */
-void image_array_invert_y(SOIL_ImageArray *imgArray);
-
 /* Vertically flips floating-point image layers in-place. */
 void image_array_invert_y_f32(
 	float **data,
@@ -46,21 +42,15 @@ void image_array_invert_y_f32(
 	int channels
 );
 
-/* Premultiplies RGB channels by alpha (if present).
-   Requires channels >= 4; otherwise does nothing. */
-void image_array_premultiply_alpha(SOIL_ImageArray *imgArray);
-
-/* Converts RGB data to NTSC-safe color range.
-   Requires channels >= 3; otherwise does nothing. */
-void image_array_to_NTSC_safe(SOIL_ImageArray *imgArray);
-
-/* Converts RGB data to YCoCg color space.
-   Requires channels >= 3; otherwise does nothing. */
-void image_array_to_YCoCg(SOIL_ImageArray *imgArray);
+/* Applies the transform_image operations (IMAGE_TRANSFORM_*) to all
+   layers in-place, in a single pass per layer.
+   Returns non-zero on success, zero on failure. */
+int image_array_transform(SOIL_ImageArray *imgArray, unsigned int operations);
 
-/* Resizes all layers to the nearest power-of-two dimensions.
+/* Resizes all layers to the nearest power-of-two dimensions, no larger
+   than max_size (halved back down when max_size isn't a power of two).
    Returns non-zero on success, zero on failure. */
-int image_array_resize_POT(SOIL_ImageArray *imgArray);
+int image_array_resize_POT(SOIL_ImageArray *imgArray, int max_size);
 
 /* Resizes floating-point image layers to explicit dimensions.
    The function replaces and frees each non-NULL layer on success. */
@@ -74,16 +64,34 @@ int image_array_resize_f32(
 	int new_height
 );
 
-/* Resizes floating-point image layers to power-of-two dimensions. */
+/* Resizes floating-point image layers to power-of-two dimensions, no
+   larger than max_size. */
 int image_array_resize_POT_f32(
 	float **data,
 	int layers,
 	int channels,
 	int *width,
-	int *height
+	int *height,
+	int max_size
+);
+
+/* Writes the next floating-point mip level into caller-provided memory,
+   which must hold (width/2) * (height/2) * channels floats (each at
+   least 1).  Follows the OpenGL floor(n/2) chain, odd sizes are reduced
+   with a 3 tap polyphase box.
+   Lets a whole mip chain reuse one scratch allocation.
+   Returns non-zero on success, zero on failure. */
+int image_array_make_next_mipmap_into_f32(
+	const float *data,
+	int channels,
+	int width,
+	int height,
+	float *mipmap,
+	int *new_width,
+	int *new_height
 );
 
-/* Creates the next floating-point mip level using a box filter.
+/* Creates the next floating-point mip level, see above.
    The caller owns the returned buffer. */
 float *image_array_make_next_mipmap_f32(
 	const float *data,
@@ -95,7 +103,7 @@ float *image_array_make_next_mipmap_f32(
 );
 
 /* Reduces all layers so that width and height do not exceed max_size.
-   Aspect ratio is preserved.
+   Each oversized dimension is area averaged straight down to max_size.
    Returns non-zero on success, zero on failure. */
 int image_array_reduce_to_max(SOIL_ImageArray *imgArray, int max_size);
 
@@ -7,9 +7,15 @@
 */
 
 #include "image_helper.h"
+#include "image_simd.h"
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 
+#if defined( SOIL_SIMD_AVX2 ) && defined( _MSC_VER )
+	#include <intrin.h>
+#endif
+
 int image_next_power_of_two( int value )
 {
 	int result = 1;
@@ -91,6 +97,148 @@ int
     return 1;
 }
 
+/*	Downscaling the image uses an area average	*/
+int
+	down_scale_image
+	(
+		const unsigned char* const orig,
+		int width, int height, int channels,
+		unsigned char* resampled,
+		int resampled_width, int resampled_height
+	)
+{
+	float scale_x, scale_y, normalize;
+	int *x_first, *x_last;
+	float *x_weight_first, *x_weight_last;
+	float *row_sum, *accum;
+	int i, j, c;
+
+	/*	error(s) check	*/
+	if( (width < 1) || (height < 1) ||
+		(resampled_width < 1) || (resampled_height < 1) ||
+		(resampled_width > width) || (resampled_height > height) ||
+		(channels < 1) ||
+		(NULL == orig) || (NULL == resampled) )
+	{
+		/*	signify badness	*/
+		return 0;
+	}
+	scale_x = (float)width / (float)resampled_width;
+	scale_y = (float)height / (float)resampled_height;
+	normalize = 1.0f / (scale_x * scale_y);
+
+	/*	the horizontal footprint is the same for every row,
+		so work out the partial texels at each end once	*/
+	x_first = (int*)malloc( resampled_width * sizeof(int) );
+	x_last = (int*)malloc( resampled_width * sizeof(int) );
+	x_weight_first = (float*)malloc( resampled_width * sizeof(float) );
+	x_weight_last = (float*)malloc( resampled_width * sizeof(float) );
+	row_sum = (float*)malloc( resampled_width * channels * sizeof(float) );
+	accum = (float*)malloc( resampled_width * channels * sizeof(float) );
+	if( (NULL == x_first) || (NULL == x_last) || (NULL == x_weight_first) || (NULL == x_weight_last) ||
+		(NULL == row_sum) || (NULL == accum) )
+	{
+		free( x_first );
+		free( x_last );
+		free( x_weight_first );
+		free( x_weight_last );
+		free( row_sum );
+		free( accum );
+		return 0;
+	}
+	for( i = 0; i < resampled_width; ++i )
+	{
+		const float x0 = i * scale_x;
+		const float x1 = (i + 1 == resampled_width) ? (float)width : (i + 1) * scale_x;
+		int first = (int)x0;
+		int last = (int)ceil( x1 ) - 1;
+		if( last >= width )
+		{
+			last = width - 1;
+		}
+		if( last < first )
+		{
+			last = first;
+		}
+		x_first[i] = first;
+		x_last[i] = last;
+		if( first == last )
+		{
+			x_weight_first[i] = x1 - x0;
+			x_weight_last[i] = 0.0f;
+		} else
+		{
+			x_weight_first[i] = (first + 1) - x0;
+			x_weight_last[i] = x1 - last;
+		}
+	}
+
+	for( j = 0; j < resampled_height; ++j )
+	{
+		const float y0 = j * scale_y;
+		const float y1 = (j + 1 == resampled_height) ? (float)height : (j + 1) * scale_y;
+		int y = (int)y0;
+		int y_end = (int)ceil( y1 );
+		if( y_end > height )
+		{
+			y_end = height;
+		}
+		for( i = 0; i < resampled_width * channels; ++i )
+		{
+			accum[i] = 0.0f;
+		}
+		/*	the window of source rows this output row covers	*/
+		for( ; y < y_end; ++y )
+		{
+			const unsigned char *row = orig + y * width * channels;
+			const float top = (y < y0) ? y0 : (float)y;
+			const float bottom = (y + 1 > y1) ? y1 : (float)(y + 1);
+			const float weight_y = bottom - top;
+			if( weight_y <= 0.0f )
+			{
+				continue;
+			}
+			for( i = 0; i < resampled_width; ++i )
+			{
+				const int first = x_first[i];
+				const int last = x_last[i];
+				int x;
+				for( c = 0; c < channels; ++c )
+				{
+					float sum = row[first * channels + c] * x_weight_first[i];
+					if( last > first )
+					{
+						for( x = first + 1; x < last; ++x )
+						{
+							sum += row[x * channels + c];
+						}
+						sum += row[last * channels + c] * x_weight_last[i];
+					}
+					row_sum[i * channels + c] = sum;
+				}
+			}
+			for( i = 0; i < resampled_width * channels; ++i )
+			{
+				accum[i] += row_sum[i] * weight_y;
+			}
+		}
+		for( i = 0; i < resampled_width * channels; ++i )
+		{
+			const int value = (int)( accum[i] * normalize + 0.5f );
+			resampled[j * resampled_width * channels + i] =
+				(unsigned char)( value > 255 ? 255 : value );
+		}
+	}
+
+	free( x_first );
+	free( x_last );
+	free( x_weight_first );
+	free( x_weight_last );
+	free( row_sum );
+	free( accum );
+	return 1;
+}
+
 int
 	resize_image_f32
 	(
@@ -146,6 +294,304 @@ int
 	return 1;
 }
 
+int image_simd_has_AVX2( void )
+{
+#if defined( SOIL_SIMD_AVX2 )
+	static int has_AVX2 = -1;
+	if( has_AVX2 < 0 )
+	{
+	#if defined( __GNUC__ )
+		__builtin_cpu_init();
+		has_AVX2 = __builtin_cpu_supports( "avx2" ) ? 1 : 0;
+	#else
+		int info[4];
+		int result = 0;
+		__cpuid( info, 0 );
+		if( info[0] >= 7 )
+		{
+			__cpuid( info, 1 );
+			/*	the OS must also save the YMM registers	*/
+			if( ( info[2] & ( 1 << 27 ) ) && ( info[2] & ( 1 << 28 ) ) &&
+				( ( _xgetbv( 0 ) & 6 ) == 6 ) )
+			{
+				__cpuidex( info, 7, 0 );
+				result = ( info[1] & ( 1 << 5 ) ) != 0;
+			}
+		}
+		has_AVX2 = result;
+	#endif
+	}
+	return has_AVX2;
+#else
+	return 0;
+#endif
+}
+
+/*	2x2 box filter over one pair of rows, every block is complete.
+	The rounding matches mipmap_image: (sum + 2) / 4	*/
+typedef void (*image_downsample_row_2x2_func)(
+	const unsigned char *row0, const unsigned char *row1,
+	unsigned char *out, int pairs, int channels, int first_pair );
+
+static void
+	downsample_row_2x2_C
+	(
+		const unsigned char *row0, const unsigned char *row1,
+		unsigned char *out, int pairs, int channels, int first_pair
+	)
+{
+	int i, c;
+	for( i = first_pair; i < pairs; ++i )
+	{
+		const int in = i * 2 * channels;
+		for( c = 0; c < channels; ++c )
+		{
+			out[i*channels + c] = (unsigned char)(( 2 +
+				row0[in + c] + row0[in + channels + c] +
+				row1[in + c] + row1[in + channels + c] ) >> 2);
+		}
+	}
+}
+
+#if defined( SOIL_SIMD_SSE2 )
+/*	adds the horizontal neighbours of 8 vertical sums (8 input bytes),
+	leaving the 4 results in the low 64 bits	*/
+static __m128i
+	downsample_pair_sum_SSE2( __m128i v, int channels )
+{
+	__m128i h;
+	switch( channels )
+	{
+	case 1:
+		h = _mm_add_epi16( v, _mm_srli_si128( v, 2 ) );
+		h = _mm_and_si128( h, _mm_set1_epi32( 0xFFFF ) );
+		return _mm_packs_epi32( h, h );
+	case 2:
+		h = _mm_add_epi16( v, _mm_srli_si128( v, 4 ) );
+		return _mm_shuffle_epi32( h, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+	default:
+		return _mm_add_epi16( v, _mm_srli_si128( v, 8 ) );
+	}
+}
+
+static void
+	downsample_row_2x2_SSE2
+	(
+		const unsigned char *row0, const unsigned char *row1,
+		unsigned char *out, int pairs, int channels, int first_pair
+	)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i two = _mm_set1_epi16( 2 );
+	const int out_bytes = pairs * channels;
+	/*	every output byte comes from 2 input bytes of each row	*/
+	int done = first_pair * channels;
+
+	if( channels == 3 )
+	{
+		/*	4 RGB texels per row in, 2 out	*/
+		const __m128i mask3 = _mm_set_epi16( 0, 0, 0, 0, 0, -1, -1, -1 );
+		for( ; done + 8 <= out_bytes; done += 6 )
+		{
+			const __m128i a = _mm_loadu_si128( (const __m128i*)( row0 + done*2 ) );
+			const __m128i b = _mm_loadu_si128( (const __m128i*)( row1 + done*2 ) );
+			const __m128i lo = _mm_add_epi16( _mm_unpacklo_epi8( a, zero ), _mm_unpacklo_epi8( b, zero ) );
+			const __m128i hi = _mm_add_epi16( _mm_unpackhi_epi8( a, zero ), _mm_unpackhi_epi8( b, zero ) );
+			/*	texels 2 and 3 straddle the two halves	*/
+			const __m128i mid = _mm_or_si128( _mm_srli_si128( lo, 12 ), _mm_slli_si128( hi, 4 ) );
+			const __m128i pa = _mm_add_epi16( lo, _mm_srli_si128( lo, 6 ) );
+			const __m128i pb = _mm_add_epi16( mid, _mm_srli_si128( mid, 6 ) );
+			__m128i sum = _mm_or_si128( _mm_and_si128( pa, mask3 ),
+				_mm_slli_si128( _mm_and_si128( pb, mask3 ), 6 ) );
+			int first4;
+			unsigned short last2;
+			sum = _mm_srli_epi16( _mm_add_epi16( sum, two ), 2 );
+			sum = _mm_packus_epi16( sum, zero );
+			first4 = _mm_cvtsi128_si32( sum );
+			last2 = (unsigned short)_mm_extract_epi16( sum, 2 );
+			memcpy( out + done, &first4, 4 );
+			memcpy( out + done + 4, &last2, 2 );
+		}
+	} else
+	{
+		/*	16 bytes per row in, 8 out	*/
+		for( ; done + 8 <= out_bytes; done += 8 )
+		{
+			const __m128i a = _mm_loadu_si128( (const __m128i*)( row0 + done*2 ) );
+			const __m128i b = _mm_loadu_si128( (const __m128i*)( row1 + done*2 ) );
+			__m128i lo = _mm_add_epi16( _mm_unpacklo_epi8( a, zero ), _mm_unpacklo_epi8( b, zero ) );
+			__m128i hi = _mm_add_epi16( _mm_unpackhi_epi8( a, zero ), _mm_unpackhi_epi8( b, zero ) );
+			__m128i sum;
+			lo = downsample_pair_sum_SSE2( lo, channels );
+			hi = downsample_pair_sum_SSE2( hi, channels );
+			sum = _mm_unpacklo_epi64( lo, hi );
+			sum = _mm_srli_epi16( _mm_add_epi16( sum, two ), 2 );
+			_mm_storel_epi64( (__m128i*)( out + done ), _mm_packus_epi16( sum, zero ) );
+		}
+	}
+
+	downsample_row_2x2_C( row0, row1, out, pairs, channels, done / channels );
+}
+#endif
+
+#if defined( SOIL_SIMD_AVX2 )
+/*	same as the SSE2 version, on each 128 bit lane	*/
+static SOIL_SIMD_TARGET_AVX2 __m256i
+	downsample_pair_sum_AVX2( __m256i v, int channels )
+{
+	__m256i h;
+	switch( channels )
+	{
+	case 1:
+		h = _mm256_add_epi16( v, _mm256_srli_si256( v, 2 ) );
+		h = _mm256_and_si256( h, _mm256_set1_epi32( 0xFFFF ) );
+		return _mm256_packus_epi32( h, h );
+	case 2:
+		h = _mm256_add_epi16( v, _mm256_srli_si256( v, 4 ) );
+		return _mm256_shuffle_epi32( h, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+	default:
+		return _mm256_add_epi16( v, _mm256_srli_si256( v, 8 ) );
+	}
+}
+
+static SOIL_SIMD_TARGET_AVX2 void
+	downsample_row_2x2_AVX2
+	(
+		const unsigned char *row0, const unsigned char *row1,
+		unsigned char *out, int pairs, int channels, int first_pair
+	)
+{
+	const __m256i two = _mm256_set1_epi16( 2 );
+	const int out_bytes = pairs * channels;
+	int done = first_pair * channels;
+
+	if( channels != 3 )
+	{
+		/*	32 bytes per row in, 16 out	*/
+		for( ; done + 16 <= out_bytes; done += 16 )
+		{
+			const __m256i a = _mm256_loadu_si256( (const __m256i*)( row0 + done*2 ) );
+			const __m256i b = _mm256_loadu_si256( (const __m256i*)( row1 + done*2 ) );
+			__m256i lo = _mm256_add_epi16(
+				_mm256_cvtepu8_epi16( _mm256_castsi256_si128( a ) ),
+				_mm256_cvtepu8_epi16( _mm256_castsi256_si128( b ) ) );
+			__m256i hi = _mm256_add_epi16(
+				_mm256_cvtepu8_epi16( _mm256_extracti128_si256( a, 1 ) ),
+				_mm256_cvtepu8_epi16( _mm256_extracti128_si256( b, 1 ) ) );
+			__m256i sum;
+			lo = downsample_pair_sum_AVX2( lo, channels );
+			hi = downsample_pair_sum_AVX2( hi, channels );
+			/*	undo the lane interleaving of unpack	*/
+			sum = _mm256_permute4x64_epi64( _mm256_unpacklo_epi64( lo, hi ), _MM_SHUFFLE( 3, 1, 2, 0 ) );
+			sum = _mm256_srli_epi16( _mm256_add_epi16( sum, two ), 2 );
+			sum = _mm256_packus_epi16( sum, sum );
+			sum = _mm256_permute4x64_epi64( sum, _MM_SHUFFLE( 0, 0, 2, 0 ) );
+			_mm_storeu_si128( (__m128i*)( out + done ), _mm256_castsi256_si128( sum ) );
+		}
+	}
+
+	downsample_row_2x2_SSE2( row0, row1, out, pairs, channels, done / channels );
+}
+#endif
+
+#if defined( SOIL_SIMD_NEON )
+static void
+	downsample_row_2x2_NEON
+	(
+		const unsigned char *row0, const unsigned char *row1,
+		unsigned char *out, int pairs, int channels, int first_pair
+	)
+{
+	/*	the structured loads split the channels, so every layout
+		is 16 texels per row in, 8 out	*/
+	int i = first_pair;
+
+	switch( channels )
+	{
+	case 1:
+		for( ; i + 8 <= pairs; i += 8 )
+		{
+			const uint8x16_t a = vld1q_u8( row0 + i*2 );
+			const uint8x16_t b = vld1q_u8( row1 + i*2 );
+			vst1_u8( out + i, vrshrn_n_u16( vaddq_u16( vpaddlq_u8( a ), vpaddlq_u8( b ) ), 2 ) );
+		}
+		break;
+	case 2:
+		for( ; i + 8 <= pairs; i += 8 )
+		{
+			const uint8x16x2_t a = vld2q_u8( row0 + i*4 );
+			const uint8x16x2_t b = vld2q_u8( row1 + i*4 );
+			uint8x8x2_t r;
+			r.val[0] = vrshrn_n_u16( vaddq_u16( vpaddlq_u8( a.val[0] ), vpaddlq_u8( b.val[0] ) ), 2 );
+			r.val[1] = vrshrn_n_u16( vaddq_u16( vpaddlq_u8( a.val[1] ), vpaddlq_u8( b.val[1] ) ), 2 );
+			vst2_u8( out + i*2, r );
+		}
+		break;
+	case 3:
+		for( ; i + 8 <= pairs; i += 8 )
+		{
+			const uint8x16x3_t a = vld3q_u8( row0 + i*6 );
+			const uint8x16x3_t b = vld3q_u8( row1 + i*6 );
+			uint8x8x3_t r;
+			r.val[0] = vrshrn_n_u16( vaddq_u16( vpaddlq_u8( a.val[0] ), vpaddlq_u8( b.val[0] ) ), 2 );
+			r.val[1] = vrshrn_n_u16( vaddq_u16( vpaddlq_u8( a.val[1] ), vpaddlq_u8( b.val[1] ) ), 2 );
+			r.val[2] = vrshrn_n_u16( vaddq_u16( vpaddlq_u8( a.val[2] ), vpaddlq_u8( b.val[2] ) ), 2 );
+			vst3_u8( out + i*3, r );
+		}
+		break;
+	case 4:
+		for( ; i + 8 <= pairs; i += 8 )
+		{
+			const uint8x16x4_t a = vld4q_u8( row0 + i*8 );
+			const uint8x16x4_t b = vld4q_u8( row1 + i*8 );
+			uint8x8x4_t r;
+			r.val[0] = vrshrn_n_u16( vaddq_u16( vpaddlq_u8( a.val[0] ), vpaddlq_u8( b.val[0] ) ), 2 );
+			r.val[1] = vrshrn_n_u16( vaddq_u16( vpaddlq_u8( a.val[1] ), vpaddlq_u8( b.val[1] ) ), 2 );
+			r.val[2] = vrshrn_n_u16( vaddq_u16( vpaddlq_u8( a.val[2] ), vpaddlq_u8( b.val[2] ) ), 2 );
+			r.val[3] = vrshrn_n_u16( vaddq_u16( vpaddlq_u8( a.val[3] ), vpaddlq_u8( b.val[3] ) ), 2 );
+			vst4_u8( out + i*4, r );
+		}
+		break;
+	}
+
+	downsample_row_2x2_C( row0, row1, out, pairs, channels, i );
+}
+#endif
+
+static void
+	downsample_row_2x2
+	(
+		const unsigned char *row0, const unsigned char *row1,
+		unsigned char *out, int pairs, int channels
+	)
+{
+	static image_downsample_row_2x2_func kernel = NULL;
+	if( kernel == NULL )
+	{
+		/*	pick once, every thread picks the same one	*/
+		image_downsample_row_2x2_func best = downsample_row_2x2_C;
+#if defined( SOIL_SIMD_NEON )
+		best = downsample_row_2x2_NEON;
+#endif
+#if defined( SOIL_SIMD_SSE2 )
+		best = downsample_row_2x2_SSE2;
+#endif
+#if defined( SOIL_SIMD_AVX2 )
+		if( image_simd_has_AVX2() )
+		{
+			best = downsample_row_2x2_AVX2;
+		}
+#endif
+		kernel = best;
+	}
+	if( channels > 4 )
+	{
+		downsample_row_2x2_C( row0, row1, out, pairs, channels, 0 );
+		return;
+	}
+	kernel( row0, row1, out, pairs, channels, 0 );
+}
+
 int
 	mipmap_image
 	(
@@ -177,6 +623,18 @@ int
 	{
 		mip_height = 1;
 	}
+	if( (block_size_x == 2) && (block_size_y == 2) &&
+		(width >= 2) && (height >= 2) )
+	{
+		/*	every block is a full 2x2 one, use the fast kernels	*/
+		for( j = 0; j < mip_height; ++j )
+		{
+			const unsigned char *row0 = orig + (j*2)*width*channels;
+			downsample_row_2x2( row0, row0 + width*channels,
+				resampled + j*mip_width*channels, mip_width, channels );
+		}
+		return 1;
+	}
 	for( j = 0; j < mip_height; ++j )
 	{
 		for( i = 0; i < mip_width; ++i )
@@ -216,38 +674,98 @@ int
 	return 1;
 }
 
+/*	Even sizes are a plain 2 tap box, odd sizes use the 3 tap
+	polyphase box so every source texel keeps its share.	*/
 int
-	scale_image_RGB_to_NTSC_safe
+	mipmap_axis_taps
 	(
-		unsigned char* orig,
-		int width, int height, int channels
+		int i, int size, int mip_size,
+		int *index, float *weight
 	)
 {
-	const float scale_lo = 16.0f - 0.499f;
-	const float scale_hi = 235.0f + 0.499f;
-	int i, j;
-	int nc = channels;
-	unsigned char scale_LUT[256];
+	if( size == 1 )
+	{
+		index[0] = 0;
+		weight[0] = 1.0f;
+		return 1;
+	}
+	if( (size & 1) == 0 )
+	{
+		index[0] = i*2;
+		index[1] = i*2 + 1;
+		weight[0] = weight[1] = 0.5f;
+		return 2;
+	}
+	index[0] = i*2;
+	index[1] = i*2 + 1;
+	index[2] = i*2 + 2;
+	weight[0] = (float)(mip_size - i) / (float)size;
+	weight[1] = (float)mip_size / (float)size;
+	weight[2] = (float)(i + 1) / (float)size;
+	return 3;
+}
+
+int
+	mipmap_image_next_level
+	(
+		const unsigned char* const orig,
+		int width, int height, int channels,
+		unsigned char* resampled
+	)
+{
+	int mip_width, mip_height;
+	int row_stride;
+	int i, j, c, u, v;
+
 	/*	error check	*/
 	if( (width < 1) || (height < 1) ||
-		(channels < 1) || (orig == NULL) )
+		(channels < 1) || (orig == NULL) ||
+		(resampled == NULL) )
 	{
 		/*	nothing to do	*/
 		return 0;
 	}
-	/*	set up the scaling Look Up Table	*/
-	for( i = 0; i < 256; ++i )
+	mip_width = width > 1 ? width / 2 : 1;
+	mip_height = height > 1 ? height / 2 : 1;
+	row_stride = width * channels;
+	if( ((width & 1) == 0) && ((height & 1) == 0) )
 	{
-		scale_LUT[i] = (unsigned char)((scale_hi - scale_lo) * i / 255.0f + scale_lo);
+		/*	the common case, full 2x2 blocks	*/
+		for( j = 0; j < mip_height; ++j )
+		{
+			const unsigned char *row0 = orig + (j*2)*row_stride;
+			downsample_row_2x2( row0, row0 + row_stride,
+				resampled + j*mip_width*channels, mip_width, channels );
+		}
+		return 1;
 	}
-	/*	for channels = 2 or 4, ignore the alpha component	*/
-	nc -= 1 - (channels & 1);
-	/*	OK, go through the image and scale any non-alpha components	*/
-	for( i = 0; i < width*height*channels; i += channels )
+	for( j = 0; j < mip_height; ++j )
 	{
-		for( j = 0; j < nc; ++j )
+		int y_index[3];
+		float y_weight[3];
+		const int y_taps = mipmap_axis_taps( j, height, mip_height, y_index, y_weight );
+		unsigned char *out = resampled + j*mip_width*channels;
+		for( i = 0; i < mip_width; ++i )
 		{
-			orig[i+j] = scale_LUT[orig[i+j]];
+			int x_index[3];
+			float x_weight[3];
+			const int x_taps = mipmap_axis_taps( i, width, mip_width, x_index, x_weight );
+			for( c = 0; c < channels; ++c )
+			{
+				float sum = 0.5f;
+				for( v = 0; v < y_taps; ++v )
+				{
+					const unsigned char *row = orig + y_index[v]*row_stride + c;
+					float row_sum = 0.0f;
+					for( u = 0; u < x_taps; ++u )
+					{
+						row_sum += row[x_index[u]*channels] * x_weight[u];
+					}
+					sum += row_sum * y_weight[v];
+				}
+				out[c] = (unsigned char)( sum > 255.0f ? 255 : (int)sum );
+			}
+			out += channels;
 		}
 	}
 	return 1;
@@ -255,6 +773,706 @@ int
 
 unsigned char clamp_byte( int x ) { return ( (x) < 0 ? (0) : ( (x) > 255 ? 255 : (x) ) ); }
 
+/*	the NTSC safe scale of [0,255] to [16,235], this integer form gives
+	the same bytes as ( 219.998f * i / 255 + 15.501f ) for every i	*/
+#define IMAGE_NTSC_SAFE_MUL		1767
+#define IMAGE_NTSC_SAFE_ADD		31720
+#define IMAGE_NTSC_SAFE_SHIFT	11
+
+/*	one row of transform_image from first_pixel on, every enabled
+	operation is applied to a pixel before it is written.  NTSC_LUT
+	is NULL unless IMAGE_TRANSFORM_NTSC_SAFE is set	*/
+typedef void (*image_transform_row_func)(
+	const unsigned char* src, unsigned char* dst,
+	int width, int channels, unsigned int operations,
+	const unsigned char* NTSC_LUT, int first_pixel );
+
+static void
+	transform_image_row_C
+	(
+		const unsigned char* src,
+		unsigned char* dst,
+		int width, int channels,
+		unsigned int operations,
+		const unsigned char* NTSC_LUT,
+		int first_pixel
+	)
+{
+	/*	for channels = 2 or 4, the last one is alpha	*/
+	const int color_channels = channels - (1 - (channels & 1));
+	const int premultiply = (operations & IMAGE_TRANSFORM_MULTIPLY_ALPHA) && !(channels & 1);
+	const int YCoCg = (operations & IMAGE_TRANSFORM_YCOCG) && (channels >= 3);
+	int x, c;
+	src += first_pixel * channels;
+	dst += first_pixel * channels;
+	for( x = first_pixel; x < width; ++x )
+	{
+		int p[4] = { 0, 0, 0, 0 };
+		for( c = 0; c < channels; ++c )
+		{
+			p[c] = src[c];
+		}
+		if( NULL != NTSC_LUT )
+		{
+			for( c = 0; c < color_channels; ++c )
+			{
+				p[c] = NTSC_LUT[p[c]];
+			}
+		}
+		if( premultiply )
+		{
+			const int a = p[channels-1];
+			for( c = 0; c < channels-1; ++c )
+			{
+				p[c] = (p[c] * a + 128) >> 8;
+			}
+		}
+		if( YCoCg )
+		{
+			const int r = p[0];
+			const int g = (p[1] + 1) >> 1;
+			const int b = p[2];
+			const int tmp = (2 + r + b) >> 2;
+			/*	Co	*/
+			dst[0] = clamp_byte( 128 + ((r - b + 1) >> 1) );
+			if( channels == 3 )
+			{
+				/*	Y, Cg	*/
+				dst[1] = clamp_byte( g + tmp );
+				dst[2] = clamp_byte( 128 + g - tmp );
+			} else
+			{
+				/*	Cg, Alpha, Y	*/
+				const int a = p[3];
+				dst[1] = clamp_byte( 128 + g - tmp );
+				dst[2] = (unsigned char)a;
+				dst[3] = clamp_byte( g + tmp );
+			}
+		} else
+		{
+			for( c = 0; c < channels; ++c )
+			{
+				dst[c] = (unsigned char)p[c];
+			}
+		}
+		src += channels;
+		dst += channels;
+	}
+}
+
+/*	YCoCg back to RGB, the inverse of the YCoCg operation above	*/
+typedef void (*image_YCoCg_to_RGB_row_func)(
+	unsigned char* pixels, int width, int channels, int first_pixel );
+
+static void
+	YCoCg_to_RGB_row_C
+	(
+		unsigned char* pixels,
+		int width, int channels,
+		int first_pixel
+	)
+{
+	int x;
+	pixels += first_pixel * channels;
+	for( x = first_pixel; x < width; ++x, pixels += channels )
+	{
+		if( channels == 3 )
+		{
+			int co = pixels[0] - 128;
+			int y  = pixels[1];
+			int cg = pixels[2] - 128;
+			/*	R	*/
+			pixels[0] = clamp_byte( y + co - cg );
+			/*	G	*/
+			pixels[1] = clamp_byte( y + cg );
+			/*	B	*/
+			pixels[2] = clamp_byte( y - co - cg );
+		} else
+		{
+			int co = pixels[0] - 128;
+			int cg = pixels[1] - 128;
+			unsigned char a  = pixels[2];
+			int y  = pixels[3];
+			/*	R	*/
+			pixels[0] = clamp_byte( y + co - cg );
+			/*	G	*/
+			pixels[1] = clamp_byte( y + cg );
+			/*	B	*/
+			pixels[2] = clamp_byte( y - co - cg );
+			/*	A	*/
+			pixels[3] = a;
+		}
+	}
+}
+
+#if defined( SOIL_SIMD_SSE2 )
+/*	the vector kernels work on 16 bit lanes holding RGBA pixels,
+	the 2x16 bit pixel broadcasts are two shuffles	*/
+#define IMAGE_SSE2_BROADCAST( v, c ) \
+	_mm_shufflehi_epi16( _mm_shufflelo_epi16( v, _MM_SHUFFLE( c, c, c, c ) ), _MM_SHUFFLE( c, c, c, c ) )
+
+/*	the NTSC scale of every lane, in 32 bits: (x * MUL + 1 * ADD) >> SHIFT	*/
+static __m128i
+	NTSC_safe_SSE2( __m128i v )
+{
+	const __m128i one = _mm_set1_epi16( 1 );
+	const __m128i scale = _mm_set1_epi32( ( IMAGE_NTSC_SAFE_ADD << 16 ) | IMAGE_NTSC_SAFE_MUL );
+	const __m128i lo = _mm_srai_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( v, one ), scale ), IMAGE_NTSC_SAFE_SHIFT );
+	const __m128i hi = _mm_srai_epi32( _mm_madd_epi16( _mm_unpackhi_epi16( v, one ), scale ), IMAGE_NTSC_SAFE_SHIFT );
+	return _mm_packs_epi32( lo, hi );
+}
+
+/*	two RGBA pixels in 16 bit lanes	*/
+static __m128i
+	transform_RGBA_SSE2( __m128i p, int NTSC, int premultiply, int YCoCg )
+{
+	const __m128i alpha_mask = _mm_set_epi16( -1, 0, 0, 0, -1, 0, 0, 0 );
+	if( NTSC )
+	{
+		p = _mm_or_si128( _mm_andnot_si128( alpha_mask, NTSC_safe_SSE2( p ) ), _mm_and_si128( alpha_mask, p ) );
+	}
+	if( premultiply )
+	{
+		/*	(c * a + 128) >> 8 never leaves 16 unsigned bits	*/
+		__m128i m = _mm_mullo_epi16( p, IMAGE_SSE2_BROADCAST( p, 3 ) );
+		m = _mm_srli_epi16( _mm_add_epi16( m, _mm_set1_epi16( 128 ) ), 8 );
+		p = _mm_or_si128( _mm_andnot_si128( alpha_mask, m ), _mm_and_si128( alpha_mask, p ) );
+	}
+	if( YCoCg )
+	{
+		const __m128i c128 = _mm_set1_epi16( 128 );
+		const __m128i r = IMAGE_SSE2_BROADCAST( p, 0 );
+		const __m128i g = _mm_srli_epi16( _mm_add_epi16( IMAGE_SSE2_BROADCAST( p, 1 ), _mm_set1_epi16( 1 ) ), 1 );
+		const __m128i b = IMAGE_SSE2_BROADCAST( p, 2 );
+		const __m128i tmp = _mm_srli_epi16( _mm_add_epi16( _mm_add_epi16( r, b ), _mm_set1_epi16( 2 ) ), 2 );
+		const __m128i co = _mm_add_epi16( c128, _mm_srai_epi16( _mm_add_epi16( _mm_sub_epi16( r, b ), _mm_set1_epi16( 1 ) ), 1 ) );
+		const __m128i cg = _mm_sub_epi16( _mm_add_epi16( c128, g ), tmp );
+		const __m128i y = _mm_add_epi16( g, tmp );
+		/*	Co, Cg, Alpha, Y, the final pack clamps to [0,255]	*/
+		p = _mm_or_si128(
+			_mm_or_si128(
+				_mm_and_si128( co, _mm_set_epi16( 0, 0, 0, -1, 0, 0, 0, -1 ) ),
+				_mm_and_si128( cg, _mm_set_epi16( 0, 0, -1, 0, 0, 0, -1, 0 ) ) ),
+			_mm_or_si128(
+				_mm_and_si128( IMAGE_SSE2_BROADCAST( p, 3 ), _mm_set_epi16( 0, -1, 0, 0, 0, -1, 0, 0 ) ),
+				_mm_and_si128( y, _mm_set_epi16( -1, 0, 0, 0, -1, 0, 0, 0 ) ) ) );
+	}
+	return p;
+}
+
+static void
+	transform_image_row_SSE2
+	(
+		const unsigned char* src,
+		unsigned char* dst,
+		int width, int channels,
+		unsigned int operations,
+		const unsigned char* NTSC_LUT,
+		int first_pixel
+	)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const int NTSC = NULL != NTSC_LUT;
+	int x = first_pixel;
+
+	if( channels == 4 )
+	{
+		const int premultiply = (operations & IMAGE_TRANSFORM_MULTIPLY_ALPHA) != 0;
+		const int YCoCg = (operations & IMAGE_TRANSFORM_YCOCG) != 0;
+		/*	4 pixels at a time	*/
+		for( ; x + 4 <= width; x += 4 )
+		{
+			const __m128i v = _mm_loadu_si128( (const __m128i*)( src + x*4 ) );
+			const __m128i lo = transform_RGBA_SSE2( _mm_unpacklo_epi8( v, zero ), NTSC, premultiply, YCoCg );
+			const __m128i hi = transform_RGBA_SSE2( _mm_unpackhi_epi8( v, zero ), NTSC, premultiply, YCoCg );
+			_mm_storeu_si128( (__m128i*)( dst + x*4 ), _mm_packus_epi16( lo, hi ) );
+		}
+	} else if( NTSC && (channels & 1) && !(operations & (IMAGE_TRANSFORM_MULTIPLY_ALPHA | IMAGE_TRANSFORM_YCOCG)) )
+	{
+		/*	no alpha, so every byte is scaled the same way	*/
+		const int bytes = width * channels;
+		int done = x * channels;
+		for( ; done + 16 <= bytes; done += 16 )
+		{
+			const __m128i v = _mm_loadu_si128( (const __m128i*)( src + done ) );
+			_mm_storeu_si128( (__m128i*)( dst + done ), _mm_packus_epi16(
+				NTSC_safe_SSE2( _mm_unpacklo_epi8( v, zero ) ),
+				NTSC_safe_SSE2( _mm_unpackhi_epi8( v, zero ) ) ) );
+		}
+		/*	the tail may start inside a pixel	*/
+		for( ; done < bytes; ++done )
+		{
+			dst[done] = NTSC_LUT[src[done]];
+		}
+		return;
+	}
+
+	transform_image_row_C( src, dst, width, channels, operations, NTSC_LUT, x );
+}
+
+/*	two CoCgAY pixels in 16 bit lanes back to RGBA	*/
+static __m128i
+	YCoCg_to_RGBA_SSE2( __m128i p )
+{
+	const __m128i c128 = _mm_set1_epi16( 128 );
+	const __m128i co = _mm_sub_epi16( IMAGE_SSE2_BROADCAST( p, 0 ), c128 );
+	const __m128i cg = _mm_sub_epi16( IMAGE_SSE2_BROADCAST( p, 1 ), c128 );
+	const __m128i y = IMAGE_SSE2_BROADCAST( p, 3 );
+	/*	R = y + co - cg, G = y + cg, B = y - co - cg	*/
+	const __m128i rgb = _mm_add_epi16( y, _mm_or_si128(
+		_mm_or_si128(
+			_mm_and_si128( _mm_sub_epi16( co, cg ), _mm_set_epi16( 0, 0, 0, -1, 0, 0, 0, -1 ) ),
+			_mm_and_si128( cg, _mm_set_epi16( 0, 0, -1, 0, 0, 0, -1, 0 ) ) ),
+		_mm_and_si128( _mm_sub_epi16( _mm_setzero_si128(), _mm_add_epi16( co, cg ) ),
+			_mm_set_epi16( 0, -1, 0, 0, 0, -1, 0, 0 ) ) ) );
+	const __m128i alpha_mask = _mm_set_epi16( -1, 0, 0, 0, -1, 0, 0, 0 );
+	return _mm_or_si128( _mm_andnot_si128( alpha_mask, rgb ),
+		_mm_and_si128( alpha_mask, IMAGE_SSE2_BROADCAST( p, 2 ) ) );
+}
+
+static void
+	YCoCg_to_RGB_row_SSE2
+	(
+		unsigned char* pixels,
+		int width, int channels,
+		int first_pixel
+	)
+{
+	const __m128i zero = _mm_setzero_si128();
+	int x = first_pixel;
+	if( channels == 4 )
+	{
+		for( ; x + 4 <= width; x += 4 )
+		{
+			const __m128i v = _mm_loadu_si128( (const __m128i*)( pixels + x*4 ) );
+			_mm_storeu_si128( (__m128i*)( pixels + x*4 ), _mm_packus_epi16(
+				YCoCg_to_RGBA_SSE2( _mm_unpacklo_epi8( v, zero ) ),
+				YCoCg_to_RGBA_SSE2( _mm_unpackhi_epi8( v, zero ) ) ) );
+		}
+	}
+	YCoCg_to_RGB_row_C( pixels, width, channels, x );
+}
+#endif
+
+#if defined( SOIL_SIMD_AVX2 )
+/*	same as the SSE2 versions, on each 128 bit lane	*/
+#define IMAGE_AVX2_BROADCAST( v, c ) \
+	_mm256_shufflehi_epi16( _mm256_shufflelo_epi16( v, _MM_SHUFFLE( c, c, c, c ) ), _MM_SHUFFLE( c, c, c, c ) )
+
+static SOIL_SIMD_TARGET_AVX2 __m256i
+	NTSC_safe_AVX2( __m256i v )
+{
+	const __m256i one = _mm256_set1_epi16( 1 );
+	const __m256i scale = _mm256_set1_epi32( ( IMAGE_NTSC_SAFE_ADD << 16 ) | IMAGE_NTSC_SAFE_MUL );
+	const __m256i lo = _mm256_srai_epi32( _mm256_madd_epi16( _mm256_unpacklo_epi16( v, one ), scale ), IMAGE_NTSC_SAFE_SHIFT );
+	const __m256i hi = _mm256_srai_epi32( _mm256_madd_epi16( _mm256_unpackhi_epi16( v, one ), scale ), IMAGE_NTSC_SAFE_SHIFT );
+	return _mm256_packs_epi32( lo, hi );
+}
+
+static SOIL_SIMD_TARGET_AVX2 __m256i
+	transform_RGBA_AVX2( __m256i p, int NTSC, int premultiply, int YCoCg )
+{
+	if( NTSC )
+	{
+		p = _mm256_blend_epi16( NTSC_safe_AVX2( p ), p, 0x88 );
+	}
+	if( premultiply )
+	{
+		__m256i m = _mm256_mullo_epi16( p, IMAGE_AVX2_BROADCAST( p, 3 ) );
+		m = _mm256_srli_epi16( _mm256_add_epi16( m, _mm256_set1_epi16( 128 ) ), 8 );
+		p = _mm256_blend_epi16( m, p, 0x88 );
+	}
+	if( YCoCg )
+	{
+		const __m256i c128 = _mm256_set1_epi16( 128 );
+		const __m256i r = IMAGE_AVX2_BROADCAST( p, 0 );
+		const __m256i g = _mm256_srli_epi16( _mm256_add_epi16( IMAGE_AVX2_BROADCAST( p, 1 ), _mm256_set1_epi16( 1 ) ), 1 );
+		const __m256i b = IMAGE_AVX2_BROADCAST( p, 2 );
+		const __m256i tmp = _mm256_srli_epi16( _mm256_add_epi16( _mm256_add_epi16( r, b ), _mm256_set1_epi16( 2 ) ), 2 );
+		const __m256i co = _mm256_add_epi16( c128, _mm256_srai_epi16( _mm256_add_epi16( _mm256_sub_epi16( r, b ), _mm256_set1_epi16( 1 ) ), 1 ) );
+		const __m256i cg = _mm256_sub_epi16( _mm256_add_epi16( c128, g ), tmp );
+		const __m256i y = _mm256_add_epi16( g, tmp );
+		/*	Co, Cg, Alpha, Y	*/
+		p = _mm256_blend_epi16(
+			_mm256_blend_epi16( co, cg, 0x22 ),
+			_mm256_blend_epi16( IMAGE_AVX2_BROADCAST( p, 3 ), y, 0x88 ), 0xCC );
+	}
+	return p;
+}
+
+static SOIL_SIMD_TARGET_AVX2 void
+	transform_image_row_AVX2
+	(
+		const unsigned char* src,
+		unsigned char* dst,
+		int width, int channels,
+		unsigned int operations,
+		const unsigned char* NTSC_LUT,
+		int first_pixel
+	)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	int x = first_pixel;
+
+	if( channels == 4 )
+	{
+		const int NTSC = NULL != NTSC_LUT;
+		const int premultiply = (operations & IMAGE_TRANSFORM_MULTIPLY_ALPHA) != 0;
+		const int YCoCg = (operations & IMAGE_TRANSFORM_YCOCG) != 0;
+		/*	8 pixels at a time, unpack and pack undo each other per lane	*/
+		for( ; x + 8 <= width; x += 8 )
+		{
+			const __m256i v = _mm256_loadu_si256( (const __m256i*)( src + x*4 ) );
+			const __m256i lo = transform_RGBA_AVX2( _mm256_unpacklo_epi8( v, zero ), NTSC, premultiply, YCoCg );
+			const __m256i hi = transform_RGBA_AVX2( _mm256_unpackhi_epi8( v, zero ), NTSC, premultiply, YCoCg );
+			_mm256_storeu_si256( (__m256i*)( dst + x*4 ), _mm256_packus_epi16( lo, hi ) );
+		}
+	}
+
+	transform_image_row_SSE2( src, dst, width, channels, operations, NTSC_LUT, x );
+}
+
+static SOIL_SIMD_TARGET_AVX2 __m256i
+	YCoCg_to_RGBA_AVX2( __m256i p )
+{
+	const __m256i c128 = _mm256_set1_epi16( 128 );
+	const __m256i co = _mm256_sub_epi16( IMAGE_AVX2_BROADCAST( p, 0 ), c128 );
+	const __m256i cg = _mm256_sub_epi16( IMAGE_AVX2_BROADCAST( p, 1 ), c128 );
+	const __m256i y = IMAGE_AVX2_BROADCAST( p, 3 );
+	/*	R = y + co - cg, G = y + cg, B = y - co - cg	*/
+	const __m256i rgb = _mm256_add_epi16( y, _mm256_blend_epi16(
+		_mm256_blend_epi16( _mm256_sub_epi16( co, cg ), cg, 0x22 ),
+		_mm256_sub_epi16( _mm256_setzero_si256(), _mm256_add_epi16( co, cg ) ), 0x44 ) );
+	return _mm256_blend_epi16( rgb, IMAGE_AVX2_BROADCAST( p, 2 ), 0x88 );
+}
+
+static SOIL_SIMD_TARGET_AVX2 void
+	YCoCg_to_RGB_row_AVX2
+	(
+		unsigned char* pixels,
+		int width, int channels,
+		int first_pixel
+	)
+{
+	const __m256i zero = _mm256_setzero_si256();
+	int x = first_pixel;
+	if( channels == 4 )
+	{
+		for( ; x + 8 <= width; x += 8 )
+		{
+			const __m256i v = _mm256_loadu_si256( (const __m256i*)( pixels + x*4 ) );
+			_mm256_storeu_si256( (__m256i*)( pixels + x*4 ), _mm256_packus_epi16(
+				YCoCg_to_RGBA_AVX2( _mm256_unpacklo_epi8( v, zero ) ),
+				YCoCg_to_RGBA_AVX2( _mm256_unpackhi_epi8( v, zero ) ) ) );
+		}
+	}
+	YCoCg_to_RGB_row_SSE2( pixels, width, channels, x );
+}
+#endif
+
+#if defined( SOIL_SIMD_NEON )
+/*	the structured loads split the channels, 8 pixels at a time	*/
+static uint8x8_t
+	NTSC_safe_NEON( uint8x8_t v )
+{
+	const uint16x8_t w = vmovl_u8( v );
+	const uint32x4_t add = vdupq_n_u32( IMAGE_NTSC_SAFE_ADD );
+	const uint32x4_t lo = vmlal_n_u16( add, vget_low_u16( w ), IMAGE_NTSC_SAFE_MUL );
+	const uint32x4_t hi = vmlal_n_u16( add, vget_high_u16( w ), IMAGE_NTSC_SAFE_MUL );
+	return vmovn_u16( vcombine_u16(
+		vshrn_n_u32( lo, IMAGE_NTSC_SAFE_SHIFT ),
+		vshrn_n_u32( hi, IMAGE_NTSC_SAFE_SHIFT ) ) );
+}
+
+/*	Co, Y and Cg of 8 pixels	*/
+static void
+	RGB_to_YCoCg_NEON( uint8x8_t r8, uint8x8_t g8, uint8x8_t b8, uint8x8_t *co, uint8x8_t *y, uint8x8_t *cg )
+{
+	const int16x8_t r = vreinterpretq_s16_u16( vmovl_u8( r8 ) );
+	const int16x8_t b = vreinterpretq_s16_u16( vmovl_u8( b8 ) );
+	const int16x8_t g = vreinterpretq_s16_u16( vshrq_n_u16( vaddw_u8( vdupq_n_u16( 1 ), g8 ), 1 ) );
+	const int16x8_t tmp = vreinterpretq_s16_u16( vshrq_n_u16( vaddq_u16( vaddl_u8( r8, b8 ), vdupq_n_u16( 2 ) ), 2 ) );
+	const int16x8_t c128 = vdupq_n_s16( 128 );
+	*co = vqmovun_s16( vaddq_s16( c128, vshrq_n_s16( vaddq_s16( vsubq_s16( r, b ), vdupq_n_s16( 1 ) ), 1 ) ) );
+	*y = vqmovun_s16( vaddq_s16( g, tmp ) );
+	*cg = vqmovun_s16( vsubq_s16( vaddq_s16( c128, g ), tmp ) );
+}
+
+static void
+	transform_image_row_NEON
+	(
+		const unsigned char* src,
+		unsigned char* dst,
+		int width, int channels,
+		unsigned int operations,
+		const unsigned char* NTSC_LUT,
+		int first_pixel
+	)
+{
+	const int NTSC = NULL != NTSC_LUT;
+	const int premultiply = (operations & IMAGE_TRANSFORM_MULTIPLY_ALPHA) != 0;
+	const int YCoCg = (operations & IMAGE_TRANSFORM_YCOCG) != 0;
+	int x = first_pixel;
+	int c;
+
+	switch( channels )
+	{
+	case 2:
+		for( ; x + 8 <= width; x += 8 )
+		{
+			uint8x8x2_t p = vld2_u8( src + x*2 );
+			if( NTSC )
+				p.val[0] = NTSC_safe_NEON( p.val[0] );
+			if( premultiply )
+				p.val[0] = vrshrn_n_u16( vmull_u8( p.val[0], p.val[1] ), 8 );
+			vst2_u8( dst + x*2, p );
+		}
+		break;
+	case 3:
+		for( ; x + 8 <= width; x += 8 )
+		{
+			uint8x8x3_t p = vld3_u8( src + x*3 );
+			if( NTSC )
+				for( c = 0; c < 3; ++c )
+					p.val[c] = NTSC_safe_NEON( p.val[c] );
+			if( YCoCg )
+			{
+				uint8x8x3_t out;
+				RGB_to_YCoCg_NEON( p.val[0], p.val[1], p.val[2], &out.val[0], &out.val[1], &out.val[2] );
+				p = out;
+			}
+			vst3_u8( dst + x*3, p );
+		}
+		break;
+	case 4:
+		for( ; x + 8 <= width; x += 8 )
+		{
+			uint8x8x4_t p = vld4_u8( src + x*4 );
+			if( NTSC )
+				for( c = 0; c < 3; ++c )
+					p.val[c] = NTSC_safe_NEON( p.val[c] );
+			/*	(c * a + 128) >> 8 is a rounding narrow	*/
+			if( premultiply )
+				for( c = 0; c < 3; ++c )
+					p.val[c] = vrshrn_n_u16( vmull_u8( p.val[c], p.val[3] ), 8 );
+			if( YCoCg )
+			{
+				uint8x8x4_t out;
+				/*	Co, Cg, Alpha, Y	*/
+				RGB_to_YCoCg_NEON( p.val[0], p.val[1], p.val[2], &out.val[0], &out.val[3], &out.val[1] );
+				out.val[2] = p.val[3];
+				p = out;
+			}
+			vst4_u8( dst + x*4, p );
+		}
+		break;
+	}
+
+	transform_image_row_C( src, dst, width, channels, operations, NTSC_LUT, x );
+}
+
+static void
+	YCoCg_to_RGB_row_NEON
+	(
+		unsigned char* pixels,
+		int width, int channels,
+		int first_pixel
+	)
+{
+	const int16x8_t c128 = vdupq_n_s16( 128 );
+	int x = first_pixel;
+	if( channels >= 3 )
+	{
+		for( ; x + 8 <= width; x += 8 )
+		{
+			uint8x8x4_t p;
+			int16x8_t co, y, cg;
+			if( channels == 3 )
+			{
+				uint8x8x3_t q = vld3_u8( pixels + x*3 );
+				co = vreinterpretq_s16_u16( vmovl_u8( q.val[0] ) );
+				y = vreinterpretq_s16_u16( vmovl_u8( q.val[1] ) );
+				cg = vreinterpretq_s16_u16( vmovl_u8( q.val[2] ) );
+			} else
+			{
+				p = vld4_u8( pixels + x*4 );
+				co = vreinterpretq_s16_u16( vmovl_u8( p.val[0] ) );
+				cg = vreinterpretq_s16_u16( vmovl_u8( p.val[1] ) );
+				y = vreinterpretq_s16_u16( vmovl_u8( p.val[3] ) );
+				p.val[3] = p.val[2];
+			}
+			co = vsubq_s16( co, c128 );
+			cg = vsubq_s16( cg, c128 );
+			/*	R, G, B	*/
+			p.val[0] = vqmovun_s16( vaddq_s16( y, vsubq_s16( co, cg ) ) );
+			p.val[1] = vqmovun_s16( vaddq_s16( y, cg ) );
+			p.val[2] = vqmovun_s16( vsubq_s16( y, vaddq_s16( co, cg ) ) );
+			if( channels == 3 )
+			{
+				uint8x8x3_t q;
+				q.val[0] = p.val[0];
+				q.val[1] = p.val[1];
+				q.val[2] = p.val[2];
+				vst3_u8( pixels + x*3, q );
+			} else
+			{
+				vst4_u8( pixels + x*4, p );
+			}
+		}
+	}
+	YCoCg_to_RGB_row_C( pixels, width, channels, x );
+}
+#endif
+
+/*	pick the kernels once, every thread picks the same ones	*/
+static image_transform_row_func
+	transform_image_row_kernel( void )
+{
+	static image_transform_row_func kernel = NULL;
+	if( kernel == NULL )
+	{
+		image_transform_row_func best = transform_image_row_C;
+#if defined( SOIL_SIMD_NEON )
+		best = transform_image_row_NEON;
+#endif
+#if defined( SOIL_SIMD_SSE2 )
+		best = transform_image_row_SSE2;
+#endif
+#if defined( SOIL_SIMD_AVX2 )
+		if( image_simd_has_AVX2() )
+		{
+			best = transform_image_row_AVX2;
+		}
+#endif
+		kernel = best;
+	}
+	return kernel;
+}
+
+static image_YCoCg_to_RGB_row_func
+	YCoCg_to_RGB_row_kernel( void )
+{
+	static image_YCoCg_to_RGB_row_func kernel = NULL;
+	if( kernel == NULL )
+	{
+		image_YCoCg_to_RGB_row_func best = YCoCg_to_RGB_row_C;
+#if defined( SOIL_SIMD_NEON )
+		best = YCoCg_to_RGB_row_NEON;
+#endif
+#if defined( SOIL_SIMD_SSE2 )
+		best = YCoCg_to_RGB_row_SSE2;
+#endif
+#if defined( SOIL_SIMD_AVX2 )
+		if( image_simd_has_AVX2() )
+		{
+			best = YCoCg_to_RGB_row_AVX2;
+		}
+#endif
+		kernel = best;
+	}
+	return kernel;
+}
+
+static void
+	transform_image_row
+	(
+		const unsigned char* src,
+		unsigned char* dst,
+		int width, int channels,
+		unsigned int operations,
+		const unsigned char* NTSC_LUT
+	)
+{
+	if( !(operations & ~IMAGE_TRANSFORM_INVERT_Y) )
+	{
+		/*	only moving rows around	*/
+		if( src != dst )
+		{
+			memcpy( dst, src, (size_t)width * channels );
+		}
+		return;
+	}
+	transform_image_row_kernel()( src, dst, width, channels, operations, NTSC_LUT, 0 );
+}
+
+int
+	transform_image
+	(
+		const unsigned char* const orig,
+		int width, int height, int channels,
+		unsigned char* transformed,
+		unsigned int operations
+	)
+{
+	const size_t row_size = (size_t)width * channels;
+	unsigned char NTSC_LUT[256];
+	const unsigned char* LUT = NULL;
+	int i, j;
+	/*	error check	*/
+	if( (width < 1) || (height < 1) ||
+		(channels < 1) || (channels > 4) ||
+		(orig == NULL) || (transformed == NULL) )
+	{
+		/*	nothing to do	*/
+		return 0;
+	}
+	if( operations & IMAGE_TRANSFORM_NTSC_SAFE )
+	{
+		/*	set up the scaling Look Up Table	*/
+		for( i = 0; i < 256; ++i )
+		{
+			NTSC_LUT[i] = (unsigned char)((i * IMAGE_NTSC_SAFE_MUL + IMAGE_NTSC_SAFE_ADD) >> IMAGE_NTSC_SAFE_SHIFT);
+		}
+		LUT = NTSC_LUT;
+	}
+	if( !(operations & IMAGE_TRANSFORM_INVERT_Y) )
+	{
+		for( j = 0; j < height; ++j )
+		{
+			transform_image_row(
+					orig + j * row_size, transformed + j * row_size,
+					width, channels, operations, LUT );
+		}
+	} else if( orig != transformed )
+	{
+		/*	read the source rows bottom up	*/
+		for( j = 0; j < height; ++j )
+		{
+			transform_image_row(
+					orig + (height - 1 - j) * row_size, transformed + j * row_size,
+					width, channels, operations, LUT );
+		}
+	} else
+	{
+		/*	flipping in place, each pair of rows swaps through one row of scratch	*/
+		unsigned char* row_copy = (unsigned char*)malloc( row_size );
+		if( NULL == row_copy )
+		{
+			return 0;
+		}
+		for( j = 0; j < (height + 1) / 2; ++j )
+		{
+			unsigned char* top = transformed + j * row_size;
+			unsigned char* bottom = transformed + (height - 1 - j) * row_size;
+			memcpy( row_copy, top, row_size );
+			transform_image_row( bottom, top, width, channels, operations, LUT );
+			transform_image_row( row_copy, bottom, width, channels, operations, LUT );
+		}
+		free( row_copy );
+	}
+	return 1;
+}
+
+int
+	scale_image_RGB_to_NTSC_safe
+	(
+		unsigned char* orig,
+		int width, int height, int channels
+	)
+{
+	return transform_image( orig, width, height, channels, orig, IMAGE_TRANSFORM_NTSC_SAFE );
+}
+
 /*
 	This function takes the RGB components of the image
 	and converts them into YCoCg.  3 components will be
@@ -269,7 +1487,6 @@ int
 		int width, int height, int channels
 	)
 {
-	int i;
 	/*	error check	*/
 	if( (width < 1) || (height < 1) ||
 		(channels < 3) || (channels > 4) ||
@@ -279,40 +1496,7 @@ int
 		return -1;
 	}
 	/*	do the conversion	*/
-	if( channels == 3 )
-	{
-		for( i = 0; i < width*height*3; i += 3 )
-		{
-			int r = orig[i+0];
-			int g = (orig[i+1] + 1) >> 1;
-			int b = orig[i+2];
-			int tmp = (2 + r + b) >> 2;
-			/*	Co	*/
-			orig[i+0] = clamp_byte( 128 + ((r - b + 1) >> 1) );
-			/*	Y	*/
-			orig[i+1] = clamp_byte( g + tmp );
-			/*	Cg	*/
-			orig[i+2] = clamp_byte( 128 + g - tmp );
-		}
-	} else
-	{
-		for( i = 0; i < width*height*4; i += 4 )
-		{
-			int r = orig[i+0];
-			int g = (orig[i+1] + 1) >> 1;
-			int b = orig[i+2];
-			unsigned char a = orig[i+3];
-			int tmp = (2 + r + b) >> 2;
-			/*	Co	*/
-			orig[i+0] = clamp_byte( 128 + ((r - b + 1) >> 1) );
-			/*	Cg	*/
-			orig[i+1] = clamp_byte( 128 + g - tmp );
-			/*	Alpha	*/
-			orig[i+2] = a;
-			/*	Y	*/
-			orig[i+3] = clamp_byte( g + tmp );
-		}
-	}
+	transform_image( orig, width, height, channels, orig, IMAGE_TRANSFORM_YCOCG );
 	/*	done	*/
 	return 0;
 }
@@ -328,7 +1512,6 @@ int
 		int width, int height, int channels
 	)
 {
-	int i;
 	/*	error check	*/
 	if( (width < 1) || (height < 1) ||
 		(channels < 3) || (channels > 4) ||
@@ -337,39 +1520,8 @@ int
 		/*	nothing to do	*/
 		return -1;
 	}
-	/*	do the conversion	*/
-	if( channels == 3 )
-	{
-		for( i = 0; i < width*height*3; i += 3 )
-		{
-			int co = orig[i+0] - 128;
-			int y  = orig[i+1];
-			int cg = orig[i+2] - 128;
-			/*	R	*/
-			orig[i+0] = clamp_byte( y + co - cg );
-			/*	G	*/
-			orig[i+1] = clamp_byte( y + cg );
-			/*	B	*/
-			orig[i+2] = clamp_byte( y - co - cg );
-		}
-	} else
-	{
-		for( i = 0; i < width*height*4; i += 4 )
-		{
-			int co = orig[i+0] - 128;
-			int cg = orig[i+1] - 128;
-			unsigned char a  = orig[i+2];
-			int y  = orig[i+3];
-			/*	R	*/
-			orig[i+0] = clamp_byte( y + co - cg );
-			/*	G	*/
-			orig[i+1] = clamp_byte( y + cg );
-			/*	B	*/
-			orig[i+2] = clamp_byte( y - co - cg );
-			/*	A	*/
-			orig[i+3] = a;
-		}
-	}
+	/*	do the conversion, the rows are contiguous	*/
+	YCoCg_to_RGB_row_kernel()( orig, width*height, channels, 0 );
 	/*	done	*/
 	return 0;
 }
@@ -498,3 +1650,128 @@ RGBE_to_RGBdivA2
 	}
 	return 1;
 }
+
+int
+	convert_BGR_to_RGB
+	(
+		const unsigned char* const orig,
+		int pixels, int channels,
+		unsigned char* swapped
+	)
+{
+	int i = 0;
+	/* error check */
+	if( (!orig) || (!swapped) || (pixels < 0) || ((channels != 3) && (channels != 4)) )
+	{
+		return 0;
+	}
+	if( channels == 4 )
+	{
+#if defined( SOIL_SIMD_SSE2 )
+		/*	blue and red trade places inside each 32 bit pixel	*/
+		const __m128i keep = _mm_set1_epi32( (int)0xFF00FF00 );
+		const __m128i low = _mm_set1_epi32( 0xFF );
+		for( ; i + 4 <= pixels; i += 4 )
+		{
+			const __m128i p = _mm_loadu_si128( (const __m128i*)(orig + i*4) );
+			const __m128i s = _mm_or_si128( _mm_and_si128( p, keep ),
+				_mm_or_si128( _mm_and_si128( _mm_srli_epi32( p, 16 ), low ),
+					_mm_slli_epi32( _mm_and_si128( p, low ), 16 ) ) );
+			_mm_storeu_si128( (__m128i*)(swapped + i*4), s );
+		}
+#elif defined( SOIL_SIMD_NEON )
+		for( ; i + 16 <= pixels; i += 16 )
+		{
+			uint8x16x4_t p = vld4q_u8( orig + i*4 );
+			const uint8x16_t r = p.val[0];
+			p.val[0] = p.val[2];
+			p.val[2] = r;
+			vst4q_u8( swapped + i*4, p );
+		}
+#endif
+	}
+#if defined( SOIL_SIMD_NEON )
+	else
+	{
+		for( ; i + 16 <= pixels; i += 16 )
+		{
+			uint8x16x3_t p = vld3q_u8( orig + i*3 );
+			const uint8x16_t r = p.val[0];
+			p.val[0] = p.val[2];
+			p.val[2] = r;
+			vst3q_u8( swapped + i*3, p );
+		}
+	}
+#endif
+	for( ; i < pixels; ++i )
+	{
+		const unsigned char *src = orig + i*channels;
+		unsigned char *dst = swapped + i*channels;
+		const unsigned char b = src[0];
+		dst[0] = src[2];
+		dst[1] = src[1];
+		dst[2] = b;
+		if( channels == 4 )
+		{
+			dst[3] = src[3];
+		}
+	}
+	return 1;
+}
+
+int
+	convert_ARGB16_to_RGBA16
+	(
+		const unsigned char* const orig,
+		int pixels, int alpha_bits, int opaque,
+		unsigned char* converted
+	)
+{
+	/*	a rotation left by alpha_bits, alpha then fills the bottom bits	*/
+	const unsigned int alpha_mask = (1u << alpha_bits) - 1;
+	int i = 0;
+	/* error check */
+	if( (!orig) || (!converted) || (pixels < 0) || (alpha_bits < 1) || (alpha_bits > 15) )
+	{
+		return 0;
+	}
+#if defined( SOIL_SIMD_SSE2 )
+	{
+		const __m128i shift_left = _mm_cvtsi32_si128( alpha_bits );
+		const __m128i shift_right = _mm_cvtsi32_si128( 16 - alpha_bits );
+		const __m128i set = _mm_set1_epi16( (short)(opaque ? alpha_mask : 0) );
+		for( ; i + 8 <= pixels; i += 8 )
+		{
+			const __m128i p = _mm_loadu_si128( (const __m128i*)(orig + i*2) );
+			const __m128i r = _mm_or_si128( _mm_or_si128(
+				_mm_sll_epi16( p, shift_left ), _mm_srl_epi16( p, shift_right ) ), set );
+			_mm_storeu_si128( (__m128i*)(converted + i*2), r );
+		}
+	}
+#elif defined( SOIL_SIMD_NEON )
+	{
+		const int16x8_t shift_left = vdupq_n_s16( (short)alpha_bits );
+		const int16x8_t shift_right = vdupq_n_s16( (short)(alpha_bits - 16) );
+		const uint16x8_t set = vdupq_n_u16( (unsigned short)(opaque ? alpha_mask : 0) );
+		for( ; i + 8 <= pixels; i += 8 )
+		{
+			const uint16x8_t p = vreinterpretq_u16_u8( vld1q_u8( orig + i*2 ) );
+			const uint16x8_t r = vorrq_u16( vorrq_u16(
+				vshlq_u16( p, shift_left ), vshlq_u16( p, shift_right ) ), set );
+			vst1q_u8( converted + i*2, vreinterpretq_u8_u16( r ) );
+		}
+	}
+#endif
+	for( ; i < pixels; ++i )
+	{
+		unsigned int p = orig[i*2] | ((unsigned int)orig[i*2+1] << 8);
+		p = ((p << alpha_bits) | (p >> (16 - alpha_bits))) & 0xFFFF;
+		if( opaque )
+		{
+			p |= alpha_mask;
+		}
+		converted[i*2] = (unsigned char)(p & 0xFF);
+		converted[i*2+1] = (unsigned char)(p >> 8);
+	}
+	return 1;
+}
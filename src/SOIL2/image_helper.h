@@ -31,6 +31,25 @@ int
 		int resampled_width, int resampled_height
 	);
 
+/**
+	This function downscales an image to any smaller
+	size by averaging the source area each destination
+	texel covers (fractional texels are weighted).
+	Source rows are visited in order, one window at a
+	time, so only a couple of rows of scratch memory
+	are needed on top of the source and destination.
+	The resampled size must not exceed the original.
+	\return 0 if failed, otherwise returns 1
+**/
+int
+	down_scale_image
+	(
+		const unsigned char* const orig,
+		int width, int height, int channels,
+		unsigned char* resampled,
+		int resampled_width, int resampled_height
+	);
+
 /** Bilinear resize for floating-point image data. */
 int
 	resize_image_f32
@@ -56,6 +75,68 @@ int
 		int block_size_x, int block_size_y
 	);
 
+/**
+	This function builds the next MIPmap level from
+	the given level, so a whole chain can be cascaded
+	without going back to level 0.  It follows the
+	OpenGL chain for any size: the resampled image is
+	floor(width/2) x floor(height/2) (at least 1), even
+	sizes use a 2x2 box and odd sizes a 3 tap polyphase
+	box so the odd edge texels are not dropped.
+	\return 0 if failed, otherwise returns 1
+**/
+int
+	mipmap_image_next_level
+	(
+		const unsigned char* const orig,
+		int width, int height, int channels,
+		unsigned char* resampled
+	);
+
+/**
+	The taps of output texel i along one axis of a
+	floor(size/2) reduction, as used by
+	mipmap_image_next_level: fills up to 3 source
+	indices and their weights.
+	\return the number of taps, 1, 2 or 3
+**/
+int
+	mipmap_axis_taps
+	(
+		int i, int size, int mip_size,
+		int *index, float *weight
+	);
+
+/** The operations of transform_image, applied in this order. */
+enum
+{
+	IMAGE_TRANSFORM_INVERT_Y = 1,
+	IMAGE_TRANSFORM_NTSC_SAFE = 2,
+	IMAGE_TRANSFORM_MULTIPLY_ALPHA = 4,
+	IMAGE_TRANSFORM_YCOCG = 8
+};
+
+/**
+	This function copies an image applying any of the
+	operations above in a single pass: every destination
+	row is written once, from the source row it comes from,
+	with all the enabled operations applied to each pixel.
+	The results match scale_image_RGB_to_NTSC_safe and
+	convert_RGB_to_YCoCg, alpha is premultiplied for 2 and
+	4 channels.  transformed may be orig itself.
+	Uses the SSE2, AVX2 or NEON kernels when available,
+	they produce the same bytes as the plain C path.
+	\return 0 if failed, otherwise returns 1
+**/
+int
+	transform_image
+	(
+		const unsigned char* const orig,
+		int width, int height, int channels,
+		unsigned char* transformed,
+		unsigned int operations
+	);
+
 /**
 	This function takes the RGB components of the image
 	and scales each channel from [0,255] to [16,235].
@@ -127,6 +208,36 @@ int
 		int rescale_to_max
 	);
 
+/**
+	Copies a row of 3 or 4 channel pixels swapping the first and
+	third channels, BGR(A) to RGB(A) or back.  For the drivers
+	that can't unpack GL_BGR(A) themselves.  swapped may be orig.
+	\return 0 if failed, otherwise returns 1
+**/
+int
+	convert_BGR_to_RGB
+	(
+		const unsigned char* const orig,
+		int pixels, int channels,
+		unsigned char* swapped
+	);
+
+/**
+	Copies a row of little endian 16 bit pixels holding alpha in
+	their top alpha_bits bits (A4R4G4B4, A1R5G5B5) moving alpha to
+	the bottom bits (R4G4B4A4, R5G5B5A1), the orders OpenGL ES
+	unpacks.  If opaque is set alpha becomes all ones instead (for
+	X4R4G4B4 and X1R5G5B5).  converted may be orig.
+	\return 0 if failed, otherwise returns 1
+**/
+int
+	convert_ARGB16_to_RGBA16
+	(
+		const unsigned char* const orig,
+		int pixels, int alpha_bits, int opaque,
+		unsigned char* converted
+	);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,51 @@
+/*
+	SIMD configuration shared by the image helpers
+
+	Picks the vector instruction sets that can be compiled on the
+	current target.  SSE2 and NEON are baseline features wherever they
+	are enabled here, AVX2 is only compiled in and must be checked at
+	runtime with image_simd_has_AVX2 before use.
+
+	Define SOIL_NO_SIMD to build the plain C paths only.
+
+	MIT license
+*/
+
+#ifndef HEADER_IMAGE_SIMD
+#define HEADER_IMAGE_SIMD
+
+#if !defined( SOIL_NO_SIMD )
+	#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+		#define SOIL_SIMD_SSE2 1
+		#include <emmintrin.h>
+		#if defined( __GNUC__ ) && ( defined( __clang__ ) || __GNUC__ >= 5 )
+			#define SOIL_SIMD_AVX2 1
+			#define SOIL_SIMD_TARGET_AVX2 __attribute__(( target( "avx2" ) ))
+			#include <immintrin.h>
+		#elif defined( _MSC_VER ) && _MSC_VER >= 1800 && !defined( __clang__ )
+			#define SOIL_SIMD_AVX2 1
+			#define SOIL_SIMD_TARGET_AVX2
+			#include <immintrin.h>
+		#endif
+	#endif
+	#if defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+		#define SOIL_SIMD_NEON 1
+		#include <arm_neon.h>
+	#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+	Returns non-zero if the CPU and the operating system
+	support AVX2.  The answer is computed once and cached.
+**/
+int image_simd_has_AVX2( void );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEADER_IMAGE_SIMD	*/
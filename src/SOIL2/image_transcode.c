@@ -0,0 +1,309 @@
+/*
+	Transcoding between GPU block formats
+
+	A desktop GPU can't sample ETC2, and a mobile one usually can't
+	sample BC, so instead of uploading the decoded pixels (4 to 8 times
+	the memory of the blocks) the blocks are converted to a format the
+	GPU has.  Bands of block rows are decoded to RGBA and handed to the
+	regular encoders, which split large bands across the thread pool.
+
+	MIT license
+*/
+
+#include "image_transcode.h"
+#include "image_DXT.h"
+#include "image_BPTC.h"
+#include "image_ETC.h"
+#include "wfETC.h"
+#include "stb_image.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*	block rows decoded at once, 256 pixel rows	*/
+#define TRANSCODE_BAND_BLOCK_ROWS	64
+
+int
+	transcode_block_size
+	(
+		int format
+	)
+{
+	switch( format )
+	{
+	case TRANSCODE_BC1:
+	case TRANSCODE_BC4:
+	case TRANSCODE_ETC1:
+	case TRANSCODE_ETC2_RGB8:
+	case TRANSCODE_ETC2_RGB8A1:
+	case TRANSCODE_EAC_R11:
+		return 8;
+	default:
+		return 16;
+	}
+}
+
+/*	the decoder of wfETC for the ETC and EAC formats, -1 for the others	*/
+static int
+	transcode_wfETC_format
+	(
+		int format
+	)
+{
+	switch( format )
+	{
+	case TRANSCODE_ETC1:		return WF_ETC_FORMAT_ETC1_RGB8;
+	case TRANSCODE_ETC2_RGB8:	return WF_ETC_FORMAT_ETC2_RGB8;
+	case TRANSCODE_ETC2_RGBA8:	return WF_ETC_FORMAT_ETC2_RGBA8;
+	case TRANSCODE_ETC2_RGB8A1:	return WF_ETC_FORMAT_ETC2_RGB8A1;
+	case TRANSCODE_EAC_R11:		return WF_ETC_FORMAT_EAC_R11;
+	case TRANSCODE_EAC_RG11:	return WF_ETC_FORMAT_EAC_RG11;
+	default:					return -1;
+	}
+}
+
+/*	one BC block to 4x4 RGBA	*/
+static void
+	transcode_decode_BC_block
+	(
+		const unsigned char *const source,
+		int format,
+		unsigned char rgba[16*4]
+	)
+{
+	unsigned char block[16];
+	int i;
+	memcpy( block, source, transcode_block_size( format ) );
+	switch( format )
+	{
+	case TRANSCODE_BC1:
+		stbi_decode_DXT1_block( rgba, block );
+		break;
+	case TRANSCODE_BC2:
+		stbi_decode_DXT23_alpha_block( rgba, block );
+		stbi_decode_DXT_color_block( rgba, block + 8 );
+		break;
+	case TRANSCODE_BC3:
+		stbi_decode_DXT45_alpha_block( rgba, block );
+		stbi_decode_DXT_color_block( rgba, block + 8 );
+		break;
+	case TRANSCODE_BC4:
+	case TRANSCODE_BC5:
+		for( i = 0; i < 16*4; ++i )
+		{
+			rgba[i] = ((i & 3) == 3) ? 255 : 0;
+		}
+		stbi_decode_BC4_block( rgba, 0, 0, block );
+		if( format == TRANSCODE_BC5 )
+		{
+			stbi_decode_BC4_block( rgba, 1, 0, block + 8 );
+		}
+		break;
+	case TRANSCODE_BC7:
+		BC7_decode_block( block, rgba );
+		break;
+	}
+}
+
+/*	decodes block_rows rows of blocks_wide blocks to RGBA	*/
+static int
+	transcode_decode_band
+	(
+		const unsigned char *source,
+		int blocks_wide, int block_rows,
+		int format,
+		unsigned char *rgba,
+		unsigned char *scratch
+	)
+{
+	const int width = blocks_wide * 4;
+	const int wf_format = transcode_wfETC_format( format );
+	int bx, by, y;
+	if( wf_format >= 0 )
+	{
+		/*	wfETC writes as many channels as the format holds	*/
+		const int channels = (wf_format == WF_ETC_FORMAT_EAC_R11) ? 1 :
+			((wf_format == WF_ETC_FORMAT_ETC2_RGBA8) || (wf_format == WF_ETC_FORMAT_ETC2_RGB8A1)) ? 4 : 3;
+		const size_t pixels = (size_t)width * block_rows * 4;
+		size_t i;
+		int c;
+		if( !wfETC_DecodeImage( source, scratch, width, block_rows * 4,
+			width, block_rows * 4, wf_format ) )
+		{
+			return 0;
+		}
+		for( i = 0; i < pixels; ++i )
+		{
+			for( c = 0; c < 4; ++c )
+			{
+				rgba[i*4+c] = (c < channels) ? scratch[i*channels+c] : ((c == 3) ? 255 : 0);
+			}
+		}
+		return 1;
+	}
+	for( by = 0; by < block_rows; ++by )
+	{
+		for( bx = 0; bx < blocks_wide; ++bx )
+		{
+			unsigned char block[16*4];
+			transcode_decode_BC_block( source, format, block );
+			for( y = 0; y < 4; ++y )
+			{
+				memcpy( rgba + ((size_t)(by * 4 + y) * width + bx * 4) * 4, block + y * 16, 16 );
+			}
+			source += transcode_block_size( format );
+		}
+	}
+	return 1;
+}
+
+/*	encodes a band with the encoder of the format	*/
+static unsigned char*
+	transcode_encode_band
+	(
+		const unsigned char *const rgba,
+		int width, int height, int channels,
+		int format,
+		int *out_size
+	)
+{
+	switch( format )
+	{
+	case TRANSCODE_BC1:			return convert_image_to_DXT1( rgba, width, height, channels, out_size );
+	case TRANSCODE_BC3:			return convert_image_to_DXT5( rgba, width, height, channels, out_size );
+	case TRANSCODE_BC4:			return convert_image_to_BC4( rgba, width, height, channels, out_size, 0 );
+	case TRANSCODE_BC5:			return convert_image_to_BC5( rgba, width, height, channels, out_size, 0 );
+	case TRANSCODE_BC7:			return convert_image_to_BC7( rgba, width, height, channels, out_size, 0 );
+	case TRANSCODE_ETC1:		return convert_image_to_ETC1( rgba, width, height, channels, out_size );
+	case TRANSCODE_ETC2_RGB8:
+	case TRANSCODE_ETC2_RGBA8:	return convert_image_to_ETC2( rgba, width, height, channels, out_size );
+	default:					return NULL;
+	}
+}
+
+unsigned char*
+	transcode_image
+	(
+		const unsigned char *const compressed,
+		int width, int height,
+		int from_format, int to_format,
+		int *out_size
+	)
+{
+	const int blocks_wide = (width + 3) / 4;
+	const int blocks_high = (height + 3) / 4;
+	const int from_block_size = transcode_block_size( from_format );
+	const int to_block_size = transcode_block_size( to_format );
+	/*	ETC2 RGB8 is told apart from RGBA8 by the number of channels	*/
+	const int channels = ((to_format == TRANSCODE_ETC1) || (to_format == TRANSCODE_ETC2_RGB8)) ? 3 : 4;
+	int band_rows = (blocks_high < TRANSCODE_BAND_BLOCK_ROWS) ? blocks_high : TRANSCODE_BAND_BLOCK_ROWS;
+	unsigned char *transcoded, *rgba, *scratch;
+	size_t band_pixels;
+	int row;
+	/*	error check	*/
+	*out_size = 0;
+	if( (NULL == compressed) || (width < 1) || (height < 1) ||
+		(from_format < TRANSCODE_BC1) || (from_format > TRANSCODE_EAC_RG11) ||
+		(to_format == TRANSCODE_BC2) || (to_format < TRANSCODE_BC1) || (to_format > TRANSCODE_ETC2_RGBA8) ||
+		((size_t)blocks_wide * blocks_high * 16 > 0x7fffffff) )
+	{
+		return NULL;
+	}
+	band_pixels = (size_t)blocks_wide * 4 * band_rows * 4;
+	transcoded = (unsigned char*)malloc( (size_t)blocks_wide * blocks_high * to_block_size );
+	rgba = (unsigned char*)malloc( band_pixels * 4 );
+	scratch = (transcode_wfETC_format( from_format ) >= 0) ? (unsigned char*)malloc( band_pixels * 4 ) : NULL;
+	if( (NULL == transcoded) || (NULL == rgba) ||
+		((NULL == scratch) && (transcode_wfETC_format( from_format ) >= 0)) )
+	{
+		free( transcoded );
+		free( rgba );
+		free( scratch );
+		return NULL;
+	}
+	for( row = 0; row < blocks_high; row += band_rows )
+	{
+		const int rows = (blocks_high - row < band_rows) ? blocks_high - row : band_rows;
+		const size_t pixels = (size_t)blocks_wide * 4 * rows * 4;
+		unsigned char *band;
+		int band_size = 0;
+		size_t i;
+		if( !transcode_decode_band( compressed + (size_t)row * blocks_wide * from_block_size,
+			blocks_wide, rows, from_format, rgba, scratch ) )
+		{
+			free( transcoded );
+			transcoded = NULL;
+			break;
+		}
+		if( channels == 3 )
+		{
+			/*	drop alpha, in place	*/
+			for( i = 0; i < pixels; ++i )
+			{
+				rgba[i*3+0] = rgba[i*4+0];
+				rgba[i*3+1] = rgba[i*4+1];
+				rgba[i*3+2] = rgba[i*4+2];
+			}
+		}
+		band = transcode_encode_band( rgba, blocks_wide * 4, rows * 4, channels, to_format, &band_size );
+		if( (NULL == band) || (band_size != blocks_wide * rows * to_block_size) )
+		{
+			free( band );
+			free( transcoded );
+			transcoded = NULL;
+			break;
+		}
+		memcpy( transcoded + (size_t)row * blocks_wide * to_block_size, band, band_size );
+		free( band );
+	}
+	free( rgba );
+	free( scratch );
+	if( NULL != transcoded )
+	{
+		*out_size = blocks_wide * blocks_high * to_block_size;
+	}
+	return transcoded;
+}
+
+int
+	transcode_has_alpha
+	(
+		const unsigned char *const compressed,
+		int width, int height,
+		int format
+	)
+{
+	const size_t blocks = (size_t)((width + 3) / 4) * ((height + 3) / 4);
+	const unsigned char *block = compressed;
+	size_t i;
+	int p;
+	switch( format )
+	{
+	case TRANSCODE_BC2:
+	case TRANSCODE_BC3:
+	case TRANSCODE_BC7:
+	case TRANSCODE_ETC2_RGBA8:
+	case TRANSCODE_ETC2_RGB8A1:
+		return 1;
+	case TRANSCODE_BC1:
+		for( i = 0; i < blocks; ++i, block += 8 )
+		{
+			const int c0 = block[0] | (block[1] << 8);
+			const int c1 = block[2] | (block[3] << 8);
+			if( c0 > c1 )
+			{
+				continue;
+			}
+			/*	3 color mode, index 3 is transparent black	*/
+			for( p = 0; p < 16; ++p )
+			{
+				if( ((block[4 + (p >> 2)] >> ((p & 3) * 2)) & 3) == 3 )
+				{
+					return 1;
+				}
+			}
+		}
+		return 0;
+	default:
+		return 0;
+	}
+}
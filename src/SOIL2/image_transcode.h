@@ -0,0 +1,81 @@
+/*
+	Transcoding between GPU block formats
+
+	MIT license
+*/
+
+#ifndef HEADER_IMAGE_TRANSCODE
+#define HEADER_IMAGE_TRANSCODE
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+	The block formats of transcode_image.  All of them can be decoded,
+	BC1, BC3, BC4, BC5, BC7, ETC1, ETC2 RGB8 and ETC2 RGBA8 can also be
+	encoded.  BC4 and BC5 are the unsigned variants, and EAC R11 and RG11
+	are decoded to 8 bits.
+**/
+enum
+{
+	TRANSCODE_BC1 = 0,
+	TRANSCODE_BC2 = 1,
+	TRANSCODE_BC3 = 2,
+	TRANSCODE_BC4 = 3,
+	TRANSCODE_BC5 = 4,
+	TRANSCODE_BC7 = 5,
+	TRANSCODE_ETC1 = 6,
+	TRANSCODE_ETC2_RGB8 = 7,
+	TRANSCODE_ETC2_RGBA8 = 8,
+	TRANSCODE_ETC2_RGB8A1 = 9,
+	TRANSCODE_EAC_R11 = 10,
+	TRANSCODE_EAC_RG11 = 11
+};
+
+/**
+	Converts an image from one block format to another, for a GPU which
+	can't sample the original format.  The blocks are decoded a band of
+	block rows at a time and encoded again with the regular encoders, so
+	only one band is ever uncompressed.  Channels missing from the
+	destination are dropped (ETC1 and ETC2 RGB8 drop alpha, BC4 keeps
+	red, BC5 red and green).
+	\return the blocks, free them with free(), or NULL if the formats
+	can't be converted or out of memory
+**/
+unsigned char*
+	transcode_image
+	(
+		const unsigned char *const compressed,
+		int width, int height,
+		int from_format, int to_format,
+		int *out_size
+	);
+
+/**
+	The size of a 4x4 block of a TRANSCODE_* format, 8 or 16 bytes.
+**/
+int
+	transcode_block_size
+	(
+		int format
+	);
+
+/**
+	Whether an image of a TRANSCODE_* format may hold transparent
+	pixels.  BC1 blocks are checked for the transparent index of their
+	3 color mode, the formats with an alpha channel are assumed to use it.
+**/
+int
+	transcode_has_alpha
+	(
+		const unsigned char *const compressed,
+		int width, int height,
+		int format
+	);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEADER_IMAGE_TRANSCODE	*/
@@ -989,6 +989,9 @@ static int      stbi__pnm_is16(stbi__context *s);
 static int      stbi__dds_test(stbi__context *s);
 static void    *stbi__dds_load(stbi__context *s, int *x, int *y, int *comp, int req_comp);
 static int      stbi__dds_info(stbi__context *s, int *x, int *y, int *comp, int *iscompressed);
+#if !defined(STBI_NO_LINEAR) && !defined(STBI_NO_HDR)
+static float   *stbi__dds_loadf(stbi__context *s, int *x, int *y, int *comp, int req_comp);
+#endif
 #endif
 
 #ifndef STBI_NO_PVR
@@ -1526,6 +1529,14 @@ static float *stbi__loadf_main(stbi__context *s, int *x, int *y, int *comp, int
          stbi__float_postprocess(hdr_data,x,y,comp,req_comp);
       return hdr_data;
    }
+   #ifndef STBI_NO_DDS
+   if (stbi__dds_test(s)) {
+      float *dds_data = stbi__dds_loadf(s,x,y,comp,req_comp);
+      if (dds_data)
+         stbi__float_postprocess(dds_data,x,y,comp,req_comp);
+      return dds_data;
+   }
+   #endif
    #endif
    data = stbi__load_and_postprocess_8bit(s, x, y, comp, req_comp);
    if (data)
@@ -19,6 +19,14 @@ extern int      stbi__dds_test_file        (FILE *f);
 extern void    *stbi__dds_load_from_file   (FILE *f,                  int *x, int *y, int *comp, int req_comp);
 #endif
 
+/*	the block decoders, to 4x4 RGBA	*/
+extern void     stbi_decode_DXT1_block     (unsigned char uncompressed[16*4], unsigned char compressed[8]);
+extern void     stbi_decode_DXT23_alpha_block (unsigned char uncompressed[16*4], unsigned char compressed[8]);
+extern void     stbi_decode_DXT45_alpha_block (unsigned char uncompressed[16*4], unsigned char compressed[8]);
+extern void     stbi_decode_DXT_color_block (unsigned char uncompressed[16*4], unsigned char compressed[8]);
+/*	BC4, into one channel of the block, signed values map -1..1 to 0..255	*/
+extern void     stbi_decode_BC4_block      (unsigned char uncompressed[16*4], int channel, int is_signed, unsigned char compressed[8]);
+
 extern int      stbi__dds_info_from_memory (stbi_uc const *buffer, int len, int *x, int *y, int *comp, int *iscompressed);
 extern int      stbi__dds_info_from_callbacks (stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *comp, int *iscompressed);
 
@@ -3,6 +3,8 @@
 ///	(use SOIL for that ;-)
 
 #include "image_DXT.h"
+#include "image_BPTC.h"
+#include "thread_pool.h"
 
 static int stbi__dds_test(stbi__context *s)
 {
@@ -240,63 +242,653 @@ void stbi_decode_DXT_color_block(
 	//	done
 }
 
-static int stbi__dds_info( stbi__context *s, int *x, int *y, int *comp, int *iscompressed ) {
-	int is_compressed,has_alpha;
-	unsigned int flags;
-	DDS_header header={0};
+void stbi_decode_BC4_block(
+			unsigned char uncompressed[16*4],
+			int channel, int is_signed,
+			unsigned char compressed[8] )
+{
+	int i;
+	int decode_value[8];
+	int low = is_signed ? -127 : 0;
+	int high = is_signed ? 127 : 255;
+	unsigned long long bits = 0;
+	//	the 2 end points, signed ones go from -127 (-128 is the same) to 127
+	decode_value[0] = is_signed ? (signed char)compressed[0] : compressed[0];
+	decode_value[1] = is_signed ? (signed char)compressed[1] : compressed[1];
+	if( decode_value[0] < low ) decode_value[0] = low;
+	if( decode_value[1] < low ) decode_value[1] = low;
+	if( decode_value[0] > decode_value[1] )
+	{
+		//	6 step intermediate
+		for( i = 1; i < 7; ++i )
+		{
+			decode_value[i+1] = ((7-i)*decode_value[0] + i*decode_value[1]) / 7;
+		}
+	} else
+	{
+		//	4 step intermediate, plus the ends of the range
+		for( i = 1; i < 5; ++i )
+		{
+			decode_value[i+1] = ((5-i)*decode_value[0] + i*decode_value[1]) / 5;
+		}
+		decode_value[6] = low;
+		decode_value[7] = high;
+	}
+	if( is_signed )
+	{
+		//	-1 to 1 maps to 0 to 255, like signed EAC
+		for( i = 0; i < 8; ++i )
+		{
+			decode_value[i] = ((decode_value[i] + 127) * 255 + 127) / 254;
+		}
+	}
+	//	16 3 bit indices in the last 6 bytes
+	for( i = 7; i >= 2; --i )
+	{
+		bits = (bits << 8) | compressed[i];
+	}
+	for( i = channel; i < 16*4; i += 4 )
+	{
+		uncompressed[i] = (unsigned char)decode_value[bits & 7];
+		bits >>= 3;
+	}
+}
+
+//	the formats decoded by block or by pixel, past the uncompressed RGB(A) of old
+enum
+{
+	STBI__DDS_LEGACY_RGB = 0,
+	STBI__DDS_BC1,
+	STBI__DDS_BC2,
+	STBI__DDS_BC3,
+	STBI__DDS_BC4,
+	STBI__DDS_BC4S,
+	STBI__DDS_BC5,
+	STBI__DDS_BC5S,
+	STBI__DDS_BC6H,
+	STBI__DDS_BC6HS,
+	STBI__DDS_BC7,
+	STBI__DDS_RGBA8,
+	STBI__DDS_BGRA8,
+	STBI__DDS_R8,
+	STBI__DDS_R8S,
+	STBI__DDS_RG8,
+	STBI__DDS_RG8S,
+	STBI__DDS_R16,
+	STBI__DDS_RG16,
+	STBI__DDS_RGBA16,
+	STBI__DDS_R16F,
+	STBI__DDS_RG16F,
+	STBI__DDS_RGBA16F,
+	STBI__DDS_R32F,
+	STBI__DDS_RG32F,
+	STBI__DDS_RGBA32F,
+	STBI__DDS_RGB10A2,
+	STBI__DDS_RG11B10F
+};
+
+//	below this many pixels the blocks are decoded on the calling thread
+#define STBI__DDS_THREADED_MIN_PIXELS (256*256)
 
+typedef struct
+{
+	int format;
+	int block_compressed;
+	//	bytes per 4x4 block, or per pixel
+	int block_size;
+	//	channels of the decoded image, RG formats get a 0 blue channel
+	int channels;
+	int is_float;
+	int faces;
+} stbi__dds_format;
+
+static void stbi__dds_set_format( stbi__dds_format *format, int id,
+			int block_compressed, int block_size, int channels, int is_float )
+{
+	format->format = id;
+	format->block_compressed = block_compressed;
+	format->block_size = block_size;
+	format->channels = channels;
+	format->is_float = is_float;
+}
+
+//	reads and checks the headers, and works out what the pixels are
+static int stbi__dds_parse( stbi__context *s, DDS_header *header, stbi__dds_format *format )
+{
+	enum
+	{
+		DXT1 = ('D' << 0) | ('X' << 8) | ('T' << 16) | ('1' << 24),
+		DXT2 = ('D' << 0) | ('X' << 8) | ('T' << 16) | ('2' << 24),
+		DXT3 = ('D' << 0) | ('X' << 8) | ('T' << 16) | ('3' << 24),
+		DXT4 = ('D' << 0) | ('X' << 8) | ('T' << 16) | ('4' << 24),
+		DXT5 = ('D' << 0) | ('X' << 8) | ('T' << 16) | ('5' << 24),
+		ATI1 = ('A' << 0) | ('T' << 8) | ('I' << 16) | ('1' << 24),
+		ATI2 = ('A' << 0) | ('T' << 8) | ('I' << 16) | ('2' << 24),
+		BC4U = ('B' << 0) | ('C' << 8) | ('4' << 16) | ('U' << 24),
+		BC4S = ('B' << 0) | ('C' << 8) | ('4' << 16) | ('S' << 24),
+		BC5U = ('B' << 0) | ('C' << 8) | ('5' << 16) | ('U' << 24),
+		BC5S = ('B' << 0) | ('C' << 8) | ('5' << 16) | ('S' << 24),
+		DX10 = ('D' << 0) | ('X' << 8) | ('1' << 16) | ('0' << 24),
+		A16B16G16R16 = 36,
+		A16B16G16R16F = 113,
+		A32B32G32R32F = 116
+	};
+	DDS_HEADER_DXT10 dx10_header;
+	unsigned int flags;
+	memset( format, 0, sizeof( stbi__dds_format ) );
 	if( sizeof( DDS_header ) != 128 )
 	{
 		return 0;
 	}
+	if( !stbi__getn( s, (stbi_uc*)header, 128 ) ) return 0;
+	//	and do some checking
+	if( header->dwMagic != (('D' << 0) | ('D' << 8) | ('S' << 16) | (' ' << 24)) ) return 0;
+	if( header->dwSize != 124 ) return 0;
+	flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT;
+	if( (header->dwFlags & flags) != flags ) return 0;
+	/*	According to the MSDN spec, the dwFlags should contain
+		DDSD_LINEARSIZE if it's compressed, or DDSD_PITCH if
+		uncompressed.  Some DDS writers do not conform to the
+		spec, so I need to make my reader more tolerant	*/
+	if( header->sPixelFormat.dwSize != 32 ) return 0;
+	flags = DDPF_FOURCC | DDPF_RGB;
+	if( (header->sPixelFormat.dwFlags & flags) == 0 ) return 0;
+	if( (header->sCaps.dwCaps1 & DDSCAPS_TEXTURE) == 0 ) return 0;
+	if( (header->dwWidth < 1) || (header->dwHeight < 1) ) return 0;
+	/*	I need cubemaps to have square faces	*/
+	format->faces = ((header->sCaps.dwCaps2 & DDSCAPS2_CUBEMAP) &&
+		(header->dwWidth == header->dwHeight)) ? 6 : 1;
+	if( (header->sPixelFormat.dwFlags & DDPF_FOURCC) == 0 )
+	{
+		//	uncompressed BGR(A)
+		stbi__dds_set_format( format, STBI__DDS_LEGACY_RGB, 0, 0,
+			(header->sPixelFormat.dwFlags & DDPF_ALPHAPIXELS) ? 4 : 3, 0 );
+		return 1;
+	}
+	switch( header->sPixelFormat.dwFourCC )
+	{
+	case DXT1: stbi__dds_set_format( format, STBI__DDS_BC1, 1, 8, 4, 0 ); break;
+	case DXT2:
+	case DXT3: stbi__dds_set_format( format, STBI__DDS_BC2, 1, 16, 4, 0 ); break;
+	case DXT4:
+	case DXT5: stbi__dds_set_format( format, STBI__DDS_BC3, 1, 16, 4, 0 ); break;
+	case ATI1:
+	case BC4U: stbi__dds_set_format( format, STBI__DDS_BC4, 1, 8, 1, 0 ); break;
+	case BC4S: stbi__dds_set_format( format, STBI__DDS_BC4S, 1, 8, 1, 0 ); break;
+	case ATI2:
+	case BC5U: stbi__dds_set_format( format, STBI__DDS_BC5, 1, 16, 3, 0 ); break;
+	case BC5S: stbi__dds_set_format( format, STBI__DDS_BC5S, 1, 16, 3, 0 ); break;
+	case A16B16G16R16: stbi__dds_set_format( format, STBI__DDS_RGBA16, 0, 8, 4, 0 ); break;
+	case A16B16G16R16F: stbi__dds_set_format( format, STBI__DDS_RGBA16F, 0, 8, 4, 1 ); break;
+	case A32B32G32R32F: stbi__dds_set_format( format, STBI__DDS_RGBA32F, 0, 16, 4, 1 ); break;
+	case DX10:
+		if( !stbi__getn( s, (stbi_uc*)&dx10_header, sizeof( DDS_HEADER_DXT10 ) ) ) return 0;
+		if( (dx10_header.resourceDimension != DDS_DIMENSION_TEXTURE2D) ||
+			(dx10_header.arraySize != 1) )
+		{
+			return 0;
+		}
+		if( (dx10_header.miscFlag & DDS_RESOURCE_MISC_TEXTURECUBE) &&
+			(header->dwWidth == header->dwHeight) )
+		{
+			format->faces = 6;
+		}
+		switch( dx10_header.dxgiFormat )
+		{
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB: stbi__dds_set_format( format, STBI__DDS_BC1, 1, 8, 4, 0 ); break;
+		case DXGI_FORMAT_BC2_UNORM:
+		case DXGI_FORMAT_BC2_UNORM_SRGB: stbi__dds_set_format( format, STBI__DDS_BC2, 1, 16, 4, 0 ); break;
+		case DXGI_FORMAT_BC3_UNORM:
+		case DXGI_FORMAT_BC3_UNORM_SRGB: stbi__dds_set_format( format, STBI__DDS_BC3, 1, 16, 4, 0 ); break;
+		case DXGI_FORMAT_BC4_UNORM: stbi__dds_set_format( format, STBI__DDS_BC4, 1, 8, 1, 0 ); break;
+		case DXGI_FORMAT_BC4_SNORM: stbi__dds_set_format( format, STBI__DDS_BC4S, 1, 8, 1, 0 ); break;
+		case DXGI_FORMAT_BC5_UNORM: stbi__dds_set_format( format, STBI__DDS_BC5, 1, 16, 3, 0 ); break;
+		case DXGI_FORMAT_BC5_SNORM: stbi__dds_set_format( format, STBI__DDS_BC5S, 1, 16, 3, 0 ); break;
+		case DXGI_FORMAT_BC6H_UF16: stbi__dds_set_format( format, STBI__DDS_BC6H, 1, 16, 3, 1 ); break;
+		case DXGI_FORMAT_BC6H_SF16: stbi__dds_set_format( format, STBI__DDS_BC6HS, 1, 16, 3, 1 ); break;
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB: stbi__dds_set_format( format, STBI__DDS_BC7, 1, 16, 4, 0 ); break;
+		case DXGI_FORMAT_R8G8B8A8_UNORM:
+		case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB: stbi__dds_set_format( format, STBI__DDS_RGBA8, 0, 4, 4, 0 ); break;
+		case DXGI_FORMAT_B8G8R8A8_UNORM:
+		case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB: stbi__dds_set_format( format, STBI__DDS_BGRA8, 0, 4, 4, 0 ); break;
+		case DXGI_FORMAT_R8_UNORM: stbi__dds_set_format( format, STBI__DDS_R8, 0, 1, 1, 0 ); break;
+		case DXGI_FORMAT_R8_SNORM: stbi__dds_set_format( format, STBI__DDS_R8S, 0, 1, 1, 0 ); break;
+		case DXGI_FORMAT_R8G8_UNORM: stbi__dds_set_format( format, STBI__DDS_RG8, 0, 2, 3, 0 ); break;
+		case DXGI_FORMAT_R8G8_SNORM: stbi__dds_set_format( format, STBI__DDS_RG8S, 0, 2, 3, 0 ); break;
+		case DXGI_FORMAT_R16_UNORM: stbi__dds_set_format( format, STBI__DDS_R16, 0, 2, 1, 0 ); break;
+		case DXGI_FORMAT_R16G16_UNORM: stbi__dds_set_format( format, STBI__DDS_RG16, 0, 4, 3, 0 ); break;
+		case DXGI_FORMAT_R16G16B16A16_UNORM: stbi__dds_set_format( format, STBI__DDS_RGBA16, 0, 8, 4, 0 ); break;
+		case DXGI_FORMAT_R16_FLOAT: stbi__dds_set_format( format, STBI__DDS_R16F, 0, 2, 1, 1 ); break;
+		case DXGI_FORMAT_R16G16_FLOAT: stbi__dds_set_format( format, STBI__DDS_RG16F, 0, 4, 3, 1 ); break;
+		case DXGI_FORMAT_R16G16B16A16_FLOAT: stbi__dds_set_format( format, STBI__DDS_RGBA16F, 0, 8, 4, 1 ); break;
+		case DXGI_FORMAT_R32_FLOAT: stbi__dds_set_format( format, STBI__DDS_R32F, 0, 4, 1, 1 ); break;
+		case DXGI_FORMAT_R32G32_FLOAT: stbi__dds_set_format( format, STBI__DDS_RG32F, 0, 8, 3, 1 ); break;
+		case DXGI_FORMAT_R32G32B32A32_FLOAT: stbi__dds_set_format( format, STBI__DDS_RGBA32F, 0, 16, 4, 1 ); break;
+		case DXGI_FORMAT_R10G10B10A2_UNORM: stbi__dds_set_format( format, STBI__DDS_RGB10A2, 0, 4, 4, 0 ); break;
+		case DXGI_FORMAT_R11G11B10_FLOAT: stbi__dds_set_format( format, STBI__DDS_RG11B10F, 0, 4, 3, 1 ); break;
+		default: return 0;
+		}
+		break;
+	default:
+		return 0;
+	}
+	return 1;
+}
 
-	stbi__getn( s, (stbi_uc*)(&header), 128 );
 
-	if( header.dwMagic != (('D' << 0) | ('D' << 8) | ('S' << 16) | (' ' << 24)) ) {
-	   stbi__rewind( s );
-	   return 0;
+typedef struct
+{
+	const stbi__dds_format *format;
+	const stbi_uc *source;
+	//	bytes per row of pixels, or of blocks
+	size_t pitch;
+	int width, height;
+	//	one of them, by format->is_float
+	stbi_uc *output;
+	float *output_f;
+	//	rows of pixels, or of blocks
+	int first_row, last_row;
+} stbi__dds_decode_job;
+
+//	5 bit exponent floats: halves, and the 11 and 10 bit ones of R11G11B10
+static float stbi__dds_small_float( unsigned int bits, int mantissa_bits, int has_sign )
+{
+	const unsigned int mantissa = bits & ((1u << mantissa_bits) - 1);
+	const unsigned int exponent = (bits >> mantissa_bits) & 31;
+	const unsigned int sign = has_sign ? (bits >> (mantissa_bits + 5)) & 1 : 0;
+	union { unsigned int u; float f; } value;
+	if( exponent == 0 )
+	{
+		//	denormal
+		value.f = (float)mantissa / (float)(1 << (14 + mantissa_bits));
+		value.u |= sign << 31;
+	} else
+	{
+		value.u = (sign << 31) | ((exponent == 31 ? 255 : exponent + 112) << 23) |
+			(mantissa << (23 - mantissa_bits));
 	}
-	if( header.dwSize != 124 ) {
-	   stbi__rewind( s );
-	   return 0;
+	return value.f;
+}
+
+static float stbi__dds_snorm8( stbi_uc value )
+{
+	const int v = (signed char)value;
+	//	-1 to 1 maps to 0 to 1, like signed EAC
+	return (v < -127 ? -127 : v) / 254.0f + 0.5f;
+}
+
+static unsigned int stbi__dds_read16( const stbi_uc *p )
+{
+	return p[0] | (p[1] << 8);
+}
+
+static unsigned int stbi__dds_read32( const stbi_uc *p )
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static float stbi__dds_read_float( const stbi_uc *p )
+{
+	union { unsigned int u; float f; } value;
+	value.u = stbi__dds_read32( p );
+	return value.f;
+}
+
+//	channels stored by the R, RG and RGBA formats
+static int stbi__dds_fetch_channels( int format )
+{
+	switch( format )
+	{
+	case STBI__DDS_R16: case STBI__DDS_R16F: case STBI__DDS_R32F: return 1;
+	case STBI__DDS_RG16: case STBI__DDS_RG16F: case STBI__DDS_RG32F: return 2;
+	default: return 4;
 	}
-	flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT;
-	if( (header.dwFlags & flags) != flags ) {
-	   stbi__rewind( s );
-	   return 0;
+}
+
+//	one pixel of an uncompressed format, as RGBA
+static void stbi__dds_fetch_pixel( int format, const stbi_uc *p, float pixel[4] )
+{
+	unsigned int packed;
+	int c;
+	pixel[0] = pixel[1] = pixel[2] = 0.0f;
+	pixel[3] = 1.0f;
+	switch( format )
+	{
+	case STBI__DDS_RGBA8:
+		for( c = 0; c < 4; ++c ) pixel[c] = p[c] / 255.0f;
+		break;
+	case STBI__DDS_BGRA8:
+		pixel[0] = p[2] / 255.0f;
+		pixel[1] = p[1] / 255.0f;
+		pixel[2] = p[0] / 255.0f;
+		pixel[3] = p[3] / 255.0f;
+		break;
+	case STBI__DDS_R8:
+	case STBI__DDS_RG8:
+		pixel[0] = p[0] / 255.0f;
+		if( format == STBI__DDS_RG8 ) pixel[1] = p[1] / 255.0f;
+		break;
+	case STBI__DDS_R8S:
+	case STBI__DDS_RG8S:
+		pixel[0] = stbi__dds_snorm8( p[0] );
+		if( format == STBI__DDS_RG8S ) pixel[1] = stbi__dds_snorm8( p[1] );
+		break;
+	case STBI__DDS_R16:
+	case STBI__DDS_RG16:
+	case STBI__DDS_RGBA16:
+		for( c = 0; c < stbi__dds_fetch_channels( format ); ++c ) pixel[c] = stbi__dds_read16( p + c * 2 ) / 65535.0f;
+		break;
+	case STBI__DDS_R16F:
+	case STBI__DDS_RG16F:
+	case STBI__DDS_RGBA16F:
+		for( c = 0; c < stbi__dds_fetch_channels( format ); ++c ) pixel[c] = stbi__dds_small_float( stbi__dds_read16( p + c * 2 ), 10, 1 );
+		break;
+	case STBI__DDS_R32F:
+	case STBI__DDS_RG32F:
+	case STBI__DDS_RGBA32F:
+		for( c = 0; c < stbi__dds_fetch_channels( format ); ++c ) pixel[c] = stbi__dds_read_float( p + c * 4 );
+		break;
+	case STBI__DDS_RGB10A2:
+		packed = stbi__dds_read32( p );
+		pixel[0] = (packed & 1023) / 1023.0f;
+		pixel[1] = ((packed >> 10) & 1023) / 1023.0f;
+		pixel[2] = ((packed >> 20) & 1023) / 1023.0f;
+		pixel[3] = (packed >> 30) / 3.0f;
+		break;
+	case STBI__DDS_RG11B10F:
+		packed = stbi__dds_read32( p );
+		pixel[0] = stbi__dds_small_float( packed & 2047, 6, 0 );
+		pixel[1] = stbi__dds_small_float( (packed >> 11) & 2047, 6, 0 );
+		pixel[2] = stbi__dds_small_float( packed >> 22, 5, 0 );
+		break;
 	}
-	if( header.sPixelFormat.dwSize != 32 ) {
-	   stbi__rewind( s );
-	   return 0;
+}
+
+//	one block, to RGBA bytes, or to RGB floats for BC6H
+static void stbi__dds_decode_block( int format, const stbi_uc *source,
+			unsigned char block[16*4], float block_f[16*3] )
+{
+	unsigned char compressed[16];
+	int i;
+	memcpy( compressed, source, (format == STBI__DDS_BC1 || format == STBI__DDS_BC4 ||
+		format == STBI__DDS_BC4S) ? 8 : 16 );
+	switch( format )
+	{
+	case STBI__DDS_BC1:
+		stbi_decode_DXT1_block( block, compressed );
+		break;
+	case STBI__DDS_BC2:
+		stbi_decode_DXT23_alpha_block( block, compressed );
+		stbi_decode_DXT_color_block( block, compressed + 8 );
+		break;
+	case STBI__DDS_BC3:
+		stbi_decode_DXT45_alpha_block( block, compressed );
+		stbi_decode_DXT_color_block( block, compressed + 8 );
+		break;
+	case STBI__DDS_BC4:
+	case STBI__DDS_BC4S:
+	case STBI__DDS_BC5:
+	case STBI__DDS_BC5S:
+		for( i = 0; i < 16*4; ++i )
+		{
+			block[i] = ((i & 3) == 3) ? 255 : 0;
+		}
+		stbi_decode_BC4_block( block, 0, format == STBI__DDS_BC4S || format == STBI__DDS_BC5S, compressed );
+		if( format == STBI__DDS_BC5 || format == STBI__DDS_BC5S )
+		{
+			stbi_decode_BC4_block( block, 1, format == STBI__DDS_BC5S, compressed + 8 );
+		}
+		break;
+	case STBI__DDS_BC6H:
+	case STBI__DDS_BC6HS:
+		BC6H_decode_block( compressed, format == STBI__DDS_BC6HS, block_f );
+		break;
+	case STBI__DDS_BC7:
+		BC7_decode_block( compressed, block );
+		break;
 	}
-	flags = DDPF_FOURCC | DDPF_RGB;
-	if( (header.sPixelFormat.dwFlags & flags) == 0 ) {
-	   stbi__rewind( s );
-	   return 0;
+}
+
+static void stbi__dds_decode_rows( void *argument )
+{
+	const stbi__dds_decode_job *job = (const stbi__dds_decode_job*)argument;
+	const stbi__dds_format *format = job->format;
+	const int n = format->channels;
+	unsigned char block[16*4];
+	float block_f[16*3];
+	float pixel[4];
+	int row, i, x, y, c;
+	for( row = job->first_row; row < job->last_row; ++row )
+	{
+		const stbi_uc *source = job->source + (size_t)row * job->pitch;
+		if( format->block_compressed )
+		{
+			for( i = 0; i * 4 < job->width; ++i, source += format->block_size )
+			{
+				//	is this a partial block?
+				const int bw = (job->width - i * 4 < 4) ? job->width - i * 4 : 4;
+				const int bh = (job->height - row * 4 < 4) ? job->height - row * 4 : 4;
+				stbi__dds_decode_block( format->format, source, block, block_f );
+				for( y = 0; y < bh; ++y )
+				{
+					const size_t idx = ((size_t)(row * 4 + y) * job->width + i * 4) * n;
+					for( x = 0; x < bw; ++x )
+					{
+						for( c = 0; c < n; ++c )
+						{
+							if( format->is_float )
+							{
+								job->output_f[idx + x * n + c] = block_f[(y * 4 + x) * 3 + c];
+							} else
+							{
+								job->output[idx + x * n + c] = block[(y * 4 + x) * 4 + c];
+							}
+						}
+					}
+				}
+			}
+		} else
+		{
+			const size_t idx = (size_t)row * job->width * n;
+			for( x = 0; x < job->width; ++x, source += format->block_size )
+			{
+				stbi__dds_fetch_pixel( format->format, source, pixel );
+				for( c = 0; c < n; ++c )
+				{
+					if( format->is_float )
+					{
+						job->output_f[idx + x * n + c] = pixel[c];
+					} else
+					{
+						const float v = pixel[c] * 255.0f + 0.5f;
+						job->output[idx + x * n + c] = (stbi_uc)(v < 0.0f ? 0.0f : (v > 255.0f ? 255.0f : v));
+					}
+				}
+			}
+		}
 	}
-	if( (header.sCaps.dwCaps1 & DDSCAPS_TEXTURE) == 0 ) {
-	   stbi__rewind( s );
-	   return 0;
+}
+
+//	large images are split in rows across the shared thread pool
+static void stbi__dds_decode( stbi__dds_decode_job *single )
+{
+	stbi__dds_decode_job *jobs;
+	struct SOIL_ThreadPool *pool;
+	thread_pool_group group;
+	int job_count, i;
+	const int rows = single->last_row;
+	pool = ((long long)single->width * single->height >= STBI__DDS_THREADED_MIN_PIXELS) ?
+		thread_pool_shared() : NULL;
+	job_count = pool ? thread_pool_thread_count( pool ) * 4 : 1;
+	if( job_count > rows )
+	{
+		job_count = rows;
+	}
+	jobs = job_count > 1 ? (stbi__dds_decode_job*)STBI_MALLOC( job_count * sizeof( stbi__dds_decode_job ) ) : NULL;
+	if( NULL == jobs )
+	{
+		stbi__dds_decode_rows( single );
+		return;
+	}
+	thread_pool_group_init( &group );
+	for( i = 0; i < job_count; ++i )
+	{
+		jobs[i] = *single;
+		jobs[i].first_row = (int)( (long long)rows * i / job_count );
+		jobs[i].last_row = (int)( (long long)rows * (i + 1) / job_count );
+		if( !thread_pool_submit( pool, &group, stbi__dds_decode_rows, &jobs[i] ) )
+		{
+			//	out of memory queueing, do it here
+			stbi__dds_decode_rows( &jobs[i] );
+		}
 	}
+	thread_pool_wait( pool, &group );
+	STBI_FREE( jobs );
+}
 
-	is_compressed = (header.sPixelFormat.dwFlags & DDPF_FOURCC) / DDPF_FOURCC;
-	has_alpha = (header.sPixelFormat.dwFlags & DDPF_ALPHAPIXELS) / DDPF_ALPHAPIXELS;
+//	decodes the top level of every face, stacked vertically, to
+//	bytes or to floats (format->is_float), the MIPmaps are skipped
+static void *stbi__dds_decode_faces( stbi__context *s, const DDS_header *header, const stbi__dds_format *format )
+{
+	const int width = header->dwWidth;
+	const int height = header->dwHeight;
+	const int n = format->channels;
+	const size_t value_size = format->is_float ? sizeof( float ) : 1;
+	const int has_mipmap = (header->sCaps.dwCaps1 & DDSCAPS_MIPMAP) && (header->dwMipMapCount > 1);
+	stbi__dds_decode_job job;
+	stbi_uc *source, *output;
+	size_t pitch, source_size;
+	int rows, cf, i;
+	if( !stbi__mad3sizes_valid( width, height * format->faces, n * (int)value_size, 0 ) ||
+		(height > 0x7fffffff / format->faces) )
+	{
+		return stbi__errpuc( "too large", "DDS too large" );
+	}
+	if( format->block_compressed )
+	{
+		pitch = (size_t)((width + 3) >> 2) * format->block_size;
+		rows = (height + 3) >> 2;
+	} else
+	{
+		//	DDS only records the top-level pitch, and not always
+		pitch = (size_t)width * format->block_size;
+		if( (header->dwFlags & DDSD_PITCH) && (header->dwPitchOrLinearSize >= pitch) )
+		{
+			pitch = header->dwPitchOrLinearSize;
+		}
+		rows = height;
+	}
+	source_size = pitch * rows;
+	if( source_size > 0x7fffffff )
+	{
+		return stbi__errpuc( "too large", "DDS too large" );
+	}
+	source = (stbi_uc*)STBI_MALLOC( source_size );
+	output = (stbi_uc*)STBI_MALLOC( (size_t)width * height * format->faces * n * value_size );
+	if( (NULL == source) || (NULL == output) )
+	{
+		STBI_FREE( source );
+		STBI_FREE( output );
+		return stbi__errpuc( "outofmem", "Out of memory" );
+	}
+	memset( &job, 0, sizeof( job ) );
+	job.format = format;
+	job.source = source;
+	job.pitch = pitch;
+	job.width = width;
+	job.height = height;
+	job.first_row = 0;
+	job.last_row = rows;
+	/*	do this once for each face	*/
+	for( cf = 0; cf < format->faces; ++cf )
+	{
+		const size_t face_offset = (size_t)width * height * n * cf;
+		if( !stbi__getn( s, source, (int)source_size ) )
+		{
+			STBI_FREE( source );
+			STBI_FREE( output );
+			return stbi__errpuc( "truncated DDS", "DDS file is truncated" );
+		}
+		if( format->is_float )
+		{
+			job.output_f = (float*)output + face_offset;
+		} else
+		{
+			job.output = output + face_offset;
+		}
+		stbi__dds_decode( &job );
+		/*	done reading and decoding the main image...
+			stbi__skip MIPmaps if present	*/
+		if( has_mipmap )
+		{
+			for( i = 1; i < (int)header->dwMipMapCount; ++i )
+			{
+				int mx = width >> i;
+				int my = height >> i;
+				if( mx < 1 )
+				{
+					mx = 1;
+				}
+				if( my < 1 )
+				{
+					my = 1;
+				}
+				if( format->block_compressed )
+				{
+					stbi__skip( s, ((mx + 3) >> 2) * ((my + 3) >> 2) * format->block_size );
+				} else
+				{
+					stbi__skip( s, mx * my * format->block_size );
+				}
+			}
+		}
+	}
+	STBI_FREE( source );
+	return output;
+}
 
-	*x = header.dwWidth;
-	*y = header.dwHeight;
+//	the 8 bit version of an HDR format, like a Radiance file
+static stbi_uc *stbi__dds_float_to_ldr( float *data, int x, int y, int comp )
+{
+#ifndef STBI_NO_HDR
+	return stbi__hdr_to_ldr( data, x, y, comp );
+#else
+	stbi_uc *output;
+	size_t i;
+	if( NULL == data ) return NULL;
+	output = (stbi_uc*)STBI_MALLOC( (size_t)x * y * comp );
+	if( NULL != output )
+	{
+		for( i = 0; i < (size_t)x * y * comp; ++i )
+		{
+			const float v = data[i] * 255.0f + 0.5f;
+			output[i] = (stbi_uc)(v < 0.0f ? 0.0f : (v > 255.0f ? 255.0f : v));
+		}
+	}
+	STBI_FREE( data );
+	return output ? output : stbi__errpuc( "outofmem", "Out of memory" );
+#endif
+}
 
-	if ( !is_compressed ) {
-		*comp = 3;
+static int stbi__dds_info( stbi__context *s, int *x, int *y, int *comp, int *iscompressed ) {
+	DDS_header header;
+	stbi__dds_format format;
 
-		if ( has_alpha )
-			*comp = 4;
+	if( !stbi__dds_parse( s, &header, &format ) ) {
+	   stbi__rewind( s );
+	   return 0;
 	}
-	else
-		*comp = 4;
+
+	*x = header.dwWidth;
+	*y = header.dwHeight;
+	*comp = format.channels;
 
 	if ( iscompressed )
-		*iscompressed = is_compressed;
+		*iscompressed = format.block_compressed;
 
+	stbi__rewind( s );
 	return 1;
 }
 
@@ -337,162 +929,46 @@ int stbi__dds_info_from_file(FILE *f,                  int *x, int *y, int *comp
 }
 #endif
 
-static void * stbi__dds_load(stbi__context *s, int *x, int *y, int *comp, int req_comp)
+//	the pixels following the headers, as bytes
+static stbi_uc *stbi__dds_load_pixels(stbi__context *s, const DDS_header *parsed_header, const stbi__dds_format *parsed_format, int *x, int *y, int *comp, int req_comp)
 {
 	//	all variables go up front
 	stbi_uc *dds_data = NULL;
-	stbi_uc block[16*4];
-	stbi_uc compressed[8];
-	int flags, DXT_family;
 	int has_alpha, has_mipmap;
-	int is_compressed, cubemap_faces;
-	int block_pitch, num_blocks;
-	DDS_header header={0};
+	DDS_header header = *parsed_header;
+	stbi__dds_format format = *parsed_format;
 	int i, sz, cf;
-	//	load the header
-	if( sizeof( DDS_header ) != 128 )
-	{
-		return NULL;
-	}
-	stbi__getn( s, (stbi_uc*)(&header), 128 );
-	//	and do some checking
-	if( header.dwMagic != (('D' << 0) | ('D' << 8) | ('S' << 16) | (' ' << 24)) ) return NULL;
-	if( header.dwSize != 124 ) return NULL;
-	flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT;
-	if( (header.dwFlags & flags) != (unsigned int)flags ) return NULL;
-	/*	According to the MSDN spec, the dwFlags should contain
-		DDSD_LINEARSIZE if it's compressed, or DDSD_PITCH if
-		uncompressed.  Some DDS writers do not conform to the
-		spec, so I need to make my reader more tolerant	*/
-	if( header.sPixelFormat.dwSize != 32 ) return NULL;
-	flags = DDPF_FOURCC | DDPF_RGB;
-	if( (header.sPixelFormat.dwFlags & flags) == 0 ) return NULL;
-	if( (header.sCaps.dwCaps1 & DDSCAPS_TEXTURE) == 0 ) return NULL;
 	//	get the image data
 	s->img_x = header.dwWidth;
 	s->img_y = header.dwHeight;
-	s->img_n = 4;
+	s->img_n = format.channels;
 
 	if (!stbi__mad3sizes_valid(s->img_x, s->img_y, s->img_n, 0))
 		return stbi__errpuc("too large", "DDS too large");
 
-	is_compressed = (header.sPixelFormat.dwFlags & DDPF_FOURCC) / DDPF_FOURCC;
-	has_alpha = (header.sPixelFormat.dwFlags & DDPF_ALPHAPIXELS) / DDPF_ALPHAPIXELS;
 	has_mipmap = (header.sCaps.dwCaps1 & DDSCAPS_MIPMAP) && (header.dwMipMapCount > 1);
-	cubemap_faces = (header.sCaps.dwCaps2 & DDSCAPS2_CUBEMAP) / DDSCAPS2_CUBEMAP;
-	/*	I need cubemaps to have square faces	*/
-	cubemap_faces &= (s->img_x == s->img_y);
-	cubemap_faces *= 5;
-	cubemap_faces += 1;
-	block_pitch = (s->img_x+3) >> 2;
-	num_blocks = block_pitch * ((s->img_y+3) >> 2);
 	/*	let the user know what's going on	*/
 	*x = s->img_x;
 	*y = s->img_y;
 	*comp = s->img_n;
+	sz = s->img_x*s->img_y*s->img_n*format.faces;
 	/*	is this uncompressed?	*/
-	if( is_compressed )
-	{
-		/*	compressed	*/
-		//	note: header.sPixelFormat.dwFourCC is something like (('D'<<0)|('X'<<8)|('T'<<16)|('1'<<24))
-		DXT_family = 1 + (header.sPixelFormat.dwFourCC >> 24) - '1';
-		if( (DXT_family < 1) || (DXT_family > 5) ) return NULL;
-		/*	check the expected size...oops, nevermind...
-			those non-compliant writers leave
-			dwPitchOrLinearSize == 0	*/
-		//	passed all the tests, get the RAM for decoding
-		sz = (s->img_x)*(s->img_y)*4*cubemap_faces;
-		dds_data = (unsigned char*)malloc( sz );
-		/*	do this once for each face	*/
-		for( cf = 0; cf < cubemap_faces; ++ cf )
+	if( format.format != STBI__DDS_LEGACY_RGB )
+	{
+		/*	decoded by block, or by pixel	*/
+		dds_data = (stbi_uc*)stbi__dds_decode_faces( s, &header, &format );
+		if( format.is_float )
 		{
-			//	now read and decode all the blocks
-			for( i = 0; i < num_blocks; ++i )
-			{
-				//	where are we?
-				int bx, by, bw=4, bh=4;
-				int ref_x = 4 * (i % block_pitch);
-				int ref_y = 4 * (i / block_pitch);
-				//	get the next block's worth of compressed data, and decompress it
-				if( DXT_family == 1 )
-				{
-					//	DXT1
-					stbi__getn( s, compressed, 8 );
-					stbi_decode_DXT1_block( block, compressed );
-				} else if( DXT_family < 4 )
-				{
-					//	DXT2/3
-					stbi__getn( s, compressed, 8 );
-					stbi_decode_DXT23_alpha_block ( block, compressed );
-					stbi__getn( s, compressed, 8 );
-					stbi_decode_DXT_color_block ( block, compressed );
-				} else
-				{
-					//	DXT4/5
-					stbi__getn( s, compressed, 8 );
-					stbi_decode_DXT45_alpha_block ( block, compressed );
-					stbi__getn( s, compressed, 8 );
-					stbi_decode_DXT_color_block ( block, compressed );
-				}
-				//	is this a partial block?
-				if( ref_x + 4 > (int)s->img_x )
-				{
-					bw = s->img_x - ref_x;
-				}
-				if( ref_y + 4 > (int)s->img_y )
-				{
-					bh = s->img_y - ref_y;
-				}
-				//	now drop our decompressed data into the buffer
-				for( by = 0; by < bh; ++by )
-				{
-					int idx = 4*((ref_y+by+cf*s->img_x)*s->img_x + ref_x);
-					for( bx = 0; bx < bw*4; ++bx )
-					{
-
-						dds_data[idx+bx] = block[by*16+bx];
-					}
-				}
-			}
-			/*	done reading and decoding the main image...
-				stbi__skip MIPmaps if present	*/
-			if( has_mipmap )
-			{
-				int block_size = 16;
-				if( DXT_family == 1 )
-				{
-					block_size = 8;
-				}
-				for( i = 1; i < (int)header.dwMipMapCount; ++i )
-				{
-					int mx = s->img_x >> (i + 2);
-					int my = s->img_y >> (i + 2);
-					if( mx < 1 )
-					{
-						mx = 1;
-					}
-					if( my < 1 )
-					{
-						my = 1;
-					}
-					stbi__skip( s, mx*my*block_size );
-				}
-			}
-		}/* per cubemap face */
+			dds_data = stbi__dds_float_to_ldr( (float*)dds_data, s->img_x, s->img_y * format.faces, s->img_n );
+		}
+		if( NULL == dds_data ) return NULL;
 	} else
 	{
 		/*	uncompressed	*/
-		DXT_family = 0;
-		s->img_n = 3;
-		if( has_alpha )
-		{
-			s->img_n = 4;
-		}
-		*comp = s->img_n;
-		sz = s->img_x*s->img_y*s->img_n*cubemap_faces;
 		dds_data = (unsigned char*)malloc( sz );
+		if( NULL == dds_data ) return stbi__errpuc("outofmem", "Out of memory");
 		/*	do this once for each face	*/
-		for( cf = 0; cf < cubemap_faces; ++ cf )
+		for( cf = 0; cf < format.faces; ++ cf )
 		{
 			/*	read the main image for this face	*/
 			stbi__getn( s, &dds_data[cf*s->img_x*s->img_y*s->img_n], s->img_x*s->img_y*s->img_n );
@@ -524,10 +1000,10 @@ static void * stbi__dds_load(stbi__context *s, int *x, int *y, int *comp, int re
 			dds_data[i+2] = temp;
 		}
 	}
-	/*	finished decompressing into RGBA,
+	/*	finished decompressing,
 		adjust the y size if we have a cubemap
 		note: sz is already up to date	*/
-	s->img_y *= cubemap_faces;
+	s->img_y *= format.faces;
 	*y = s->img_y;
 	//	did the user want something else, or
 	//	see if all the alpha values are 255 (i.e. no transparency)
@@ -560,6 +1036,88 @@ static void * stbi__dds_load(stbi__context *s, int *x, int *y, int *comp, int re
 	return dds_data;
 }
 
+static void * stbi__dds_load(stbi__context *s, int *x, int *y, int *comp, int req_comp)
+{
+	DDS_header header;
+	stbi__dds_format format;
+	//	load the header, and do some checking
+	if( !stbi__dds_parse( s, &header, &format ) ) return NULL;
+	return stbi__dds_load_pixels( s, &header, &format, x, y, comp, req_comp );
+}
+
+#if !defined(STBI_NO_LINEAR) && !defined(STBI_NO_HDR)
+
+//	stbi__convert_format, for floats
+static float *stbi__dds_convert_float( float *data, int img_n, int req_comp, int x, int y )
+{
+	float *output;
+	size_t i;
+	int c;
+	output = (float*)stbi__malloc_mad4( x, y, req_comp, sizeof( float ), 0 );
+	if( NULL == output )
+	{
+		STBI_FREE( data );
+		return stbi__errpf( "outofmem", "Out of memory" );
+	}
+	for( i = 0; i < (size_t)x * y; ++i )
+	{
+		const float *src = data + i * img_n;
+		float *dest = output + i * req_comp;
+		float rgba[4];
+		rgba[0] = src[0];
+		rgba[1] = (img_n >= 3) ? src[1] : src[0];
+		rgba[2] = (img_n >= 3) ? src[2] : src[0];
+		rgba[3] = (img_n == 4) ? src[3] : ((img_n == 2) ? src[1] : 1.0f);
+		if( req_comp <= 2 )
+		{
+			//	the same weights as stbi__compute_y
+			dest[0] = (img_n >= 3) ? (rgba[0] * 77 + rgba[1] * 150 + rgba[2] * 29) / 256.0f : rgba[0];
+			if( req_comp == 2 )
+			{
+				dest[1] = rgba[3];
+			}
+		} else
+		{
+			for( c = 0; c < req_comp; ++c )
+			{
+				dest[c] = rgba[c];
+			}
+		}
+	}
+	STBI_FREE( data );
+	return output;
+}
+
+/*	the float formats (BC6H, half and full floats, R11G11B10) keep their
+	range, the others go through stbi__ldr_to_hdr.  This is done in one
+	pass as the DX10 header doesn't fit the buffer stbi__rewind relies on	*/
+static float *stbi__dds_loadf( stbi__context *s, int *x, int *y, int *comp, int req_comp )
+{
+	DDS_header header;
+	stbi__dds_format format;
+	float *dds_data;
+	if( !stbi__dds_parse( s, &header, &format ) )
+	{
+		return stbi__errpf( "bad DDS", "Corrupt or unsupported DDS" );
+	}
+	if( !format.is_float )
+	{
+		stbi_uc *data = stbi__dds_load_pixels( s, &header, &format, x, y, comp, req_comp );
+		return data ? stbi__ldr_to_hdr( data, *x, *y, req_comp ? req_comp : *comp ) : NULL;
+	}
+	dds_data = (float*)stbi__dds_decode_faces( s, &header, &format );
+	if( NULL == dds_data ) return NULL;
+	*x = header.dwWidth;
+	*y = header.dwHeight * format.faces;
+	*comp = format.channels;
+	if( (req_comp >= 1) && (req_comp <= 4) && (req_comp != format.channels) )
+	{
+		dds_data = stbi__dds_convert_float( dds_data, format.channels, req_comp, *x, *y );
+	}
+	return dds_data;
+}
+#endif
+
 #ifndef STBI_NO_STDIO
 void *stbi__dds_load_from_file   (FILE *f,                  int *x, int *y, int *comp, int req_comp)
 {
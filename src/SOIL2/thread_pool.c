@@ -0,0 +1,641 @@
+/*
+	thread pool for the batch image loaders
+
+	MIT license
+*/
+
+#if !defined( _WIN32 ) && !defined( _POSIX_C_SOURCE ) && !defined( __APPLE__ )
+	/*	clock_gettime and pthreads on strict C builds	*/
+	#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "thread_pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined( SOIL_NO_THREADS )
+	#if defined( _WIN32 )
+		/*	condition variables and one-time initialization need Vista	*/
+		#if !defined( _WIN32_WINNT ) || _WIN32_WINNT < 0x0600
+			#undef _WIN32_WINNT
+			#define _WIN32_WINNT 0x0600
+		#endif
+		#ifndef WIN32_LEAN_AND_MEAN
+			#define WIN32_LEAN_AND_MEAN
+		#endif
+		#include <windows.h>
+		#include <process.h>
+		#define THREAD_POOL_WIN32
+	#else
+		#include <pthread.h>
+		#include <unistd.h>
+		#define THREAD_POOL_PTHREADS
+	#endif
+#endif
+
+#if defined( _WIN32 )
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+#else
+	#include <time.h>
+#endif
+
+/*	the few threading primitives the pool needs	*/
+#if defined( THREAD_POOL_WIN32 )
+typedef CRITICAL_SECTION tp_mutex;
+typedef CONDITION_VARIABLE tp_cond;
+typedef HANDLE tp_thread;
+
+static void tp_mutex_init( tp_mutex *m )		{ InitializeCriticalSection( m ); }
+static void tp_mutex_destroy( tp_mutex *m )		{ DeleteCriticalSection( m ); }
+static void tp_mutex_lock( tp_mutex *m )		{ EnterCriticalSection( m ); }
+static void tp_mutex_unlock( tp_mutex *m )		{ LeaveCriticalSection( m ); }
+static void tp_cond_init( tp_cond *c )			{ InitializeConditionVariable( c ); }
+static void tp_cond_destroy( tp_cond *c )		{ (void)c; }
+static void tp_cond_wait( tp_cond *c, tp_mutex *m )	{ SleepConditionVariableCS( c, m, INFINITE ); }
+static void tp_cond_signal( tp_cond *c )		{ WakeConditionVariable( c ); }
+static void tp_cond_broadcast( tp_cond *c )		{ WakeAllConditionVariable( c ); }
+#elif defined( THREAD_POOL_PTHREADS )
+typedef pthread_mutex_t tp_mutex;
+typedef pthread_cond_t tp_cond;
+typedef pthread_t tp_thread;
+
+static void tp_mutex_init( tp_mutex *m )		{ pthread_mutex_init( m, NULL ); }
+static void tp_mutex_destroy( tp_mutex *m )		{ pthread_mutex_destroy( m ); }
+static void tp_mutex_lock( tp_mutex *m )		{ pthread_mutex_lock( m ); }
+static void tp_mutex_unlock( tp_mutex *m )		{ pthread_mutex_unlock( m ); }
+static void tp_cond_init( tp_cond *c )			{ pthread_cond_init( c, NULL ); }
+static void tp_cond_destroy( tp_cond *c )		{ pthread_cond_destroy( c ); }
+static void tp_cond_wait( tp_cond *c, tp_mutex *m )	{ pthread_cond_wait( c, m ); }
+static void tp_cond_signal( tp_cond *c )		{ pthread_cond_signal( c ); }
+static void tp_cond_broadcast( tp_cond *c )		{ pthread_cond_broadcast( c ); }
+#else
+/*	no threads: the pool has no workers and everything is a no-op	*/
+typedef int tp_mutex;
+typedef int tp_cond;
+typedef int tp_thread;
+
+static void tp_mutex_init( tp_mutex *m )		{ (void)m; }
+static void tp_mutex_destroy( tp_mutex *m )		{ (void)m; }
+static void tp_mutex_lock( tp_mutex *m )		{ (void)m; }
+static void tp_mutex_unlock( tp_mutex *m )		{ (void)m; }
+static void tp_cond_init( tp_cond *c )			{ (void)c; }
+static void tp_cond_destroy( tp_cond *c )		{ (void)c; }
+static void tp_cond_wait( tp_cond *c, tp_mutex *m )	{ (void)c; (void)m; }
+static void tp_cond_signal( tp_cond *c )		{ (void)c; }
+static void tp_cond_broadcast( tp_cond *c )		{ (void)c; }
+#endif
+
+typedef struct
+{
+	thread_pool_task task;
+	/*	runs once the group no longer counts the task, may be NULL	*/
+	thread_pool_task done;
+	void *argument;
+	thread_pool_group *group;
+} tp_job;
+
+/*	a ring buffer, the owner pops from the back and thieves from the front	*/
+typedef struct
+{
+	tp_mutex lock;
+	tp_job *jobs;
+	int capacity;
+	int head;
+	int count;
+} tp_deque;
+
+typedef struct
+{
+	struct SOIL_ThreadPool *pool;
+	int index;
+	tp_thread thread;
+} tp_worker;
+
+struct SOIL_ThreadPool
+{
+	tp_mutex lock;
+	tp_cond work_available;
+	tp_cond group_done;
+	/*	one deque per worker, and at least one for a pool without workers	*/
+	tp_deque *deques;
+	int deque_count;
+	tp_worker *workers;
+	int thread_count;
+	/*	protected by lock	*/
+	int queued;
+	int shutdown;
+	unsigned int next_deque;
+};
+
+static int tp_deque_push( tp_deque *deque, const tp_job *job )
+{
+	tp_mutex_lock( &deque->lock );
+	if( deque->count == deque->capacity )
+	{
+		int new_capacity = deque->capacity > 0 ? deque->capacity * 2 : 16;
+		tp_job *jobs = (tp_job *)malloc( new_capacity * sizeof(tp_job) );
+		int i;
+		if( NULL == jobs )
+		{
+			tp_mutex_unlock( &deque->lock );
+			return 0;
+		}
+		for( i = 0; i < deque->count; ++i )
+		{
+			jobs[i] = deque->jobs[( deque->head + i ) % deque->capacity];
+		}
+		free( deque->jobs );
+		deque->jobs = jobs;
+		deque->capacity = new_capacity;
+		deque->head = 0;
+	}
+	deque->jobs[( deque->head + deque->count ) % deque->capacity] = *job;
+	++deque->count;
+	tp_mutex_unlock( &deque->lock );
+	return 1;
+}
+
+static int tp_deque_pop( tp_deque *deque, int from_back, tp_job *job )
+{
+	int found = 0;
+	tp_mutex_lock( &deque->lock );
+	if( deque->count > 0 )
+	{
+		if( from_back )
+		{
+			*job = deque->jobs[( deque->head + deque->count - 1 ) % deque->capacity];
+		}
+		else
+		{
+			*job = deque->jobs[deque->head];
+			deque->head = ( deque->head + 1 ) % deque->capacity;
+		}
+		--deque->count;
+		found = 1;
+	}
+	tp_mutex_unlock( &deque->lock );
+	return found;
+}
+
+/*	own deque first (newest job, its data is likely still in cache),
+	then steal the oldest job of the others	*/
+static int tp_take_job( struct SOIL_ThreadPool *pool, int own_deque, tp_job *job )
+{
+	int first = own_deque >= 0 ? own_deque : 0;
+	int i;
+
+	for( i = 0; i < pool->deque_count; ++i )
+	{
+		int index = ( first + i ) % pool->deque_count;
+		if( tp_deque_pop( &pool->deques[index], index == own_deque, job ) )
+		{
+			tp_mutex_lock( &pool->lock );
+			--pool->queued;
+			tp_mutex_unlock( &pool->lock );
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static void tp_run_job( struct SOIL_ThreadPool *pool, const tp_job *job )
+{
+	job->task( job->argument );
+
+	tp_mutex_lock( &pool->lock );
+	if( 0 == --job->group->pending )
+	{
+		tp_cond_broadcast( &pool->group_done );
+	}
+	tp_mutex_unlock( &pool->lock );
+
+	if( NULL != job->done )
+	{
+		job->done( job->argument );
+	}
+}
+
+#if defined( THREAD_POOL_WIN32 ) || defined( THREAD_POOL_PTHREADS )
+static void tp_worker_loop( tp_worker *worker )
+{
+	struct SOIL_ThreadPool *pool = worker->pool;
+	tp_job job;
+
+	for( ;; )
+	{
+		if( tp_take_job( pool, worker->index, &job ) )
+		{
+			tp_run_job( pool, &job );
+			continue;
+		}
+
+		tp_mutex_lock( &pool->lock );
+		while( pool->queued <= 0 && !pool->shutdown )
+		{
+			tp_cond_wait( &pool->work_available, &pool->lock );
+		}
+		if( pool->shutdown && pool->queued <= 0 )
+		{
+			tp_mutex_unlock( &pool->lock );
+			break;
+		}
+		tp_mutex_unlock( &pool->lock );
+	}
+}
+#endif
+
+#if defined( THREAD_POOL_WIN32 )
+static unsigned __stdcall tp_worker_main( void *argument )
+{
+	tp_worker_loop( (tp_worker *)argument );
+	return 0;
+}
+
+static int tp_thread_start( tp_worker *worker )
+{
+	worker->thread = (HANDLE)_beginthreadex( NULL, 0, tp_worker_main, worker, 0, NULL );
+	return NULL != worker->thread;
+}
+
+static void tp_thread_join( tp_worker *worker )
+{
+	WaitForSingleObject( worker->thread, INFINITE );
+	CloseHandle( worker->thread );
+}
+#elif defined( THREAD_POOL_PTHREADS )
+static void *tp_worker_main( void *argument )
+{
+	tp_worker_loop( (tp_worker *)argument );
+	return NULL;
+}
+
+static int tp_thread_start( tp_worker *worker )
+{
+	return 0 == pthread_create( &worker->thread, NULL, tp_worker_main, worker );
+}
+
+static void tp_thread_join( tp_worker *worker )
+{
+	pthread_join( worker->thread, NULL );
+}
+#else
+static int tp_thread_start( tp_worker *worker )
+{
+	(void)worker;
+	return 0;
+}
+
+static void tp_thread_join( tp_worker *worker )
+{
+	(void)worker;
+}
+#endif
+
+int
+	thread_pool_cpu_count
+	(
+		void
+	)
+{
+	int count = 1;
+#if defined( THREAD_POOL_WIN32 )
+	SYSTEM_INFO info;
+	GetSystemInfo( &info );
+	count = (int)info.dwNumberOfProcessors;
+#elif defined( THREAD_POOL_PTHREADS ) && defined( _SC_NPROCESSORS_ONLN )
+	count = (int)sysconf( _SC_NPROCESSORS_ONLN );
+#endif
+	return count > 0 ? count : 1;
+}
+
+struct SOIL_ThreadPool *
+	thread_pool_create
+	(
+		int thread_count
+	)
+{
+	struct SOIL_ThreadPool *pool;
+	int i;
+
+#if defined( THREAD_POOL_WIN32 ) || defined( THREAD_POOL_PTHREADS )
+	if( thread_count <= 0 )
+	{
+		thread_count = thread_pool_cpu_count();
+	}
+#else
+	thread_count = 0;
+#endif
+
+	pool = (struct SOIL_ThreadPool *)malloc( sizeof(struct SOIL_ThreadPool) );
+	if( NULL == pool )
+	{
+		return NULL;
+	}
+	memset( pool, 0, sizeof(struct SOIL_ThreadPool) );
+
+	pool->deque_count = thread_count > 0 ? thread_count : 1;
+	pool->deques = (tp_deque *)calloc( pool->deque_count, sizeof(tp_deque) );
+	pool->workers = (tp_worker *)calloc( pool->deque_count, sizeof(tp_worker) );
+	if( NULL == pool->deques || NULL == pool->workers )
+	{
+		free( pool->deques );
+		free( pool->workers );
+		free( pool );
+		return NULL;
+	}
+
+	tp_mutex_init( &pool->lock );
+	tp_cond_init( &pool->work_available );
+	tp_cond_init( &pool->group_done );
+	for( i = 0; i < pool->deque_count; ++i )
+	{
+		tp_mutex_init( &pool->deques[i].lock );
+	}
+
+	/*	a worker that fails to start leaves its deque to be stolen from	*/
+	for( i = 0; i < thread_count; ++i )
+	{
+		tp_worker *worker = &pool->workers[pool->thread_count];
+		worker->pool = pool;
+		worker->index = i;
+		if( tp_thread_start( worker ) )
+		{
+			++pool->thread_count;
+		}
+	}
+
+	return pool;
+}
+
+void
+	thread_pool_destroy
+	(
+		struct SOIL_ThreadPool *pool
+	)
+{
+	tp_job job;
+	int i;
+
+	if( NULL == pool )
+	{
+		return;
+	}
+
+	/*	jobs left on deques without a worker are run here	*/
+	while( tp_take_job( pool, -1, &job ) )
+	{
+		tp_run_job( pool, &job );
+	}
+
+	tp_mutex_lock( &pool->lock );
+	pool->shutdown = 1;
+	tp_cond_broadcast( &pool->work_available );
+	tp_mutex_unlock( &pool->lock );
+
+	for( i = 0; i < pool->thread_count; ++i )
+	{
+		tp_thread_join( &pool->workers[i] );
+	}
+
+	for( i = 0; i < pool->deque_count; ++i )
+	{
+		tp_mutex_destroy( &pool->deques[i].lock );
+		free( pool->deques[i].jobs );
+	}
+	tp_cond_destroy( &pool->group_done );
+	tp_cond_destroy( &pool->work_available );
+	tp_mutex_destroy( &pool->lock );
+	free( pool->deques );
+	free( pool->workers );
+	free( pool );
+}
+
+static struct SOIL_ThreadPool *shared_pool = NULL;
+
+#if defined( THREAD_POOL_WIN32 )
+static INIT_ONCE shared_pool_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK tp_create_shared( PINIT_ONCE once, PVOID parameter, PVOID *context )
+{
+	(void)once; (void)parameter; (void)context;
+	shared_pool = thread_pool_create( 0 );
+	return TRUE;
+}
+#elif defined( THREAD_POOL_PTHREADS )
+static pthread_once_t shared_pool_once = PTHREAD_ONCE_INIT;
+
+static void tp_create_shared( void )
+{
+	shared_pool = thread_pool_create( 0 );
+}
+#endif
+
+struct SOIL_ThreadPool *
+	thread_pool_shared
+	(
+		void
+	)
+{
+#if defined( THREAD_POOL_WIN32 )
+	InitOnceExecuteOnce( &shared_pool_once, tp_create_shared, NULL, NULL );
+#elif defined( THREAD_POOL_PTHREADS )
+	pthread_once( &shared_pool_once, tp_create_shared );
+#else
+	if( NULL == shared_pool )
+	{
+		shared_pool = thread_pool_create( 0 );
+	}
+#endif
+	return shared_pool;
+}
+
+int
+	thread_pool_thread_count
+	(
+		const struct SOIL_ThreadPool *pool
+	)
+{
+	return NULL != pool ? pool->thread_count : 0;
+}
+
+void
+	thread_pool_group_init
+	(
+		thread_pool_group *group
+	)
+{
+	group->pending = 0;
+}
+
+int
+	thread_pool_submit
+	(
+		struct SOIL_ThreadPool *pool,
+		thread_pool_group *group,
+		thread_pool_task task,
+		void *argument
+	)
+{
+	return thread_pool_submit_with_done( pool, group, task, NULL, argument );
+}
+
+int
+	thread_pool_submit_with_done
+	(
+		struct SOIL_ThreadPool *pool,
+		thread_pool_group *group,
+		thread_pool_task task,
+		thread_pool_task done,
+		void *argument
+	)
+{
+	tp_job job;
+	unsigned int index;
+
+	job.task = task;
+	job.done = done;
+	job.argument = argument;
+	job.group = group;
+
+	tp_mutex_lock( &pool->lock );
+	++group->pending;
+	index = pool->next_deque++ % (unsigned int)pool->deque_count;
+	tp_mutex_unlock( &pool->lock );
+
+	if( !tp_deque_push( &pool->deques[index], &job ) )
+	{
+		tp_mutex_lock( &pool->lock );
+		--group->pending;
+		tp_mutex_unlock( &pool->lock );
+		return 0;
+	}
+
+	tp_mutex_lock( &pool->lock );
+	++pool->queued;
+	tp_cond_signal( &pool->work_available );
+	tp_mutex_unlock( &pool->lock );
+	return 1;
+}
+
+void
+	thread_pool_wait
+	(
+		struct SOIL_ThreadPool *pool,
+		thread_pool_group *group
+	)
+{
+	tp_job job;
+
+	for( ;; )
+	{
+		tp_mutex_lock( &pool->lock );
+		if( group->pending <= 0 )
+		{
+			tp_mutex_unlock( &pool->lock );
+			return;
+		}
+		tp_mutex_unlock( &pool->lock );
+
+		if( tp_take_job( pool, -1, &job ) )
+		{
+			tp_run_job( pool, &job );
+			continue;
+		}
+
+		/*	nothing left to help with, sleep until a group finishes	*/
+		tp_mutex_lock( &pool->lock );
+		while( group->pending > 0 && pool->queued <= 0 )
+		{
+			tp_cond_wait( &pool->group_done, &pool->lock );
+		}
+		tp_mutex_unlock( &pool->lock );
+	}
+}
+
+int
+	thread_pool_group_done
+	(
+		struct SOIL_ThreadPool *pool,
+		thread_pool_group *group
+	)
+{
+	int done;
+	tp_mutex_lock( &pool->lock );
+	done = group->pending <= 0;
+	tp_mutex_unlock( &pool->lock );
+	return done;
+}
+
+struct thread_pool_mutex
+{
+	tp_mutex lock;
+};
+
+struct thread_pool_mutex *
+	thread_pool_mutex_create
+	(
+		void
+	)
+{
+	struct thread_pool_mutex *mutex = (struct thread_pool_mutex *)malloc( sizeof(struct thread_pool_mutex) );
+	if( NULL != mutex )
+	{
+		tp_mutex_init( &mutex->lock );
+	}
+	return mutex;
+}
+
+void
+	thread_pool_mutex_destroy
+	(
+		struct thread_pool_mutex *mutex
+	)
+{
+	if( NULL != mutex )
+	{
+		tp_mutex_destroy( &mutex->lock );
+		free( mutex );
+	}
+}
+
+void
+	thread_pool_mutex_lock
+	(
+		struct thread_pool_mutex *mutex
+	)
+{
+	tp_mutex_lock( &mutex->lock );
+}
+
+void
+	thread_pool_mutex_unlock
+	(
+		struct thread_pool_mutex *mutex
+	)
+{
+	tp_mutex_unlock( &mutex->lock );
+}
+
+double
+	thread_pool_time_us
+	(
+		void
+	)
+{
+#if defined( _WIN32 )
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency( &frequency );
+	QueryPerformanceCounter( &counter );
+	return (double)counter.QuadPart * 1000000.0 / (double)frequency.QuadPart;
+#elif defined( CLOCK_MONOTONIC )
+	struct timespec now;
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	return (double)now.tv_sec * 1000000.0 + (double)now.tv_nsec / 1000.0;
+#else
+	return (double)clock() * 1000000.0 / (double)CLOCKS_PER_SEC;
+#endif
+}
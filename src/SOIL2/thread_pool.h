@@ -0,0 +1,182 @@
+/*
+	Thread pool used by the batch image loaders
+
+	A fixed set of workers, each one owning a task deque.  A worker takes
+	work from the back of its own deque and steals from the front of the
+	others once it runs dry.  A thread waiting for a task group runs queued
+	tasks itself instead of sleeping, so waiting never deadlocks a pool
+	and a pool without workers still makes progress.
+
+	Define SOIL_NO_THREADS to build without threads, every task then runs
+	on the thread that waits for it.
+
+	MIT license
+*/
+
+#ifndef HEADER_THREAD_POOL
+#define HEADER_THREAD_POOL
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct SOIL_ThreadPool;
+
+typedef void (*thread_pool_task)( void *argument );
+
+/**
+	Tasks submitted with the same group are waited for together.
+	Initialize it with thread_pool_group_init before the first submit.
+**/
+typedef struct
+{
+	int pending;
+} thread_pool_group;
+
+/**
+	Number of processors available to the process, at least 1.
+**/
+int
+	thread_pool_cpu_count
+	(
+		void
+	);
+
+/**
+	Creates a pool.
+	\param thread_count the number of workers, 0 or less uses one per processor
+	\return the pool, or NULL if out of memory
+**/
+struct SOIL_ThreadPool *
+	thread_pool_create
+	(
+		int thread_count
+	);
+
+/**
+	Runs every queued task, then stops the workers and frees the pool.
+**/
+void
+	thread_pool_destroy
+	(
+		struct SOIL_ThreadPool *pool
+	);
+
+/**
+	The pool shared by the loaders when the caller doesn't provide one.
+	It is created on first use, with one worker per processor, and lives
+	until the process exits.
+**/
+struct SOIL_ThreadPool *
+	thread_pool_shared
+	(
+		void
+	);
+
+int
+	thread_pool_thread_count
+	(
+		const struct SOIL_ThreadPool *pool
+	);
+
+void
+	thread_pool_group_init
+	(
+		thread_pool_group *group
+	);
+
+/**
+	Queues a task.
+	\return 1 on success, 0 if the task could not be queued (out of memory)
+**/
+int
+	thread_pool_submit
+	(
+		struct SOIL_ThreadPool *pool,
+		thread_pool_group *group,
+		thread_pool_task task,
+		void *argument
+	);
+
+/**
+	Same as thread_pool_submit, then done runs on the same thread once
+	the group no longer counts the task.  The pool doesn't touch the
+	group after that, so done may release the memory holding it.
+**/
+int
+	thread_pool_submit_with_done
+	(
+		struct SOIL_ThreadPool *pool,
+		thread_pool_group *group,
+		thread_pool_task task,
+		thread_pool_task done,
+		void *argument
+	);
+
+/**
+	Blocks until every task of the group has run, helping the workers
+	in the meantime.
+**/
+void
+	thread_pool_wait
+	(
+		struct SOIL_ThreadPool *pool,
+		thread_pool_group *group
+	);
+
+/**
+	Non-blocking check.
+	\return 1 once every task of the group has run, and the pool no
+	longer touches the group, so its memory can be released
+**/
+int
+	thread_pool_group_done
+	(
+		struct SOIL_ThreadPool *pool,
+		thread_pool_group *group
+	);
+
+/**
+	A mutex for state shared between tasks and the threads that submit
+	them.  It is not recursive.
+**/
+struct thread_pool_mutex;
+
+struct thread_pool_mutex *
+	thread_pool_mutex_create
+	(
+		void
+	);
+
+void
+	thread_pool_mutex_destroy
+	(
+		struct thread_pool_mutex *mutex
+	);
+
+void
+	thread_pool_mutex_lock
+	(
+		struct thread_pool_mutex *mutex
+	);
+
+void
+	thread_pool_mutex_unlock
+	(
+		struct thread_pool_mutex *mutex
+	);
+
+/**
+	A monotonic clock in microseconds, for time budgets.
+**/
+double
+	thread_pool_time_us
+	(
+		void
+	);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HEADER_THREAD_POOL	*/
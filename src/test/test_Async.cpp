@@ -0,0 +1,184 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../SOIL2/SOIL2.h"
+
+#define NO_SDL_GLEXT
+#if ( ( defined( _MSCVER ) || defined( _MSC_VER ) ) || defined( __APPLE_CC__ ) || defined ( __APPLE__ ) ) && !defined( SOIL2_NO_FRAMEWORKS )
+	#include <SDL.h>
+	#include <SDL_opengl.h>
+#else
+	#include <SDL2/SDL.h>
+	#include <SDL2/SDL_opengl.h>
+#endif
+
+static int load_file_data( const std::string &path, std::vector<unsigned char> *data )
+{
+	std::ifstream input( path.c_str(), std::ios::binary );
+	if( !input )
+		return 0;
+	data->assign(
+		std::istreambuf_iterator<char>( input ),
+		std::istreambuf_iterator<char>() );
+	return !data->empty();
+}
+
+static std::vector<unsigned char> read_level( GLuint texture, int level, int *width, int *height )
+{
+	std::vector<unsigned char> pixels;
+	glBindTexture( GL_TEXTURE_2D, texture );
+	glGetTexLevelParameteriv( GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, width );
+	glGetTexLevelParameteriv( GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, height );
+	pixels.resize( (size_t)*width * (size_t)*height * 4 );
+	glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+	glGetTexImage( GL_TEXTURE_2D, level, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data() );
+	return pixels;
+}
+
+/*	the asynchronous texture must be identical to the synchronous one	*/
+static int compare_textures( const char *name, GLuint async_texture, GLuint sync_texture, int levels )
+{
+	for( int level = 0; level < levels; ++level )
+	{
+		int aw = 0, ah = 0, sw = 0, sh = 0;
+		std::vector<unsigned char> a = read_level( async_texture, level, &aw, &ah );
+		std::vector<unsigned char> s = read_level( sync_texture, level, &sw, &sh );
+		if( aw != sw || ah != sh || aw == 0 || a != s )
+		{
+			fprintf( stderr, "%s: level %d differs (%dx%d vs %dx%d)\n", name, level, aw, ah, sw, sh );
+			return 0;
+		}
+	}
+	return 1;
+}
+
+int main( int argc, char **argv )
+{
+	std::string base = argc > 1 ? argv[1] : "bin/";
+	static const char *files[] = { "img_test.png", "img_test.bmp", "img_mars.jpg", "lenna1.jpg", "test_rect.png" };
+	const int file_count = (int)( sizeof( files ) / sizeof( files[0] ) );
+	const unsigned int flags = SOIL_FLAG_MIPMAPS | SOIL_FLAG_INVERT_Y | SOIL_FLAG_MULTIPLY_ALPHA;
+	std::vector<SOIL_AsyncTexture *> requests;
+	std::vector<unsigned char> memory;
+	SDL_Window *window;
+	SDL_GLContext context;
+	int success = 1;
+	int i;
+
+	if( !base.empty() && base[base.size() - 1] != '/' )
+		base += '/';
+	if( !load_file_data( base + files[0], &memory ) )
+	{
+		fprintf( stderr, "Could not read %s%s\n", base.c_str(), files[0] );
+		return 1;
+	}
+	if( SDL_Init( SDL_INIT_VIDEO ) != 0 )
+	{
+		fprintf( stderr, "SDL initialization failed: %s\n", SDL_GetError() );
+		return 1;
+	}
+
+	window = SDL_CreateWindow(
+		"SOIL2 async test", 0, 0, 16, 16,
+		SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN );
+	context = window ? SDL_GL_CreateContext( window ) : NULL;
+	if( context == NULL )
+	{
+		fprintf( stderr, "OpenGL context creation failed: %s\n", SDL_GetError() );
+		if( window )
+			SDL_DestroyWindow( window );
+		SDL_Quit();
+		return 1;
+	}
+
+	for( i = 0; i < file_count; ++i )
+		requests.push_back( SOIL_load_OGL_texture_async(
+			( base + files[i] ).c_str(), SOIL_LOAD_RGBA, SOIL_CREATE_NEW_ID, flags ) );
+	requests.push_back( SOIL_load_OGL_texture_from_memory_async(
+		memory.data(), (int)memory.size(), SOIL_LOAD_RGBA, SOIL_CREATE_NEW_ID, flags ) );
+
+	/*	a failing request and a cancelled one	*/
+	SOIL_AsyncTexture *missing = SOIL_load_OGL_texture_async(
+		"this_file_does_not_exist.png", SOIL_LOAD_AUTO, SOIL_CREATE_NEW_ID, 0 );
+	SOIL_AsyncTexture *cancelled = SOIL_load_OGL_texture_async(
+		( base + files[2] ).c_str(), SOIL_LOAD_AUTO, SOIL_CREATE_NEW_ID, flags );
+	if( !SOIL_async_cancel( cancelled ) || SOIL_async_poll( cancelled ) != SOIL_ASYNC_CANCELLED )
+	{
+		fprintf( stderr, "Cancelling a pending request failed\n" );
+		success = 0;
+	}
+
+	/*	pump with a tiny budget once per "frame", every call must still make progress	*/
+	int pending = (int)requests.size();
+	int frames = 0;
+	while( pending > 0 && frames < 10000 )
+	{
+		pending -= SOIL_async_pump( 100 );
+		SDL_Delay( 1 );
+		++frames;
+	}
+	if( pending != 0 )
+	{
+		fprintf( stderr, "%d requests never completed\n", pending );
+		success = 0;
+	}
+
+	for( i = 0; i < (int)requests.size(); ++i )
+	{
+		const char *name = i < file_count ? files[i] : "memory";
+		std::string path = base + ( i < file_count ? files[i] : files[0] );
+		GLuint texture = SOIL_async_texture_id( requests[i] );
+		GLuint reference = SOIL_load_OGL_texture( path.c_str(), SOIL_LOAD_RGBA, SOIL_CREATE_NEW_ID, flags );
+		if( SOIL_async_poll( requests[i] ) != SOIL_ASYNC_COMPLETE || texture == 0 || reference == 0 )
+		{
+			fprintf( stderr, "%s: async load failed: %s\n", name, SOIL_async_result( requests[i] ) );
+			success = 0;
+		}
+		else
+		{
+			success &= compare_textures( name, texture, reference, 2 );
+		}
+		glDeleteTextures( 1, &texture );
+		glDeleteTextures( 1, &reference );
+		SOIL_async_free( requests[i] );
+	}
+
+	if( SOIL_async_wait( missing ) != 0 || SOIL_async_poll( missing ) != SOIL_ASYNC_FAILED ||
+		SOIL_async_result_code( missing ) != SOIL_RESULT_FILE_NOT_FOUND ||
+		SOIL_last_result_code() != SOIL_RESULT_FILE_NOT_FOUND )
+	{
+		fprintf( stderr, "The missing file was not reported\n" );
+		success = 0;
+	}
+	SOIL_async_free( missing );
+	SOIL_async_free( cancelled );
+
+	/*	waiting uploads right away, without any pump	*/
+	SOIL_AsyncTexture *waited = SOIL_load_OGL_texture_async(
+		( base + files[3] ).c_str(), SOIL_LOAD_AUTO, SOIL_CREATE_NEW_ID, SOIL_FLAG_MIPMAPS );
+	GLuint texture = SOIL_async_wait( waited );
+	if( texture == 0 || SOIL_async_poll( waited ) != SOIL_ASYNC_COMPLETE )
+	{
+		fprintf( stderr, "Waiting for a request failed: %s\n", SOIL_last_result() );
+		success = 0;
+	}
+	glDeleteTextures( 1, &texture );
+	SOIL_async_free( waited );
+
+	/*	freed while still decoding, the pool releases them without a pump	*/
+	for( i = 0; i < file_count; ++i )
+		SOIL_async_free( SOIL_load_OGL_texture_async(
+			( base + files[i] ).c_str(), SOIL_LOAD_AUTO, SOIL_CREATE_NEW_ID, flags ) );
+
+	SDL_GL_DeleteContext( context );
+	SDL_DestroyWindow( window );
+	SDL_Quit();
+
+	if( success )
+		printf( "Asynchronous texture tests passed\n" );
+	return success ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../SOIL2/SOIL2.h"
+
+static int load_file_data( const std::string &path, std::vector<unsigned char> *data )
+{
+	std::ifstream input( path.c_str(), std::ios::binary );
+	if( !input )
+		return 0;
+	data->assign(
+		std::istreambuf_iterator<char>( input ),
+		std::istreambuf_iterator<char>() );
+	return !data->empty();
+}
+
+/*	every batch result must match what a serial SOIL_load_image returns	*/
+static int check_image( const char *path, int force_channels, const SOIL_Image &image )
+{
+	int width = 0, height = 0, channels = 0;
+	unsigned char *expected = SOIL_load_image( path, &width, &height, &channels, force_channels );
+	int stored_channels = force_channels ? force_channels : channels;
+	int ok = 1;
+
+	if( NULL == expected || NULL == image.data )
+	{
+		fprintf( stderr, "%s did not load: %s\n", path, image.result_string );
+		ok = 0;
+	}
+	else if( image.width != width || image.height != height || image.channels != channels ||
+		image.result_code != SOIL_RESULT_OK ||
+		0 != memcmp( expected, image.data, (size_t)width * height * stored_channels ) )
+	{
+		fprintf( stderr, "%s differs from the serial load\n", path );
+		ok = 0;
+	}
+
+	SOIL_free_image_data( expected );
+	return ok;
+}
+
+static int run_batch( SOIL_ThreadPool *pool, const std::string &base )
+{
+	static const char *files[] = {
+		"img_test.png", "img_test.bmp", "img_test.tga", "img_test_indexed.tga",
+		"img_mars.jpg", "lenna1.jpg", "lenna2.jpg", "lenna3.jpg", "test_rect.png"
+	};
+	const int file_count = (int)( sizeof( files ) / sizeof( files[0] ) );
+	std::vector<std::string> paths;
+	std::vector<unsigned char> memory;
+	std::vector<SOIL_LoadDesc> descs;
+	std::vector<SOIL_Image> images;
+	int ok = 1;
+	int i;
+
+	for( i = 0; i < file_count; ++i )
+		paths.push_back( base + files[i] );
+
+	if( !load_file_data( paths[0], &memory ) )
+	{
+		fprintf( stderr, "Could not read %s\n", paths[0].c_str() );
+		return 0;
+	}
+
+	/*	each file twice, once with forced channels, plus a memory item and a missing file	*/
+	for( i = 0; i < file_count * 2; ++i )
+	{
+		SOIL_LoadDesc desc;
+		memset( &desc, 0, sizeof( desc ) );
+		desc.filename = paths[i % file_count].c_str();
+		desc.force_channels = i < file_count ? SOIL_LOAD_AUTO : SOIL_LOAD_RGBA;
+		descs.push_back( desc );
+	}
+	{
+		SOIL_LoadDesc desc;
+		memset( &desc, 0, sizeof( desc ) );
+		desc.buffer = memory.data();
+		desc.buffer_length = (int)memory.size();
+		desc.force_channels = SOIL_LOAD_RGB;
+		descs.push_back( desc );
+
+		desc.buffer = NULL;
+		desc.buffer_length = 0;
+		desc.filename = "this_file_does_not_exist.png";
+		descs.push_back( desc );
+	}
+
+	images.resize( descs.size() );
+	int loaded = pool
+		? SOIL_load_images_batch_pool( pool, descs.data(), (int)descs.size(), images.data() )
+		: SOIL_load_images_batch( descs.data(), (int)descs.size(), images.data() );
+	int batch_result = SOIL_last_result_code();
+
+	if( loaded != (int)descs.size() - 1 )
+	{
+		fprintf( stderr, "Expected %d loaded images, got %d\n", (int)descs.size() - 1, loaded );
+		ok = 0;
+	}
+
+	for( i = 0; i < file_count * 2; ++i )
+		ok &= check_image( descs[i].filename, descs[i].force_channels, images[i] );
+	ok &= check_image( paths[0].c_str(), SOIL_LOAD_RGB, images[file_count * 2] );
+
+	if( NULL != images.back().data || SOIL_RESULT_FILE_NOT_FOUND != images.back().result_code ||
+		SOIL_RESULT_FILE_NOT_FOUND != batch_result )
+	{
+		fprintf( stderr, "The missing file was not reported\n" );
+		ok = 0;
+	}
+
+	for( i = 0; i < (int)images.size(); ++i )
+		SOIL_free_image_data( images[i].data );
+
+	return ok;
+}
+
+int main( int argc, char **argv )
+{
+	std::string base = argc > 1 ? argv[1] : "bin/";
+	int ok = 1;
+
+	if( !base.empty() && base[base.size() - 1] != '/' )
+		base += '/';
+
+	/*	the shared pool, then one pool reused for several batches	*/
+	ok &= run_batch( NULL, base );
+
+	SOIL_ThreadPool *pool = SOIL_create_thread_pool( 3 );
+	if( NULL == pool )
+	{
+		fprintf( stderr, "Could not create the thread pool\n" );
+		return 1;
+	}
+	ok &= run_batch( pool, base );
+	ok &= run_batch( pool, base );
+	SOIL_free_thread_pool( pool );
+
+	if( !ok )
+		return 1;
+
+	printf( "Batch loading test passed\n" );
+	return 0;
+}
@@ -0,0 +1,198 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../SOIL2/SOIL2.h"
+
+#define NO_SDL_GLEXT
+#if ( ( defined( _MSCVER ) || defined( _MSC_VER ) ) || defined( __APPLE_CC__ ) || defined ( __APPLE__ ) ) && !defined( SOIL2_NO_FRAMEWORKS )
+	#include <SDL.h>
+	#include <SDL_opengl.h>
+#else
+	#include <SDL2/SDL.h>
+	#include <SDL2/SDL_opengl.h>
+#endif
+
+/*	counts what each SOIL context allocates, so one context's calls can be
+	shown not to touch the other's memory	*/
+static void *counting_allocate( size_t size, void *user_data )
+{
+	++*(int *)user_data;
+	return malloc( size );
+}
+
+static void counting_release( void *memory, void *user_data )
+{
+	(void)user_data;
+	free( memory );
+}
+
+static std::vector<unsigned char> make_pattern( int width, int height, int channels, int seed )
+{
+	std::vector<unsigned char> pixels( (size_t)width * height * channels );
+	for( size_t i = 0; i < pixels.size(); ++i )
+		pixels[i] = (unsigned char)( i * 7 + seed * 31 );
+	return pixels;
+}
+
+/*	uploads a pattern through the bound SOIL context and checks level 0 reads back unchanged	*/
+static int upload_and_check( const char *name, int width, int height, int channels, int seed )
+{
+	std::vector<unsigned char> pixels = make_pattern( width, height, channels, seed );
+	std::vector<unsigned char> back( (size_t)width * height * 4 );
+	GLint w = 0, h = 0;
+	GLuint texture;
+	GLenum error;
+
+	while( glGetError() != GL_NO_ERROR )
+		;
+
+	texture = SOIL_create_OGL_texture( pixels.data(), &width, &height, channels, SOIL_CREATE_NEW_ID, SOIL_FLAG_MIPMAPS );
+	if( texture == 0 )
+	{
+		fprintf( stderr, "%s: upload failed: %s\n", name, SOIL_last_result() );
+		return 0;
+	}
+
+	glBindTexture( GL_TEXTURE_2D, texture );
+	glGetTexLevelParameteriv( GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &w );
+	glGetTexLevelParameteriv( GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &h );
+	glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+	glGetTexImage( GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, back.data() );
+	error = glGetError();
+	glDeleteTextures( 1, &texture );
+
+	if( error != GL_NO_ERROR || w != width || h != height )
+	{
+		fprintf( stderr, "%s: %dx%d, GL error 0x%x\n", name, w, h, error );
+		return 0;
+	}
+
+	for( int i = 0; i < width * height; ++i )
+	{
+		for( int c = 0; c < channels; ++c )
+		{
+			if( back[i * 4 + c] != pixels[i * channels + c] )
+			{
+				fprintf( stderr, "%s: pixel %d channel %d differs\n", name, i, c );
+				return 0;
+			}
+		}
+	}
+
+	return 1;
+}
+
+int main( int, char ** )
+{
+	SDL_Window *window;
+	SDL_GLContext first_gl, second_gl;
+	SOIL_Context *first, *second;
+	SOIL_Allocator first_hooks, second_hooks;
+	int first_count = 0, second_count = 0, counted;
+	int first_pbo;
+	int success = 1;
+
+	if( SDL_Init( SDL_INIT_VIDEO ) != 0 )
+	{
+		fprintf( stderr, "SDL initialization failed: %s\n", SDL_GetError() );
+		return 1;
+	}
+
+	window = SDL_CreateWindow(
+		"SOIL2 context test", 0, 0, 16, 16,
+		SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN );
+	first_gl = window ? SDL_GL_CreateContext( window ) : NULL;
+	if( first_gl == NULL )
+	{
+		fprintf( stderr, "OpenGL context creation failed: %s\n", SDL_GetError() );
+		if( window )
+			SDL_DestroyWindow( window );
+		SDL_Quit();
+		return 1;
+	}
+
+	first_hooks.allocate = counting_allocate;
+	first_hooks.release = counting_release;
+	first_hooks.user_data = &first_count;
+	second_hooks.allocate = counting_allocate;
+	second_hooks.release = counting_release;
+	second_hooks.user_data = &second_count;
+
+	first = SOIL_create_context( &first_hooks );
+	if( first == NULL )
+	{
+		fprintf( stderr, "SOIL context creation failed: %s\n", SOIL_last_result() );
+		return 1;
+	}
+	SOIL_bind_context( first );
+	first_pbo = SOIL_enable_PBO_uploads( 2 );
+	success &= upload_and_check( "first context", 37, 19, 4, 1 );
+
+	/*	a second OpenGL context, not sharing objects with the first, so a
+		PBO ring or sync object leaking across would show up as GL errors	*/
+	second_gl = SDL_GL_CreateContext( window );
+	if( second_gl == NULL )
+	{
+		fprintf( stderr, "Second OpenGL context creation failed: %s\n", SDL_GetError() );
+		return 1;
+	}
+
+	counted = first_count;
+	second = SOIL_create_context( &second_hooks );
+	if( second == NULL || SOIL_bind_context( second ) != first )
+	{
+		fprintf( stderr, "Creating a context changed the bound one\n" );
+		success = 0;
+	}
+
+	/*	plain uploads in the second context while the first has its ring	*/
+	success &= upload_and_check( "second context RGBA", 37, 19, 4, 2 );
+	success &= upload_and_check( "second context RGB", 13, 7, 3, 3 );
+	if( first_count != counted || second_count == 0 )
+	{
+		fprintf( stderr, "The second context used the first one's memory (%d, %d)\n", first_count - counted, second_count );
+		success = 0;
+	}
+
+	/*	turning the ring on and off again in the second context must leave the first one's alone	*/
+	if( first_pbo )
+	{
+		if( !SOIL_enable_PBO_uploads( 3 ) )
+		{
+			fprintf( stderr, "Enabling PBO uploads in the second context failed: %s\n", SOIL_last_result() );
+			success = 0;
+		}
+		success &= upload_and_check( "second context PBO", 21, 11, 4, 4 );
+		SOIL_enable_PBO_uploads( 0 );
+	}
+	SOIL_bind_context( NULL );
+	SOIL_free_context( second );
+
+	/*	the first context kept its ring, it wraps around here	*/
+	SDL_GL_MakeCurrent( window, first_gl );
+	SOIL_bind_context( first );
+	counted = second_count;
+	for( int i = 0; i < 3; ++i )
+		success &= upload_and_check( "first context again", 29 + i, 17, 4, 5 + i );
+	if( second_count != counted )
+	{
+		fprintf( stderr, "The first context used the freed second one's memory\n" );
+		success = 0;
+	}
+	SOIL_enable_PBO_uploads( 0 );
+	SOIL_bind_context( NULL );
+	SOIL_free_context( first );
+
+	/*	the process wide cache still works once no context is bound	*/
+	success &= upload_and_check( "no context", 9, 5, 4, 8 );
+
+	SDL_GL_DeleteContext( second_gl );
+	SDL_GL_DeleteContext( first_gl );
+	SDL_DestroyWindow( window );
+	SDL_Quit();
+
+	if( success )
+		printf( "Context isolation tests passed\n" );
+	return success ? 0 : 1;
+}
@@ -1,12 +1,14 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iterator>
 #include <string>
 #include <vector>
 
 #include "../SOIL2/SOIL2.h"
+#include "../SOIL2/stb_image.h"
 
 #define NO_SDL_GLEXT
 #if ( ( defined( _MSCVER ) || defined( _MSC_VER ) ) || defined( __APPLE_CC__ ) || defined ( __APPLE__ ) ) && !defined( SOIL2_NO_FRAMEWORKS )
@@ -137,6 +139,657 @@ static int test_memory_fixture(
 	return success;
 }
 
+struct DDSDecodeFixture
+{
+	const char* filename;
+	// channels holding the pattern, R, RG, RGB or RGBA
+	int channels;
+	int tolerance;
+};
+
+struct DDSFloatFixture
+{
+	const char* filename;
+	float scale;
+	int signed_values;
+	float tolerance;
+};
+
+static unsigned char* load_rgba( const std::string& path, int* width, int* height )
+{
+	int channels = 0;
+	unsigned char* data = SOIL_load_image( path.c_str(), width, height, &channels, SOIL_LOAD_RGBA );
+	if( data == NULL )
+		fprintf( stderr, "%s: CPU decode failed: %s\n", path.c_str(), SOIL_last_result() );
+	return data;
+}
+
+static int test_cpu_decode( const std::string& fixture_dir )
+{
+	static const DDSDecodeFixture fixtures[] = {
+		{ "test_dx10_bgra8_unorm.dds", 4, 1 },
+		{ "test_dx10_r8_unorm_padded.dds", 1, 1 },
+		{ "test_dx10_rg8_unorm.dds", 2, 1 },
+		{ "test_dx10_r8_snorm.dds", 1, 2 },
+		{ "test_dx10_rg8_snorm.dds", 2, 2 },
+		{ "test_dx10_r16_unorm.dds", 1, 1 },
+		{ "test_dx10_rg16_unorm.dds", 2, 1 },
+		{ "test_rgba16_unorm.dds", 4, 1 },
+		{ "test_dx10_rgb10a2_unorm.dds", 3, 2 },
+		{ "test_dx10_bc1_unorm.dds", 3, 24 },
+		{ "test_dx10_bc2_unorm.dds", 4, 24 },
+		{ "test_dx10_bc3_unorm.dds", 4, 24 },
+		{ "test_dx10_bc4_unorm.dds", 1, 8 },
+		{ "test_dx10_bc4_snorm.dds", 1, 8 },
+		{ "test_dx10_bc5_unorm.dds", 2, 8 },
+		{ "test_dx10_bc5_snorm.dds", 2, 8 },
+		{ "test_dx10_bc7_unorm.dds", 4, 24 },
+		{ "test_legacy_dxt2.dds", 4, 24 },
+		{ "test_legacy_dxt4.dds", 4, 24 },
+		{ "test_legacy_ati1.dds", 1, 8 },
+		{ "test_legacy_bc4s.dds", 1, 8 },
+		{ "test_legacy_bc5s.dds", 2, 8 }
+	};
+	int width = 0;
+	int height = 0;
+	unsigned char* reference = load_rgba( fixture_dir + "/test_dx10_rgba8_unorm.dds", &width, &height );
+	if( reference == NULL )
+		return 0;
+	int success = 1;
+	for( size_t i = 0; i < sizeof( fixtures ) / sizeof( fixtures[0] ); ++i )
+	{
+		const std::string path = fixture_dir + "/" + fixtures[i].filename;
+		int w = 0;
+		int h = 0;
+		unsigned char* pixels = load_rgba( path, &w, &h );
+		if( pixels == NULL )
+		{
+			success = 0;
+			continue;
+		}
+		int max_error = 0;
+		if( w != width || h != height )
+			max_error = 256;
+		for( int p = 0; max_error < 256 && p < width * height; ++p )
+		{
+			// BC1 turns the most transparent blocks to black
+			if( fixtures[i].channels == 3 && pixels[p * 4 + 3] == 0 )
+				continue;
+			for( int c = 0; c < fixtures[i].channels; ++c )
+				max_error = std::max( max_error, std::abs( pixels[p * 4 + c] - reference[p * 4 + c] ) );
+		}
+		if( max_error > fixtures[i].tolerance )
+		{
+			fprintf( stderr, "%s: CPU decode differs by %d\n", path.c_str(), max_error );
+			success = 0;
+		}
+		SOIL_free_image_data( pixels );
+	}
+	SOIL_free_image_data( reference );
+
+	// the float formats keep their range through stbi_loadf, the BC6H
+	// fixtures are 4 times brighter, with signed red and green for SF16
+	static const DDSFloatFixture float_fixtures[] = {
+		{ "test_rgba16_float.dds", 1.0f, 0, 0.001f },
+		{ "test_dx10_r11g11b10_float.dds", 1.0f, 0, 0.01f },
+		{ "test_dx10_bc6h_uf16.dds", 4.0f, 0, 0.1f },
+		{ "test_dx10_bc6h_sf16.dds", 4.0f, 1, 0.1f }
+	};
+	int channels = 0;
+	float* float_reference = stbi_loadf(
+		( fixture_dir + "/test_rgba32_float.dds" ).c_str(), &width, &height, &channels, 3 );
+	if( float_reference == NULL )
+	{
+		fprintf( stderr, "test_rgba32_float.dds: CPU decode failed: %s\n", stbi_failure_reason() );
+		return 0;
+	}
+	for( size_t i = 0; i < sizeof( float_fixtures ) / sizeof( float_fixtures[0] ); ++i )
+	{
+		const std::string path = fixture_dir + "/" + float_fixtures[i].filename;
+		int w = 0;
+		int h = 0;
+		float* pixels = stbi_loadf( path.c_str(), &w, &h, &channels, 3 );
+		if( pixels == NULL || w != width || h != height )
+		{
+			fprintf( stderr, "%s: CPU decode failed: %s\n", path.c_str(), stbi_failure_reason() );
+			success = 0;
+			stbi_image_free( pixels );
+			continue;
+		}
+		// the BC6H fixtures lose some steep gradients, so the mean error is checked
+		float total_error = 0.0f;
+		for( int v = 0; v < width * height * 3; ++v )
+		{
+			float expected = float_reference[v];
+			if( float_fixtures[i].signed_values && v % 3 != 2 )
+				expected = expected * 2.0f - 1.0f;
+			expected *= float_fixtures[i].scale;
+			total_error += std::fabs( pixels[v] - expected );
+		}
+		const float mean_error = total_error / ( width * height * 3 );
+		if( mean_error > float_fixtures[i].tolerance )
+		{
+			fprintf( stderr, "%s: CPU decode differs by %f\n", path.c_str(), mean_error );
+			success = 0;
+		}
+		stbi_image_free( pixels );
+	}
+	stbi_image_free( float_reference );
+
+	// the faces of a cubemap are stacked vertically
+	unsigned char* cubemap = load_rgba( fixture_dir + "/test_bc6h_uf16_cubemap.dds", &width, &height );
+	if( cubemap == NULL || width != 16 || height != 16 * 6 )
+	{
+		fprintf( stderr, "test_bc6h_uf16_cubemap.dds: CPU decode has the wrong size\n" );
+		success = 0;
+	}
+	SOIL_free_image_data( cubemap );
+
+	// BC3.dds is large enough to be mapped instead of read, the pixels
+	// have to match the ones decoded from a copy in memory
+	const std::string mapped_path = fixture_dir + "/BC3.dds";
+	std::ifstream input( mapped_path.c_str(), std::ios::binary );
+	const std::vector<unsigned char> data{
+		std::istreambuf_iterator<char>( input ),
+		std::istreambuf_iterator<char>() };
+	int memory_width = 0;
+	int memory_height = 0;
+	int memory_channels = 0;
+	unsigned char* mapped = load_rgba( mapped_path, &width, &height );
+	unsigned char* memory = SOIL_load_image_from_memory(
+		data.data(), (int)data.size(), &memory_width, &memory_height, &memory_channels,
+		SOIL_LOAD_RGBA );
+	if( mapped == NULL || memory == NULL || width != memory_width || height != memory_height ||
+		!std::equal( mapped, mapped + (size_t)width * height * 4, memory ) )
+	{
+		fprintf( stderr, "%s: file decode differs from memory decode\n", mapped_path.c_str() );
+		success = 0;
+	}
+	SOIL_free_image_data( mapped );
+	SOIL_free_image_data( memory );
+	return success;
+}
+
+struct DDSLegacyLayout
+{
+	const char* name;
+	unsigned int bit_count;
+	unsigned int masks[4];
+	// extra bytes at the end of the rows of the top level
+	unsigned int padding;
+};
+
+static void write_dword( std::vector<unsigned char>& data, size_t offset, unsigned int value )
+{
+	for( int i = 0; i < 4; ++i )
+		data[offset + i] = ( value >> ( i * 8 ) ) & 0xff;
+}
+
+// the Direct3D 9 layouts are uploaded straight from the file where GL can
+// unpack them, the texture has to hold the same pixels either way
+static int test_legacy_layouts()
+{
+	static const DDSLegacyLayout layouts[] = {
+		{ "R5G6B5", 16, { 0xf800, 0x7e0, 0x1f, 0 }, 6 },
+		{ "A4R4G4B4", 16, { 0xf00, 0xf0, 0xf, 0xf000 }, 4 },
+		{ "A1R5G5B5", 16, { 0x7c00, 0x3e0, 0x1f, 0x8000 }, 0 },
+		{ "X1R5G5B5", 16, { 0x7c00, 0x3e0, 0x1f, 0 }, 2 },
+		{ "R8G8B8", 24, { 0xff0000, 0xff00, 0xff, 0 }, 1 },
+		{ "A8R8G8B8", 32, { 0xff0000, 0xff00, 0xff, 0xff000000 }, 8 }
+	};
+	const int width = 13;
+	const int height = 7;
+	int success = 1;
+	for( size_t i = 0; i < sizeof( layouts ) / sizeof( layouts[0] ); ++i )
+	{
+		const DDSLegacyLayout& layout = layouts[i];
+		const unsigned int pixel_size = layout.bit_count / 8;
+		const unsigned int pitch = width * pixel_size + layout.padding;
+		std::vector<unsigned char> file( 128 + pitch * height, 0xcd );
+		std::vector<unsigned char> expected( width * height * 4 );
+		write_dword( file, 0, 0x20534444 );
+		write_dword( file, 4, 124 );
+		// DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PITCH | DDSD_PIXELFORMAT
+		write_dword( file, 8, 0x100f );
+		write_dword( file, 12, height );
+		write_dword( file, 16, width );
+		write_dword( file, 20, pitch );
+		write_dword( file, 28, 1 );
+		write_dword( file, 76, 32 );
+		// DDPF_RGB, with DDPF_ALPHAPIXELS for an alpha mask
+		write_dword( file, 80, layout.masks[3] ? 0x41 : 0x40 );
+		write_dword( file, 88, layout.bit_count );
+		for( int c = 0; c < 4; ++c )
+			write_dword( file, 92 + c * 4, layout.masks[c] );
+		write_dword( file, 108, 0x1000 );
+		for( int p = 0; p < width * height; ++p )
+		{
+			unsigned int value = 0;
+			for( int c = 0; c < 4; ++c )
+			{
+				const unsigned int mask = layout.masks[c];
+				if( mask == 0 )
+				{
+					expected[p * 4 + c] = 255;
+					continue;
+				}
+				int shift = 0;
+				while( ( ( mask >> shift ) & 1 ) == 0 )
+					++shift;
+				const unsigned int max = mask >> shift;
+				const unsigned int channel = ( p * 7 + c * 53 + p / width * 31 ) % ( max + 1 );
+				value |= channel << shift;
+				expected[p * 4 + c] = (unsigned char)( ( channel * 255 + max / 2 ) / max );
+			}
+			unsigned char* pixel = &file[128 + p / width * pitch + p % width * pixel_size];
+			for( unsigned int b = 0; b < pixel_size; ++b )
+				pixel[b] = ( value >> ( b * 8 ) ) & 0xff;
+		}
+
+		const GLuint texture = SOIL_direct_load_DDS_from_memory(
+			file.data(), (int)file.size(), SOIL_CREATE_NEW_ID, 0, 0 );
+		if( texture == 0 )
+		{
+			fprintf( stderr, "%s DDS: %s\n", layout.name, SOIL_last_result() );
+			success = 0;
+			continue;
+		}
+		std::vector<unsigned char> pixels( width * height * 4 );
+		glBindTexture( GL_TEXTURE_2D, texture );
+		glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+		glGetTexImage( GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data() );
+		int max_error = 0;
+		for( size_t v = 0; v < pixels.size(); ++v )
+			max_error = std::max( max_error, std::abs( pixels[v] - expected[v] ) );
+		// drivers may round the expansion of the narrow channels differently
+		if( glGetError() != GL_NO_ERROR || max_error > 1 )
+		{
+			fprintf( stderr, "%s DDS: uploaded pixels differ by %d\n", layout.name, max_error );
+			success = 0;
+		}
+		glDeleteTextures( 1, &texture );
+	}
+	return success;
+}
+
+enum DDSLayeredKind
+{
+	DDS_ARRAY,
+	DDS_VOLUME,
+	DDS_COMPRESSED_ARRAY,
+	DDS_CUBEMAP_ARRAY,
+	DDS_WIDE_COMPRESSED_ARRAY
+};
+
+typedef void (APIENTRY *DDS_GL_GET_COMPRESSED_TEX_IMAGE_PROC)( GLenum target, GLint level, void* pixels );
+typedef void (APIENTRY *DDS_GL_TEX_STORAGE_3D_PROC)(
+	GLenum target, GLsizei levels, GLenum internal_format, GLsizei width, GLsizei height, GLsizei depth );
+
+// reads every layer (the whole volume) of a level back from GL at once
+static int check_layered_levels(
+	const char* name, GLuint texture, GLenum target, int compressed,
+	const std::vector<std::vector<unsigned char> >& expected )
+{
+	const DDS_GL_GET_COMPRESSED_TEX_IMAGE_PROC get_compressed =
+		(DDS_GL_GET_COMPRESSED_TEX_IMAGE_PROC)SDL_GL_GetProcAddress( "glGetCompressedTexImage" );
+	int success = 1;
+	glBindTexture( target, texture );
+	glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+	for( size_t level = 0; level < expected.size(); ++level )
+	{
+		std::vector<unsigned char> pixels( expected[level].size() );
+		if( !compressed )
+			glGetTexImage( target, (GLint)level, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data() );
+		else if( get_compressed != NULL )
+			get_compressed( target, (GLint)level, pixels.data() );
+		if( glGetError() != GL_NO_ERROR || pixels != expected[level] )
+		{
+			fprintf( stderr, "%s DDS: level %d differs\n", name, (int)level );
+			success = 0;
+		}
+	}
+	return success;
+}
+
+// a DX10 2D array (RGBA8 or BC1), cubemap array or volume
+static int test_layered_texture( DDSLayeredKind kind )
+{
+	const int volume = kind == DDS_VOLUME;
+	const int wide = kind == DDS_WIDE_COMPRESSED_ARRAY;
+	const int compressed = kind == DDS_COMPRESSED_ARRAY || wide;
+	const int cubemap = kind == DDS_CUBEMAP_ARRAY;
+	// the faces of a cubemap are square; a single row of blocks holds
+	// less data than the width in pixels times the block size
+	const int width = wide ? 256 : 6;
+	const int height = wide ? 4 : cubemap ? 6 : 5;
+	// two cubemaps of six faces each
+	const int array_size = cubemap ? 2 : 3;
+	const int layers = cubemap ? array_size * 6 : array_size;
+	const int levels = wide ? 1 : 2;
+	std::vector<unsigned char> file( 148, 0 );
+	write_dword( file, 0, 0x20534444 );
+	write_dword( file, 4, 124 );
+	// DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT, DDSD_DEPTH
+	write_dword( file, 8, 0x21007 | ( volume ? 0x800000 : 0 ) );
+	write_dword( file, 12, height );
+	write_dword( file, 16, width );
+	write_dword( file, 24, volume ? layers : 0 );
+	write_dword( file, 28, levels );
+	write_dword( file, 76, 32 );
+	// DDPF_FOURCC, DX10
+	write_dword( file, 80, 0x4 );
+	write_dword( file, 84, 0x30315844 );
+	// DDSCAPS_TEXTURE | DDSCAPS_MIPMAP | DDSCAPS_COMPLEX, DDSCAPS2_VOLUME
+	write_dword( file, 108, 0x401008 );
+	write_dword( file, 112, volume ? 0x200000 : 0 );
+	// DXGI_FORMAT_BC1_UNORM or R8G8B8A8_UNORM, DDS_DIMENSION_TEXTURE3D or TEXTURE2D
+	write_dword( file, 128, compressed ? 71 : 28 );
+	write_dword( file, 132, volume ? 4 : 3 );
+	// DDS_RESOURCE_MISC_TEXTURECUBE
+	write_dword( file, 136, cubemap ? 0x4 : 0 );
+	write_dword( file, 140, volume ? 1 : array_size );
+
+	// an array stores each layer's chain in turn, a volume each level's slices
+	std::vector<std::vector<unsigned char> > expected( levels );
+	std::vector<size_t> slice_sizes( levels );
+	for( int level = 0; level < levels; ++level )
+	{
+		const int slices = volume ? std::max( layers >> level, 1 ) : layers;
+		const int level_width = std::max( width >> level, 1 );
+		const int level_height = std::max( height >> level, 1 );
+		// 8 bytes for each 4x4 BC1 block
+		slice_sizes[level] = compressed ?
+			(size_t)( ( level_width + 3 ) / 4 ) * ( ( level_height + 3 ) / 4 ) * 8 :
+			(size_t)level_width * level_height * 4;
+		expected[level].resize( slice_sizes[level] * slices );
+	}
+	for( int outer = 0; outer < ( volume ? levels : layers ); ++outer )
+	{
+		for( int inner = 0; inner < ( volume ? std::max( layers >> outer, 1 ) : levels ); ++inner )
+		{
+			const int level = volume ? outer : inner;
+			const int slice = volume ? inner : outer;
+			const size_t slice_size = slice_sizes[level];
+			for( size_t i = 0; i < slice_size; ++i )
+			{
+				const unsigned char value = (unsigned char)( i * 13 + slice * 71 + level * 29 );
+				expected[level][slice * slice_size + i] = value;
+				file.push_back( value );
+			}
+		}
+	}
+
+	static const char* names[] = {
+		"DX10 array", "DX10 volume", "DX10 BC1 array", "DX10 cubemap array", "DX10 wide BC1 array" };
+	const char* name = names[kind];
+	// GL_TEXTURE_3D, GL_TEXTURE_CUBE_MAP_ARRAY or GL_TEXTURE_2D_ARRAY
+	const GLenum target = volume ? 0x806F : cubemap ? 0x9009 : 0x8C1A;
+	// GL_COMPRESSED_RGB_S3TC_DXT1_EXT or GL_RGBA8
+	const GLenum storage_format = compressed ? 0x83F1 : 0x8058;
+	GLuint texture = SOIL_direct_load_DDS_from_memory(
+		file.data(), (int)file.size(), SOIL_CREATE_NEW_ID, 0, 0 );
+	// cubemap arrays need OpenGL 4.0 or ARB_texture_cube_map_array
+	if( texture == 0 && cubemap && SOIL_last_result_code() == SOIL_RESULT_GL_UNSUPPORTED )
+		return 1;
+	if( texture == 0 )
+	{
+		fprintf( stderr, "%s DDS: %s\n", name, SOIL_last_result() );
+		return 0;
+	}
+	int success = check_layered_levels( name, texture, target, compressed, expected );
+	glDeleteTextures( 1, &texture );
+
+	// immutable storage is filled in place when it fits the image, and
+	// left alone when it doesn't
+	const DDS_GL_TEX_STORAGE_3D_PROC tex_storage_3d =
+		(DDS_GL_TEX_STORAGE_3D_PROC)SDL_GL_GetProcAddress( "glTexStorage3D" );
+	if( tex_storage_3d == NULL )
+		return success;
+	for( int fits = 1; fits >= 0; --fits )
+	{
+		glGenTextures( 1, &texture );
+		glBindTexture( target, texture );
+		// one layer too many, or a whole cubemap for a cubemap array
+		tex_storage_3d( target, levels, storage_format, width, height, layers + ( fits ? 0 : cubemap ? 6 : 1 ) );
+		while( glGetError() != GL_NO_ERROR )
+			;
+		const GLuint reused = SOIL_direct_load_DDS_from_memory(
+			file.data(), (int)file.size(), texture, 0, 0 );
+		if( fits && ( reused != texture ||
+			!check_layered_levels( name, texture, target, compressed, expected ) ) )
+		{
+			fprintf( stderr, "%s DDS: matching immutable storage wasn't filled: %s\n", name, SOIL_last_result() );
+			success = 0;
+		}
+		if( !fits && ( reused != 0 || SOIL_last_result_code() != SOIL_RESULT_INVALID_ARGUMENT ) )
+		{
+			fprintf( stderr, "%s DDS: mismatched immutable storage was filled\n", name );
+			success = 0;
+		}
+		glDeleteTextures( 1, &texture );
+	}
+	return success;
+}
+
+// a file read through SOIL_io_callbacks, remembering the largest read
+struct DDSStream
+{
+	const std::vector<unsigned char>* file;
+	size_t position;
+	int largest_read;
+};
+
+static int stream_read( void* user, char* data, int size )
+{
+	DDSStream* stream = (DDSStream*)user;
+	const int left = (int)( stream->file->size() - std::min( stream->position, stream->file->size() ) );
+	const int bytes = std::min( size, left );
+	if( bytes > 0 )
+	{
+		memcpy( data, stream->file->data() + stream->position, bytes );
+		stream->position += bytes;
+	}
+	stream->largest_read = std::max( stream->largest_read, bytes );
+	return bytes;
+}
+
+static void stream_skip( void* user, int n )
+{
+	( (DDSStream*)user )->position += n;
+}
+
+static int stream_eof( void* user )
+{
+	DDSStream* stream = (DDSStream*)user;
+	return stream->position >= stream->file->size();
+}
+
+// levels above the budget stay in the file, the rest become levels 0, 1, ...
+static int test_lod_texture( int layers, int levels, int streamed )
+{
+	const int width = 16;
+	const int height = 8;
+	// the padded top level pitch must not apply to the first kept level
+	const int pitch = width * 4 + 8;
+	std::vector<unsigned char> file( 148, 0 );
+	write_dword( file, 0, 0x20534444 );
+	write_dword( file, 4, 124 );
+	// DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PITCH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT
+	write_dword( file, 8, 0x2100F );
+	write_dword( file, 12, height );
+	write_dword( file, 16, width );
+	write_dword( file, 20, pitch );
+	write_dword( file, 28, levels );
+	write_dword( file, 76, 32 );
+	// DDPF_FOURCC, DX10
+	write_dword( file, 80, 0x4 );
+	write_dword( file, 84, 0x30315844 );
+	// DDSCAPS_TEXTURE | DDSCAPS_MIPMAP | DDSCAPS_COMPLEX
+	write_dword( file, 108, 0x401008 );
+	// DXGI_FORMAT_R8G8B8A8_UNORM, DDS_DIMENSION_TEXTURE2D
+	write_dword( file, 128, 28 );
+	write_dword( file, 132, 3 );
+	write_dword( file, 140, layers );
+
+	std::vector<std::vector<unsigned char> > expected( levels );
+	for( int layer = 0; layer < layers; ++layer )
+	{
+		for( int level = 0; level < levels; ++level )
+		{
+			const int w = std::max( width >> level, 1 );
+			const int h = std::max( height >> level, 1 );
+			const int row_pitch = level ? w * 4 : pitch;
+			for( int y = 0; y < h; ++y )
+			{
+				for( int x = 0; x < row_pitch; ++x )
+				{
+					const unsigned char value = (unsigned char)( x * 7 + y * 31 + layer * 71 + level * 29 );
+					if( x < w * 4 )
+					{
+						expected[level].push_back( value );
+					}
+					file.push_back( value );
+				}
+			}
+		}
+	}
+
+	static const struct { int skip_mips, max_dimension, first_level; } cases[] = {
+		{ 0, 0, 0 },
+		{ 1, 0, 1 },
+		{ 0, 4, 2 },
+		{ 1, 8, 1 },
+		{ 9, 0, 3 }
+	};
+	const char* name = layers > 1 ? ( streamed ? "streamed DX10 array" : "DX10 array" ) :
+		( streamed ? "streamed DX10" : "DX10" );
+	const SOIL_io_callbacks callbacks = { stream_read, stream_skip, stream_eof };
+	// GL_TEXTURE_2D_ARRAY
+	const GLenum target = layers > 1 ? 0x8C1A : GL_TEXTURE_2D;
+	int success = 1;
+	for( size_t c = 0; c < sizeof( cases ) / sizeof( cases[0] ); ++c )
+	{
+		// the only level is never skipped
+		const int first_level = std::min( cases[c].first_level, levels - 1 );
+		DDSStream stream = { &file, 0, 0 };
+		const GLuint texture = streamed ?
+			SOIL_direct_load_DDS_from_callbacks_lod(
+				&callbacks, &stream, SOIL_CREATE_NEW_ID, SOIL_FLAG_MIPMAPS, 0,
+				cases[c].skip_mips, cases[c].max_dimension ) :
+			SOIL_direct_load_DDS_from_memory_lod(
+				file.data(), (int)file.size(), SOIL_CREATE_NEW_ID, SOIL_FLAG_MIPMAPS, 0,
+				cases[c].skip_mips, cases[c].max_dimension );
+		if( texture == 0 )
+		{
+			fprintf( stderr, "%s DDS skipping %d levels: %s\n", name, first_level, SOIL_last_result() );
+			success = 0;
+			continue;
+		}
+		glBindTexture( target, texture );
+		glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+		for( int level = first_level; level < levels; ++level )
+		{
+			std::vector<unsigned char> pixels( expected[level].size() );
+			GLint level_width = 0;
+			glGetTexLevelParameteriv( target, level - first_level, GL_TEXTURE_WIDTH, &level_width );
+			glGetTexImage( target, level - first_level, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data() );
+			if( glGetError() != GL_NO_ERROR || level_width != std::max( width >> level, 1 ) ||
+				pixels != expected[level] )
+			{
+				fprintf( stderr, "%s DDS skipping %d levels: level %d differs\n",
+					name, first_level, level );
+				success = 0;
+			}
+		}
+		// one level of one layer at a time, never the whole file, nor
+		// all the layers of a single level array
+		if( streamed && stream.largest_read > pitch * height )
+		{
+			fprintf( stderr, "%s DDS: read %d bytes at once\n", name, stream.largest_read );
+			success = 0;
+		}
+		glDeleteTextures( 1, &texture );
+	}
+	return success;
+}
+
+// a 4GB file made up on the fly: the header, then filler bytes
+struct DDSLargeStream
+{
+	std::vector<unsigned char> header;
+	unsigned long long size;
+	unsigned long long position;
+};
+
+static int large_stream_read( void* user, char* data, int size )
+{
+	DDSLargeStream* stream = (DDSLargeStream*)user;
+	int bytes = 0;
+	while( bytes < size && stream->position < stream->size )
+	{
+		data[bytes++] = stream->position < stream->header.size() ?
+			(char)stream->header[(size_t)stream->position] : (char)0x55;
+		++stream->position;
+	}
+	return bytes;
+}
+
+static void large_stream_skip( void* user, int n )
+{
+	( (DDSLargeStream*)user )->position += n;
+}
+
+static int large_stream_eof( void* user )
+{
+	DDSLargeStream* stream = (DDSLargeStream*)user;
+	return stream->position >= stream->size;
+}
+
+// streams are read up to 2GB, past that the load fails as too large, not as truncated
+static int test_large_stream()
+{
+	const unsigned int side = 32768;
+	const SOIL_io_callbacks callbacks = { large_stream_read, large_stream_skip, large_stream_eof };
+	DDSLargeStream stream;
+	stream.header.assign( 148, 0 );
+	write_dword( stream.header, 0, 0x20534444 );
+	write_dword( stream.header, 4, 124 );
+	// DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT
+	write_dword( stream.header, 8, 0x1007 );
+	write_dword( stream.header, 12, side );
+	write_dword( stream.header, 16, side );
+	write_dword( stream.header, 76, 32 );
+	// DDPF_FOURCC, DX10
+	write_dword( stream.header, 80, 0x4 );
+	write_dword( stream.header, 84, 0x30315844 );
+	// DDSCAPS_TEXTURE
+	write_dword( stream.header, 108, 0x1000 );
+	// DXGI_FORMAT_R8G8B8A8_UNORM, DDS_DIMENSION_TEXTURE2D
+	write_dword( stream.header, 128, 28 );
+	write_dword( stream.header, 132, 3 );
+	write_dword( stream.header, 140, 1 );
+
+	static const struct { unsigned long long size; int result_code; } cases[] = {
+		{ 148ull + side * side * 4ull, SOIL_RESULT_IO_ERROR },
+		{ 148ull + 1024, SOIL_RESULT_DECODE_FAILED }
+	};
+	int success = 1;
+	for( size_t c = 0; c < sizeof( cases ) / sizeof( cases[0] ); ++c )
+	{
+		stream.size = cases[c].size;
+		stream.position = 0;
+		const GLuint texture = SOIL_direct_load_DDS_from_callbacks(
+			&callbacks, &stream, SOIL_CREATE_NEW_ID, 0, 0 );
+		if( texture != 0 || SOIL_last_result_code() != cases[c].result_code )
+		{
+			fprintf( stderr, "%llu byte DDS stream: %s\n", cases[c].size, SOIL_last_result() );
+			success = 0;
+		}
+		glDeleteTextures( 1, &texture );
+	}
+	return success;
+}
+
 int main( int argc, char** argv )
 {
 	static const DDSFixture fixtures[] = {
@@ -180,6 +833,9 @@ int main( int argc, char** argv )
 	const std::string fixture_dir = argc > 1 ? argv[1] : "bin";
 	int success = 1;
 
+	// the software decoders don't need a context
+	success &= test_cpu_decode( fixture_dir );
+
 	if( SDL_Init( SDL_INIT_VIDEO ) != 0 )
 	{
 		fprintf( stderr, "SDL initialization failed: %s\n", SDL_GetError() );
@@ -207,6 +863,19 @@ int main( int argc, char** argv )
 		fixture_dir + "/test_dx10_bc7_unorm.dds", 0x8E8C, 1 );
 	success &= test_memory_fixture(
 		fixture_dir + "/test_dx10_r8_unorm_padded.dds", 0x8229, 0 );
+	success &= test_legacy_layouts();
+	success &= test_layered_texture( DDS_ARRAY );
+	success &= test_layered_texture( DDS_VOLUME );
+	success &= test_layered_texture( DDS_COMPRESSED_ARRAY );
+	success &= test_layered_texture( DDS_CUBEMAP_ARRAY );
+	success &= test_layered_texture( DDS_WIDE_COMPRESSED_ARRAY );
+	success &= test_lod_texture( 1, 4, 0 );
+	success &= test_lod_texture( 2, 4, 0 );
+	success &= test_lod_texture( 8, 1, 0 );
+	success &= test_lod_texture( 1, 4, 1 );
+	success &= test_lod_texture( 2, 4, 1 );
+	success &= test_lod_texture( 8, 1, 1 );
+	success &= test_large_stream();
 
 	const std::string cubemap_path = fixture_dir + "/test_bc6h_uf16_cubemap.dds";
 	const GLuint cubemap = SOIL_load_OGL_single_cubemap(
@@ -230,6 +899,6 @@ int main( int argc, char** argv )
 	SDL_Quit();
 
 	if( success )
-		printf( "DDS direct upload tests passed\n" );
+		printf( "DDS direct upload and decoding tests passed\n" );
 	return success ? 0 : 1;
 }
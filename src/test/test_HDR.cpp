@@ -21,6 +21,9 @@
 #ifndef GL_RGB32F
 #define GL_RGB32F 0x8815
 #endif
+#ifndef GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT
+#define GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT 0x8E8F
+#endif
 
 static int check_texture(
 	GLenum target,
@@ -173,6 +176,29 @@ int main( int argc, char **argv )
 		glDeleteTextures( 1, &texture );
 	}
 
+	texture = SOIL_load_OGL_HDR_cubemap_f32(
+		fixture, fixture, fixture, fixture, fixture, fixture,
+		SOIL_HDR_TEXTURE_BC6H, SOIL_CREATE_NEW_ID, SOIL_FLAG_GL_MIPMAPS );
+	if( texture == 0 )
+	{
+		fprintf( stderr, "BC6H cubemap file load failed: %s\n", SOIL_last_result() );
+		success = 0;
+	}
+	else
+	{
+		/* without BPTC support the faces fall back to RGB16F */
+		const GLint bc6h_format =
+			( SOIL_GL_ExtensionSupported( "GL_ARB_texture_compression_bptc" ) ||
+			  SOIL_GL_ExtensionSupported( "GL_EXT_texture_compression_bptc" ) ) ?
+			GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT : GL_RGB16F;
+		glBindTexture( GL_TEXTURE_CUBE_MAP, texture );
+		success &= check_texture(
+			GL_TEXTURE_CUBE_MAP_POSITIVE_Y, bc6h_format, 16, 16, 0 );
+		success &= check_texture(
+			GL_TEXTURE_CUBE_MAP_POSITIVE_Y, bc6h_format, 8, 8, 1 );
+		glDeleteTextures( 1, &texture );
+	}
+
 	SDL_GL_DeleteContext( context );
 	SDL_DestroyWindow( window );
 	SDL_Quit();
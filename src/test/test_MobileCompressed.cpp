@@ -8,6 +8,8 @@
 #include <vector>
 
 #include "../SOIL2/SOIL2.h"
+#include "../SOIL2/image_ETC.h"
+#include "../SOIL2/image_transcode.h"
 
 #define NO_SDL_GLEXT
 #if ( ( defined( _MSCVER ) || defined( _MSC_VER ) ) || defined( __APPLE_CC__ ) || defined ( __APPLE__ ) ) && !defined( SOIL2_NO_FRAMEWORKS )
@@ -215,7 +217,8 @@ static int test_fixture( const std::string& directory, const Fixture& fixture )
 }
 
 static int expect_failure(
-	const std::vector<unsigned char>& data, int astc, const char* expected_error )
+	const std::vector<unsigned char>& data, int astc, const char* expected_error,
+	int expected_code )
 {
 	const GLuint texture =
 		astc ?
@@ -223,11 +226,13 @@ static int expect_failure(
 				data.data(), (int)data.size(), SOIL_CREATE_NEW_ID, 0 ) :
 			SOIL_direct_load_PKM_from_memory(
 				data.data(), (int)data.size(), SOIL_CREATE_NEW_ID, 0 );
-	if( texture != 0 || strstr( SOIL_last_result(), expected_error ) == NULL )
+	if( texture != 0 || strstr( SOIL_last_result(), expected_error ) == NULL ||
+		SOIL_last_result_code() != expected_code )
 	{
 		fprintf(
-			stderr, "Expected failure containing '%s', got '%s'\n",
-			expected_error, SOIL_last_result() );
+			stderr, "Expected failure %d containing '%s', got %d '%s'\n",
+			expected_code, expected_error, SOIL_last_result_code(),
+			SOIL_last_result() );
 		if( texture )
 			glDeleteTextures( 1, &texture );
 		return 0;
@@ -252,6 +257,210 @@ static int expect_cpu_failure( const std::vector<unsigned char>& data )
 	return 1;
 }
 
+static int test_encode_round_trip( const std::string& directory )
+{
+	const std::string path = directory + "/etc2_rgba8.pkm";
+	const std::string saved = directory + "/etc2_rgba8_saved.pkm";
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	unsigned char* source = SOIL_load_image(
+		path.c_str(), &width, &height, &channels, SOIL_LOAD_RGBA );
+	if( source == NULL )
+	{
+		fprintf( stderr, "%s CPU decode: %s\n", path.c_str(), SOIL_last_result() );
+		return 0;
+	}
+	if( !SOIL_save_image( saved.c_str(), SOIL_SAVE_TYPE_PKM, width, height, 4, source ) )
+	{
+		fprintf( stderr, "%s: saving as PKM failed\n", saved.c_str() );
+		free( source );
+		return 0;
+	}
+
+	/*	the re-encoded image has to stay close to the one it came from, the
+		fixture mixes colors that only the T and H modes would hold	*/
+	int saved_width = 0;
+	int saved_height = 0;
+	int saved_channels = 0;
+	unsigned char* decoded = SOIL_load_image(
+		saved.c_str(), &saved_width, &saved_height, &saved_channels, SOIL_LOAD_RGBA );
+	int success = decoded != NULL && saved_width == width && saved_height == height;
+	if( success )
+	{
+		double error = 0.0;
+		for( int i = 0; i < width * height * 4; ++i )
+			error += std::abs( (int)decoded[i] - (int)source[i] );
+		if( error / ( width * height * 4 ) > 10.0 )
+		{
+			fprintf(
+				stderr, "%s: mean error %.2f after re-encoding\n", saved.c_str(),
+				error / ( width * height * 4 ) );
+			success = 0;
+		}
+	}
+	else
+	{
+		fprintf( stderr, "%s CPU decode: %s\n", saved.c_str(), SOIL_last_result() );
+	}
+	free( decoded );
+
+	const Fixture fixture = { "etc2_rgba8_saved.pkm", 0x9278, 0x9278, 0, 0, 4 };
+	GLuint texture = SOIL_direct_load_PKM( saved.c_str(), SOIL_CREATE_NEW_ID, 0 );
+	if( texture == 0 )
+	{
+		fprintf( stderr, "%s: %s\n", saved.c_str(), SOIL_last_result() );
+		success = 0;
+	}
+	else
+	{
+		success &= check_texture( texture, fixture );
+		glDeleteTextures( 1, &texture );
+	}
+	remove( saved.c_str() );
+
+	/*	compressing on upload picks ETC2, or DXT5 without it	*/
+	texture = SOIL_create_OGL_texture(
+		source, &width, &height, 4, SOIL_CREATE_NEW_ID, SOIL_FLAG_COMPRESS_TO_ETC2 );
+	if( texture == 0 )
+	{
+		fprintf( stderr, "ETC2 upload: %s\n", SOIL_last_result() );
+		success = 0;
+	}
+	else
+	{
+		GLint internal_format = 0;
+		glBindTexture( GL_TEXTURE_2D, texture );
+		glGetTexLevelParameteriv(
+			GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &internal_format );
+		if( internal_format != 0x9278 && internal_format != 0x83F3 )
+		{
+			fprintf( stderr, "ETC2 upload: unexpected format=%d\n", internal_format );
+			success = 0;
+		}
+		glDeleteTextures( 1, &texture );
+	}
+	free( source );
+	return success;
+}
+
+/*	the blocks of a PKM file, decoded the way SOIL_load_image does	*/
+static unsigned char* decode_PKM_blocks(
+	const unsigned char* blocks, int size, int width, int height, int pkm_format )
+{
+	std::vector<unsigned char> pkm( 16 );
+	memcpy( pkm.data(), "PKM 20", 6 );
+	pkm[6] = (unsigned char)( pkm_format >> 8 );
+	pkm[7] = (unsigned char)pkm_format;
+	pkm[8] = (unsigned char)( ( ( width + 3 ) & ~3 ) >> 8 );
+	pkm[9] = (unsigned char)( ( width + 3 ) & ~3 );
+	pkm[10] = (unsigned char)( ( ( height + 3 ) & ~3 ) >> 8 );
+	pkm[11] = (unsigned char)( ( height + 3 ) & ~3 );
+	pkm[12] = (unsigned char)( width >> 8 );
+	pkm[13] = (unsigned char)width;
+	pkm[14] = (unsigned char)( height >> 8 );
+	pkm[15] = (unsigned char)height;
+	pkm.insert( pkm.end(), blocks, blocks + size );
+	int decoded_width = 0;
+	int decoded_height = 0;
+	int decoded_channels = 0;
+	unsigned char* decoded = SOIL_load_image_from_memory(
+		pkm.data(), (int)pkm.size(), &decoded_width, &decoded_height,
+		&decoded_channels, SOIL_LOAD_RGBA );
+	if( decoded != NULL && ( decoded_width != width || decoded_height != height ) )
+	{
+		free( decoded );
+		decoded = NULL;
+	}
+	return decoded;
+}
+
+/*	ETC2 blocks of a gradient go through another block format and back,
+	what comes out has to stay close to the gradient	*/
+static int test_transcode_round_trip(
+	int alpha, int through_format, int to_format, int to_pkm_format )
+{
+	const int width = 61;
+	const int height = 37;
+	std::vector<unsigned char> gradient( (size_t)width * height * 4 );
+	for( int y = 0; y < height; ++y )
+	{
+		for( int x = 0; x < width; ++x )
+		{
+			unsigned char* pixel = &gradient[( (size_t)y * width + x ) * 4];
+			pixel[0] = (unsigned char)( x * 255 / ( width - 1 ) );
+			pixel[1] = (unsigned char)( y * 255 / ( height - 1 ) );
+			pixel[2] = (unsigned char)( 128 + ( x - y ) );
+			pixel[3] = alpha ? (unsigned char)( 255 - ( x + y ) * 2 ) : 255;
+		}
+	}
+	std::vector<unsigned char> packed;
+	if( !alpha )
+	{
+		for( size_t i = 0; i < gradient.size(); ++i )
+			if( ( i & 3 ) != 3 )
+				packed.push_back( gradient[i] );
+	}
+	int size = 0;
+	unsigned char* source = convert_image_to_ETC2(
+		alpha ? gradient.data() : packed.data(), width, height, alpha ? 4 : 3, &size );
+	const int from_format = alpha ? TRANSCODE_ETC2_RGBA8 : TRANSCODE_ETC2_RGB8;
+	unsigned char* through = source ?
+		transcode_image( source, width, height, from_format, through_format, &size ) : NULL;
+	free( source );
+	unsigned char* blocks = through ?
+		transcode_image( through, width, height, through_format, to_format, &size ) : NULL;
+	free( through );
+	if( blocks == NULL ||
+	    size != ( ( width + 3 ) / 4 ) * ( ( height + 3 ) / 4 ) * transcode_block_size( to_format ) )
+	{
+		fprintf( stderr, "Transcoding through %d failed\n", through_format );
+		free( blocks );
+		return 0;
+	}
+	unsigned char* result = decode_PKM_blocks( blocks, size, width, height, to_pkm_format );
+	free( blocks );
+	if( result == NULL )
+	{
+		fprintf( stderr, "Transcoded CPU decode: %s\n", SOIL_last_result() );
+		return 0;
+	}
+	double error = 0.0;
+	for( size_t i = 0; i < gradient.size(); ++i )
+		error += std::abs( (int)result[i] - (int)gradient[i] );
+	free( result );
+	if( error / gradient.size() > 4.0 )
+	{
+		fprintf(
+			stderr, "Mean error %.2f after transcoding through %d\n",
+			error / gradient.size(), through_format );
+		return 0;
+	}
+	return 1;
+}
+
+static int test_transcode()
+{
+	int success = 1;
+	success &= test_transcode_round_trip( 1, TRANSCODE_BC3, TRANSCODE_ETC2_RGBA8, 3 );
+	success &= test_transcode_round_trip( 1, TRANSCODE_BC7, TRANSCODE_ETC2_RGBA8, 3 );
+	success &= test_transcode_round_trip( 0, TRANSCODE_BC1, TRANSCODE_ETC1, 0 );
+	success &= test_transcode_round_trip( 0, TRANSCODE_BC7, TRANSCODE_ETC2_RGB8, 1 );
+
+	/*	an opaque image is sent as BC1 instead of BC3, and there's no BC2 encoder	*/
+	unsigned char opaque[16] = { 0 };
+	int size = 0;
+	unsigned char* bc1 = transcode_image( opaque, 4, 4, TRANSCODE_ETC2_RGB8, TRANSCODE_BC1, &size );
+	if( bc1 == NULL || transcode_has_alpha( bc1, 4, 4, TRANSCODE_BC1 ) ||
+	    transcode_image( opaque, 4, 4, TRANSCODE_ETC2_RGB8, TRANSCODE_BC2, &size ) != NULL )
+	{
+		fprintf( stderr, "Unexpected transcode of an opaque block\n" );
+		success = 0;
+	}
+	free( bc1 );
+	return success;
+}
+
 int main( int argc, char** argv )
 {
 	static const Fixture fixtures[] = {
@@ -269,7 +478,7 @@ int main( int argc, char** argv )
 		{ "astc_12x12.astc", 0x93DD, 0x93DD, 1, SOIL_FLAG_SRGB_COLOR_SPACE, 0 }
 	};
 	const std::string fixture_dir = argc > 1 ? argv[1] : "bin/mobile";
-	int success = 1;
+	int success = test_transcode();
 
 	if( SDL_Init( SDL_INIT_VIDEO ) != 0 )
 	{
@@ -291,30 +500,31 @@ int main( int argc, char** argv )
 
 	for( size_t i = 0; i < sizeof( fixtures ) / sizeof( fixtures[0] ); ++i )
 		success &= test_fixture( fixture_dir, fixtures[i] );
+	success &= test_encode_round_trip( fixture_dir );
 
 	std::vector<unsigned char> invalid = read_file( fixture_dir + "/etc2_rgb8.pkm" );
 	invalid.pop_back();
-	success &= expect_failure( invalid, 0, "payload size" );
+	success &= expect_failure( invalid, 0, "payload size", SOIL_RESULT_DECODE_FAILED );
 	success &= expect_cpu_failure( invalid );
 	invalid = read_file( fixture_dir + "/etc2_rgb8.pkm" );
 	invalid[7] = 99;
-	success &= expect_failure( invalid, 0, "Unsupported PKM texture format" );
+	success &= expect_failure( invalid, 0, "Unsupported PKM texture format", SOIL_RESULT_UNSUPPORTED_FORMAT );
 	success &= expect_cpu_failure( invalid );
 	invalid = read_file( fixture_dir + "/astc_4x4.astc" );
 	invalid[4] = 7;
-	success &= expect_failure( invalid, 1, "block footprint" );
+	success &= expect_failure( invalid, 1, "block footprint", SOIL_RESULT_UNSUPPORTED_FORMAT );
 	invalid = read_file( fixture_dir + "/astc_4x4.astc" );
 	invalid.pop_back();
-	success &= expect_failure( invalid, 1, "payload size" );
+	success &= expect_failure( invalid, 1, "payload size", SOIL_RESULT_DECODE_FAILED );
 	invalid = read_file( fixture_dir + "/astc_4x4.astc" );
 	invalid[7] = 0xFF;
 	invalid[8] = 0xFF;
 	invalid[9] = 0xFF;
-	success &= expect_failure( invalid, 1, "payload size" );
+	success &= expect_failure( invalid, 1, "payload size", SOIL_RESULT_DECODE_FAILED );
 	invalid = read_file( fixture_dir + "/etc2_rgb8.pkm" );
 	invalid[12] = 0;
 	invalid[13] = 0;
-	success &= expect_failure( invalid, 0, "Invalid PKM dimensions" );
+	success &= expect_failure( invalid, 0, "Invalid PKM dimensions", SOIL_RESULT_DECODE_FAILED );
 	success &= expect_cpu_failure( invalid );
 
 	SDL_GL_DeleteContext( context );
@@ -0,0 +1,139 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../SOIL2/SOIL2.h"
+
+#define NO_SDL_GLEXT
+#if ( ( defined( _MSCVER ) || defined( _MSC_VER ) ) || defined( __APPLE_CC__ ) || defined ( __APPLE__ ) ) && !defined( SOIL2_NO_FRAMEWORKS )
+	#include <SDL.h>
+	#include <SDL_opengl.h>
+#else
+	#include <SDL2/SDL.h>
+	#include <SDL2/SDL_opengl.h>
+#endif
+
+static std::vector<unsigned char> read_level( GLuint texture, int level, int *width, int *height )
+{
+	std::vector<unsigned char> pixels;
+	glBindTexture( GL_TEXTURE_2D, texture );
+	glGetTexLevelParameteriv( GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, width );
+	glGetTexLevelParameteriv( GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, height );
+	pixels.resize( (size_t)*width * (size_t)*height * 4 );
+	glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+	glGetTexImage( GL_TEXTURE_2D, level, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data() );
+	return pixels;
+}
+
+/*	a texture uploaded through the PBO ring must be identical to a plain upload	*/
+static int compare_textures( const char *name, GLuint pbo_texture, GLuint plain_texture, int levels )
+{
+	for( int level = 0; level < levels; ++level )
+	{
+		int pw = 0, ph = 0, sw = 0, sh = 0;
+		std::vector<unsigned char> p = read_level( pbo_texture, level, &pw, &ph );
+		std::vector<unsigned char> s = read_level( plain_texture, level, &sw, &sh );
+		if( pw != sw || ph != sh || pw == 0 || p != s )
+		{
+			fprintf( stderr, "%s: level %d differs (%dx%d vs %dx%d)\n", name, level, pw, ph, sw, sh );
+			return 0;
+		}
+	}
+	return 1;
+}
+
+int main( int argc, char **argv )
+{
+	std::string base = argc > 1 ? argv[1] : "bin/";
+	static const char *files[] = { "img_test.png", "img_test.bmp", "img_mars.jpg", "lenna1.jpg", "test_rect.png" };
+	const int file_count = (int)( sizeof( files ) / sizeof( files[0] ) );
+	const unsigned int flags = SOIL_FLAG_MIPMAPS | SOIL_FLAG_INVERT_Y;
+	std::vector<GLuint> plain;
+	SDL_Window *window;
+	SDL_GLContext context;
+	int success = 1;
+	int i;
+
+	if( !base.empty() && base[base.size() - 1] != '/' )
+		base += '/';
+	if( SDL_Init( SDL_INIT_VIDEO ) != 0 )
+	{
+		fprintf( stderr, "SDL initialization failed: %s\n", SDL_GetError() );
+		return 1;
+	}
+
+	window = SDL_CreateWindow(
+		"SOIL2 PBO test", 0, 0, 16, 16,
+		SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN );
+	context = window ? SDL_GL_CreateContext( window ) : NULL;
+	if( context == NULL )
+	{
+		fprintf( stderr, "OpenGL context creation failed: %s\n", SDL_GetError() );
+		if( window )
+			SDL_DestroyWindow( window );
+		SDL_Quit();
+		return 1;
+	}
+
+	for( i = 0; i < file_count; ++i )
+		plain.push_back( SOIL_load_OGL_texture(
+			( base + files[i] ).c_str(), SOIL_LOAD_AUTO, SOIL_CREATE_NEW_ID, flags ) );
+
+	if( !SOIL_enable_PBO_uploads( 3 ) )
+	{
+		printf( "Pixel buffer objects are not supported, skipping: %s\n", SOIL_last_result() );
+	}
+	else
+	{
+		/*	more textures than buffers, so the ring wraps around	*/
+		for( i = 0; i < file_count; ++i )
+		{
+			GLuint texture = SOIL_load_OGL_texture(
+				( base + files[i] ).c_str(), SOIL_LOAD_AUTO, SOIL_CREATE_NEW_ID, flags );
+			if( texture == 0 || plain[i] == 0 )
+			{
+				fprintf( stderr, "%s: load failed: %s\n", files[i], SOIL_last_result() );
+				success = 0;
+			}
+			else
+			{
+				success &= compare_textures( files[i], texture, plain[i], 2 );
+			}
+			glDeleteTextures( 1, &texture );
+		}
+
+		/*	the asynchronous uploads share the ring	*/
+		SOIL_AsyncTexture *request = SOIL_load_OGL_texture_async(
+			( base + files[0] ).c_str(), SOIL_LOAD_AUTO, SOIL_CREATE_NEW_ID, flags );
+		GLuint texture = SOIL_async_wait( request );
+		if( texture == 0 )
+		{
+			fprintf( stderr, "Asynchronous PBO upload failed: %s\n", SOIL_last_result() );
+			success = 0;
+		}
+		else
+		{
+			success &= compare_textures( "async", texture, plain[0], 2 );
+		}
+		glDeleteTextures( 1, &texture );
+		SOIL_async_free( request );
+		SOIL_async_pump( 0 );
+
+		if( SOIL_enable_PBO_uploads( 0 ) != 0 || SOIL_last_result_code() != SOIL_RESULT_OK )
+		{
+			fprintf( stderr, "Disabling PBO uploads failed\n" );
+			success = 0;
+		}
+	}
+
+	for( i = 0; i < file_count; ++i )
+		glDeleteTextures( 1, &plain[i] );
+
+	SDL_GL_DeleteContext( context );
+	SDL_DestroyWindow( window );
+	SDL_Quit();
+
+	if( success )
+		printf( "PBO upload tests passed\n" );
+	return success ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../SOIL2/SOIL2.h"
+
+#define NO_SDL_GLEXT
+#if ( ( defined( _MSCVER ) || defined( _MSC_VER ) ) || defined( __APPLE_CC__ ) || defined ( __APPLE__ ) ) && !defined( SOIL2_NO_FRAMEWORKS )
+	#include <SDL.h>
+	#include <SDL_opengl.h>
+#else
+	#include <SDL2/SDL.h>
+	#include <SDL2/SDL_opengl.h>
+#endif
+
+#ifndef GL_TEXTURE_IMMUTABLE_FORMAT
+#define GL_TEXTURE_IMMUTABLE_FORMAT 0x912F
+#endif
+
+static std::vector<unsigned char> read_level( GLuint texture, int level, int *width, int *height )
+{
+	std::vector<unsigned char> pixels;
+	glBindTexture( GL_TEXTURE_2D, texture );
+	glGetTexLevelParameteriv( GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, width );
+	glGetTexLevelParameteriv( GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, height );
+	pixels.resize( (size_t)*width * (size_t)*height * 4 );
+	glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+	glGetTexImage( GL_TEXTURE_2D, level, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data() );
+	return pixels;
+}
+
+/*	a texture reloaded into an existing ID must be identical to a fresh load	*/
+static int compare_textures( const char *name, GLuint reloaded, GLuint fresh, int levels )
+{
+	for( int level = 0; level < levels; ++level )
+	{
+		int rw = 0, rh = 0, fw = 0, fh = 0;
+		std::vector<unsigned char> r = read_level( reloaded, level, &rw, &rh );
+		std::vector<unsigned char> f = read_level( fresh, level, &fw, &fh );
+		if( rw != fw || rh != fh || rw == 0 || r != f )
+		{
+			fprintf( stderr, "%s: level %d differs (%dx%d vs %dx%d)\n", name, level, rw, rh, fw, fh );
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/*	loads first, reloads second into the same ID and checks it against a fresh load of second	*/
+static int reload( const std::string &base, const char *first, const char *second, unsigned int flags )
+{
+	const std::string first_path = base + first;
+	const std::string second_path = base + second;
+	GLuint texture = SOIL_load_OGL_texture( first_path.c_str(), SOIL_LOAD_RGBA, SOIL_CREATE_NEW_ID, flags );
+	GLuint reloaded = SOIL_load_OGL_texture( second_path.c_str(), SOIL_LOAD_RGBA, texture, flags );
+	GLuint fresh = SOIL_load_OGL_texture( second_path.c_str(), SOIL_LOAD_RGBA, SOIL_CREATE_NEW_ID, flags );
+	int ok = 1;
+
+	if( texture == 0 || fresh == 0 || reloaded != texture )
+	{
+		fprintf( stderr, "Reloading %s over %s failed: %s\n", second, first, SOIL_last_result() );
+		ok = 0;
+	}
+	else
+	{
+		ok = compare_textures( second, reloaded, fresh, 2 );
+	}
+
+	glDeleteTextures( 1, &texture );
+	glDeleteTextures( 1, &fresh );
+	return ok;
+}
+
+int main( int argc, char **argv )
+{
+	std::string base = argc > 1 ? argv[1] : "bin/";
+	const unsigned int flags = SOIL_FLAG_MIPMAPS | SOIL_FLAG_INVERT_Y;
+	SDL_Window *window;
+	SDL_GLContext context;
+	int success = 1;
+
+	if( !base.empty() && base[base.size() - 1] != '/' )
+		base += '/';
+	if( SDL_Init( SDL_INIT_VIDEO ) != 0 )
+	{
+		fprintf( stderr, "SDL initialization failed: %s\n", SDL_GetError() );
+		return 1;
+	}
+
+	window = SDL_CreateWindow(
+		"SOIL2 reload test", 0, 0, 16, 16,
+		SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN );
+	context = window ? SDL_GL_CreateContext( window ) : NULL;
+	if( context == NULL )
+	{
+		fprintf( stderr, "OpenGL context creation failed: %s\n", SDL_GetError() );
+		if( window )
+			SDL_DestroyWindow( window );
+		SDL_Quit();
+		return 1;
+	}
+
+	/*	same size and format (updated in place), then a different size	*/
+	success &= reload( base, "img_test.png", "img_test.bmp", flags );
+	success &= reload( base, "img_test.png", "lenna1.jpg", flags );
+	success &= reload( base, "img_test.png", "img_test.bmp", flags | SOIL_FLAG_IMMUTABLE_STORAGE );
+
+	/*	immutable storage can't be resized	*/
+	GLuint texture = SOIL_load_OGL_texture(
+		( base + "img_test.png" ).c_str(), SOIL_LOAD_RGBA, SOIL_CREATE_NEW_ID, flags | SOIL_FLAG_IMMUTABLE_STORAGE );
+	GLint immutable = 0;
+	glBindTexture( GL_TEXTURE_2D, texture );
+	glGetTexParameteriv( GL_TEXTURE_2D, GL_TEXTURE_IMMUTABLE_FORMAT, &immutable );
+	while( glGetError() != GL_NO_ERROR ) {}
+	if( immutable )
+	{
+		if( SOIL_load_OGL_texture( ( base + "lenna1.jpg" ).c_str(), SOIL_LOAD_RGBA, texture, flags ) != 0 ||
+			SOIL_last_result_code() != SOIL_RESULT_INVALID_ARGUMENT )
+		{
+			fprintf( stderr, "Resizing an immutable texture was not reported\n" );
+			success = 0;
+		}
+	}
+	else
+	{
+		printf( "Immutable texture storage is not supported, skipping the resize check\n" );
+	}
+	glDeleteTextures( 1, &texture );
+
+	SDL_GL_DeleteContext( context );
+	SDL_DestroyWindow( window );
+	SDL_Quit();
+
+	if( success )
+		printf( "Texture reload tests passed\n" );
+	return success ? 0 : 1;
+}
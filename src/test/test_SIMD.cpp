@@ -0,0 +1,204 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../SOIL2/SOIL2.h"
+#include "../SOIL2/image_ETC.h"
+#include "../SOIL2/image_helper.h"
+
+/*	The SIMD kernels must give the same bytes as the plain C paths on every
+	CPU.  The checksums below were recorded from a build with SOIL_NO_SIMD,
+	so a kernel that drifts from the plain C one fails here on the machine
+	that runs it, SSE2, AVX2 or NEON.	*/
+
+static unsigned long long checksum( const unsigned char *data, size_t size )
+{
+	unsigned long long hash = 1469598103934665603ull;
+	for( size_t i = 0; i < size; ++i )
+	{
+		hash ^= data[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+/*	gradients with noise on top, so every kernel sees both smooth and busy texels	*/
+static std::vector<unsigned char> make_image( int width, int height, int channels, unsigned int seed )
+{
+	std::vector<unsigned char> pixels( (size_t)width * height * channels );
+	for( int y = 0; y < height; ++y )
+	{
+		for( int x = 0; x < width; ++x )
+		{
+			for( int c = 0; c < channels; ++c )
+			{
+				seed = seed * 1664525u + 1013904223u;
+				const int gradient = ( x * 255 / width + y * 255 / height + c * 64 ) & 255;
+				const int noise = (int)( seed >> 27 ) - 16;
+				const int value = gradient + ( ( x + y ) % 5 == 0 ? noise * 4 : noise );
+				pixels[( (size_t)y * width + x ) * channels + c] =
+					(unsigned char)( value < 0 ? 0 : value > 255 ? 255 : value );
+			}
+		}
+	}
+	return pixels;
+}
+
+struct SIMDCase
+{
+	int width, height, channels;
+};
+
+/*	odd sizes leave partial blocks and vector tails, with every channel count	*/
+static const SIMDCase cases[] = {
+	{ 37, 19, 1 }, { 37, 19, 2 }, { 37, 19, 3 }, { 37, 19, 4 },
+	{ 64, 33, 1 }, { 64, 33, 2 }, { 64, 33, 3 }, { 64, 33, 4 },
+	{ 70, 38, 1 }, { 70, 38, 2 }, { 70, 38, 3 }, { 70, 38, 4 }
+};
+static const int case_count = (int)( sizeof( cases ) / sizeof( cases[0] ) );
+
+static int check( const char *name, const SIMDCase &c, const unsigned char *data, size_t size, unsigned long long expected )
+{
+	const unsigned long long actual = NULL != data ? checksum( data, size ) : 0;
+	if( actual != expected )
+	{
+		fprintf( stderr, "%s %dx%d %d channels: 0x%016llxull, expected 0x%016llxull\n",
+			name, c.width, c.height, c.channels, actual, expected );
+		return 0;
+	}
+	return 1;
+}
+
+/*	the ETC half block search	*/
+static int test_ETC()
+{
+	static const unsigned long long expected[][2] = {
+		{ 0xfa9fe63985bed064ull, 0xfa9fe63985bed064ull }, { 0xd0f4274b1754d3bbull, 0x9a9dbdd29272f9efull },
+		{ 0x0836e6b9fba992bcull, 0x9959e25358c6ea66ull }, { 0xa9f849e6b64ca157ull, 0xef9c712b734c2276ull },
+		{ 0x11057a95dd24c70cull, 0x8efdd36600a6a8e3ull }, { 0xb1ccc5387c51fafaull, 0xa8c212e379f0567full },
+		{ 0x73ba024834273c1eull, 0xd4b46113ee90a92cull }, { 0x64b5fee6ac240f8eull, 0x15b1ce95ff742ca1ull },
+		{ 0x0d52cac153868257ull, 0x0d52cac153868257ull }, { 0x3e120725c7699c4bull, 0x2190512a7d9c6eebull },
+		{ 0xb8f68cc46c46953eull, 0x2955575381f88d86ull }, { 0x2fcd391bd0d4d46dull, 0x71307a43e48d2ccbull }
+	};
+	int success = 1;
+	for( int i = 0; i < case_count; ++i )
+	{
+		const SIMDCase &c = cases[i];
+		std::vector<unsigned char> image = make_image( c.width, c.height, c.channels, 1u + i );
+		int size = 0;
+		unsigned char *etc1 = convert_image_to_ETC1( image.data(), c.width, c.height, c.channels, &size );
+		success &= check( "ETC1", c, etc1, (size_t)size, expected[i][0] );
+		free( etc1 );
+		unsigned char *etc2 = convert_image_to_ETC2( image.data(), c.width, c.height, c.channels, &size );
+		success &= check( "ETC2", c, etc2, (size_t)size, expected[i][1] );
+		free( etc2 );
+	}
+	return success;
+}
+
+/*	the 2x2 box filter, an odd width leaves a vector tail and the last
+	column out, only even sizes take the kernels in mipmap_image_next_level	*/
+static int test_box_filter()
+{
+	static const unsigned long long expected[][2] = {
+		{ 0x59da31fa80794e38ull, 0x1113d6354278e229ull }, { 0xd1a0b753ce230387ull, 0x97b5c2d0f1a3ea2cull },
+		{ 0xb9c1d48ac66bbd79ull, 0x35100117edf8a49dull }, { 0xc05085a4074c81a5ull, 0x6df7f6275a4b0df8ull },
+		{ 0x8692021974e9a014ull, 0xcbc0b84c1c8c8282ull }, { 0x39830e94668927eaull, 0xd0a0fc530e0f1e9bull },
+		{ 0x2f98ce6a79ecd942ull, 0x6782fa4332648165ull }, { 0x97f78ffe25a0ccf3ull, 0x79f2c02a85c22878ull },
+		{ 0xcc8cd67d7891052bull, 0xcc8cd67d7891052bull }, { 0xd280faef7b5732daull, 0xd280faef7b5732daull },
+		{ 0x3894d1d4f9e33239ull, 0x3894d1d4f9e33239ull }, { 0xd8fde6936d9d99d5ull, 0xd8fde6936d9d99d5ull }
+	};
+	int success = 1;
+	for( int i = 0; i < case_count; ++i )
+	{
+		const SIMDCase &c = cases[i];
+		std::vector<unsigned char> image = make_image( c.width, c.height, c.channels, 11u + i );
+		std::vector<unsigned char> mipmap( (size_t)( c.width / 2 ) * ( c.height / 2 ) * c.channels );
+		mipmap_image( image.data(), c.width, c.height, c.channels, mipmap.data(), 2, 2 );
+		success &= check( "mipmap_image", c, mipmap.data(), mipmap.size(), expected[i][0] );
+		mipmap_image_next_level( image.data(), c.width, c.height, c.channels, mipmap.data() );
+		success &= check( "mipmap_image_next_level", c, mipmap.data(), mipmap.size(), expected[i][1] );
+	}
+	return success;
+}
+
+/*	the per pixel transforms alone and together, in place and not	*/
+static int test_transform()
+{
+	static const unsigned int operations[] = {
+		IMAGE_TRANSFORM_NTSC_SAFE,
+		IMAGE_TRANSFORM_MULTIPLY_ALPHA,
+		IMAGE_TRANSFORM_INVERT_Y | IMAGE_TRANSFORM_MULTIPLY_ALPHA,
+		IMAGE_TRANSFORM_INVERT_Y | IMAGE_TRANSFORM_NTSC_SAFE | IMAGE_TRANSFORM_MULTIPLY_ALPHA | IMAGE_TRANSFORM_YCOCG
+	};
+	static const unsigned long long expected[][4] = {
+		{ 0x1f071317a1e2a452ull, 0xe4da8af473eed6e1ull, 0x8b8ae3de2f66d341ull, 0x9cf0c79bd9d91196ull },
+		{ 0x1d74ee5b5c4d398aull, 0x2356fbb095789eb4ull, 0x03dd3a0e90bbe054ull, 0xd0b3b2472738df70ull },
+		{ 0xeb4d8dec9a895fb1ull, 0xf09cad14c0490c92ull, 0xb6169f78b888a926ull, 0x272e140ddd13c08bull },
+		{ 0xe3abd2e1cd2a1864ull, 0xcf0f6704de07fd5dull, 0x9938b4218d615ab5ull, 0x340f610e6bcbfc76ull },
+		{ 0x5e6d7998510a9a60ull, 0xd878ff2933215682ull, 0xb677719fc20e8df2ull, 0x417d4b2fe0148350ull },
+		{ 0xfad21f83858bc35full, 0x97a36675117609c9ull, 0xa83a4210fa93acb1ull, 0xb13a15db518ace57ull },
+		{ 0xd879d87dbc626787ull, 0x5b57c889e8c4aca6ull, 0x3898a4251c269376ull, 0xe90f80fd80f42c05ull },
+		{ 0xe45bb22686bf0ef4ull, 0x7c642a78c6402acbull, 0x721b47e0c5a556a7ull, 0x9d76607ca3036ae9ull },
+		{ 0xf23506a85166b7a8ull, 0x175b9cbaf61fccf0ull, 0xcc2c00deb0d2ba3cull, 0x861a27beec6c8dbcull },
+		{ 0x847c112ae1608cdaull, 0xda0f7b730d84276full, 0x3b17f464f0ebe423ull, 0xe0b9e4321483f25bull },
+		{ 0xd1ca8401311faaa3ull, 0x47ad765d689eb225ull, 0xd3afa6f56b3fa08dull, 0x9ed77890ec5cb1cfull },
+		{ 0xdd31e23be1da890eull, 0xb2b9273539eadc14ull, 0xe7f115810c49dbe8ull, 0x728363d9a724e450ull }
+	};
+	int success = 1;
+	for( int i = 0; i < case_count; ++i )
+	{
+		const SIMDCase &c = cases[i];
+		const std::vector<unsigned char> image = make_image( c.width, c.height, c.channels, 21u + i );
+		for( int o = 0; o < 4; ++o )
+		{
+			char name[32];
+			std::vector<unsigned char> transformed( image );
+			snprintf( name, sizeof( name ), "transform_image 0x%x", operations[o] );
+			if( o == 3 )
+				transform_image( transformed.data(), c.width, c.height, c.channels, transformed.data(), operations[o] );
+			else
+				transform_image( image.data(), c.width, c.height, c.channels, transformed.data(), operations[o] );
+			success &= check( name, c, transformed.data(), transformed.size(), expected[i][o] );
+		}
+	}
+	return success;
+}
+
+/*	RGB to YCoCg and back, only 3 and 4 channels are converted	*/
+static int test_YCoCg()
+{
+	static const unsigned long long expected[][2] = {
+		{ 0xd84608667c3f2ce9ull, 0xd84608667c3f2ce9ull }, { 0x63dab1259c1b06a2ull, 0x63dab1259c1b06a2ull },
+		{ 0xec4313979cc8418aull, 0x11d9771e0c5ab276ull }, { 0xbdefb4906c874844ull, 0xa56b8aed0f70ed59ull },
+		{ 0x5744dc4532ccb8b7ull, 0x5744dc4532ccb8b7ull }, { 0xaaeb8903472fe571ull, 0xaaeb8903472fe571ull },
+		{ 0xe32226d69fb99ad9ull, 0xd9ae9c28dba82960ull }, { 0xe9e0d6c4454d098eull, 0x97a4747cebbb0aa4ull },
+		{ 0x85b209e70512ad47ull, 0x85b209e70512ad47ull }, { 0x0748be6f2fda93c3ull, 0x0748be6f2fda93c3ull },
+		{ 0x7e8d041d7a87ca71ull, 0xd0084b30610f2c60ull }, { 0x7891f149b960fb7bull, 0xae0684c21072fc99ull }
+	};
+	int success = 1;
+	for( int i = 0; i < case_count; ++i )
+	{
+		const SIMDCase &c = cases[i];
+		std::vector<unsigned char> image = make_image( c.width, c.height, c.channels, 31u + i );
+		convert_RGB_to_YCoCg( image.data(), c.width, c.height, c.channels );
+		success &= check( "convert_RGB_to_YCoCg", c, image.data(), image.size(), expected[i][0] );
+		convert_YCoCg_to_RGB( image.data(), c.width, c.height, c.channels );
+		success &= check( "convert_YCoCg_to_RGB", c, image.data(), image.size(), expected[i][1] );
+	}
+	return success;
+}
+
+int main( int, char ** )
+{
+	int success = 1;
+
+	success &= test_ETC();
+	success &= test_box_filter();
+	success &= test_transform();
+	success &= test_YCoCg();
+
+	if( success )
+		printf( "SIMD kernel tests passed\n" );
+	return success ? 0 : 1;
+}